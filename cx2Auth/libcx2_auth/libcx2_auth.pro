@@ -3,6 +3,7 @@ QT       -= core gui
 SOURCES +=  \
     src/accountsecret_validation.cpp \
     src/domains.cpp \
+    src/hashingpool.cpp \
     src/manager.cpp \
     src/session.cpp
 HEADERS += \
@@ -12,6 +13,7 @@ HEADERS += \
     src/datastructs/ds_auth_reason.h \
     src/datastructs/ds_auth_secret.h \
     src/domains.h \
+    src/hashingpool.h \
     src/manager.h \
     src/session.h
 
@@ -10,6 +10,7 @@ using namespace CX2::Authentication;
 
 AccountSecret_Validation::AccountSecret_Validation()
 {
+    hashingPool = nullptr;
 }
 
 AccountSecret_Validation::~AccountSecret_Validation()
@@ -19,7 +20,12 @@ AccountSecret_Validation::~AccountSecret_Validation()
 
 
 
-Reason AccountSecret_Validation::validateStoredSecret(const Secret &storedSecret, const std::string &passwordInput, const std::string &challengeSalt, Mode authMode)
+void AccountSecret_Validation::setHashingPool(HashingPool *value)
+{
+    hashingPool = value;
+}
+
+Reason AccountSecret_Validation::validateStoredSecret(const Secret &storedSecret, const std::string &passwordInput, const std::string &challengeSalt, Mode authMode, const std::string &source)
 {
     Reason r =REASON_NOT_IMPLEMENTED;
   //  bool saltedHash = false;
@@ -35,20 +41,24 @@ Reason AccountSecret_Validation::validateStoredSecret(const Secret &storedSecret
     } break;
     case FN_SHA256:
     {
-        toCompare = Helpers::Crypto::calcSHA256(passwordInput);
+        if (!hashSecret(source, FN_SHA256, passwordInput, nullptr, &toCompare))
+            return REASON_AUTHENTICATOR_BUSY;
     } break;
     case FN_SHA512:
     {
-        toCompare = Helpers::Crypto::calcSHA512(passwordInput);
+        if (!hashSecret(source, FN_SHA512, passwordInput, nullptr, &toCompare))
+            return REASON_AUTHENTICATOR_BUSY;
     } break;
     case FN_SSHA256:
     {
-        toCompare = Helpers::Crypto::calcSSHA256(passwordInput, storedSecret.ssalt);
+        if (!hashSecret(source, FN_SSHA256, passwordInput, storedSecret.ssalt, &toCompare))
+            return REASON_AUTHENTICATOR_BUSY;
        // saltedHash = true;
     } break;
     case FN_SSHA512:
     {
-        toCompare = Helpers::Crypto::calcSSHA512(passwordInput, storedSecret.ssalt);
+        if (!hashSecret(source, FN_SSHA512, passwordInput, storedSecret.ssalt, &toCompare))
+            return REASON_AUTHENTICATOR_BUSY;
         //saltedHash = true;
     } break;
     case FN_GAUTHTIME:
@@ -62,7 +72,7 @@ Reason AccountSecret_Validation::validateStoredSecret(const Secret &storedSecret
         r = storedSecret.hash==toCompare? REASON_AUTHENTICATED:REASON_BAD_PASSWORD; // 1-1 comparisson
         break;
     case MODE_CHALLENGE:
-        r = validateChallenge(storedSecret.hash, passwordInput, challengeSalt);
+        r = validateChallenge(storedSecret.hash, passwordInput, challengeSalt, source);
         break;
     }
 
@@ -74,9 +84,12 @@ skipAuthMode:;
     return r;
 }
 
-Reason AccountSecret_Validation::validateChallenge(const std::string &passwordFromDB, const std::string &challengeInput, const std::string &challengeSalt)
+Reason AccountSecret_Validation::validateChallenge(const std::string &passwordFromDB, const std::string &challengeInput, const std::string &challengeSalt, const std::string &source)
 {
-    return challengeInput == Helpers::Crypto::calcSHA256(passwordFromDB + challengeSalt) ?
+    std::string challengeHash;
+    if (!hashSecret(source, FN_SHA256, passwordFromDB + challengeSalt, nullptr, &challengeHash))
+        return REASON_AUTHENTICATOR_BUSY;
+    return challengeInput == challengeHash ?
                  REASON_AUTHENTICATED:REASON_BAD_PASSWORD;
 }
 
@@ -85,3 +98,10 @@ Reason AccountSecret_Validation::validateGAuth(const std::string &seed, const st
     // TODO: (liboath)
     return REASON_NOT_IMPLEMENTED;
 }
+
+bool AccountSecret_Validation::hashSecret(const std::string &source, const Function &fn, const std::string &input, const unsigned char *ssalt, std::string *output)
+{
+    if (hashingPool)
+        return hashingPool->hash(source,fn,input,ssalt,output);
+    return HashingPool::calcHash(fn,input,ssalt,output);
+}
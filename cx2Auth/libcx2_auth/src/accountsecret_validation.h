@@ -8,6 +8,7 @@
 #include "ds_auth_reason.h"
 #include "ds_auth_function.h"
 #include "ds_auth_secret.h"
+#include "hashingpool.h"
 
 #include <cx2_thr_safecontainers/map_element.h>
 
@@ -40,8 +41,14 @@ public:
 
     virtual bool accountValidateAttribute(const std::string & sAccountName, const sApplicationAttrib & applicationAttrib)=0;
 
+    /**
+     * @brief setHashingPool Set the pool used to hash the incomming secrets (default: nullptr, hash in the caller thread)
+     * @param value started hashing pool (not owned, should live longer than this object)
+     */
+    void setHashingPool(HashingPool *value);
+
 protected:
-    Reason validateStoredSecret(const Secret & storedSecret, const std::string & passwordInput, const std::string &challengeSalt, Mode authMode);
+    Reason validateStoredSecret(const Secret & storedSecret, const std::string & passwordInput, const std::string &challengeSalt, Mode authMode, const std::string & source = "");
 
 private:
     /**
@@ -51,8 +58,15 @@ private:
      * @param challengeSalt Challenge Salt (Random Value generated by your app, take the security considerations)
      * @return Authentication Response Reason (authenticated or bad password)
      */
-    Reason validateChallenge(const std::string & passwordFromDB, const std::string & challengeInput, const std::string &challengeSalt);
+    Reason validateChallenge(const std::string & passwordFromDB, const std::string & challengeInput, const std::string &challengeSalt, const std::string & source);
     Reason validateGAuth(const std::string & seed, const std::string & token);
+    /**
+     * @brief hashSecret Hash using the hashing pool (if any)
+     * @return false if the hashing pool did not admit the task.
+     */
+    bool hashSecret(const std::string & source, const Function & fn, const std::string & input, const unsigned char * ssalt, std::string * output);
+
+    HashingPool * hashingPool;
 };
 
 }}
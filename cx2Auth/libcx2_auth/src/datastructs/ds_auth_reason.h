@@ -12,6 +12,7 @@ enum Reason
     REASON_INTERNAL_ERROR=500,          // INTERNAL ERROR (OTHER)
     REASON_NOT_IMPLEMENTED=501,         // AUTHENTICATION NOT IMPLEMENTED YET :(
     REASON_DUPLICATED_SESSION=502,      // DUPLICATED SESSION ID
+    REASON_AUTHENTICATOR_BUSY=503,      // AUTHENTICATION NOT ADMITTED (TOO MANY PENDING AUTHENTICATIONS)
     REASON_EXPIRED_PASSWORD=100,        // VALIDATE, HOWEVER MUST CHANGE PASSWORD NOW!
     REASON_EXPIRED_ACCOUNT=102,         // ACCOUNT EXPIRED. NOT USABLE
     REASON_DISABLED_ACCOUNT=103,        // ACCOUNT DISABLED BY ADMIN.
@@ -46,6 +47,7 @@ static const char * cREASON_EXPIRED = "Expired authentication";
 static const char * cREASON_UNAUTHENTICATED = "Not authenticated yet";
 static const char * cREASON_ANSWER_TIMEDOUT = "Answer timed out";
 static const char * cREASON_DUPLICATED_SESSION = "Session ID Duplicated Error";
+static const char * cREASON_AUTHENTICATOR_BUSY = "Authenticator busy, try again later";
 static const char * cREASON_INVALID_AUTHENTICATOR = "Invalid or undefined authenticator";
 static const char * cREASON_INVALID_DOMAIN = "Invalid domain name";
 static const char * cREASON_SESSIONLIMITS_EXCEEDED = "Sessions limits exceeded";
@@ -58,6 +60,7 @@ static const char * getReasonText(const Reason & reason)
     case REASON_SESSIONLIMITS_EXCEEDED: return cREASON_SESSIONLIMITS_EXCEEDED;
     case REASON_INVALID_AUTHENTICATOR: return cREASON_INVALID_AUTHENTICATOR;
     case REASON_DUPLICATED_SESSION: return cREASON_DUPLICATED_SESSION;
+    case REASON_AUTHENTICATOR_BUSY: return cREASON_AUTHENTICATOR_BUSY;
     case REASON_AUTHENTICATED: return cREASON_AUTHENTICATED;
     case REASON_INTERNAL_ERROR: return cREASON_INTERNAL_ERROR;
     case REASON_NOT_IMPLEMENTED: return cREASON_NOT_IMPLEMENTED;
@@ -0,0 +1,225 @@
+#include "hashingpool.h"
+
+#include <cx2_hlp_functions/crypto.h>
+#include <string.h>
+
+using namespace CX2::Authentication;
+
+HashingPool::HashingPool(uint32_t threadsCount, uint32_t maxQueuedCost, uint32_t maxQueuedCostPerSource)
+{
+    terminate = false;
+    started = false;
+
+    this->threadsCount = threadsCount;
+    this->maxQueuedCost = maxQueuedCost;
+    this->maxQueuedCostPerSource = maxQueuedCostPerSource;
+}
+
+HashingPool::~HashingPool()
+{
+    stop();
+}
+
+void HashingPool::start()
+{
+    std::unique_lock<std::mutex> lk(mutexQueues);
+    if (started)
+        return;
+    started = true;
+    terminate = false;
+    for (uint32_t i=0; i<threadsCount; i++)
+        threads.push_back(std::thread(hashingThread, this));
+}
+
+void HashingPool::stop()
+{
+    std::unique_lock<std::mutex> lk(mutexQueues);
+    terminate = true;
+    lk.unlock();
+    cond_insertedElement.notify_all();
+
+    for (auto & thread : threads)
+        thread.join();
+    threads.clear();
+
+    lk.lock();
+    started = false;
+}
+
+bool HashingPool::hashAsync(const std::string &source, const Function &fn, const std::string &input, const unsigned char *ssalt, void (*callbackOnHashed)(void *, const std::string &), void *callbackContext)
+{
+    uint32_t cost = hashCost(fn,input);
+    if (!cost)
+        return false;
+
+    std::unique_lock<std::mutex> lk(mutexQueues);
+
+    // Admission control:
+    sSourceQueue * sourceQueue = nullptr;
+    auto i = sourceQueues.find(source);
+    if (i != sourceQueues.end())
+        sourceQueue = &(i->second);
+
+    if (    !started || terminate
+         || stats.queuedCost + cost > maxQueuedCost
+         || (sourceQueue?sourceQueue->cost:0) + cost > maxQueuedCostPerSource )
+    {
+        stats.rejectedTasks++;
+        return false;
+    }
+
+    sHashingTask * task = new sHashingTask;
+    task->fn = fn;
+    task->input = input;
+    if (ssalt)
+        memcpy(task->ssalt,ssalt,sizeof(task->ssalt));
+    else
+        memset(task->ssalt,0,sizeof(task->ssalt));
+    task->cost = cost;
+    task->callbackOnHashed = callbackOnHashed;
+    task->callbackContext = callbackContext;
+
+    if (!sourceQueue)
+    {
+        sourceQueue = &(sourceQueues[source]);
+        sourcesRoundRobin.push_back(source);
+    }
+    sourceQueue->tasks.push(task);
+    sourceQueue->cost += cost;
+
+    stats.queuedTasks++;
+    stats.queuedCost += cost;
+    stats.queuedSources = sourceQueues.size();
+    if (stats.queuedTasks > stats.maxQueuedTasks)
+        stats.maxQueuedTasks = stats.queuedTasks;
+
+    cond_insertedElement.notify_one();
+    return true;
+}
+
+struct sHashingWaiter
+{
+    sHashingWaiter(std::string * output)
+    {
+        this->output = output;
+        done = false;
+    }
+    static void onHashed(void * context, const std::string & hash)
+    {
+        sHashingWaiter * waiter = (sHashingWaiter *)context;
+        std::unique_lock<std::mutex> lk(waiter->mutex);
+        *(waiter->output) = hash;
+        waiter->done = true;
+        // Only the thread waiting for this task is woken up:
+        waiter->cond_done.notify_one();
+    }
+
+    std::string * output;
+    bool done;
+    std::mutex mutex;
+    std::condition_variable cond_done;
+};
+
+bool HashingPool::hash(const std::string &source, const Function &fn, const std::string &input, const unsigned char *ssalt, std::string *output)
+{
+    sHashingWaiter waiter(output);
+    if (!hashAsync(source,fn,input,ssalt,sHashingWaiter::onHashed,&waiter))
+        return false;
+
+    std::unique_lock<std::mutex> lk(waiter.mutex);
+    while (!waiter.done)
+        waiter.cond_done.wait(lk);
+    return true;
+}
+
+uint32_t HashingPool::hashCost(const Function &fn, const std::string &input)
+{
+    // Cost in compression blocks (message + salt + padding).
+    switch (fn)
+    {
+    case FN_SHA256:
+    case FN_SSHA256:
+        return static_cast<uint32_t>( (input.size() + 4 + 9 + 63) / 64 );
+    case FN_SHA512:
+    case FN_SSHA512:
+        return static_cast<uint32_t>( (input.size() + 4 + 17 + 127) / 128 );
+    default:
+        return 0;
+    }
+}
+
+bool HashingPool::calcHash(const Function &fn, const std::string &input, const unsigned char *ssalt, std::string *output)
+{
+    switch (fn)
+    {
+    case FN_SHA256:
+        *output = Helpers::Crypto::calcSHA256(input);
+        break;
+    case FN_SHA512:
+        *output = Helpers::Crypto::calcSHA512(input);
+        break;
+    case FN_SSHA256:
+        *output = Helpers::Crypto::calcSSHA256(input, ssalt);
+        break;
+    case FN_SSHA512:
+        *output = Helpers::Crypto::calcSSHA512(input, ssalt);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+sHashingPoolStats HashingPool::getStats()
+{
+    std::unique_lock<std::mutex> lk(mutexQueues);
+    return stats;
+}
+
+void HashingPool::hashingThread(HashingPool *pool)
+{
+    pool->hashingLoop();
+}
+
+void HashingPool::hashingLoop()
+{
+    std::unique_lock<std::mutex> lk(mutexQueues);
+    for (;;)
+    {
+        // On termination, the queued tasks are processed before leaving.
+        while (sourcesRoundRobin.empty() && !terminate)
+            cond_insertedElement.wait(lk);
+        if (sourcesRoundRobin.empty())
+            return;
+
+        // Take the next task in round-robin by source:
+        std::string source = sourcesRoundRobin.front();
+        sourcesRoundRobin.pop_front();
+
+        sSourceQueue & sourceQueue = sourceQueues[source];
+        sHashingTask * task = sourceQueue.tasks.front();
+        sourceQueue.tasks.pop();
+        sourceQueue.cost -= task->cost;
+
+        if (sourceQueue.tasks.empty())
+            sourceQueues.erase(source);
+        else
+            sourcesRoundRobin.push_back(source);
+
+        stats.queuedTasks--;
+        stats.queuedCost -= task->cost;
+        stats.queuedSources = sourceQueues.size();
+
+        lk.unlock();
+
+        std::string output;
+        calcHash(task->fn, task->input, task->ssalt, &output);
+        task->callbackOnHashed(task->callbackContext, output);
+        // Don't leave the secret copy in the freed memory:
+        memset(&(task->input[0]),0,task->input.size());
+        delete task;
+
+        lk.lock();
+        stats.completedTasks++;
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef HASHINGPOOL_H
+#define HASHINGPOOL_H
+
+#include "ds_auth_function.h"
+
+#include <string>
+#include <list>
+#include <map>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace CX2 { namespace Authentication {
+
+struct sHashingPoolStats
+{
+    sHashingPoolStats()
+    {
+        queuedTasks = 0;
+        queuedCost = 0;
+        queuedSources = 0;
+        maxQueuedTasks = 0;
+        completedTasks = 0;
+        rejectedTasks = 0;
+    }
+    // Current queue depth:
+    uint64_t queuedTasks, queuedCost, queuedSources;
+    // Historic:
+    uint64_t maxQueuedTasks, completedTasks, rejectedTasks;
+};
+
+/**
+ * @brief Bounded hashing executor for the secret validation.
+ *        The tasks are queued per source (eg. IP Address) and served in round-robin, so a single source can't starve
+ *        the others, and the admission is bounded by the hashing cost (SHA blocks) instead of the task count.
+ */
+class HashingPool
+{
+public:
+    /**
+     * @brief HashingPool Initialize the hashing pool
+     * @param threadsCount hashing threads
+     * @param maxQueuedCost max cost (hash blocks) queued in the pool
+     * @param maxQueuedCostPerSource max cost (hash blocks) queued by the same source
+     */
+    HashingPool(uint32_t threadsCount = 4, uint32_t maxQueuedCost = 16384, uint32_t maxQueuedCostPerSource = 256);
+    ~HashingPool();
+    /**
+     * @brief start Start the hashing threads
+     */
+    void start();
+    /**
+     * @brief stop Process the queued tasks and stop the hashing threads (also called from destructor)
+     */
+    void stop();
+    /**
+     * @brief hashAsync Queue the input to be hashed by the pool, without blocking.
+     * @param source source key used for fair queueing (eg. client IP address)
+     * @param fn hash function (SHA256/SHA512/SSHA256/SSHA512)
+     * @param input data to be hashed (copied)
+     * @param ssalt 4 bytes salt for salted functions (copied)
+     * @param callbackOnHashed called from the hashing thread with callbackContext and the hex encoded hash
+     *                         (only if the task was admitted, the queued tasks are also processed on stop)
+     * @param callbackContext context passed to the callback
+     * @return false if the task was not admitted (pool busy or stopped) or the function is not a hash function.
+     */
+    bool hashAsync(const std::string & source, const Function & fn, const std::string & input, const unsigned char * ssalt,
+                   void (*callbackOnHashed)(void *, const std::string &), void * callbackContext);
+    /**
+     * @brief hash Hash the input using the pool (blocks until done).
+     * @param source source key used for fair queueing (eg. client IP address)
+     * @param fn hash function (SHA256/SHA512/SSHA256/SSHA512)
+     * @param input data to be hashed
+     * @param ssalt 4 bytes salt for salted functions
+     * @param output hex encoded hash
+     * @return false if the task was not admitted (pool busy or stopped) or the function is not a hash function.
+     */
+    bool hash(const std::string & source, const Function & fn, const std::string & input, const unsigned char * ssalt, std::string * output);
+    /**
+     * @brief hashCost Get the cost (hash blocks) of hashing input with fn
+     * @return cost, 0 if fn is not a hash function.
+     */
+    static uint32_t hashCost(const Function & fn, const std::string & input);
+    /**
+     * @brief calcHash Hash the input in the caller thread
+     * @param fn hash function (SHA256/SHA512/SSHA256/SSHA512)
+     * @param input data to be hashed
+     * @param ssalt 4 bytes salt for salted functions
+     * @param output hex encoded hash
+     * @return false if the function is not a hash function.
+     */
+    static bool calcHash(const Function & fn, const std::string & input, const unsigned char * ssalt, std::string * output);
+    /**
+     * @brief getStats Get the queue depth and the processed/rejected counters
+     */
+    sHashingPoolStats getStats();
+
+private:
+    struct sHashingTask
+    {
+        Function fn;
+        std::string input;
+        unsigned char ssalt[4];
+        uint32_t cost;
+        void (*callbackOnHashed)(void *, const std::string &);
+        void * callbackContext;
+    };
+    struct sSourceQueue
+    {
+        sSourceQueue()
+        {
+            cost = 0;
+        }
+        std::queue<sHashingTask *> tasks;
+        uint32_t cost;
+    };
+
+    static void hashingThread(HashingPool * pool);
+    void hashingLoop();
+
+    // TERMINATION:
+    bool terminate, started;
+
+    // LIMITS:
+    uint32_t maxQueuedCost, maxQueuedCostPerSource;
+
+    // THREADS:
+    std::list<std::thread> threads;
+    uint32_t threadsCount;
+
+    // QUEUES (served in round-robin by source):
+    std::map<std::string,sSourceQueue> sourceQueues;
+    std::list<std::string> sourcesRoundRobin;
+    std::mutex mutexQueues;
+    std::condition_variable cond_insertedElement;
+
+    sHashingPoolStats stats;
+};
+
+}}
+
+#endif // HASHINGPOOL_H
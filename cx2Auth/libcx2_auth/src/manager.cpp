@@ -44,15 +44,24 @@ bool Manager::initAccounts()
 Reason Manager::authenticate(const std::string &appName, const sClientDetails &clientDetails, const std::string &sAccountName, const std::string &incommingPassword, uint32_t passIndex, Mode authMode, const std::string &challengeSalt, std::map<uint32_t,std::string> *stAccountPassIndexesUsedForLogin)
 {
 
-    Reason ret;
+    Reason ret = REASON_UNAUTHENTICATED;
     bool accountFound=false, indexFound=false;
-    Threads::Sync::Lock_RD lock(mutex);      
+    uint32_t maxTries, abandonedAccountExpirationSeconds;
+    Secret pStoredSecretData;
+
+    // Only the policy is read under the manager lock, the account state methods are synchronized by the implementation
+    // and the secret hashing (expensive) is done without any lock:
+    {
+        Threads::Sync::Lock_RD lock(mutex);
+        maxTries = bAuthPolicyMaxTries;
+        abandonedAccountExpirationSeconds = bAuthPolicyAbandonedAccountExpirationSeconds;
+    }
 
     // Check if the user is enabled to authenticate in this APP:
     if (!applicationValidateAccount(appName,sAccountName))
         return REASON_BAD_ACCOUNT; // Account not available for this application.
 
-    Secret pStoredSecretData = retrieveSecret(sAccountName,passIndex, &accountFound, &indexFound);
+    pStoredSecretData = retrieveSecret(sAccountName,passIndex, &accountFound, &indexFound);
 
     if (accountFound == false)
         ret = REASON_BAD_ACCOUNT;
@@ -63,30 +72,37 @@ Reason Manager::authenticate(const std::string &appName, const sClientDetails &c
         time_t lastLogin = accountLastLogin(sAccountName);
 
         if      (!isAccountConfirmed(sAccountName))
-            return REASON_UNCONFIRMED_ACCOUNT;
+            ret = REASON_UNCONFIRMED_ACCOUNT;
 
         else if (isAccountDisabled(sAccountName))
-            return REASON_DISABLED_ACCOUNT;
+            ret = REASON_DISABLED_ACCOUNT;
 
         else if (isAccountExpired(sAccountName))
-            return REASON_EXPIRED_ACCOUNT;
+            ret = REASON_EXPIRED_ACCOUNT;
 
-        else if (lastLogin+bAuthPolicyAbandonedAccountExpirationSeconds<time(nullptr))
-            return REASON_EXPIRED_ACCOUNT;
+        else if (lastLogin+abandonedAccountExpirationSeconds<time(nullptr))
+            ret = REASON_EXPIRED_ACCOUNT;
 
-        else
-        {
-            ret = validateStoredSecret(pStoredSecretData, incommingPassword, challengeSalt, authMode);
+        if (ret != REASON_UNAUTHENTICATED)
+            return ret;
+    }
+
+    if (ret == REASON_UNAUTHENTICATED)
+    {
+        ret = validateStoredSecret(pStoredSecretData, incommingPassword, challengeSalt, authMode, clientDetails.sIPAddr);
 
-            // On successfull first login, give all pass indexes used for login...
-            if ( IS_PASSWORD_AUTHENTICATED(ret) && stAccountPassIndexesUsedForLogin && passIndex == 0 )
-            {
-                *stAccountPassIndexesUsedForLogin = accountPassIndexesUsedForLogin(sAccountName);
+        // Not admitted by the hashing pool, not a bad attempt:
+        if (ret == REASON_AUTHENTICATOR_BUSY)
+            return ret;
+
+        // On successfull first login, give all pass indexes used for login...
+        if ( IS_PASSWORD_AUTHENTICATED(ret) && stAccountPassIndexesUsedForLogin && passIndex == 0 )
+        {
+            *stAccountPassIndexesUsedForLogin = accountPassIndexesUsedForLogin(sAccountName);
 
-                // If can't retrieve well the pass indexes used for login, return an authentication error for any valid idx 0 password (preventing error).
-                if (stAccountPassIndexesUsedForLogin->find(0xFFFFFFFF)!=stAccountPassIndexesUsedForLogin->end())
-                    return REASON_INTERNAL_ERROR;
-            }
+            // If can't retrieve well the pass indexes used for login, return an authentication error for any valid idx 0 password (preventing error).
+            if (stAccountPassIndexesUsedForLogin->find(0xFFFFFFFF)!=stAccountPassIndexesUsedForLogin->end())
+                return REASON_INTERNAL_ERROR;
         }
     }
 
@@ -94,7 +110,7 @@ Reason Manager::authenticate(const std::string &appName, const sClientDetails &c
     if ( !IS_PASSWORD_AUTHENTICATED( ret ) )
     {
         // Increment the counter and disable the account acording to the policy.
-        if ( (pStoredSecretData.badAttempts + 1) >= bAuthPolicyMaxTries )
+        if ( (pStoredSecretData.badAttempts + 1) >= maxTries )
         {
             // Disable the account...
             accountDisable(sAccountName,true);
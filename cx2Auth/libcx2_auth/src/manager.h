@@ -134,6 +134,12 @@ public:
     bool isAccountExpired(const std::string & sAccountName);
 
     bool accountValidateAttribute(const std::string & sAccountName, const sApplicationAttrib & applicationAttrib) override;
+    /**
+     * @brief authorizationVersion Get a counter that changes every time the accounts/groups/attributes are modified
+     *        (used for caching the authorization results)
+     * @return version, or 0 if the manager does not track the changes (don't cache)
+     */
+    virtual uint64_t authorizationVersion() { return 0; }
     virtual std::set<std::string> accountsList()=0;
     virtual std::set<std::string> accountGroups(const std::string & sAccountName, bool lock = true)=0;
     virtual std::set<sApplicationAttrib> accountDirectAttribs(const std::string & sAccountName, bool lock = true)=0;
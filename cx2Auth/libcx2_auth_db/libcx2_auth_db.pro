@@ -6,7 +6,9 @@ SOURCES += \
     src/manager_db_groups.cpp \
     src/manager_db_attributes.cpp \
     src/manager_db_accounts.cpp \
-    src/manager_db_passindexs.cpp
+    src/manager_db_passindexs.cpp \
+    src/manager_db_snapshot.cpp \
+    src/manager_db_writebehind.cpp
 HEADERS += \  
     src/manager_db.h
 
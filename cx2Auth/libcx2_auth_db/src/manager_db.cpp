@@ -17,6 +17,21 @@ using namespace CX2::Authentication;
 Manager_DB::Manager_DB( CX2::Database::SQLConnector * sqlConnector )
 {
     this->sqlConnector = sqlConnector;
+
+    currentSnapshot = std::make_shared<const sSnapshot>();
+    bSnapshotReload = false;
+    snapshotReloadPeriodMS = 10000;
+
+    bWriteBehind = false;
+    writeBehindPeriodMS = 1000;
+    writeBehindMaxPending = 512;
+}
+
+Manager_DB::~Manager_DB()
+{
+    // Stop the reloader, and the flusher (writing the pending updates).
+    setSnapshotReload(false);
+    setWriteBehind(false);
 }
 
 bool Manager_DB::initScheme()
@@ -153,9 +168,9 @@ bool Manager_DB::initScheme()
                                     )
 
                 ;
-        return r;
+        return r && snapshotReload();
     }
-    return true;
+    return snapshotReload();
 }
 
 
@@ -3,6 +3,14 @@
 
 #include <cx2_auth/manager.h>
 #include <cx2_db/sqlconnector.h>
+#include <cx2_thr_mutex/mutex_shared.h>
+
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <functional>
 
 namespace CX2 { namespace Authentication {
 
@@ -11,8 +19,26 @@ class Manager_DB : public Manager
 public:
     // Open authentication system:
     Manager_DB( CX2::Database::SQLConnector * sqlConnector );
+    ~Manager_DB() override;
     bool initScheme() override;
 
+    /////////////////////////////////////////////////////////////////////////////////
+    // Write-Behind:
+    /**
+     * @brief setWriteBehind Enable/Disable the write-behind journal for the login bookkeeping (last login, login registry and bad attempts).
+     *                       The updates are coalesced per account and written in batched transactions every flushPeriodMS
+     *                       or when maxPendingUpdates is reached, while the pending counts are applied immediately to the lockout decisions.
+     * @param enabled true to enable (default: disabled)
+     * @param flushPeriodMS time between flushes in milliseconds
+     * @param maxPendingUpdates pending updates that triggers an early flush
+     */
+    void setWriteBehind(bool enabled, const uint32_t & flushPeriodMS = 1000, const size_t & maxPendingUpdates = 512);
+    /**
+     * @brief flushWriteBehind Write the pending login bookkeeping now.
+     * @return true if every batch was written.
+     */
+    bool flushWriteBehind();
+
     /////////////////////////////////////////////////////////////////////////////////
     // Pass Indexes:
     std::set<uint32_t> passIndexesUsedByAccount(const std::string & sAccountName) override;
@@ -117,6 +143,22 @@ public:
     std::set<sApplicationAttrib> groupAttribs(const std::string & groupName, bool lock = true) override;
     std::set<std::string> groupAccounts(const std::string & groupName, bool lock = true) override;
 
+    /////////////////////////////////////////////////////////////////////////////////
+    // authorization (served from the snapshot):
+    bool accountValidateAttribute(const std::string & sAccountName, const sApplicationAttrib & applicationAttrib) override;
+    /**
+     * @brief snapshotVersion Get the version of the published account/group/attribute snapshot (incremented on every change)
+     */
+    uint64_t snapshotVersion();
+    uint64_t authorizationVersion() override;
+    /**
+     * @brief setSnapshotReload Enable/Disable reloading the snapshot from the database every periodMS, to see the changes
+     *                          written by other processes (otherwise, only the changes done through this manager are seen)
+     * @param enabled true to enable (default: disabled)
+     * @param periodMS time between reloads in milliseconds
+     */
+    void setSnapshotReload(bool enabled, const uint32_t & periodMS = 10000);
+
     std::list<std::string> getSqlErrorList() const;
     void clearSQLErrorList();
 
@@ -125,6 +167,101 @@ protected:
     Secret retrieveSecret(const std::string &sAccountName, uint32_t passIndex, bool * accountFound, bool * indexFound) override;
 
 private:
+    // Immutable snapshot of the account/group/attribute graph, published RCU style: readers take the
+    // current pointer without locking, writers copy the changed nodes and publish a new version.
+    struct sSnapshotAccount {
+        sSnapshotAccount()
+        {
+            enabled = false;
+            confirmed = false;
+            superuser = false;
+            expiration = 1;
+        }
+        bool enabled, confirmed, superuser;
+        time_t expiration;
+        std::set<std::string> groups, applications;
+        std::set<sApplicationAttrib> attribs;
+    };
+    struct sSnapshotGroup {
+        std::set<std::string> accounts;
+        std::set<sApplicationAttrib> attribs;
+    };
+    struct sSnapshot {
+        sSnapshot()
+        {
+            version = 0;
+        }
+        uint64_t version;
+        std::map<std::string,std::shared_ptr<const sSnapshotAccount>> accounts;
+        std::map<std::string,std::shared_ptr<const sSnapshotGroup>> groups;
+    };
+
+    // The snapshot is updated by the writes done through this manager (single writer), the changes done to the
+    // database by other processes/managers are only seen after a reload (see setSnapshotReload).
+    std::shared_ptr<const sSnapshot> snapshot();
+    std::shared_ptr<const sSnapshotAccount> snapshotAccount(const std::string & sAccountName);
+    std::shared_ptr<const sSnapshotGroup> snapshotGroup(const std::string & groupName);
+    bool snapshotReload();
+    void snapshotUpdate(const std::function<void(sSnapshot &)> & update);
+    static void snapshotUpdateAccount(sSnapshot & s, const std::string & sAccountName, const std::function<void(sSnapshotAccount &)> & update);
+    static void snapshotUpdateGroup(sSnapshot & s, const std::string & groupName, const std::function<void(sSnapshotGroup &)> & update);
+
+    static void snapshotReloadThread(Manager_DB * manager);
+    void snapshotReloadLoop();
+
+    std::shared_ptr<const sSnapshot> currentSnapshot;
+    std::mutex mtSnapshotUpdate;
+
+    // Periodic reload:
+    std::mutex mtSnapshotReload;
+    std::condition_variable cvSnapshotReload;
+    std::atomic<bool> bSnapshotReload;
+    uint32_t snapshotReloadPeriodMS;
+    std::thread snapshotReloader;
+
+    struct sPendingBadAttempts {
+        sPendingBadAttempts()
+        {
+            reset = false;
+            increments = 0;
+        }
+        bool reset;
+        uint32_t increments;
+    };
+    struct sPendingLogin {
+        std::string sAccountName;
+        uint32_t passIndex;
+        time_t loginDateTime;
+        sClientDetails clientDetails;
+    };
+    struct sWriteBehindJournal {
+        size_t size() const { return badAttempts.size() + lastLogins.size() + logins.size(); }
+        void clear() { badAttempts.clear(); lastLogins.clear(); logins.clear(); }
+        void removeAccount(const std::string & sAccountName);
+
+        std::map<std::pair<std::string,uint32_t>,sPendingBadAttempts> badAttempts;
+        std::map<std::string,time_t> lastLogins;
+        std::list<sPendingLogin> logins;
+    };
+
+    static void writeBehindThread(Manager_DB * manager);
+    void writeBehindLoop();
+    void writeBehindBadAttempts(const std::string & sAccountName, const uint32_t & passIndex, bool reset);
+    uint32_t writeBehindCurrentBadAttempts(const std::string & sAccountName, const uint32_t & passIndex, const uint32_t & storedBadAttempts);
+    bool writeBehindCurrentLastLogin(const std::string & sAccountName, time_t * lastLogin);
+    void writeBehindRemove(const std::string & sAccountName, const uint32_t & passIndex = 0xFFFFFFFF);
+
+    // Write-Behind journal (the flushing one remains visible until it's written):
+    sWriteBehindJournal pendingJournal, flushingJournal;
+    std::mutex mtWriteBehind, mtWriteBehindFlush;
+    std::condition_variable cvWriteBehind;
+    std::atomic<bool> bWriteBehind;
+    uint32_t writeBehindPeriodMS;
+    size_t writeBehindMaxPending;
+    std::thread writeBehindFlusher;
+
+    // Secrets and login bookkeeping (not blocked by the account/group/attribute writers):
+    Threads::Sync::Mutex_Shared mutexSecrets;
 
     std::list<std::string> sqlErrorList;
     std::string filePath;
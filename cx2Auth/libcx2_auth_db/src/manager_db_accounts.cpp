@@ -18,7 +18,7 @@ bool Manager_DB::accountAdd(const std::string &sAccountName, const Secret &secre
 {
     Threads::Sync::Lock_RW lock(mutex);
 
-    return sqlConnector->query("INSERT INTO vauth_v3_accounts (`userName`,`givenName`,`lastName`,`email`,`description`,`extraData`,`superuser`,`enabled`,`expiration`,`confirmed`,`canCreateAccounts`,`canCreateApplications`,`creator`) "
+    bool r = sqlConnector->query("INSERT INTO vauth_v3_accounts (`userName`,`givenName`,`lastName`,`email`,`description`,`extraData`,`superuser`,`enabled`,`expiration`,`confirmed`,`canCreateAccounts`,`canCreateApplications`,`creator`) "
                                                        "VALUES(:userName ,:givenname ,:lastname ,:email ,:description ,:extraData ,:superuser ,:enabled ,:expiration ,:confirmed ,:canCreateAccounts ,:canCreateApplications ,:creator);",
                                {
                                    {":userName",new Abstract::STRING(sAccountName)},
@@ -60,6 +60,22 @@ bool Manager_DB::accountAdd(const std::string &sAccountName, const Secret &secre
                                 }
                                 );
 
+    if (!r)
+    {
+        // Partially inserted?, take the graph from the database:
+        snapshotReload();
+        return false;
+    }
+
+    snapshotUpdate([&](sSnapshot & s) {
+        std::shared_ptr<sSnapshotAccount> account = std::make_shared<sSnapshotAccount>();
+        account->enabled = accountAttribs.enabled;
+        account->confirmed = accountAttribs.confirmed;
+        account->superuser = accountAttribs.superuser;
+        account->expiration = expirationDate;
+        s.accounts[sAccountName] = account;
+    });
+    return true;
 }
 
 std::string Manager_DB::accountConfirmationToken(const std::string &sAccountName)
@@ -80,36 +96,43 @@ std::string Manager_DB::accountConfirmationToken(const std::string &sAccountName
 bool Manager_DB::accountRemove(const std::string &sAccountName)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("DELETE FROM vauth_v3_accounts WHERE `userName`=:userName;",
-                               {
-                                   {":userName",new Abstract::STRING(sAccountName)}
-                               });
-
+    writeBehindRemove(sAccountName);
+    if (!sqlConnector->query("DELETE FROM vauth_v3_accounts WHERE `userName`=:userName;",
+                             {
+                                 {":userName",new Abstract::STRING(sAccountName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        auto account = s.accounts.find(sAccountName);
+        if (account == s.accounts.end())
+            return;
+        for (const std::string & groupName : account->second->groups)
+            snapshotUpdateGroup(s, groupName, [&](sSnapshotGroup & group) { group.accounts.erase(sAccountName); });
+        s.accounts.erase(account);
+    });
+    return true;
 }
 
 bool Manager_DB::accountExist(const std::string &sAccountName)
 {
-    bool ret = false;
-    Threads::Sync::Lock_RD lock(mutex);
-
-    QueryInstance i = sqlConnector->query("SELECT `enabled` FROM vauth_v3_accounts WHERE `userName`=:userName LIMIT 1;",
-                                          {{":userName",new Memory::Abstract::STRING(sAccountName)}},
-                                          { });
-    if (i.ok && i.query->step())
-    {
-        ret = true;
-    }
-    return ret;
+    return snapshotAccount(sAccountName) != nullptr;
 }
 
 bool Manager_DB::accountDisable(const std::string &sAccountName, bool disabled)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("UPDATE vauth_v3_accounts SET `enabled`=:enabled WHERE `userName`=:userName;",
-                               {
-                                   {":enabled",new Abstract::BOOL(!disabled)},
-                                   {":userName",new Abstract::STRING(sAccountName)}
-                               });
+    if (!sqlConnector->query("UPDATE vauth_v3_accounts SET `enabled`=:enabled WHERE `userName`=:userName;",
+                             {
+                                 {":enabled",new Abstract::BOOL(!disabled)},
+                                 {":userName",new Abstract::STRING(sAccountName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.enabled = !disabled; });
+    });
+    return true;
 }
 
 bool Manager_DB::accountConfirm(const std::string &sAccountName, const std::string &confirmationToken)
@@ -125,10 +148,16 @@ bool Manager_DB::accountConfirm(const std::string &sAccountName, const std::stri
     {
         if (!token.getValue().empty() && token.getValue() == confirmationToken)
         {
-            return sqlConnector->query("UPDATE vauth_v3_accounts SET `confirmed`='1' WHERE `userName`=:userName;",
-                                       {
-                                           {":userName",new Abstract::STRING(sAccountName)}
-                                       });
+            if (!sqlConnector->query("UPDATE vauth_v3_accounts SET `confirmed`='1' WHERE `userName`=:userName;",
+                                     {
+                                         {":userName",new Abstract::STRING(sAccountName)}
+                                     }))
+                return false;
+
+            snapshotUpdate([&](sSnapshot & s) {
+                snapshotUpdateAccount(s, sAccountName, [](sSnapshotAccount & account) { account.confirmed = true; });
+            });
+            return true;
         }
     }
     return false;
@@ -137,6 +166,8 @@ bool Manager_DB::accountConfirm(const std::string &sAccountName, const std::stri
 bool Manager_DB::accountChangeSecret(const std::string &sAccountName, const Secret &passwordData, uint32_t passIndex)
 {
     Threads::Sync::Lock_RW lock(mutex);
+    Threads::Sync::Lock_RW lockSecrets(mutexSecrets);
+    writeBehindRemove(sAccountName,passIndex);
 
     // Destroy (if exist).
     sqlConnector->query("DELETE FROM vauth_v3_accountsecrets WHERE `f_userName`=:userName and `f_secretIndex`=:index",
@@ -217,59 +248,35 @@ bool Manager_DB::accountChangeExpiration(const std::string &sAccountName, time_t
 {
     Threads::Sync::Lock_RW lock(mutex);
 
-    return sqlConnector->query("UPDATE vauth_v3_accounts SET `expiration`=:expiration WHERE `userName`=:userName;",
-                               {
-                                   {":expiration",new Abstract::DATETIME(expiration)},
-                                   {":userName",new Abstract::STRING(sAccountName)}
-                               });
+    if (!sqlConnector->query("UPDATE vauth_v3_accounts SET `expiration`=:expiration WHERE `userName`=:userName;",
+                             {
+                                 {":expiration",new Abstract::DATETIME(expiration)},
+                                 {":userName",new Abstract::STRING(sAccountName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.expiration = expiration; });
+    });
+    return true;
 }
 
 bool Manager_DB::isAccountDisabled(const std::string &sAccountName)
 {
-    Threads::Sync::Lock_RD lock(mutex);
-
-    Abstract::BOOL enabled;
-    QueryInstance i = sqlConnector->query("SELECT `enabled` FROM vauth_v3_accounts WHERE `userName`=:userName LIMIT 1;",
-                                          { {":userName",new Memory::Abstract::STRING(sAccountName)} },
-                                          { &enabled });
-
-    if (i.ok && i.query->step())
-    {
-        return !enabled.getValue();
-    }
-    return true;
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return !account || !account->enabled;
 }
 
 bool Manager_DB::isAccountConfirmed(const std::string &sAccountName)
 {
-    Threads::Sync::Lock_RD lock(mutex);
-
-    Abstract::BOOL confirmed;
-    QueryInstance i = sqlConnector->query("SELECT `confirmed` FROM vauth_v3_accounts WHERE `userName`=:userName LIMIT 1;",
-                                          { {":userName",new Memory::Abstract::STRING(sAccountName)} },
-                                          { &confirmed });
-
-    if (i.ok && i.query->step())
-    {
-        return confirmed.getValue();
-    }
-    return false;
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return account && account->confirmed;
 }
 
 bool Manager_DB::isAccountSuperUser(const std::string &sAccountName)
 {
-    Threads::Sync::Lock_RD lock(mutex);
-
-    Abstract::BOOL superuser;
-    QueryInstance i = sqlConnector->query("SELECT `superuser` FROM vauth_v3_accounts WHERE `userName`=:userName LIMIT 1;",
-                                          { {":userName",new Memory::Abstract::STRING(sAccountName)} },
-                                          { &superuser });
-
-    if (i.ok && i.query->step())
-    {
-        return superuser.getValue();
-    }
-    return false;
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return account && account->superuser;
 }
 
 std::string Manager_DB::accountGivenName(const std::string &sAccountName)
@@ -354,23 +361,26 @@ std::string Manager_DB::accountExtraData(const std::string &sAccountName)
 
 time_t Manager_DB::accountExpirationDate(const std::string &sAccountName)
 {
-    Threads::Sync::Lock_RD lock(mutex);
-
-    Abstract::DATETIME expiration;
-    QueryInstance i = sqlConnector->query("SELECT `expiration` FROM vauth_v3_accounts WHERE `userName`=:userName LIMIT 1;",
-                                          { {":userName",new Memory::Abstract::STRING(sAccountName)} },
-                                          { &expiration });
-    if (i.ok && i.query->step())
-    {
-        return expiration.getValue();
-    }
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
     // If can't get this data, the account is expired:
-    return 1;
+    return account ? account->expiration : 1;
 }
 
 void Manager_DB::updateLastLogin(const std::string &sAccountName, const uint32_t &uPassIdx, const sClientDetails &clientDetails)
 {
-    Threads::Sync::Lock_RW lock(mutex);
+    if (bWriteBehind)
+    {
+        // Journal it, the flusher will write it later:
+        std::unique_lock<std::mutex> lock(mtWriteBehind);
+        time_t now = time(nullptr);
+        pendingJournal.lastLogins[sAccountName] = now;
+        pendingJournal.logins.push_back( { sAccountName, uPassIdx, now, clientDetails } );
+        if (pendingJournal.size() >= writeBehindMaxPending)
+            cvWriteBehind.notify_one();
+        return;
+    }
+
+    Threads::Sync::Lock_RW lock(mutexSecrets);
 
     sqlConnector->query("UPDATE vauth_v3_accounts SET `lastLogin`=CURRENT_TIMESTAMP WHERE `userName`=:userName;",
                         {
@@ -395,12 +405,15 @@ void Manager_DB::updateLastLogin(const std::string &sAccountName, const uint32_t
 
 time_t Manager_DB::accountLastLogin(const std::string &sAccountName)
 {
-    Threads::Sync::Lock_RD lock(mutex);
+    Threads::Sync::Lock_RD lock(mutexSecrets);
 
     Abstract::DATETIME lastLogin;
     QueryInstance i = sqlConnector->query("SELECT `lastLogin` FROM vauth_v3_accounts WHERE `userName`=:userName LIMIT 1;",
                                           { {":userName",new Memory::Abstract::STRING(sAccountName)} },
                                           { &lastLogin });
+    time_t pendingLastLogin;
+    if (writeBehindCurrentLastLogin(sAccountName,&pendingLastLogin))
+        return pendingLastLogin;
     if (i.ok && i.query->step())
     {
         return lastLogin.getValue();
@@ -411,7 +424,13 @@ time_t Manager_DB::accountLastLogin(const std::string &sAccountName)
 
 void Manager_DB::resetBadAttempts(const std::string &sAccountName, const uint32_t &passIndex)
 {
-    Threads::Sync::Lock_RW lock(mutex);
+    if (bWriteBehind)
+    {
+        writeBehindBadAttempts(sAccountName,passIndex,true);
+        return;
+    }
+
+    Threads::Sync::Lock_RW lock(mutexSecrets);
     sqlConnector->query("UPDATE vauth_v3_accountsecrets SET `badAttempts`='0' WHERE `f_userName`=:userName and `f_secretIndex`=:index;",
                         {
                             {":userName",new Abstract::STRING(sAccountName)},
@@ -422,7 +441,13 @@ void Manager_DB::resetBadAttempts(const std::string &sAccountName, const uint32_
 
 void Manager_DB::incrementBadAttempts(const std::string &sAccountName, const uint32_t &passIndex)
 {
-    Threads::Sync::Lock_RW lock(mutex);
+    if (bWriteBehind)
+    {
+        writeBehindBadAttempts(sAccountName,passIndex,false);
+        return;
+    }
+
+    Threads::Sync::Lock_RW lock(mutexSecrets);
     sqlConnector->query("UPDATE vauth_v3_accountsecrets SET `badAttempts`=`badAttempts`+1  WHERE `f_userName`=:userName and `f_secretIndex`=:index;",
                         {
                             {":userName",new Abstract::STRING(sAccountName)},
@@ -433,67 +458,30 @@ void Manager_DB::incrementBadAttempts(const std::string &sAccountName, const uin
 std::set<std::string> Manager_DB::accountsList()
 {
     std::set<std::string> ret;
-    Threads::Sync::Lock_RD lock(mutex);
-
-    Abstract::STRING sAccountName;
-    QueryInstance i = sqlConnector->query("SELECT `userName` FROM vauth_v3_accounts;",
-                                          { },
-                                          { &sAccountName });
-    while (i.ok && i.query->step())
-    {
-        ret.insert(sAccountName.getValue());
-    }
-
+    for (const auto & account : snapshot()->accounts)
+        ret.insert(ret.end(), account.first);
     return ret;
 }
 
-std::set<std::string> Manager_DB::accountGroups(const std::string &sAccountName, bool lock)
+std::set<std::string> Manager_DB::accountGroups(const std::string &sAccountName, bool)
 {
-    std::set<std::string> ret;
-    if (lock) mutex.lock_shared();
-
-    Abstract::STRING group;
-    QueryInstance i = sqlConnector->query("SELECT `f_groupName` FROM vauth_v3_groupsaccounts WHERE `f_userName`=:userName;",
-                                          { {":userName",new Memory::Abstract::STRING(sAccountName)} },
-                                          { &group });
-    while (i.ok && i.query->step())
-    {
-        ret.insert(group.getValue());
-    }
-
-    if (lock) mutex.unlock_shared();
-    return ret;
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return account ? account->groups : std::set<std::string>();
 }
 
-std::set<sApplicationAttrib> Manager_DB::accountDirectAttribs(const std::string &sAccountName, bool lock)
+std::set<sApplicationAttrib> Manager_DB::accountDirectAttribs(const std::string &sAccountName, bool)
 {
-    std::set<sApplicationAttrib> ret;
-    if (lock) mutex.lock_shared();
-
-    Abstract::STRING appName,attrib;
-    QueryInstance i = sqlConnector->query("SELECT `f_appName`,`f_attribName` FROM vauth_v3_attribsaccounts WHERE `f_userName`=:userName;",
-                                          { {":userName",new Memory::Abstract::STRING(sAccountName)} },
-                                          { &appName,&attrib });
-    while (i.ok && i.query->step())
-    {
-        ret.insert( { appName.getValue(), attrib.getValue() } );
-    }
-
-    if (lock) mutex.unlock_shared();
-    return ret;
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return account ? account->attribs : std::set<sApplicationAttrib>();
 }
 
 bool Manager_DB::superUserAccountExist()
 {
-    Threads::Sync::Lock_RD lock(mutex);
-
-    QueryInstance i = sqlConnector->query("SELECT `superuser` FROM vauth_v3_accounts WHERE `superuser`=:superuser LIMIT 1;",
-                                          { {":superuser",new Memory::Abstract::BOOL(true)} },
-                                          { });
-
-    if (i.ok && i.query->step())
-        return true;
-
+    for (const auto & account : snapshot()->accounts)
+    {
+        if (account.second->superuser)
+            return true;
+    }
     return false;
 }
 
@@ -504,7 +492,7 @@ Secret Manager_DB::retrieveSecret(const std::string &sAccountName, uint32_t pass
     *indexFound = false;
     *accountFound = false;
 
-    Threads::Sync::Lock_RD lock(mutex);
+    Threads::Sync::Lock_RD lock(mutexSecrets);
 
     Abstract::UINT32 steps,function,badAttempts;
     Abstract::BOOL forcedExpiration;
@@ -530,7 +518,7 @@ Secret Manager_DB::retrieveSecret(const std::string &sAccountName, uint32_t pass
         ret.forceExpiration = forcedExpiration.getValue();
         ret.passwordFunction = (Authentication::Function)function.getValue();
         ret.expiration = expiration.getValue();
-        ret.badAttempts = badAttempts.getValue();
+        ret.badAttempts = writeBehindCurrentBadAttempts(sAccountName,passIndex,badAttempts.getValue());
         CX2::Helpers::Encoders::fromHex(salt.getValue(),ret.ssalt,4);
         ret.hash = hash.getValue();
     }
@@ -27,10 +27,14 @@ bool Manager_DB::applicationAdd(const std::string &appName, const std::string &a
 bool Manager_DB::applicationRemove(const std::string &appName)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("DELETE FROM vauth_v3_applications WHERE `appName`=:appName;",
-                               {
-                                   {":appName",new Abstract::STRING(appName)}
-                               });
+    bool ret = sqlConnector->query("DELETE FROM vauth_v3_applications WHERE `appName`=:appName;",
+                                   {
+                                       {":appName",new Abstract::STRING(appName)}
+                                   });
+    // The application attributes and accounts are removed in cascade, reload the graph:
+    if (ret)
+        snapshotReload();
+    return ret;
 }
 
 bool Manager_DB::applicationExist(const std::string &appName)
@@ -108,14 +112,8 @@ bool Manager_DB::applicationValidateOwner(const std::string &appName, const std:
 
 bool Manager_DB::applicationValidateAccount(const std::string &appName, const std::string &sAccountName)
 {
-    Threads::Sync::Lock_RD lock(mutex);
-
-    QueryInstance i = sqlConnector->query("SELECT `f_appName` FROM vauth_v3_applicationusers WHERE `f_userName`=:userName AND `f_appName`=:appName;",
-                                          { {":appName",new Abstract::STRING(appName)},
-                                            {":userName",new Memory::Abstract::STRING(sAccountName)}
-                                          },
-                                          { });
-    return (i.ok && i.query->step());
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return account && account->applications.find(appName) != account->applications.end();
 }
 
 std::set<std::string> Manager_DB::applicationOwners(const std::string &appName)
@@ -158,31 +156,24 @@ std::set<std::string> Manager_DB::applicationAccounts(const std::string &appName
 
 std::set<std::string> Manager_DB::accountApplications(const std::string &sAccountName)
 {
-    std::set<std::string> ret;
-    Threads::Sync::Lock_RD lock(mutex);
-
-    Abstract::STRING sApplicationName;
-    QueryInstance i = sqlConnector->query("SELECT `f_appName` FROM vauth_v3_applicationusers WHERE `f_userName`=:userName;",
-                                          {
-                                              {":userName",new Abstract::STRING(sAccountName)}
-                                          },
-                                          { &sApplicationName });
-    while (i.ok && i.query->step())
-    {
-        ret.insert(sApplicationName.getValue());
-    }
-
-    return ret;
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return account ? account->applications : std::set<std::string>();
 }
 
 bool Manager_DB::applicationAccountAdd(const std::string &appName, const std::string &sAccountName)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("INSERT INTO vauth_v3_applicationusers (`f_userName`,`f_appName`) VALUES(:userName,:appName);",
-                               {
-                                   {":appName",new Abstract::STRING(appName)},
-                                   {":userName",new Abstract::STRING(sAccountName)}
-                               });
+    if (!sqlConnector->query("INSERT INTO vauth_v3_applicationusers (`f_userName`,`f_appName`) VALUES(:userName,:appName);",
+                             {
+                                 {":appName",new Abstract::STRING(appName)},
+                                 {":userName",new Abstract::STRING(sAccountName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.applications.insert(appName); });
+    });
+    return true;
 }
 
 bool Manager_DB::applicationAccountRemove(const std::string &appName, const std::string &sAccountName)
@@ -195,6 +186,12 @@ bool Manager_DB::applicationAccountRemove(const std::string &appName, const std:
                                   {":appName",new Abstract::STRING(appName)},
                                   {":userName",new Abstract::STRING(sAccountName)}
                               });
+    if (ret)
+    {
+        snapshotUpdate([&](sSnapshot & s) {
+            snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.applications.erase(appName); });
+        });
+    }
     return ret;
 }
 
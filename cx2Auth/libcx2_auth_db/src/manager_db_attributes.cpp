@@ -21,11 +21,27 @@ bool Manager_DB::attribAdd(const sApplicationAttrib & applicationAttrib, const s
 bool Manager_DB::attribRemove(const sApplicationAttrib & applicationAttrib)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("DELETE FROM vauth_v3_attribs WHERE `attribName`=:attribName and `f_appName`=:appName;",
-                               {
-                                   {":appName",new Abstract::STRING(applicationAttrib.appName)},
-                                   {":attribName",new Abstract::STRING(applicationAttrib.attribName)}
-                               });
+    if (!sqlConnector->query("DELETE FROM vauth_v3_attribs WHERE `attribName`=:attribName and `f_appName`=:appName;",
+                             {
+                                 {":appName",new Abstract::STRING(applicationAttrib.appName)},
+                                 {":attribName",new Abstract::STRING(applicationAttrib.attribName)}
+                             }))
+        return false;
+
+    // Removed in cascade from groups and accounts:
+    snapshotUpdate([&](sSnapshot & s) {
+        for (auto & group : s.groups)
+        {
+            if (group.second->attribs.find(applicationAttrib) != group.second->attribs.end())
+                snapshotUpdateGroup(s, group.first, [&](sSnapshotGroup & g) { g.attribs.erase(applicationAttrib); });
+        }
+        for (auto & account : s.accounts)
+        {
+            if (account.second->attribs.find(applicationAttrib) != account.second->attribs.end())
+                snapshotUpdateAccount(s, account.first, [&](sSnapshotAccount & a) { a.attribs.erase(applicationAttrib); });
+        }
+    });
+    return true;
 }
 
 bool Manager_DB::attribExist(const sApplicationAttrib & applicationAttrib)
@@ -50,12 +66,18 @@ bool Manager_DB::attribGroupAdd(const sApplicationAttrib & applicationAttrib, co
 {
     Threads::Sync::Lock_RW lock(mutex);
 
-    return sqlConnector->query("INSERT INTO vauth_v3_attribsgroups (`f_appName`,`f_attribName`,`f_groupName`) VALUES(:appName,:attribName,:groupName);",
-                               {
-                                   {":appName",new Abstract::STRING(applicationAttrib.appName)},
-                                   {":attribName",new Abstract::STRING(applicationAttrib.attribName)},
-                                   {":groupName",new Abstract::STRING(sGroupName)}
-                               });
+    if (!sqlConnector->query("INSERT INTO vauth_v3_attribsgroups (`f_appName`,`f_attribName`,`f_groupName`) VALUES(:appName,:attribName,:groupName);",
+                             {
+                                 {":appName",new Abstract::STRING(applicationAttrib.appName)},
+                                 {":attribName",new Abstract::STRING(applicationAttrib.attribName)},
+                                 {":groupName",new Abstract::STRING(sGroupName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        snapshotUpdateGroup(s, sGroupName, [&](sSnapshotGroup & group) { group.attribs.insert(applicationAttrib); });
+    });
+    return true;
 }
 
 bool Manager_DB::attribGroupRemove(const sApplicationAttrib & applicationAttrib, const std::string &sGroupName, bool lock)
@@ -68,6 +90,12 @@ bool Manager_DB::attribGroupRemove(const sApplicationAttrib & applicationAttrib,
                                   {":attribName",new Abstract::STRING(applicationAttrib.attribName)},
                                   {":groupName",new Abstract::STRING(sGroupName)}
                               });
+    if (ret)
+    {
+        snapshotUpdate([&](sSnapshot & s) {
+            snapshotUpdateGroup(s, sGroupName, [&](sSnapshotGroup & group) { group.attribs.erase(applicationAttrib); });
+        });
+    }
     if (lock) mutex.unlock();
     return ret;
 }
@@ -75,12 +103,18 @@ bool Manager_DB::attribGroupRemove(const sApplicationAttrib & applicationAttrib,
 bool Manager_DB::attribAccountAdd(const sApplicationAttrib & applicationAttrib, const std::string &sAccountName)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("INSERT INTO vauth_v3_attribsaccounts (`f_appName`,`f_attribName`,`f_userName`) VALUES(:appName,:attribName,:userName);",
-                               {
-                                   {":appName",new Abstract::STRING(applicationAttrib.appName)},
-                                   {":attribName",new Abstract::STRING(applicationAttrib.attribName)},
-                                   {":userName",new Abstract::STRING(sAccountName)}
-                               });
+    if (!sqlConnector->query("INSERT INTO vauth_v3_attribsaccounts (`f_appName`,`f_attribName`,`f_userName`) VALUES(:appName,:attribName,:userName);",
+                             {
+                                 {":appName",new Abstract::STRING(applicationAttrib.appName)},
+                                 {":attribName",new Abstract::STRING(applicationAttrib.attribName)},
+                                 {":userName",new Abstract::STRING(sAccountName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.attribs.insert(applicationAttrib); });
+    });
+    return true;
 }
 
 bool Manager_DB::attribAccountRemove(const sApplicationAttrib & applicationAttrib, const std::string &sAccountName, bool lock)
@@ -93,6 +127,12 @@ bool Manager_DB::attribAccountRemove(const sApplicationAttrib & applicationAttri
                                   {":attribName",new Abstract::STRING(applicationAttrib.attribName)},
                                   {":userName",new Abstract::STRING(sAccountName)}
                               });
+    if (ret)
+    {
+        snapshotUpdate([&](sSnapshot & s) {
+            snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.attribs.erase(applicationAttrib); });
+        });
+    }
     if (lock) mutex.unlock();
     return ret;
 }
@@ -188,13 +228,6 @@ std::set<std::string> Manager_DB::attribAccounts(const sApplicationAttrib & appl
 
 bool Manager_DB::accountValidateDirectAttribute(const std::string &sAccountName, const sApplicationAttrib & applicationAttrib)
 {
-    Threads::Sync::Lock_RD lock(mutex);
-
-    QueryInstance i = sqlConnector->query("SELECT `f_userName` FROM vauth_v3_attribsaccounts WHERE `f_attribName`=:attribName AND `f_userName`=:userName AND `f_appName`=:appName;",
-                                          { {":attribName",new Memory::Abstract::STRING(applicationAttrib.attribName)},
-                                            {":appName",new Abstract::STRING(applicationAttrib.appName)},
-                                            {":userName",new Memory::Abstract::STRING(sAccountName)}
-                                          },
-                                          { });
-    return (i.ok && i.query->step());
+    std::shared_ptr<const sSnapshotAccount> account = snapshotAccount(sAccountName);
+    return account && account->attribs.find(applicationAttrib) != account->attribs.end();
 }
@@ -9,39 +9,59 @@ using namespace CX2::Database;
 bool Manager_DB::groupAdd(const std::string &groupName, const std::string &groupDescription)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("INSERT INTO vauth_v3_groups (`groupName`,`groupDescription`) VALUES(:groupName,:groupDescription);",
-                               {
-                                   {":groupName",new Abstract::STRING(groupName)},
-                                   {":groupDescription",new Abstract::STRING(groupDescription)}
-                               });
+    if (!sqlConnector->query("INSERT INTO vauth_v3_groups (`groupName`,`groupDescription`) VALUES(:groupName,:groupDescription);",
+                             {
+                                 {":groupName",new Abstract::STRING(groupName)},
+                                 {":groupDescription",new Abstract::STRING(groupDescription)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        s.groups[groupName] = std::make_shared<const sSnapshotGroup>();
+    });
+    return true;
 }
 
 bool Manager_DB::groupRemove(const std::string &groupName)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("DELETE FROM vauth_v3_groups WHERE `groupName`=:groupName;",
-                               {
-                                   {":groupName",new Abstract::STRING(groupName)}
-                               });
+    if (!sqlConnector->query("DELETE FROM vauth_v3_groups WHERE `groupName`=:groupName;",
+                             {
+                                 {":groupName",new Abstract::STRING(groupName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        auto group = s.groups.find(groupName);
+        if (group == s.groups.end())
+            return;
+        for (const std::string & sAccountName : group->second->accounts)
+            snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.groups.erase(groupName); });
+        s.groups.erase(group);
+    });
+    return true;
 }
 
 bool Manager_DB::groupExist(const std::string &groupName)
 {
-    Threads::Sync::Lock_RD lock(mutex);
-    QueryInstance i = sqlConnector->query("SELECT `groupName` FROM vauth_v3_groups WHERE `groupName`=:groupName;",
-                                          {{":groupName",new Memory::Abstract::STRING(groupName)}},
-                                          {});
-    return i.ok && i.query->step();
+    return snapshotGroup(groupName) != nullptr;
 }
 
 bool Manager_DB::groupAccountAdd(const std::string &sGroupName, const std::string &sAccountName)
 {
     Threads::Sync::Lock_RW lock(mutex);
-    return sqlConnector->query("INSERT INTO vauth_v3_groupsaccounts (`f_groupName`,`f_userName`) VALUES(:groupName,:userName);",
-                               {
-                                   {":groupName",new Abstract::STRING(sGroupName)},
-                                   {":userName",new Abstract::STRING(sAccountName)}
-                               });
+    if (!sqlConnector->query("INSERT INTO vauth_v3_groupsaccounts (`f_groupName`,`f_userName`) VALUES(:groupName,:userName);",
+                             {
+                                 {":groupName",new Abstract::STRING(sGroupName)},
+                                 {":userName",new Abstract::STRING(sAccountName)}
+                             }))
+        return false;
+
+    snapshotUpdate([&](sSnapshot & s) {
+        snapshotUpdateGroup(s, sGroupName, [&](sSnapshotGroup & group) { group.accounts.insert(sAccountName); });
+        snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.groups.insert(sGroupName); });
+    });
+    return true;
 }
 
 bool Manager_DB::groupAccountRemove(const std::string &sGroupName, const std::string &sAccountName, bool lock)
@@ -53,6 +73,13 @@ bool Manager_DB::groupAccountRemove(const std::string &sGroupName, const std::st
                                   {":groupName",new Abstract::STRING(sGroupName)},
                                   {":userName",new Abstract::STRING(sAccountName)}
                               });
+    if (ret)
+    {
+        snapshotUpdate([&](sSnapshot & s) {
+            snapshotUpdateGroup(s, sGroupName, [&](sSnapshotGroup & group) { group.accounts.erase(sAccountName); });
+            snapshotUpdateAccount(s, sAccountName, [&](sSnapshotAccount & account) { account.groups.erase(sGroupName); });
+        });
+    }
 
     if (lock) mutex.unlock();
     return ret;
@@ -68,22 +95,10 @@ bool Manager_DB::groupChangeDescription(const std::string &groupName, const std:
                                });
 }
 
-bool Manager_DB::groupValidateAttribute(const std::string &sGroupName, const sApplicationAttrib &attrib, bool lock)
+bool Manager_DB::groupValidateAttribute(const std::string &sGroupName, const sApplicationAttrib &attrib, bool)
 {
-    bool ret = false;
-    if (lock) mutex.lock_shared();
-
-    QueryInstance i = sqlConnector->query("SELECT `f_groupName` FROM vauth_v3_attribsgroups WHERE `f_attribName`=:attribName AND `f_appName`=:appName AND `f_groupName`=:groupName;",
-                                          {
-                                              {":attribName",new Memory::Abstract::STRING(attrib.attribName)},
-                                              {":appName",new Memory::Abstract::STRING(attrib.appName)},
-                                              {":groupName",new Memory::Abstract::STRING(sGroupName)}
-                                          },
-                                          {});
-    ret = i.ok && i.query->step();
-
-    if (lock) mutex.unlock_shared();
-    return ret;
+    std::shared_ptr<const sSnapshotGroup> group = snapshotGroup(sGroupName);
+    return group && group->attribs.find(attrib) != group->attribs.end();
 }
 
 std::string Manager_DB::groupDescription(const std::string &sGroupName)
@@ -103,52 +118,20 @@ std::string Manager_DB::groupDescription(const std::string &sGroupName)
 std::set<std::string> Manager_DB::groupsList()
 {
     std::set<std::string> ret;
-    Threads::Sync::Lock_RD lock(mutex);
-
-    Abstract::STRING sGroupName;
-    QueryInstance i = sqlConnector->query("SELECT `groupName` FROM vauth_v3_groups;",
-                                          {},
-                                          { &sGroupName });
-    while (i.ok && i.query->step())
-    {
-        ret.insert(sGroupName.getValue());
-    }
+    for (const auto & group : snapshot()->groups)
+        ret.insert(ret.end(), group.first);
     return ret;
 }
 
-std::set<sApplicationAttrib> Manager_DB::groupAttribs(const std::string &sGroupName, bool lock)
+std::set<sApplicationAttrib> Manager_DB::groupAttribs(const std::string &sGroupName, bool)
 {
-    std::set<sApplicationAttrib> ret;
-    if (lock) mutex.lock_shared();
-
-    Abstract::STRING sAppName,sAttribName;
-    QueryInstance i = sqlConnector->query("SELECT `f_appName`,`f_attribName` FROM vauth_v3_attribsgroups WHERE `f_groupName`=:groupName;",
-                                          { {":groupName",new Memory::Abstract::STRING(sGroupName)} },
-                                          { &sAppName,&sAttribName });
-    while (i.ok && i.query->step())
-    {
-        ret.insert({sAppName.getValue(),sAttribName.getValue()});
-    }
-
-    if (lock) mutex.unlock_shared();
-    return ret;
+    std::shared_ptr<const sSnapshotGroup> group = snapshotGroup(sGroupName);
+    return group ? group->attribs : std::set<sApplicationAttrib>();
 }
 
-std::set<std::string> Manager_DB::groupAccounts(const std::string &sGroupName, bool lock)
+std::set<std::string> Manager_DB::groupAccounts(const std::string &sGroupName, bool)
 {
-    std::set<std::string> ret;
-    if (lock) mutex.lock_shared();
-
-    Abstract::STRING sAccountName;
-    QueryInstance i = sqlConnector->query("SELECT `f_userName` FROM vauth_v3_groupsaccounts WHERE `f_groupName`=:groupName;",
-                                          { {":groupName",new Memory::Abstract::STRING(sGroupName)} },
-                                          { &sAccountName });
-    while (i.ok && i.query->step())
-    {
-        ret.insert(sAccountName.getValue());
-    }
-
-    if (lock) mutex.unlock_shared();
-    return ret;
+    std::shared_ptr<const sSnapshotGroup> group = snapshotGroup(sGroupName);
+    return group ? group->accounts : std::set<std::string>();
 }
 
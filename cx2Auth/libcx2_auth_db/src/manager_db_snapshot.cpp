@@ -0,0 +1,234 @@
+#include "manager_db.h"
+
+#include <cx2_thr_mutex/lock_shared.h>
+
+#include <cx2_mem_vars/a_string.h>
+#include <cx2_mem_vars/a_datetime.h>
+#include <cx2_mem_vars/a_bool.h>
+
+using namespace CX2::Authentication;
+using namespace CX2::Memory;
+using namespace CX2::Database;
+
+bool Manager_DB::accountValidateAttribute(const std::string &sAccountName, const sApplicationAttrib &applicationAttrib)
+{
+    // Everything from the same snapshot:
+    std::shared_ptr<const sSnapshot> s = snapshot();
+
+    auto account = s->accounts.find(sAccountName);
+    if (account == s->accounts.end())
+        return false;
+
+    if (account->second->attribs.find(applicationAttrib) != account->second->attribs.end())
+        return true;
+
+    for (const std::string & groupName : account->second->groups)
+    {
+        auto group = s->groups.find(groupName);
+        if (group != s->groups.end() && group->second->attribs.find(applicationAttrib) != group->second->attribs.end())
+            return true;
+    }
+    return false;
+}
+
+uint64_t Manager_DB::snapshotVersion()
+{
+    return snapshot()->version;
+}
+
+uint64_t Manager_DB::authorizationVersion()
+{
+    return snapshotVersion();
+}
+
+std::shared_ptr<const Manager_DB::sSnapshot> Manager_DB::snapshot()
+{
+    return std::atomic_load(&currentSnapshot);
+}
+
+std::shared_ptr<const Manager_DB::sSnapshotAccount> Manager_DB::snapshotAccount(const std::string &sAccountName)
+{
+    std::shared_ptr<const sSnapshot> s = snapshot();
+    auto i = s->accounts.find(sAccountName);
+    return i == s->accounts.end() ? nullptr : i->second;
+}
+
+std::shared_ptr<const Manager_DB::sSnapshotGroup> Manager_DB::snapshotGroup(const std::string &groupName)
+{
+    std::shared_ptr<const sSnapshot> s = snapshot();
+    auto i = s->groups.find(groupName);
+    return i == s->groups.end() ? nullptr : i->second;
+}
+
+bool Manager_DB::snapshotReload()
+{
+    std::map<std::string,std::shared_ptr<sSnapshotAccount>> accounts;
+    std::map<std::string,std::shared_ptr<sSnapshotGroup>> groups;
+
+    Abstract::STRING sAccountName, groupName, appName, attribName;
+    Abstract::BOOL enabled, confirmed, superuser;
+    Abstract::DATETIME expiration;
+
+    QueryInstance i1 = sqlConnector->query("SELECT `userName`,`enabled`,`confirmed`,`superuser`,`expiration` FROM vauth_v3_accounts;",
+                                           {},
+                                           { &sAccountName, &enabled, &confirmed, &superuser, &expiration });
+    if (!i1.ok)
+        return false;
+    while (i1.query->step())
+    {
+        std::shared_ptr<sSnapshotAccount> account = std::make_shared<sSnapshotAccount>();
+        account->enabled = enabled.getValue();
+        account->confirmed = confirmed.getValue();
+        account->superuser = superuser.getValue();
+        account->expiration = expiration.getValue();
+        accounts[sAccountName.getValue()] = account;
+    }
+
+    QueryInstance i2 = sqlConnector->query("SELECT `groupName` FROM vauth_v3_groups;",
+                                           {},
+                                           { &groupName });
+    if (!i2.ok)
+        return false;
+    while (i2.query->step())
+        groups[groupName.getValue()] = std::make_shared<sSnapshotGroup>();
+
+    QueryInstance i3 = sqlConnector->query("SELECT `f_groupName`,`f_userName` FROM vauth_v3_groupsaccounts;",
+                                           {},
+                                           { &groupName, &sAccountName });
+    if (!i3.ok)
+        return false;
+    while (i3.query->step())
+    {
+        auto group = groups.find(groupName.getValue());
+        auto account = accounts.find(sAccountName.getValue());
+        if (group == groups.end() || account == accounts.end())
+            continue;
+        group->second->accounts.insert(sAccountName.getValue());
+        account->second->groups.insert(groupName.getValue());
+    }
+
+    QueryInstance i4 = sqlConnector->query("SELECT `f_appName`,`f_attribName`,`f_groupName` FROM vauth_v3_attribsgroups;",
+                                           {},
+                                           { &appName, &attribName, &groupName });
+    if (!i4.ok)
+        return false;
+    while (i4.query->step())
+    {
+        auto group = groups.find(groupName.getValue());
+        if (group != groups.end())
+            group->second->attribs.insert({appName.getValue(),attribName.getValue()});
+    }
+
+    QueryInstance i5 = sqlConnector->query("SELECT `f_appName`,`f_attribName`,`f_userName` FROM vauth_v3_attribsaccounts;",
+                                           {},
+                                           { &appName, &attribName, &sAccountName });
+    if (!i5.ok)
+        return false;
+    while (i5.query->step())
+    {
+        auto account = accounts.find(sAccountName.getValue());
+        if (account != accounts.end())
+            account->second->attribs.insert({appName.getValue(),attribName.getValue()});
+    }
+
+    QueryInstance i6 = sqlConnector->query("SELECT `f_appName`,`f_userName` FROM vauth_v3_applicationusers;",
+                                           {},
+                                           { &appName, &sAccountName });
+    if (!i6.ok)
+        return false;
+    while (i6.query->step())
+    {
+        auto account = accounts.find(sAccountName.getValue());
+        if (account != accounts.end())
+            account->second->applications.insert(appName.getValue());
+    }
+
+    // Publish:
+    snapshotUpdate([&](sSnapshot & s) {
+        s.accounts.clear();
+        s.groups.clear();
+        for (const auto & account : accounts)
+            s.accounts[account.first] = account.second;
+        for (const auto & group : groups)
+            s.groups[group.first] = group.second;
+    });
+
+    return true;
+}
+
+void Manager_DB::setSnapshotReload(bool enabled, const uint32_t &periodMS)
+{
+    std::unique_lock<std::mutex> lock(mtSnapshotReload);
+
+    snapshotReloadPeriodMS = periodMS;
+
+    if (enabled == bSnapshotReload)
+        return;
+
+    bSnapshotReload = enabled;
+
+    if (enabled)
+    {
+        snapshotReloader = std::thread(snapshotReloadThread,this);
+    }
+    else
+    {
+        cvSnapshotReload.notify_one();
+        lock.unlock();
+        snapshotReloader.join();
+    }
+}
+
+void Manager_DB::snapshotReloadThread(Manager_DB *manager)
+{
+    manager->snapshotReloadLoop();
+}
+
+void Manager_DB::snapshotReloadLoop()
+{
+    std::unique_lock<std::mutex> lock(mtSnapshotReload);
+    while (bSnapshotReload)
+    {
+        cvSnapshotReload.wait_for(lock, std::chrono::milliseconds(snapshotReloadPeriodMS));
+        if (!bSnapshotReload)
+            break;
+        lock.unlock();
+        {
+            // The writers update the database and the snapshot under the write lock, don't publish in the middle:
+            Threads::Sync::Lock_RD lockManager(mutex);
+            snapshotReload();
+        }
+        lock.lock();
+    }
+}
+
+void Manager_DB::snapshotUpdate(const std::function<void (sSnapshot &)> &update)
+{
+    std::unique_lock<std::mutex> lock(mtSnapshotUpdate);
+
+    // Copy (only the node pointers), update and publish, the readers keep their previous version until they release it.
+    std::shared_ptr<sSnapshot> s = std::make_shared<sSnapshot>(*snapshot());
+    update(*s);
+    s->version++;
+    std::atomic_store(&currentSnapshot, std::shared_ptr<const sSnapshot>(s));
+}
+
+void Manager_DB::snapshotUpdateAccount(sSnapshot &s, const std::string &sAccountName, const std::function<void (sSnapshotAccount &)> &update)
+{
+    auto i = s.accounts.find(sAccountName);
+    if (i == s.accounts.end())
+        return;
+    std::shared_ptr<sSnapshotAccount> account = std::make_shared<sSnapshotAccount>(*i->second);
+    update(*account);
+    i->second = account;
+}
+
+void Manager_DB::snapshotUpdateGroup(sSnapshot &s, const std::string &groupName, const std::function<void (sSnapshotGroup &)> &update)
+{
+    auto i = s.groups.find(groupName);
+    if (i == s.groups.end())
+        return;
+    std::shared_ptr<sSnapshotGroup> group = std::make_shared<sSnapshotGroup>(*i->second);
+    update(*group);
+    i->second = group;
+}
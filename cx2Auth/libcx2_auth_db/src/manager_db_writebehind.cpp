@@ -0,0 +1,228 @@
+#include "manager_db.h"
+
+#include <cx2_thr_mutex/lock_shared.h>
+
+#include <cx2_mem_vars/a_string.h>
+#include <cx2_mem_vars/a_datetime.h>
+#include <cx2_mem_vars/a_uint32.h>
+
+using namespace CX2::Authentication;
+using namespace CX2::Memory;
+using namespace CX2::Database;
+
+void Manager_DB::setWriteBehind(bool enabled, const uint32_t &flushPeriodMS, const size_t &maxPendingUpdates)
+{
+    std::unique_lock<std::mutex> lock(mtWriteBehind);
+
+    writeBehindPeriodMS = flushPeriodMS;
+    writeBehindMaxPending = maxPendingUpdates;
+
+    if (enabled == bWriteBehind)
+        return;
+
+    bWriteBehind = enabled;
+
+    if (enabled)
+    {
+        writeBehindFlusher = std::thread(writeBehindThread,this);
+    }
+    else
+    {
+        cvWriteBehind.notify_one();
+        lock.unlock();
+        writeBehindFlusher.join();
+        flushWriteBehind();
+    }
+}
+
+bool Manager_DB::flushWriteBehind()
+{
+    // One flush at time:
+    std::unique_lock<std::mutex> lockFlush(mtWriteBehindFlush);
+
+    std::unique_lock<std::mutex> lock(mtWriteBehind);
+    if (pendingJournal.size() == 0)
+        return true;
+    // The flushing journal remains visible for the readers until it's written.
+    std::swap(flushingJournal,pendingJournal);
+    lock.unlock();
+
+    // Changes to the database and to the flushing journal are done under the secrets lock, so the readers
+    // get the stored values + the pending ones without counting twice (and the accounts can't be removed meanwhile).
+    Threads::Sync::Lock_RW lockManager(mutex);
+    Threads::Sync::Lock_RW lockSecrets(mutexSecrets);
+
+    std::list<std::map<std::string,Abstract::Var *>> resetRows, incrementRows, lastLoginRows, loginRows;
+
+    lock.lock();
+    for (const auto & i : flushingJournal.badAttempts)
+    {
+        if (i.second.reset)
+            resetRows.push_back({
+                                    {":userName",new Abstract::STRING(i.first.first)},
+                                    {":index",new Abstract::UINT32(i.first.second)},
+                                    {":badAttempts",new Abstract::UINT32(i.second.increments)}
+                                });
+        else
+            incrementRows.push_back({
+                                        {":userName",new Abstract::STRING(i.first.first)},
+                                        {":index",new Abstract::UINT32(i.first.second)},
+                                        {":increments",new Abstract::UINT32(i.second.increments)}
+                                    });
+    }
+    for (const auto & i : flushingJournal.lastLogins)
+    {
+        lastLoginRows.push_back({
+                                    {":userName",new Abstract::STRING(i.first)},
+                                    {":date",new Abstract::DATETIME(i.second)}
+                                });
+    }
+    for (const auto & i : flushingJournal.logins)
+    {
+        loginRows.push_back({
+                                {":userName",new Abstract::STRING(i.sAccountName)},
+                                {":index",new Abstract::UINT32(i.passIndex)},
+                                {":date",new Abstract::DATETIME(i.loginDateTime)},
+                                {":loginIP",new Abstract::STRING(i.clientDetails.sIPAddr)},
+                                {":loginTLSCN",new Abstract::STRING(i.clientDetails.sTLSCommonName)},
+                                {":loginUserAgent",new Abstract::STRING(i.clientDetails.sUserAgent)},
+                                {":loginExtraData",new Abstract::STRING(i.clientDetails.sExtraData)}
+                            });
+    }
+    lock.unlock();
+
+    bool r = true;
+
+    if (!resetRows.empty() && !sqlConnector->batchQuery("UPDATE vauth_v3_accountsecrets SET `badAttempts`=:badAttempts WHERE `f_userName`=:userName and `f_secretIndex`=:index;",
+                                                        resetRows))
+    {
+        sqlErrorList.push_back(sqlConnector->getLastSQLError());
+        r = false;
+    }
+
+    if (!incrementRows.empty() && !sqlConnector->batchQuery("UPDATE vauth_v3_accountsecrets SET `badAttempts`=`badAttempts`+:increments WHERE `f_userName`=:userName and `f_secretIndex`=:index;",
+                                                            incrementRows))
+    {
+        sqlErrorList.push_back(sqlConnector->getLastSQLError());
+        r = false;
+    }
+
+    if (!lastLoginRows.empty() && !sqlConnector->batchQuery("UPDATE vauth_v3_accounts SET `lastLogin`=:date WHERE `userName`=:userName;",
+                                                            lastLoginRows))
+    {
+        sqlErrorList.push_back(sqlConnector->getLastSQLError());
+        r = false;
+    }
+
+    if (!loginRows.empty() && !sqlConnector->batchQuery("INSERT INTO vauth_v3_accountlogins(`f_userName`,`f_secretIndex`,`loginDateTime`,`loginIP`,`loginTLSCN`,`loginUserAgent`,`loginExtraData`) "
+                                                        "VALUES "
+                                                        "(:userName,:index,:date,:loginIP,:loginTLSCN,:loginUserAgent,:loginExtraData);",
+                                                        loginRows))
+    {
+        sqlErrorList.push_back(sqlConnector->getLastSQLError());
+        r = false;
+    }
+
+    lock.lock();
+    flushingJournal.clear();
+
+    return r;
+}
+
+void Manager_DB::writeBehindThread(Manager_DB *manager)
+{
+    manager->writeBehindLoop();
+}
+
+void Manager_DB::writeBehindLoop()
+{
+    std::unique_lock<std::mutex> lock(mtWriteBehind);
+    while (bWriteBehind)
+    {
+        // Wake up on the period, or before when there are too many pending updates.
+        cvWriteBehind.wait_for(lock, std::chrono::milliseconds(writeBehindPeriodMS));
+        lock.unlock();
+        flushWriteBehind();
+        lock.lock();
+    }
+}
+
+void Manager_DB::writeBehindBadAttempts(const std::string &sAccountName, const uint32_t &passIndex, bool reset)
+{
+    std::unique_lock<std::mutex> lock(mtWriteBehind);
+
+    sPendingBadAttempts & pending = pendingJournal.badAttempts[std::make_pair(sAccountName,passIndex)];
+    if (reset)
+    {
+        pending.reset = true;
+        pending.increments = 0;
+    }
+    else
+        pending.increments++;
+
+    if (pendingJournal.size() >= writeBehindMaxPending)
+        cvWriteBehind.notify_one();
+}
+
+uint32_t Manager_DB::writeBehindCurrentBadAttempts(const std::string &sAccountName, const uint32_t &passIndex, const uint32_t &storedBadAttempts)
+{
+    std::unique_lock<std::mutex> lock(mtWriteBehind);
+
+    uint32_t r = storedBadAttempts;
+    auto key = std::make_pair(sAccountName,passIndex);
+
+    // Apply the flushing journal first, then the pending one:
+    for (const sWriteBehindJournal * journal : { &flushingJournal, &pendingJournal })
+    {
+        auto i = journal->badAttempts.find(key);
+        if (i != journal->badAttempts.end())
+            r = (i->second.reset ? 0 : r) + i->second.increments;
+    }
+
+    return r;
+}
+
+bool Manager_DB::writeBehindCurrentLastLogin(const std::string &sAccountName, time_t *lastLogin)
+{
+    std::unique_lock<std::mutex> lock(mtWriteBehind);
+
+    for (const sWriteBehindJournal * journal : { &pendingJournal, &flushingJournal })
+    {
+        auto i = journal->lastLogins.find(sAccountName);
+        if (i != journal->lastLogins.end())
+        {
+            *lastLogin = i->second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Manager_DB::writeBehindRemove(const std::string &sAccountName, const uint32_t &passIndex)
+{
+    std::unique_lock<std::mutex> lock(mtWriteBehind);
+
+    if (passIndex == 0xFFFFFFFF)
+    {
+        pendingJournal.removeAccount(sAccountName);
+        flushingJournal.removeAccount(sAccountName);
+    }
+    else
+    {
+        pendingJournal.badAttempts.erase(std::make_pair(sAccountName,passIndex));
+        flushingJournal.badAttempts.erase(std::make_pair(sAccountName,passIndex));
+    }
+}
+
+void Manager_DB::sWriteBehindJournal::removeAccount(const std::string &sAccountName)
+{
+    for (auto i = badAttempts.begin(); i != badAttempts.end();)
+    {
+        if (i->first.first == sAccountName)
+            i = badAttempts.erase(i);
+        else
+            i++;
+    }
+    lastLogins.erase(sAccountName);
+    logins.remove_if([&sAccountName](const sPendingLogin & login) { return login.sAccountName == sAccountName; });
+}
@@ -88,6 +88,12 @@ void Query::setFetchLastInsertRowID(bool value)
     bFetchLastInsertRowID = value;
 }
 
+bool Query::execBatch(const std::list<std::map<std::string, CX2::Memory::Abstract::Var *> > &)
+{
+    lastSQLError = "Batch execution is not supported by this driver";
+    return false;
+}
+
 bool Query::step()
 {
     clearDestroyableStringsForInput();
@@ -153,6 +159,7 @@ void Query::clearDestroyableStringsForInput()
 {
     // Destroy strings.
     for (auto * i : destroyableStringsForInput) delete i;
+    destroyableStringsForInput.clear();
 }
 
 std::string *Query::createDestroyableStringForResults(const std::string &str)
@@ -167,6 +174,7 @@ void Query::clearDestroyableStringsForResults()
 {
     // Destroy strings.
     for (auto * i : destroyableStringsForResults) delete i;
+    destroyableStringsForResults.clear();
 }
 
 void Query::setSqlConnector(void *value, std::mutex *mtDatabaseLock)
@@ -37,6 +37,14 @@ public:
 
     // Query Execution:
     virtual bool exec(const ExecType & execType) = 0;
+    /**
+     * @brief execBatch Execute the prepared (non-select) statement once for each input row inside one transaction
+     *                  (committed if every row succeed, otherwise rolled back).
+     *                  The input keys are taken from the first row, and every row should contain the same keys.
+     * @param inputRows Input Vars for each execution (not destroyed by the query)
+     * @return true if all the rows were executed and committed.
+     */
+    virtual bool execBatch(const std::list<std::map<std::string,Memory::Abstract::Var *>> & inputRows);
 
     // GET ROW FROM SELECT Results:
     bool step();
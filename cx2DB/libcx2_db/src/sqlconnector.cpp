@@ -144,6 +144,30 @@ QueryInstance SQLConnector::query(const std::string &preparedQuery, const std::m
     return q;
 }
 
+bool SQLConnector::batchQuery(const std::string &preparedQuery, const std::list<std::map<std::string, CX2::Memory::Abstract::Var *> > &inputRows)
+{
+    bool r = true;
+
+    if (!inputRows.empty())
+    {
+        QueryInstance q = prepareNewQueryInstance();
+
+        r = q.query!=nullptr && q.query->setPreparedSQLQuery(preparedQuery) && q.query->execBatch(inputRows);
+
+        if (!r && q.query)
+            lastSQLError = q.query->getLastSQLError();
+    }
+
+    // Destroy the input vars:
+    for (const auto & row : inputRows)
+    {
+        for (const auto & i : row)
+            delete i.second;
+    }
+
+    return r;
+}
+
 std::string SQLConnector::getDBName() const
 {
     return dbName;
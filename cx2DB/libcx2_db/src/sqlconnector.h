@@ -101,6 +101,16 @@ public:
                 const std::map<std::string,Memory::Abstract::Var *> & inputVars,
                 const std::vector<Memory::Abstract::Var *> & resultVars
                 );
+    /**
+     * @brief batchQuery Execute the same prepared statement (non-select) for many input rows in one transaction,
+     *                   using the native driver batching (MariaDB array binding, PostgreSQL pipeline, SQLite3 statement reuse)
+     * @param preparedQuery Prepared SQL Query String.
+     * @param inputRows Input Vars for each execution (every row should contain the same keys, abstract elements will be deleted after the batch is executed)
+     * @return true if every row was executed and the transaction was committed (otherwise the transaction is rolled back).
+     */
+    bool batchQuery( const std::string & preparedQuery,
+                     const std::list<std::map<std::string,Memory::Abstract::Var *>> & inputRows
+                     );
 
 protected:
     virtual Query * createQuery0() { return nullptr; };
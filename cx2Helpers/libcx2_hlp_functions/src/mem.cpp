@@ -74,22 +74,26 @@ void *Mem::memmove64(void *dest, const void *src, uint64_t n)
     size_t blockSize = 64*KB_MULT;
     if (dest>src)
     {
-        for (size_t curBlock = (n>blockSize?blockSize:n); n ;n-=curBlock)
+        while (n)
         {
+            size_t curBlock = n>blockSize?blockSize:n;
             memmove(((char *)dest)+n-curBlock,
                     ((const char *)src)+n-curBlock,
                     curBlock);
+            n-=curBlock;
         }
     }
     else if (dest<src)
     {
         uint64_t curOffset = 0;
-        for (size_t curBlock = (n>blockSize?blockSize:n);n;n-=curBlock)
+        while (n)
         {
+            size_t curBlock = n>blockSize?blockSize:n;
             memmove(((char *)dest)+curOffset,
                     ((const char *)src)+curOffset,
                     curBlock);
             curOffset+=curBlock;
+            n-=curBlock;
         }
     }
     return dest;
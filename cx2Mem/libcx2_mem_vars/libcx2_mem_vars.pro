@@ -26,6 +26,8 @@ SOURCES += \
     src/b_mem.cpp \
     src/b_mmap.cpp \
     src/b_ref.cpp \
+    src/b_ring.cpp \
+    src/delimitermatcher.cpp \
     src/filemap.cpp \
     src/nullcontainer.cpp \
     src/streamable.cpp \
@@ -61,6 +63,8 @@ HEADERS += \
     src/b_mem.h \
     src/b_mmap.h \
     src/b_ref.h \
+    src/b_ring.h \
+    src/delimitermatcher.h \
     src/filemap.h \
     src/nullcontainer.h \
     src/streamable.h \
@@ -616,6 +616,22 @@ bool B_Base::streamTo(Memory::Streams::Streamable *out, Streams::Status &wrStatU
     }
 }
 
+bool B_Base::streamRangeTo(Memory::Streams::Streamable *out, Streams::Status &wrStatUpd, const uint64_t &offset, const uint64_t &count)
+{
+    std::pair<bool,uint64_t> bytesAppended = appendTo(*out,wrStatUpd,count,offset);
+    if (bytesAppended.first==false || bytesAppended.second!=count)
+    {
+        wrStatUpd.succeed=false;
+        out->writeEOF(false);
+        return false;
+    }
+    else
+    {
+        out->writeEOF(true);
+        return true;
+    }
+}
+
 CX2::Memory::Streams::Status B_Base::write(const void * buf, const size_t &count, CX2::Memory::Streams::Status & wrStatUpd)
 {
     Memory::Streams::Status ret;
@@ -20,6 +20,7 @@ enum BinaryContainerMethod {
     BC_METHOD_MEM,
     BC_METHOD_BCREF,
     BC_METHOD_FILEMMAP,
+    BC_METHOD_RING,
     BC_METHOD_NULL
 };
 
@@ -261,6 +262,7 @@ public:
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Streamable
     bool streamTo(Memory::Streams::Streamable * out, Streams::Status & wrStatUpd) override;
+    bool streamRangeTo(Memory::Streams::Streamable * out, Streams::Status & wrStatUpd, const uint64_t & offset, const uint64_t & count) override;
     Memory::Streams::Status write(const void * buf, const size_t &count, Streams::Status & wrStatUpd) override;
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // FS options:
@@ -87,6 +87,17 @@ struct BinaryContainerChunk {
         memcpy(data,buf,count);
         return true;
     }
+    /**
+     * @brief Take the ownership of a memory space (allocated with new char[]) without copying it.
+     * @param buf data to be referenced (will be released by destroy)
+     * @param count size of data.
+     */
+    void take(char * buf, size_t count)
+    {
+        destroy();
+        data = buf;
+        size = count;
+    }
 
     /**
      * @brief Offset of the next/following chunk.
@@ -61,6 +61,11 @@ void B_Chunks::setMaxChunkSize(const uint32_t &value)
     maxChunkSize = value;
 }
 
+uint32_t B_Chunks::getMaxChunkSize() const
+{
+    return maxChunkSize;
+}
+
 uint64_t B_Chunks::size() const
 {
     if (mmapContainer) return mmapContainer->size();
@@ -163,6 +168,29 @@ std::pair<bool, uint64_t> B_Chunks::append2(const void *buf, const uint64_t &roL
     return appendedBytes;
 }
 
+std::pair<bool, uint64_t> B_Chunks::appendChunk(char *data, const uint32_t &len)
+{
+    uint64_t currentSize = size();
+
+    if (    readOnly || mmapContainer || !len || len>maxChunkSize || chunksVector.size()+1>maxChunks
+            || CHECK_UINT_OVERFLOW_SUM(len,currentSize) || len+currentSize>maxSize
+            || (maxContainerSizeUntilGoingToFS!=0 && len+currentSize > maxContainerSizeUntilGoingToFS) )
+    {
+        // Let the regular append handle the limits/filesystem:
+        std::pair<bool,uint64_t> r = append(data,len);
+        delete [] data;
+        return r;
+    }
+
+    BinaryContainerChunk bcc;
+    bcc.take(data,len);
+    bcc.offset = chunksVector.size()? chunksVector[chunksVector.size()-1].nextOffset() : 0;
+    chunksVector.push_back(bcc);
+
+    incContainerBytesCount(bcc.size);
+    return std::make_pair(true,bcc.size);
+}
+
 std::pair<bool,uint64_t> B_Chunks::displace2(const uint64_t &roBytesToDisplace)
 {
     uint64_t bytesToDisplace = roBytesToDisplace;
@@ -536,11 +564,10 @@ std::pair<bool, uint64_t> B_Chunks::findChar(const int &c, const uint64_t &roOff
 void B_Chunks::recalcChunkOffsets()
 {
     unsigned long long currentOffset = 0;
-    size_t vpos=0, vsize = chunksVector.size();
-    for ( BinaryContainerChunk * i = &(chunksVector[vpos]) ; vpos<vsize ; vpos++ )
+    for ( BinaryContainerChunk & i : chunksVector )
     {
-        i->offset = currentOffset;
-        currentOffset = i->nextOffset();
+        i.offset = currentOffset;
+        currentOffset = i.nextOffset();
     }
 }
 
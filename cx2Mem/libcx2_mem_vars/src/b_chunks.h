@@ -44,6 +44,11 @@ public:
      * @param value Max Chunk size in bytes.
      */
     void setMaxChunkSize(const uint32_t & value);
+    /**
+     * @brief getMaxChunkSize Get Maximum Chunk Size
+     * @return Max Chunk size in bytes.
+     */
+    uint32_t getMaxChunkSize() const;
     /**
      * @brief size Get Container Data Size in bytes
      * @return data size in bytes
@@ -56,6 +61,16 @@ public:
      * @return
      */
     std::pair<bool,uint64_t> findChar(const int &c, const uint64_t &roOffset = 0, uint64_t  searchSpace = 0, bool caseSensitive = false) override;
+    /**
+     * @brief appendChunk Append a heap buffer (allocated with new char[]) as the new tail chunk without copying it.
+     *                    Useful for receiving data directly into the container (eg. from sockets).
+     *                    If the buffer can't be used as a chunk (eg. the container is going to the filesystem or the
+     *                    buffer is bigger than the max chunk size), the data is copied as in append.
+     * @param data buffer, the container always takes the ownership (even on failure).
+     * @param len data size in bytes
+     * @return true if succeed, and the bytes appended.
+     */
+    std::pair<bool,uint64_t> appendChunk(char * data, const uint32_t & len);
 
 
 protected:
@@ -2,7 +2,7 @@
 
 using namespace CX2::Memory::Containers;
 
-B_MEM::B_MEM(const void *buf, const uint32_t & len)
+B_MEM::B_MEM(const void *buf, const uint64_t & len)
 {
     storeMethod = BC_METHOD_MEM;
     linearMem = nullptr;
@@ -17,7 +17,7 @@ B_MEM::~B_MEM()
     B_MEM::clear2();
 }
 
-void B_MEM::reference(const void *buf, const uint32_t &len)
+void B_MEM::reference(const void *buf, const uint64_t &len)
 {
     clear();
     linearMem = ((const char *)buf);
@@ -182,7 +182,7 @@ std::pair<bool,uint64_t> B_MEM::copyOut2(void *buf, const uint64_t &bytes, const
 
     memcpy(buf,linearMemOffseted,copiedBytes);
 
-    return std::make_pair(false,copiedBytes);
+    return std::make_pair(true,copiedBytes);
 }
 
 bool B_MEM::compare2(const void *buf, const uint64_t &len, bool caseSensitive, const uint64_t &offset)
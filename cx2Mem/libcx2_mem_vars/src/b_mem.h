@@ -9,9 +9,9 @@ namespace CX2 { namespace Memory { namespace Containers {
 class B_MEM : public B_Base
 {
 public:
-    B_MEM(const void * buf=nullptr, const uint32_t &len=0);
+    B_MEM(const void * buf=nullptr, const uint64_t &len=0);
     ~B_MEM() override;
-    void reference(const void * buf, const uint32_t & len);
+    void reference(const void * buf, const uint64_t & len);
     /**
      * @brief findChar
      * @param c
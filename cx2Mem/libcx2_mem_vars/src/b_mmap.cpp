@@ -80,7 +80,7 @@ std::pair<bool, uint64_t> B_MMAP::truncate2(const uint64_t &bytes)
     }
 
     reMapMemoryContainer();
-    return std::make_pair(false,size());
+    return std::make_pair(true,size());
 }
 
 std::string B_MMAP::getCurrentFileName() const
@@ -133,6 +133,13 @@ std::pair<bool, uint64_t> B_MMAP::copyToStream2(std::ostream &out, const uint64_
 
 std::pair<bool, uint64_t> B_MMAP::copyTo2(Streamable &bc, Streams::Status & wrStatUpd, const uint64_t &bytes, const uint64_t &offset)
 {
+    // The container data is in the mapped file (starting at the head offset), so
+    // streams that can read from file descriptors (eg. sockets with sendfile) don't need to copy the memory.
+    if (fileReference.getFileDescriptor()!=-1 && bc.supportsWriteFromFile())
+    {
+        Streams::Status cur = bc.writeFromFile(fileReference.getFileDescriptor(),fileReference.getHeadOffset()+offset,bytes,wrStatUpd);
+        return std::make_pair(cur.succeed,cur.bytesWritten);
+    }
     return mem.appendTo(bc,wrStatUpd,bytes,offset);
 }
 
@@ -149,7 +156,7 @@ bool B_MMAP::compare2(const void *buf, const uint64_t &count, bool caseSensitive
 void B_MMAP::reMapMemoryContainer()
 {
     setContainerBytes(fileReference.getFileOpenSize());
-    mem.reference(fileReference.getMmapAddr(),size());
+    mem.reference(fileReference.getMmapAddr(),fileReference.getFileOpenSize());
 }
 
 std::string B_MMAP::getRandomFileName()
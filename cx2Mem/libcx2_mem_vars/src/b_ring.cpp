@@ -0,0 +1,274 @@
+#include "b_ring.h"
+
+#include <algorithm>
+#include <new>
+
+using namespace CX2::Memory::Containers;
+
+B_Ring::B_Ring(const uint64_t &capacity, bool spscMode)
+{
+    storeMethod = BC_METHOD_RING;
+    readOnly = false;
+    ringMem = nullptr;
+    this->capacity = 0;
+    this->spscMode = spscMode;
+    readPos = 0;
+    writePos = 0;
+    setContainerBytes(0);
+    resize(roundCapacity(capacity));
+}
+
+B_Ring::~B_Ring()
+{
+    if (ringMem) delete [] ringMem;
+}
+
+bool B_Ring::setCapacity(const uint64_t &capacity)
+{
+    if (spscMode)
+        return false;
+    uint64_t nCapacity = roundCapacity(capacity);
+    if (nCapacity<size())
+        return false;
+    return resize(nCapacity);
+}
+
+uint64_t B_Ring::getCapacity() const
+{
+    return capacity;
+}
+
+uint64_t B_Ring::getFreeSpace() const
+{
+    return capacity-size();
+}
+
+bool B_Ring::isSPSCMode() const
+{
+    return spscMode;
+}
+
+uint64_t B_Ring::size() const
+{
+    // Read the consumer position first, so the size is never negative when called from the producer.
+    uint64_t r = readPos.load(std::memory_order_acquire);
+    return writePos.load(std::memory_order_acquire)-r;
+}
+
+std::pair<bool, uint64_t> B_Ring::findChar(const int &c, const uint64_t &offset, uint64_t searchSpace, bool caseSensitive)
+{
+    if (caseSensitive && !(c>='A' && c<='Z') && !(c>='a' && c<='z') )
+        caseSensitive = false;
+
+    uint64_t currentSize = size();
+    if (CHECK_UINT_OVERFLOW_SUM(offset,searchSpace)) return std::make_pair(false,std::numeric_limits<uint64_t>::max());
+    // out of bounds:
+    if (offset>currentSize || offset+searchSpace>currentSize) return std::make_pair(false,std::numeric_limits<uint64_t>::max());
+
+    if (searchSpace == 0) searchSpace = currentSize-offset;
+
+    uint64_t retpos = offset;
+    for (const BinaryContainerChunk & chunk : getChunks(offset,searchSpace))
+    {
+        const char * pos = nullptr;
+        if (!caseSensitive)
+            pos = (const char *)memchr(chunk.rodata, c, chunk.rosize);
+        else
+        {
+            const char *pos_upper = (const char *)memchr(chunk.rodata, std::toupper(c), chunk.rosize);
+            const char *pos_lower = (const char *)memchr(chunk.rodata, std::tolower(c), chunk.rosize);
+            pos = (pos_upper && (!pos_lower || pos_upper<pos_lower))? pos_upper : pos_lower;
+        }
+
+        if (pos)
+            return std::make_pair(true,retpos+(pos-chunk.rodata));
+        retpos+=chunk.rosize;
+    }
+
+    return std::make_pair(false,(uint64_t)0);
+}
+
+std::pair<bool, uint64_t> B_Ring::truncate2(const uint64_t &bytes)
+{
+    if (spscMode)
+        return std::make_pair(false,size());
+
+    writePos.store(readPos.load(std::memory_order_relaxed)+bytes, std::memory_order_release);
+    return std::make_pair(true,size());
+}
+
+std::pair<bool, uint64_t> B_Ring::append2(const void *buf, const uint64_t &len, bool prependMode)
+{
+    if (prependMode && spscMode)
+        return std::make_pair(false,(uint64_t)0);
+
+    uint64_t r = readPos.load(std::memory_order_acquire);
+    uint64_t w = writePos.load(std::memory_order_relaxed);
+
+    if (len > capacity-(w-r))
+    {
+        // The producer can't move the data while the consumer is reading it:
+        if (spscMode)
+            return std::make_pair(false,(uint64_t)0);
+
+        uint64_t nCapacity = capacity;
+        while (nCapacity<(w-r)+len)
+        {
+            if (CHECK_UINT_OVERFLOW_SUM(nCapacity,nCapacity))
+                return std::make_pair(false,(uint64_t)0);
+            nCapacity*=2;
+        }
+        if (!resize(nCapacity))
+            return std::make_pair(false,(uint64_t)0);
+
+        r = readPos.load(std::memory_order_relaxed);
+        w = writePos.load(std::memory_order_relaxed);
+    }
+
+    uint64_t dst = prependMode? r-len : w;
+    uint64_t pos = dst & (capacity-1);
+    uint64_t firstPiece = std::min(len, capacity-pos);
+    CX2::Helpers::Mem::memcpy64(ringMem+pos, buf, firstPiece);
+    CX2::Helpers::Mem::memcpy64(ringMem, (const char *)buf+firstPiece, len-firstPiece);
+
+    // Publish the data:
+    if (prependMode)
+        readPos.store(dst, std::memory_order_release);
+    else
+        writePos.store(w+len, std::memory_order_release);
+
+    return std::make_pair(true,len);
+}
+
+std::pair<bool, uint64_t> B_Ring::displace2(const uint64_t &bytesToDisplace)
+{
+    uint64_t w = writePos.load(std::memory_order_acquire);
+    uint64_t r = readPos.load(std::memory_order_relaxed);
+
+    if (bytesToDisplace>w-r) return std::make_pair(false,(uint64_t)0);
+
+    // Release the space to the producer:
+    readPos.store(r+bytesToDisplace, std::memory_order_release);
+    return std::make_pair(true,bytesToDisplace);
+}
+
+bool B_Ring::clear2()
+{
+    readPos = 0;
+    writePos = 0;
+    setContainerBytes(0);
+    return true;
+}
+
+std::pair<bool, uint64_t> B_Ring::copyToStream2(std::ostream &bc, const uint64_t &bytes, const uint64_t &offset)
+{
+    // No bytes to copy.
+    if (!bytes) return std::make_pair(true,0);
+    // Offset:bytes will overflow...
+    if (CHECK_UINT_OVERFLOW_SUM(offset,bytes)) return std::make_pair(false,(uint64_t)0);
+    // No bytes to copy:
+    if (offset>size()) return std::make_pair(false,(uint64_t)0);
+
+    return std::make_pair(true,copyToStreamUsingCleanVector(bc,getChunks(offset,bytes)));
+}
+
+std::pair<bool, uint64_t> B_Ring::copyTo2(Streamable &bc, Streams::Status &wrStatUpd, const uint64_t &bytes, const uint64_t &offset)
+{
+    // No bytes to copy.
+    if (!bytes) return std::make_pair(true,0);
+    // Offset:bytes will overflow...
+    if (CHECK_UINT_OVERFLOW_SUM(offset,bytes)) return std::make_pair(false,(uint64_t)0);
+    // No bytes to copy:
+    if (offset>size()) return std::make_pair(false,(uint64_t)0);
+
+    return std::make_pair(true,copyToSOUsingCleanVector(bc,getChunks(offset,bytes),wrStatUpd));
+}
+
+std::pair<bool, uint64_t> B_Ring::copyOut2(void *buf, const uint64_t &bytes, const uint64_t &offset)
+{
+    // Offset:bytes will overflow...
+    if (CHECK_UINT_OVERFLOW_SUM(offset,bytes)) return std::make_pair(false,(uint64_t)0);
+    // No bytes to copy:
+    if (!bytes) return std::make_pair(true,0);
+    // out of bounds (fail to copy):
+    if (offset+bytes>size()) return std::make_pair(false,(uint64_t)0);
+
+    uint64_t copiedBytes = 0;
+    for (const BinaryContainerChunk & chunk : getChunks(offset,bytes))
+    {
+        memcpy((char *)buf+copiedBytes, chunk.rodata, chunk.rosize);
+        copiedBytes+=chunk.rosize;
+    }
+    return std::make_pair(true,copiedBytes);
+}
+
+bool B_Ring::compare2(const void *buf, const uint64_t &len, bool caseSensitive, const uint64_t &offset)
+{
+    // Offset:bytes will overflow...
+    if (CHECK_UINT_OVERFLOW_SUM(offset,len)) return false;
+    // No bytes to compare:
+    if (!len) return true;
+    // out of bounds (fail to compare):
+    if (offset+len>size()) return false;
+
+    uint64_t comparedBytes = 0;
+    for (const BinaryContainerChunk & chunk : getChunks(offset,len))
+    {
+        if (CX2::Helpers::Mem::memicmp2(chunk.rodata, (const char *)buf+comparedBytes, chunk.rosize, caseSensitive))
+            return false;
+        comparedBytes+=chunk.rosize;
+    }
+    return true;
+}
+
+std::vector<BinaryContainerChunk> B_Ring::getChunks(const uint64_t &offset, uint64_t bytes) const
+{
+    std::vector<BinaryContainerChunk> chunks;
+
+    uint64_t w = writePos.load(std::memory_order_acquire);
+    uint64_t r = readPos.load(std::memory_order_relaxed);
+    if (offset>=w-r) return chunks;
+    if (bytes>(w-r)-offset) bytes = (w-r)-offset;
+
+    uint64_t pos = (r+offset) & (capacity-1);
+    while (bytes)
+    {
+        BinaryContainerChunk bcx;
+        bcx.rosize = std::min(bytes, capacity-pos);
+        bcx.rodata = ringMem+pos;
+        chunks.push_back(bcx);
+
+        bytes-=bcx.rosize;
+        pos = 0;
+    }
+    return chunks;
+}
+
+bool B_Ring::resize(const uint64_t &nCapacity)
+{
+    char * nRingMem = new (std::nothrow) char[nCapacity];
+    if (!nRingMem)
+        return false;
+
+    // Move the data to the start of the new ring:
+    uint64_t currentSize = size();
+    if (ringMem)
+    {
+        copyOut2(nRingMem,currentSize,0);
+        delete [] ringMem;
+    }
+
+    ringMem = nRingMem;
+    capacity = nCapacity;
+    readPos = 0;
+    writePos = currentSize;
+    return true;
+}
+
+uint64_t B_Ring::roundCapacity(const uint64_t &capacity)
+{
+    uint64_t r = 1;
+    while (r<capacity && r<(1ull<<63))
+        r<<=1;
+    return r;
+}
@@ -0,0 +1,156 @@
+#ifndef BINARYCONTAINER_RING_H
+#define BINARYCONTAINER_RING_H
+
+#include "b_base.h"
+
+#include <atomic>
+
+// Default ring capacity in bytes (the capacity is always a power of 2).
+#define B_RING_DEFAULT_CAPACITY (64*KB_MULT)
+
+namespace CX2 { namespace Memory { namespace Containers {
+
+/**
+ * @brief The B_Ring class is a FIFO container (append at the end, displace from the beggining) over a ring buffer,
+ *        append and displace are O(1) and don't move/copy the data already stored.
+ *
+ *        In the single-producer/single-consumer mode, one thread can append while another one reads/finds/displaces
+ *        without locks. In this mode the capacity is fixed (append fails when there is no space), and prepend/truncate
+ *        are disabled.
+ *        Without this mode, the capacity grows (doubling) when required.
+ */
+class B_Ring : public B_Base
+{
+public:
+    /**
+     * @brief B_Ring Constructor
+     * @param capacity initial capacity in bytes (rounded up to a power of 2)
+     * @param spscMode single-producer/single-consumer mode
+     */
+    B_Ring(const uint64_t & capacity = B_RING_DEFAULT_CAPACITY, bool spscMode = false);
+    ~B_Ring() override;
+
+    /**
+     * @brief setCapacity Set the ring capacity (the data is kept), not available in the spsc mode.
+     * @param capacity capacity in bytes (rounded up to a power of 2), should be greater than the current size.
+     * @return true if succeed
+     */
+    bool setCapacity(const uint64_t & capacity);
+    /**
+     * @brief getCapacity Get the ring capacity
+     * @return capacity in bytes.
+     */
+    uint64_t getCapacity() const;
+    /**
+     * @brief getFreeSpace Get the bytes that can be appended without growing the ring
+     * @return free space in bytes
+     */
+    uint64_t getFreeSpace() const;
+    /**
+     * @brief isSPSCMode Get if the ring is in single-producer/single-consumer mode
+     * @return true if in spsc mode
+     */
+    bool isSPSCMode() const;
+
+    /**
+     * @brief size Get Container Data Size in bytes
+     * @return data size in bytes
+     */
+    uint64_t size() const override;
+    /**
+     * @brief findChar
+     * @param c
+     * @param offset
+     * @return
+     */
+    std::pair<bool,uint64_t> findChar(const int & c, const uint64_t &offset = 0, uint64_t searchSpace = 0, bool caseSensitive = false) override;
+
+protected:
+    /**
+     * @brief truncate the current container to n bytes (disabled in spsc mode)
+     * @param bytes n bytes.
+     * @return new container size.
+     */
+    std::pair<bool, uint64_t> truncate2(const uint64_t &bytes) override;
+    /**
+     * @brief Append (producer) or prepend (disabled in spsc mode) data to the ring.
+     * @param data data to be appended
+     * @param len data size in bytes to be appended
+     * @param prependMode mode: true will prepend the data, false will append.
+     * @return true if succeed
+     */
+    std::pair<bool,uint64_t> append2(const void * buf, const uint64_t &len, bool prependMode = false) override;
+    /**
+     * @brief remove n bytes at the beggining shrinking the container (consumer)
+     * @param bytes bytes to be removed
+     * @return bytes removed.
+     */
+    std::pair<bool, uint64_t> displace2(const uint64_t &bytes = 0) override;
+    /**
+     * @brief free the whole container (not thread safe)
+     * @return true if succeed
+     */
+    bool clear2() override;
+    /**
+    * @brief Append this current container to a new one.
+    * @param bc Binary container.
+    * @param bytes size of data to be copied in bytes. -1 copy all the container but the offset.
+    * @param offset displacement in bytes where the data starts.
+    * @return
+    */
+    std::pair<bool, uint64_t> copyToStream2(std::ostream & bc, const uint64_t &bytes = std::numeric_limits<uint64_t>::max(), const uint64_t &offset = 0) override;
+    /**
+    * @brief Internal Copy function to copy this container to a new one.
+    * @param out data stream out
+    * @param bytes size of data to be copied in bytes. -1 copy all the container but the offset.
+    * @param offset displacement in bytes where the data starts.
+    * @return
+    */
+    std::pair<bool,uint64_t> copyTo2(Streamable & bc, Streams::Status &wrStatUpd, const uint64_t &bytes = std::numeric_limits<uint64_t>::max(), const uint64_t &offset = 0) override;
+    /**
+     * @brief Copy append to another binary container.
+     * @param bc destination binary container
+     * @param bytes size of data in bytes to be copied
+     * @param offset starting point (offset) in bytes, default: 0 (start)
+     * @return number of bytes copied (in bytes)
+     */
+    std::pair<bool, uint64_t> copyOut2(void * buf, const uint64_t &bytes, const uint64_t &offset = 0) override;
+    /**
+     * @brief Compare memory with the container
+     * @param mem Memory to be compared
+     * @param len Memory size in bytes to be compared
+     * @param offset starting point (offset) in bytes, default: 0 (start)
+     * @return true where comparison returns equeal.
+     */
+    bool compare2(const void * buf, const uint64_t &len, bool caseSensitive = true, const uint64_t &offset = 0 ) override;
+
+private:
+    /**
+     * @brief getChunks Get the (up to two) memory pieces of a range, limited to the container size.
+     * @param offset data offset
+     * @param bytes data size in bytes
+     * @return memory pieces (rodata/rosize)
+     */
+    std::vector<BinaryContainerChunk> getChunks(const uint64_t & offset, uint64_t bytes) const;
+    bool resize(const uint64_t & nCapacity);
+    static uint64_t roundCapacity(const uint64_t & capacity);
+
+    /**
+     * @brief ringMem Ring memory, the data is from readPos to writePos (masked with capacity-1).
+     */
+    char * ringMem;
+    uint64_t capacity;
+    /**
+     * @brief readPos total bytes displaced (only modified by the consumer in spsc mode)
+     */
+    std::atomic<uint64_t> readPos;
+    /**
+     * @brief writePos total bytes appended (only modified by the producer in spsc mode)
+     */
+    std::atomic<uint64_t> writePos;
+    bool spscMode;
+};
+
+}}}
+
+#endif // BINARYCONTAINER_RING_H
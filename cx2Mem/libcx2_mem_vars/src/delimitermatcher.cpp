@@ -0,0 +1,91 @@
+#include "delimitermatcher.h"
+
+#include <string.h>
+
+using namespace CX2::Memory::Streams::Parsing;
+
+DelimiterMatcher::DelimiterMatcher()
+{
+}
+
+void DelimiterMatcher::setDelimiters(const std::list<std::string> &delimiters)
+{
+    this->delimiters.clear();
+    for (const std::string & value : delimiters)
+    {
+        if (value.empty())
+            continue;
+
+        sDelimiter d;
+        d.value = value;
+        d.matched = 0;
+        d.failure.resize(value.size(),0);
+        for (size_t i=1, k=0; i<value.size(); i++)
+        {
+            while (k && value[i]!=value[k]) k = d.failure[k-1];
+            if (value[i]==value[k]) k++;
+            d.failure[i] = k;
+        }
+        this->delimiters.push_back(d);
+    }
+}
+
+void DelimiterMatcher::reset()
+{
+    for (sDelimiter & d : delimiters)
+        d.matched = 0;
+}
+
+std::pair<bool, size_t> DelimiterMatcher::feed(const void *buf, size_t count)
+{
+    const char * data = (const char *)buf;
+    size_t i = 0;
+
+    while (i<count)
+    {
+        // Single delimiter without partial match: jump to its first byte.
+        if (delimiters.size()==1 && !delimiters[0].matched)
+        {
+            const char * p = (const char *)memchr(data+i, delimiters[0].value[0], count-i);
+            if (!p) break;
+            i = p-data;
+        }
+
+        sDelimiter * found = nullptr;
+        for (sDelimiter & d : delimiters)
+        {
+            while (d.matched && d.value[d.matched]!=data[i]) d.matched = d.failure[d.matched-1];
+            if (d.value[d.matched]==data[i]) d.matched++;
+
+            if (d.matched == d.value.size())
+            {
+                if (!found || d.value.size()>found->value.size())
+                    found = &d;
+                d.matched = d.failure[d.matched-1];
+            }
+        }
+        i++;
+
+        if (found)
+        {
+            delimiterFound = found->value;
+            reset();
+            return std::make_pair(true,i);
+        }
+    }
+
+    return std::make_pair(false,count);
+}
+
+std::string DelimiterMatcher::getDelimiterFound() const
+{
+    return delimiterFound;
+}
+
+size_t DelimiterMatcher::getPartialMatchSize() const
+{
+    size_t r = 0;
+    for (const sDelimiter & d : delimiters)
+        if (d.matched>r) r = d.matched;
+    return r;
+}
@@ -0,0 +1,66 @@
+#ifndef DELIMITERMATCHER_H
+#define DELIMITERMATCHER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace CX2 { namespace Memory { namespace Streams { namespace Parsing {
+
+/**
+ * @brief The DelimiterMatcher class find one or many delimiters in a stream given in pieces, keeping the partial
+ *        match state between the pieces (KMP automaton per delimiter), so every byte is examined only once.
+ */
+class DelimiterMatcher
+{
+public:
+    DelimiterMatcher();
+
+    /**
+     * @brief setDelimiters Set the delimiters to be found (resets the state)
+     * @param delimiters delimiters (empty ones are ignored)
+     */
+    void setDelimiters(const std::list<std::string> & delimiters);
+    /**
+     * @brief reset Forget the partial matches (eg. when the previous data was discarded).
+     */
+    void reset();
+    /**
+     * @brief feed Scan the next piece of the stream.
+     *             The first delimiter that ends in this piece is reported (if many end at the same byte, the longest).
+     *             Once found, the state is reset (the next piece is scanned as a new stream).
+     * @param buf data
+     * @param count data size in bytes
+     * @return true and the bytes of the piece up to the delimiter end, or false and count if not found.
+     */
+    std::pair<bool,size_t> feed(const void * buf, size_t count);
+    /**
+     * @brief getDelimiterFound Get the last delimiter found by feed
+     * @return delimiter found.
+     */
+    std::string getDelimiterFound() const;
+    /**
+     * @brief getPartialMatchSize Get the bytes at the end of the scanned data that can be the start of a delimiter
+     * @return bytes in bytes
+     */
+    size_t getPartialMatchSize() const;
+
+private:
+    struct sDelimiter {
+        std::string value;
+        // KMP failure function: longest proper prefix that is also a suffix of value[0..i]
+        std::vector<size_t> failure;
+        // delimiter bytes matched at the end of the scanned data
+        size_t matched;
+    };
+
+    std::vector<sDelimiter> delimiters;
+    std::string delimiterFound;
+};
+
+}}}}
+
+#endif // DELIMITERMATCHER_H
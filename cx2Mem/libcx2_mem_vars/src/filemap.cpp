@@ -6,10 +6,13 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <string.h>
 
 #ifndef _WIN32
 #include <sys/mman.h>
+#define FILEMAP_PAGE_SIZE 4096
 #else
+#define FILEMAP_PAGE_SIZE 65536
 #include <io.h>
 #define MAP_FAILED	((void *) -1)
 
@@ -50,6 +53,8 @@ FileMap &FileMap::operator=(FileMap &bc)
     fd = bc.fd;
     mmapAddr = bc.mmapAddr;
     fileOpenSize = bc.fileOpenSize;
+    headOffset = bc.headOffset;
+    mapCapacity = bc.mapCapacity;
     readOnly = bc.readOnly;
 #ifdef WIN32
     hFileMapping = bc.hFileMapping;
@@ -70,6 +75,8 @@ void FileMap::cleanVars()
     hFileMapping = nullptr;
 #endif
     fileOpenSize=0;
+    headOffset=0;
+    mapCapacity=0;
 }
 
 void FileMap::setRemoveOnDestroy(bool value)
@@ -84,7 +91,7 @@ bool FileMap::unMapFile()
     if (mmapAddr && mmapAddr!=MAP_FAILED && mmapAddr!=emptyMap)
     {
 #ifndef _WIN32
-        ret = munmap(mmapAddr,fileOpenSize)==0;
+        ret = munmap(mmapAddr,mapCapacity)==0;
 #else
         ret = UnmapViewOfFile(mmapAddr)!=0;
 #endif
@@ -99,6 +106,7 @@ bool FileMap::unMapFile()
 #endif
 
     mmapAddr = nullptr;
+    mapCapacity = 0;
     return ret;
 }
 
@@ -107,14 +115,21 @@ bool FileMap::mapFileUsingCurrentFileDescriptor(size_t len)
     if (fd == -1)
         return false;
 
-    // Establish the new file size.
+    // Establish the new file size (the whole file is data).
     this->fileOpenSize = len;
+    this->headOffset = 0;
+
+    return mapFile(len);
+}
+
+bool FileMap::mapFile(const uint64_t &len)
+{
+    this->mapCapacity = len;
 
     // In case we are mapping 0-bytes file:
     if (len == 0)
     {
         // No map for zero bytes!
-        this->fileOpenSize = 0;
         this->mmapAddr = emptyMap;
         return true;
     }
@@ -153,9 +168,86 @@ bool FileMap::mapFileUsingCurrentFileDescriptor(size_t len)
     return true;
 }
 
+bool FileMap::resizeMap(const uint64_t &nCapacity)
+{
+#ifdef __linux__
+    // Extend the current map in place (or move it) without unmapping the file:
+    if (mmapAddr && mmapAddr!=MAP_FAILED && mmapAddr!=emptyMap && nCapacity)
+    {
+        // Resize the file...
+        if (ftruncate64(fd,nCapacity)!=0)
+        {
+            closeFile();
+            return false;
+        }
+        void * nAddr = mremap(mmapAddr, mapCapacity, nCapacity, MREMAP_MAYMOVE);
+        if (nAddr == MAP_FAILED)
+        {
+            closeFile();
+            return false;
+        }
+        mmapAddr = static_cast<char *>(nAddr);
+        mapCapacity = nCapacity;
+        return true;
+    }
+#endif
+
+    // A mapped file can't be resized everywhere (eg. Windows), unmap it first:
+    uint64_t oCapacity = mapCapacity;
+    if (!unMapFile())
+    {
+        // Error unmaping, closing...
+        closeFile();
+        return false;
+    }
+
+    // Resize the file...
+    if (ftruncate64(fd,nCapacity)!=0)
+    {
+        // Map it back, so the close leaves only the data in the file:
+        if (mapFile(oCapacity))
+            closeFile();
+        return false;
+    }
+    return mapFile(nCapacity);
+}
+
+uint64_t FileMap::grownCapacity(const uint64_t &required)
+{
+    // Double the capacity, but don't reserve more than FILEMAP_MAX_GROWTH at once.
+    uint64_t nCapacity = mapCapacity<FILEMAP_MIN_CAPACITY? FILEMAP_MIN_CAPACITY : mapCapacity;
+    while (nCapacity<required)
+        nCapacity += nCapacity<FILEMAP_MAX_GROWTH? nCapacity : FILEMAP_MAX_GROWTH;
+    // Page aligned:
+    return ((nCapacity+FILEMAP_PAGE_SIZE-1)/FILEMAP_PAGE_SIZE)*FILEMAP_PAGE_SIZE;
+}
+
+void FileMap::compact()
+{
+    if (!headOffset)
+        return;
+    CX2::Helpers::Mem::memmove64(mmapAddr, mmapAddr+headOffset, fileOpenSize);
+    headOffset = 0;
+}
+
 char *FileMap::getMmapAddr() const
 {
-    return mmapAddr;
+    return mmapAddr+headOffset;
+}
+
+uint64_t FileMap::getHeadOffset() const
+{
+    return headOffset;
+}
+
+uint64_t FileMap::getCapacity() const
+{
+    return mapCapacity;
+}
+
+int FileMap::getFileDescriptor() const
+{
+    return fd;
 }
 
 uint64_t FileMap::getFileOpenSize() const
@@ -170,36 +262,72 @@ std::string FileMap::getCurrentFileName() const
 
 bool FileMap::mmapDisplace(const uint64_t &offsetBytes)
 {
-    CX2::Helpers::Mem::memmove64(mmapAddr, mmapAddr+offsetBytes, fileOpenSize-offsetBytes);
-    return mmapTruncate(fileOpenSize-offsetBytes);
+    if (offsetBytes>fileOpenSize)
+        return false;
+
+    // Just move the data start, the space is reused by the next appends/prepends:
+    headOffset+=offsetBytes;
+    fileOpenSize-=offsetBytes;
+    if (!fileOpenSize)
+        headOffset = 0;
+    return true;
 }
 
 std::pair<bool, uint64_t> FileMap::mmapAppend(const void *buf, const uint64_t &count)
 {
     if (!count) return std::make_pair(true,0);
+    if (fd==-1 || readOnly) return std::make_pair(false,(uint64_t)0);
     /////////////////////////////
 
-    uint64_t curOpenSize = fileOpenSize;
-    if (!mmapTruncate(fileOpenSize+count)) return std::make_pair(false,(uint64_t)0);
+    if (headOffset+fileOpenSize+count > mapCapacity)
+    {
+        // Reuse the displaced space when it is bigger than the data to move (so the moves are amortized):
+        if (headOffset>=fileOpenSize && fileOpenSize+count<=mapCapacity)
+            compact();
+        else if (!mmapReserve(headOffset+fileOpenSize+count))
+            return std::make_pair(false,(uint64_t)0);
+    }
 
-    memcpy(mmapAddr+curOpenSize,buf,count);
+    CX2::Helpers::Mem::memcpy64(mmapAddr+headOffset+fileOpenSize,buf,count);
+    fileOpenSize+=count;
     return std::make_pair(true,count);
 }
 
 std::pair<bool, uint64_t> FileMap::mmapPrepend(const void *buf, const uint64_t &count)
 {
     if (!count) return std::make_pair(true,0);
-
+    if (fd==-1 || readOnly) return std::make_pair(false,(uint64_t)0);
     /////////////////////////////
-    uint64_t curOpenSize = fileOpenSize;
-    if (!mmapTruncate(fileOpenSize+count)) return std::make_pair(false,(uint64_t)0);
-    CX2::Helpers::Mem::memmove64(mmapAddr,mmapAddr+count,curOpenSize);
-    CX2::Helpers::Mem::memcpy64(mmapAddr,buf,count);
+
+    if (count>headOffset)
+    {
+        // Make room before the data, also for the next prepends:
+        uint64_t nHeadOffset = count + (fileOpenSize<FILEMAP_MAX_GROWTH? fileOpenSize : FILEMAP_MAX_GROWTH);
+        if (!mmapReserve(nHeadOffset+fileOpenSize))
+            return std::make_pair(false,(uint64_t)0);
+        CX2::Helpers::Mem::memmove64(mmapAddr+nHeadOffset,mmapAddr+headOffset,fileOpenSize);
+        headOffset = nHeadOffset;
+    }
+
+    headOffset-=count;
+    fileOpenSize+=count;
+    CX2::Helpers::Mem::memcpy64(mmapAddr+headOffset,buf,count);
     return std::make_pair(true,count);
 }
 
 bool FileMap::closeFile(bool respectRemoveOnDestroy)
 {
+    // Leave the file with only the data (the capacity is an in-memory detail):
+    bool ret = true;
+    bool removeFile = removeOnDestroy && respectRemoveOnDestroy && currentFileName.size();
+    bool mapped = mmapAddr && mmapAddr!=MAP_FAILED;
+    if (fd!=-1 && mapped && !readOnly && !removeFile && (headOffset || mapCapacity!=fileOpenSize))
+    {
+        compact();
+        unMapFile();
+        ret = ftruncate64(fd,fileOpenSize)==0;
+    }
+
     // If there is a mmap, close the mmap:
     unMapFile();
 
@@ -207,7 +335,7 @@ bool FileMap::closeFile(bool respectRemoveOnDestroy)
     if (fd!=-1) close(fd);
 
     // If there is an order to destroy the file, destroy the file.
-    if (removeOnDestroy && respectRemoveOnDestroy && currentFileName.size())
+    if (removeFile)
     {
         remove(currentFileName.c_str());
     }
@@ -215,7 +343,7 @@ bool FileMap::closeFile(bool respectRemoveOnDestroy)
     // Clean the vars...
     cleanVars();
 
-    return true;
+    return ret;
 }
 
 bool FileMap::mmapTruncate(const uint64_t &nSize)
@@ -224,23 +352,31 @@ bool FileMap::mmapTruncate(const uint64_t &nSize)
     if (fd==-1 || readOnly)
         return false;
 
-    // Unmap the file:
-    if (!unMapFile())
+    if (nSize<=fileOpenSize)
     {
-        // Error unmaping, closing...
-        closeFile();
-        return false;
+        // Keep the capacity for the next appends:
+        fileOpenSize = nSize;
+        if (!fileOpenSize)
+            headOffset = 0;
+        return true;
     }
 
-    // Truncate the file...
-    if (ftruncate64(fd,nSize)!=0)
-    {
-        closeFile();
+    if (headOffset+nSize>mapCapacity && !mmapReserve(headOffset+nSize))
         return false;
-    }
 
-    // Map the file into memory:
-    return mapFileUsingCurrentFileDescriptor(nSize);
+    // The reused capacity may contain old data:
+    memset(mmapAddr+headOffset+fileOpenSize,0,nSize-fileOpenSize);
+    fileOpenSize = nSize;
+    return true;
+}
+
+bool FileMap::mmapReserve(const uint64_t &capacity)
+{
+    if (fd==-1 || readOnly)
+        return false;
+    if (capacity<=mapCapacity)
+        return true;
+    return resizeMap(grownCapacity(capacity));
 }
 
 bool FileMap::openFile(const std::string &filePath, bool readOnly, bool createFile)
@@ -8,6 +8,10 @@
 #include <windows.h>
 #endif
 
+// The mapping capacity grows geometrically (doubling) from the min capacity, by steps of at most the max growth.
+#define FILEMAP_MIN_CAPACITY (64*1024)
+#define FILEMAP_MAX_GROWTH (1024ull*1024*1024)
+
 namespace CX2 { namespace Memory { namespace Containers {
 
 class FileMap
@@ -19,6 +23,11 @@ public:
 
     FileMap & operator=(FileMap & bc);
 
+    /**
+     * @brief mmapDisplace Remove bytes from the beginning of the data (O(1): only moves the head offset).
+     * @param offsetBytes bytes to be removed.
+     * @return true if succeed
+     */
     bool mmapDisplace(const uint64_t &offsetBytes);
 
     // thanks to larsmans: http://stackoverflow.com/questions/4460507/appending-to-a-memory-mapped-file
@@ -47,8 +56,18 @@ public:
 
 
     // Mmap/FILE MODE methods:
-    // TODO: use mmap64... or plain seek mode...
+    /**
+     * @brief mmapTruncate Set the data size (new bytes are zeroed), the file capacity is kept for the next appends.
+     * @param nSize new data size in bytes
+     * @return true if succeed
+     */
     bool mmapTruncate(const uint64_t &nSize);
+    /**
+     * @brief mmapReserve Reserve file/mapping capacity for the head offset plus the data
+     * @param capacity capacity in bytes
+     * @return true if succeed
+     */
+    bool mmapReserve(const uint64_t &capacity);
 
     /**
      * @brief openFile Open file and Map to Memory
@@ -62,9 +81,31 @@ public:
 
     std::string getCurrentFileName() const;
 
+    /**
+     * @brief getFileOpenSize Get the data size (the file may be bigger while open, see getCapacity)
+     * @return data size in bytes
+     */
     uint64_t getFileOpenSize() const;
-
+    /**
+     * @brief getMmapAddr Get the memory address where the data starts.
+     * @return data address.
+     */
     char *getMmapAddr() const;
+    /**
+     * @brief getHeadOffset Get the file offset where the data starts (displaced/reserved bytes before the data).
+     * @return offset in bytes.
+     */
+    uint64_t getHeadOffset() const;
+    /**
+     * @brief getCapacity Get the current mapped file size (head offset + data + reserved space).
+     * @return capacity in bytes.
+     */
+    uint64_t getCapacity() const;
+    /**
+     * @brief getFileDescriptor Get the file descriptor of the mapped file
+     * @return file descriptor or -1 if there is no file openned.
+     */
+    int getFileDescriptor() const;
 
     void setRemoveOnDestroy(bool value);
 
@@ -72,6 +113,10 @@ private:
 
     bool unMapFile();
     bool mapFileUsingCurrentFileDescriptor(size_t len);
+    bool mapFile(const uint64_t & len);
+    bool resizeMap(const uint64_t & nCapacity);
+    uint64_t grownCapacity(const uint64_t & required);
+    void compact();
     void cleanVars();
 
     /**
@@ -91,9 +136,17 @@ private:
      */
     char * mmapAddr;
     /**
-     * @brief containerBytesOriginalBytes original container size.
+     * @brief fileOpenSize data size.
      */
     uint64_t fileOpenSize;
+    /**
+     * @brief headOffset bytes before the data (displaced or reserved for prepends).
+     */
+    uint64_t headOffset;
+    /**
+     * @brief mapCapacity mapped bytes (file size while open).
+     */
+    uint64_t mapCapacity;
 
     /**
      * @brief readOnly Use Read-Only Mode.
@@ -98,6 +98,26 @@ void Streamable::writeEOF(bool )
 {
 
 }
+
+bool Streamable::streamRangeTo(Streamable *out, Status &wrStatUpd, const uint64_t &offset, const uint64_t &count)
+{
+    if (offset == 0 && count == size() && count != std::numeric_limits<uint64_t>::max())
+        return streamTo(out,wrStatUpd);
+    wrStatUpd.succeed = false;
+    return false;
+}
+
+bool Streamable::supportsWriteFromFile()
+{
+    return false;
+}
+
+Status Streamable::writeFromFile(int, const uint64_t &, const uint64_t &, Status &wrStatUpd)
+{
+    Status cur;
+    wrStatUpd.succeed = cur.succeed = setFailedWriteState();
+    return cur;
+}
 /*
 uint64_t Streamable::size() const
 {
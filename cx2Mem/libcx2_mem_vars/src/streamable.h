@@ -71,6 +71,31 @@ public:
     virtual uint64_t size() const { return std::numeric_limits<uint64_t>::max(); }
     virtual bool streamTo(Memory::Streams::Streamable * out, Status & wrStatUpd)=0;
     virtual Status write(const void * buf, const size_t &count, Status & wrStatUpd)=0;
+    /**
+     * @brief streamRangeTo stream only a part of a fixed size stream.
+     * The default implementation only handles the whole stream range (offset 0, count size()).
+     * @param out output stream.
+     * @param wrStatUpd write status.
+     * @param offset starting offset in bytes.
+     * @param count bytes to be streamed.
+     * @return true if succeed, false if failed or the range is not supported by this stream.
+     */
+    virtual bool streamRangeTo(Memory::Streams::Streamable * out, Status & wrStatUpd, const uint64_t & offset, const uint64_t & count);
+    /**
+     * @brief supportsWriteFromFile tells if this stream can consume data directly from a file descriptor (eg. sendfile)
+     * @return false by default.
+     */
+    virtual bool supportsWriteFromFile();
+    /**
+     * @brief writeFromFile write a range of a file descriptor into this stream without passing trough user memory.
+     * Only called when supportsWriteFromFile() returns true.
+     * @param fd file descriptor (will not be closed nor displaced)
+     * @param offset file offset in bytes.
+     * @param count bytes to be written.
+     * @param wrStatUpd write status.
+     * @return status of the current write.
+     */
+    virtual Status writeFromFile(int fd, const uint64_t & offset, const uint64_t & count, Status & wrStatUpd);
 
     Status writeFullStream(const void *buf, const size_t &count, Status & wrStatUpd);
     /**
@@ -1,6 +1,8 @@
 #include "streamparser.h"
 #include "b_ref.h"
 
+#include <algorithm>
+
 using namespace CX2::Memory::Streams;
 using namespace CX2::Memory::Streams::Parsing;
 
@@ -50,22 +52,32 @@ bool Parser::streamTo(Memory::Streams::Streamable *out, Status &wrsStat)
 Status Parser::write(const void *buf, const size_t &count, Status &wrStat)
 {
     Status ret;
-    // Parse this data...
-    size_t ttl = 0;
-    bool finished = false;
-
-    std::pair<bool, uint64_t> r = parseData(buf,count, &ttl, &finished);
-    if (finished) ret.finish = wrStat.finish = true;
+    size_t offset = 0;
 
-    if (r.first==false)
-    {
-        wrStat.succeed = ret.succeed = setFailedWriteState();
-    }
-    else
+    // Parse this data in slices (the TTL limits the sub-parser changes per slice, and big reads are not
+    // going deeper in the recursion)
+    do
     {
+        size_t ttl = 0;
+        bool finished = false;
+        size_t sliceSize = std::min(count-offset, (size_t)PARSER_MAX_SLICE_SIZE);
+
+        std::pair<bool, uint64_t> r = parseData((const char *)buf+offset,sliceSize, &ttl, &finished);
+        if (finished) ret.finish = wrStat.finish = true;
+
+        if (r.first==false)
+        {
+            wrStat.succeed = ret.succeed = setFailedWriteState();
+            return ret;
+        }
+
         ret+=r.second;
-        wrStat+=ret;
-    }
+        wrStat+=r.second;
+        offset+=r.second;
+
+        if (finished || r.second!=sliceSize)
+            break;
+    } while (offset<count);
 
     return ret;
 }
@@ -5,6 +5,9 @@
 #include "b_chunks.h"
 #include "streamable.h"
 
+// Max data given to the sub-parsers in one pass (big writes are parsed in slices of this size)
+#define PARSER_MAX_SLICE_SIZE 8192
+
 namespace CX2 { namespace Memory { namespace Streams { namespace Parsing {
 
 enum ParseErrorMSG {
@@ -1,6 +1,8 @@
 #include "substreamparser.h"
 #include "b_ref.h"
 
+#include <algorithm>
+
 using namespace CX2::Memory::Streams;
 using namespace CX2::Memory::Streams::Parsing;
 
@@ -12,6 +14,7 @@ SubParser::SubParser()
     parseMode = PARSE_MODE_DELIMITER;
     parseDelimiter = "\r\n";
     leftToParse = std::numeric_limits<uint64_t>::max();
+    updateDelimiterMatcher();
 }
 
 SubParser::~SubParser()
@@ -67,6 +70,7 @@ void SubParser::setParseStatus(const ParseStatus &value)
 void SubParser::setParseDelimiter(const std::string &value)
 {
     parseDelimiter = value;
+    updateDelimiterMatcher();
 }
 
 CX2::Memory::Containers::B_Base *SubParser::getParsedData()
@@ -76,82 +80,39 @@ CX2::Memory::Containers::B_Base *SubParser::getParsedData()
 
 std::pair<bool,uint64_t> SubParser::parseByMultiDelimiter(const void *buf, size_t count)
 {
-    std::pair<bool,uint64_t> needlePos, bytesAppended = std::make_pair(true,0);
-    uint64_t prevSize = unparsedBuffer.size(), bytesToDisplace = 0;
-    if (!count)
-    {
-        streamEnded = true;
-       /* if (!unparsedBuffer.size())
-        {
-            return 0;
-        }*/
-    }
-
-    if (count && ((bytesAppended=unparsedBuffer.append(buf,count)).first==false || bytesAppended.second==0))
-    {
-        // size exceeded. don't continue with the streamparser, error.
-        unparsedBuffer.clear();
-        return std::make_pair(false,(uint64_t)0);
-    }
-
-    bytesToDisplace = bytesAppended.second;
-    parsedBuffer.reference(&unparsedBuffer);
-
-    if ( (needlePos = unparsedBuffer.find(parseMultiDelimiter, delimiterFound)).first!=false )
-    {
-        //std::cout << "DELIMITER FOUND AT ->" << needlePos.second << std::endl << std::flush;
-
-        // needle found.
-        parsedBuffer.reference(&unparsedBuffer,0,needlePos.second);
-
-#ifdef DEBUG_PARSER
-        printf("Parsing by multidelimiter: %s\n", postParsedBuffer.toString().c_str()); fflush(stdout);
-#endif
-
-        setParseStatus(parse());
-        unparsedBuffer.clear();
-
-        // Bytes to displace:
-        bytesToDisplace = needlePos.second+delimiterFound.size()-prevSize;
-    }
-    else if (streamEnded)
-    {
-        parsedBuffer.reference(&unparsedBuffer);
-        setParseStatus(parse());
-        unparsedBuffer.clear();
-    }
-    else
-    {
-        //std::cout << "DELIMITER NOT FOUND HERE." << std::endl << std::flush;
-    }
-
-    return std::make_pair(true,bytesToDisplace);
+    return parseByDelimiter(buf,count);
 }
 
 std::pair<bool,uint64_t> SubParser::parseByDelimiter(const void *buf, size_t count)
 {
-    std::pair<bool,uint64_t> needlePos, bytesAppended = std::make_pair(true,0);
+    std::pair<bool,uint64_t> bytesAppended = std::make_pair(true,0);
 
-    uint64_t prevSize = unparsedBuffer.size(), bytesToDisplace = 0;
     if (!count)
     {
         streamEnded = true;
     }
 
-    if (count && ((bytesAppended=unparsedBuffer.append(buf,count)).second==0 || bytesAppended.first==false))
+    // Take only what fits in the buffer, the rest is given again after this delimiter.
+    uint64_t bytesToAppend = std::min((uint64_t)count, unparsedBuffer.getMaxSize()-unparsedBuffer.size());
+
+    // Scan only the new bytes (the partial matches of the previous ones are kept in the matcher):
+    std::pair<bool,size_t> delimiterEnd = delimiterMatcher.feed(buf,bytesToAppend);
+    if (delimiterEnd.first)
+        bytesToAppend = delimiterEnd.second;
+
+    if (count && (!bytesToAppend || (bytesAppended=unparsedBuffer.append(buf,bytesToAppend)).second==0 || bytesAppended.first==false))
     {
         // size exceeded. don't continue with the streamparser, error.
         unparsedBuffer.clear();
+        delimiterMatcher.reset();
         return std::make_pair(false,(uint64_t)0);
     }
 
-    bytesToDisplace = bytesAppended.second;
-    parsedBuffer.reference(&unparsedBuffer);
-
-    if ( (needlePos = unparsedBuffer.find(parseDelimiter.c_str(),parseDelimiter.size())).first!=false )
+    if (delimiterEnd.first)
     {
-        // needle found.
-        parsedBuffer.reference(&unparsedBuffer,0,needlePos.second);
+        // needle found (at the end of the buffer).
+        delimiterFound = delimiterMatcher.getDelimiterFound();
+        parsedBuffer.reference(&unparsedBuffer,0,unparsedBuffer.size()-delimiterFound.size());
 
 #ifdef DEBUG_PARSER
         printf("Parsing by delimiter: %s\n", postParsedBuffer.toString().c_str()); fflush(stdout);
@@ -159,18 +120,20 @@ std::pair<bool,uint64_t> SubParser::parseByDelimiter(const void *buf, size_t cou
 
         setParseStatus(parse());
         unparsedBuffer.clear();
-
-        // Bytes to displace:
-        bytesToDisplace = (needlePos.second-prevSize)+parseDelimiter.size();
     }
     else if (streamEnded)
     {
         parsedBuffer.reference(&unparsedBuffer);
         setParseStatus(parse());
         unparsedBuffer.clear();
+        delimiterMatcher.reset();
+    }
+    else
+    {
+        parsedBuffer.reference(&unparsedBuffer);
     }
 
-    return std::make_pair(true,bytesToDisplace);
+    return std::make_pair(true,bytesAppended.second);
 }
 
 std::pair<bool,uint64_t> SubParser::parseBySize(const void *buf, size_t count)
@@ -205,6 +168,9 @@ std::pair<bool,uint64_t> SubParser::parseBySize(const void *buf, size_t count)
 #endif
         setParseStatus(parse());
         unparsedBuffer.clear(); // Destroy the container data.
+
+        // Reset the left to parse counter (for the next element).
+        leftToParse = unparsedBuffer.getMaxSize();
     }
 
     return std::make_pair(true,bytesToAppend);
@@ -288,10 +254,8 @@ std::pair<bool,uint64_t> SubParser::parseDirect(const void *buf, size_t count)
 
 std::pair<bool,uint64_t> SubParser::parseDirectDelimiter(const void *buf, size_t count)
 {
-    std::pair<bool,uint64_t> delimPos;
     std::pair<bool,uint64_t> copiedDirect;
 
-    uint64_t prevSize=0;
     delimiterFound = "";
 
     // TODO: termination?
@@ -301,55 +265,38 @@ std::pair<bool,uint64_t> SubParser::parseDirectDelimiter(const void *buf, size_t
     else if (leftToParse != std::numeric_limits<uint64_t>::max() && count>leftToParse)
         count = leftToParse; // handle only left to parse
 
-    // Get the previous size.
-    prevSize = unparsedBuffer.size();
-    // Append the current data
-    if ((copiedDirect = unparsedBuffer.append(buf,count)).first==false)
-        return std::make_pair(false,(uint64_t)0);
+    // Find the delimiter end in the new data:
+    std::pair<bool,size_t> delimiterEnd = delimiterMatcher.feed(buf,count);
 
+    // Append the current data (until the delimiter)
+    if ((copiedDirect = unparsedBuffer.append(buf,delimiterEnd.second)).first==false)
+        return std::make_pair(false,(uint64_t)0);
 
-    // Find the delimiter pos.
-    if ((delimPos = unparsedBuffer.find(parseDelimiter.c_str(),parseDelimiter.size())).first==false)
+    if (!delimiterEnd.first)
     {
-        // Not found, evaluate how much data I can give here...
-        uint64_t bytesOfPossibleDelim = getLastBytesInCommon(parseDelimiter);
-        switch (bytesOfPossibleDelim)
+        // Not found, the bytes that possibly belongs to the delimiter are kept for the next round, parse the others.
+        uint64_t bytesOfPossibleDelim = delimiterMatcher.getPartialMatchSize();
+        if (unparsedBuffer.size()>bytesOfPossibleDelim)
         {
-        case std::numeric_limits<uint64_t>::max():
-            // delimiter not found at all, parse ALL direct...
-            parsedBuffer.reference(&unparsedBuffer);
-            //printf("Parsing direct delimiter (%llu, until size %llu): ", postParsedBuffer.size(), leftToParse); postParsedBuffer.print(); printf("\n"); fflush(stdout);
-            setParseStatus(parse());
-            unparsedBuffer.clear(); // Reset the container data for the next element.
-            break;
-        case 0:
-            // empty (should not occur)...
-            break;
-        default:
-            // bytesOfPossibleDelim possibly belongs to the delimiter.
-            // we are safe on unparsedBuffer.size()-bytesOfPossibleDelim
             parsedBuffer.reference(&unparsedBuffer, 0,unparsedBuffer.size()-bytesOfPossibleDelim);
             setParseStatus(parse());
-            unparsedBuffer.clear(); // Reset the container data for the next element.
-            break;
+            if (bytesOfPossibleDelim)
+                unparsedBuffer.displace(unparsedBuffer.size()-bytesOfPossibleDelim);
+            else
+                unparsedBuffer.clear(); // Reset the container data for the next element.
         }
 
         if (leftToParse!= std::numeric_limits<uint64_t>::max())
             leftToParse -= copiedDirect.second;
 
-        return std::make_pair(true,parseDelimiter.size()-prevSize); // Move all data copied.
+        return std::make_pair(true,copiedDirect.second); // Move all data copied.
     }
     else
     {
-        // DELIMITER Found...
+        // DELIMITER Found (at the end of the buffer)...
         delimiterFound = parseDelimiter;
 
-        if (delimPos.second==0)
-        {
-            unparsedBuffer.clear(); // found on 0... give nothing to give
-            parsedBuffer.reference(&unparsedBuffer);
-        }
-        else parsedBuffer.reference(&unparsedBuffer,0,delimPos.second);
+        parsedBuffer.reference(&unparsedBuffer,0,unparsedBuffer.size()-parseDelimiter.size());
 
         setParseStatus(parse());
         unparsedBuffer.clear(); // Reset the container data for the next element.
@@ -357,35 +304,10 @@ std::pair<bool,uint64_t> SubParser::parseDirectDelimiter(const void *buf, size_t
         // reestablish the left to parse (delim found).
         if (leftToParse!=std::numeric_limits<uint64_t>::max()) leftToParse = unparsedBuffer.getMaxSize();
 
-        return std::make_pair(true,(delimPos.second-prevSize)+parseDelimiter.size());
+        return std::make_pair(true,copiedDirect.second);
     }
 }
 
-uint64_t SubParser::getLastBytesInCommon(const std::string &boundary)
-{
-    size_t maxBoundary = unparsedBuffer.size()>(boundary.size()-1)?(boundary.size()-1) : unparsedBuffer.size();
-    for (size_t v=maxBoundary; v!=MAX_SIZE_T; v--)
-    {
-        CX2::Memory::Containers::B_Ref ref = referenceLastBytes(v);
-        char * toCmp = ((char *)malloc(ref.size()));
-        ref.copyOut(toCmp,ref.size());
-        if (!memcmp(toCmp,boundary.c_str(),ref.size()))
-        {
-            free(toCmp);
-            return v;
-        }
-        free(toCmp);
-    }
-    return std::numeric_limits<uint64_t>::max();
-}
-
-CX2::Memory::Containers::B_Ref SubParser::referenceLastBytes(const size_t &bytes)
-{
-    CX2::Memory::Containers::B_Ref r;
-    r.reference(&unparsedBuffer, unparsedBuffer.size()-bytes);
-    return r;
-}
-
 std::string SubParser::getDelimiterFound() const
 {
     return delimiterFound;
@@ -394,6 +316,15 @@ std::string SubParser::getDelimiterFound() const
 void SubParser::setParseMultiDelimiter(const std::list<std::string> &value)
 {
     parseMultiDelimiter = value;
+    updateDelimiterMatcher();
+}
+
+void SubParser::updateDelimiterMatcher()
+{
+    if (parseMode == PARSE_MODE_MULTIDELIMITER)
+        delimiterMatcher.setDelimiters(parseMultiDelimiter);
+    else
+        delimiterMatcher.setDelimiters({parseDelimiter});
 }
 
 uint64_t SubParser::getLeftToparse() const
@@ -407,6 +338,16 @@ void SubParser::setParseDataTargetSize(const uint64_t &value)
     unparsedBuffer.setMaxSize(value);
 }
 
+void SubParser::reset()
+{
+    unparsedBuffer.clear();
+    parsedBuffer.reference(&unparsedBuffer);
+    delimiterFound.clear();
+    delimiterMatcher.reset();
+    streamEnded = false;
+    setParseStatus(PARSE_STAT_GET_MORE_DATA);
+}
+
 bool SubParser::isStreamEnded() const
 {
     return streamEnded;
@@ -416,4 +357,5 @@ void SubParser::setParseMode(const ParseMode &value)
 {
     if (value == PARSE_MODE_DIRECT) setParseDataTargetSize(std::numeric_limits<uint64_t>::max());
     parseMode = value;
+    updateDelimiterMatcher();
 }
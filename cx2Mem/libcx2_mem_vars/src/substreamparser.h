@@ -3,6 +3,7 @@
 
 #include "b_chunks.h"
 #include "b_ref.h"
+#include "delimitermatcher.h"
 
 namespace CX2 { namespace Memory { namespace Streams { namespace Parsing {
 
@@ -71,6 +72,11 @@ public:
      * @return
      */
     bool isStreamEnded() const;
+    /**
+     * @brief reset Discard the unparsed data and the parse status, so the sub-parser can be reused
+     *              for a new message (eg. keep-alive connections). Parse mode and delimiters are kept.
+     */
+    virtual void reset();
 
 protected:
     /**
@@ -124,8 +130,7 @@ private:
     std::pair<bool,uint64_t> parseDirect(const void * buf, size_t count);
     std::pair<bool,uint64_t> parseDirectDelimiter(const void * buf, size_t count);
 
-    uint64_t getLastBytesInCommon(const std::string &boundary);
-    CX2::Memory::Containers::B_Ref referenceLastBytes(const size_t &bytes);
+    void updateDelimiterMatcher();
 
     CX2::Memory::Containers::B_Ref parsedBuffer;
     CX2::Memory::Containers::B_Chunks unparsedBuffer;
@@ -133,6 +138,10 @@ private:
 
     std::string delimiterFound;
     std::list<std::string> parseMultiDelimiter;
+    /**
+     * @brief delimiterMatcher delimiter search state over the unparsed data (scanned once)
+     */
+    DelimiterMatcher delimiterMatcher;
 
     ParseMode parseMode;
     Memory::Streams::Parsing::ParseStatus parseStatus;
@@ -22,6 +22,7 @@ SocketChain_AES::SocketChain_AES()
     initialized = false;
     cipher = nullptr;
     setAESRegenBlockSize();
+    setAESMode();
 }
 
 SocketChain_AES::~SocketChain_AES()
@@ -33,6 +34,11 @@ void SocketChain_AES::setAESRegenBlockSize(const size_t &value)
     aesRegenBlockSize = value;
 }
 
+void SocketChain_AES::setAESMode(const eAESChainMode &value)
+{
+    aesMode = value;
+}
+
 void SocketChain_AES::setPhase1Key256(char *pass)
 {
     memcpy(phase1Key,pass,sizeof(phase1Key));
@@ -49,9 +55,12 @@ void SocketChain_AES::setPhase1Key(char *pass)
 int SocketChain_AES::partialRead(void *data, const uint32_t &datalen)
 {
     if (!initialized)
-        return StreamSocket::partialRead(data,datalen);
+        return lowerPartialRead(data,datalen);
 
-    int r = StreamSocket::partialRead(data,datalen);
+    if (aesMode == AES_CHAINMODE_CTR)
+        return partialReadCTR(data,datalen);
+
+    int r = lowerPartialRead(data,datalen);
     if (r<=0) return r;
 
     // Enlarge the buffer to decrypt the requested string...
@@ -69,7 +78,10 @@ int SocketChain_AES::partialRead(void *data, const uint32_t &datalen)
 int SocketChain_AES::partialWrite(const void *data, const uint32_t &datalen)
 {
     if (!initialized)
-        return StreamSocket::partialWrite(data,datalen);
+        return lowerPartialWrite(data,datalen);
+
+    if (aesMode == AES_CHAINMODE_CTR)
+        return partialWriteCTR(data,datalen);
 
     // Copy the data...
     char * edata = new char [datalen];
@@ -87,7 +99,7 @@ int SocketChain_AES::partialWrite(const void *data, const uint32_t &datalen)
     writeParams.cryptoXOR(edata,datalen,true);
 
     // Try to transmit the encrypted data...
-    int r=StreamSocket::partialWrite(edata,datalen);
+    int r=lowerPartialWrite(edata,datalen);
     if (r>0)
     {
         // Data transmited.. reduce it.
@@ -100,6 +112,53 @@ int SocketChain_AES::partialWrite(const void *data, const uint32_t &datalen)
     return r;
 }
 
+int SocketChain_AES::partialReadCTR(void *data, const uint32_t &datalen)
+{
+    int r = lowerPartialRead(data,datalen);
+    if (r<=0) return r;
+
+    // Decrypt in place (CTR is symmetric and keeps the keystream position in the context)
+    int len;
+    if (1 != EVP_EncryptUpdate(readParams.ctx, (unsigned char *)data, &len, (unsigned char *)data, r) || len != r)
+        return -1;
+    return r;
+}
+
+int SocketChain_AES::partialWriteCTR(const void *data, const uint32_t &datalen)
+{
+    if (!datalen) return 0;
+
+    // The previous call was partially transmitted, the caller is retrying with the same data,
+    // that is already encrypted in the buffer (and the keystream already consumed).
+    if (!writeParams.ctrPending)
+    {
+        if (writeParams.ctrBuffer.size()<datalen)
+            writeParams.ctrBuffer.resize(datalen);
+
+        int len;
+        if (1 != EVP_EncryptUpdate(writeParams.ctx, writeParams.ctrBuffer.data(), &len, (const unsigned char *)data, datalen) || len != (int)datalen)
+            return -1;
+        writeParams.ctrPending = datalen;
+    }
+
+    size_t toSend = writeParams.ctrPending<datalen?writeParams.ctrPending:datalen;
+
+    int r=lowerPartialWrite(writeParams.ctrBuffer.data(),toSend);
+    if (r>0)
+    {
+        // Data transmited.. displace the pending bytes.
+        writeParams.ctrPending-=r;
+        if (writeParams.ctrPending)
+            memmove(writeParams.ctrBuffer.data(), writeParams.ctrBuffer.data()+r, writeParams.ctrPending);
+    }
+    return r;
+}
+
+int SocketChain_AES::shutdownSocket(int mode)
+{
+    return lowerShutdownSocket(mode);
+}
+
 bool SocketChain_AES::postAcceptSubInitialization()
 {
     char *p1,*p2;
@@ -118,6 +177,7 @@ bool SocketChain_AES::postAcceptSubInitialization()
     // Create the next local (write) keys...
     genRandomBytes(writeParams.handshake.phase2Key,sizeof(writeParams.handshake.phase2Key));
     genRandomBytes(writeParams.handshake.IVSeed,sizeof(writeParams.handshake.IVSeed));
+    writeParams.handshake.chainMode = aesMode;
     // Create the memory to transmit this...
     char vFirstLoad[sizeof(sHandShakeHeader)];
     memcpy(vFirstLoad,&(writeParams.handshake),sizeof(sHandShakeHeader));
@@ -153,6 +213,9 @@ bool SocketChain_AES::postAcceptSubInitialization()
     // Check the decryption:
     if (memcmp(readParams.handshake.magicBytes,"IHDR",4))
         return false;
+    // Both peers should use the same mode...
+    if (readParams.handshake.chainMode != aesMode)
+        return false;
     // If the decryption is OK... REGEN the AES block...
     readParams.cleanAESBlock();
     // Fill the initial Read IV values on MT engine.
@@ -164,6 +227,13 @@ bool SocketChain_AES::postAcceptSubInitialization()
     // clean the mem...
     memset(vFirstLoad,0,sizeof(sHandShakeHeader));
 
+    if (aesMode == AES_CHAINMODE_CTR)
+    {
+        // The keystream is generated by persistent contexts from phase2Key/IVSeed
+        if (!initCTR(&writeParams) || !initCTR(&readParams))
+            return false;
+    }
+
     initialized = true;
     return true;
 }
@@ -184,51 +254,48 @@ const EVP_CIPHER *SocketChain_AES::openSSLInit()
 
 bool SocketChain_AES::appendNewAESBlock(sSideParams *params, const char *key, const char *iv)
 {
-    // Create the AES block here.
-    char * cipherText = new char [aesRegenBlockSize*2];
+    // Reuse the AES block buffers here.
+    if (params->regenPlainText.size() != aesRegenBlockSize)
+    {
+        params->regenPlainText.resize(aesRegenBlockSize);
+        genPlainText(params->regenPlainText.data());
+    }
+    params->regenCipherText.resize(aesRegenBlockSize*2);
+    unsigned char * cipherText = params->regenCipherText.data();
 
     int len;
-    int cipherText_len;
 
-    // Init AES here.
-    EVP_CIPHER_CTX *ctx;
-    if(!(ctx = EVP_CIPHER_CTX_new()))
+    // Init AES here (the context is created once and reinitialized with the new key/iv).
+    if (!params->ctx && !(params->ctx = EVP_CIPHER_CTX_new()))
         return false;
-    if(1 != EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, (unsigned char *)key, (unsigned char *)iv))
-    {
-        EVP_CIPHER_CTX_free(ctx);
-        delete [] cipherText;
+    if(1 != EVP_EncryptInit_ex(params->ctx, EVP_aes_256_cbc(), nullptr, (unsigned char *)key, (unsigned char *)iv))
         return false;
-    }
 
     // Encrypt the plaintext block
-    char * plainText = genPlainText();
-    if(1 != EVP_EncryptUpdate(ctx, (unsigned char *)cipherText, &len, (unsigned char *)plainText, aesRegenBlockSize))
-    {
-        EVP_CIPHER_CTX_free(ctx);
-        delete [] cipherText;
-        delete [] plainText;
+    if(1 != EVP_EncryptUpdate(params->ctx, cipherText, &len, params->regenPlainText.data(), aesRegenBlockSize))
         return false;
-    }
-    delete [] plainText;
-    cipherText_len = len;
-    if(1 != EVP_EncryptFinal_ex(ctx, (unsigned char *)cipherText + len, &len))
-    {
-        EVP_CIPHER_CTX_free(ctx);
-        delete [] cipherText;
+    if(1 != EVP_EncryptFinal_ex(params->ctx, cipherText + len, &len))
         return false;
-    }
-    cipherText_len += len;
 
-    params->appendAESBlock(cipherText,aesRegenBlockSize);
+    params->appendAESBlock((char *)cipherText,aesRegenBlockSize);
 
-    delete [] cipherText;
     // Now it's encrypted :)
-    EVP_CIPHER_CTX_free(ctx);
+    memset(cipherText,0,params->regenCipherText.size());
 
     return true;
 }
 
+bool SocketChain_AES::initCTR(sSideParams *params)
+{
+    if (!params->ctx && !(params->ctx = EVP_CIPHER_CTX_new()))
+        return false;
+    // CTR is symmetric, the encryption context also decrypts.
+    if(1 != EVP_EncryptInit_ex(params->ctx, EVP_aes_256_ctr(), nullptr, (unsigned char *)params->handshake.phase2Key, (unsigned char *)params->handshake.IVSeed))
+        return false;
+    params->ctrPending = 0;
+    return true;
+}
+
 void SocketChain_AES::genRandomBytes(char *bytes, size_t size)
 {
 #ifdef _WIN32
@@ -323,12 +390,10 @@ void SocketChain_AES::regenIV(sSideParams *param)
     memcpy(param->currentIV+8,&(r64[1]),8);
 }
 
-char *SocketChain_AES::genPlainText()
+void SocketChain_AES::genPlainText(unsigned char *plainText)
 {
-    char * vGen = new char [aesRegenBlockSize];
     for (size_t i=0;i<aesRegenBlockSize;i++)
     {
-        vGen[i] = (i*487)%256;
+        plainText[i] = (i*487)%256;
     }
-    return vGen;
 }
@@ -6,15 +6,28 @@
 #include <openssl/evp.h>
 #include <string.h>
 #include <random>
+#include <vector>
 
 namespace CX2 { namespace Network { namespace Chains { namespace Protocols {
 
+enum eAESChainMode {
+    /**
+     * @brief AES_CHAINMODE_XORBLOCKS XOR with AES-256-CBC blocks regenerated with MT19937 IV's (legacy)
+     */
+    AES_CHAINMODE_XORBLOCKS = 0,
+    /**
+     * @brief AES_CHAINMODE_CTR AES-256-CTR keystream with one persistent EVP context per direction
+     */
+    AES_CHAINMODE_CTR = 1
+};
+
 // 16 bytes sent from very first IV
 // and 112 bytes from this struct... (TOT: 128 bytes)
 struct sHandShakeHeader {
     sHandShakeHeader()
     {
         memcpy(magicBytes,"IHDR",4);
+        chainMode = 0;
         memset(reserved,0,sizeof(reserved));
     }
     ~sHandShakeHeader()
@@ -29,7 +42,9 @@ struct sHandShakeHeader {
     char magicBytes[4];
     char IVSeed[16];
     char phase2Key[32];
-    char reserved[60];
+    // eAESChainMode (legacy peers send zero here)
+    unsigned char chainMode;
+    char reserved[59];
 } __attribute__((packed));
 
 struct sSideParams {
@@ -37,12 +52,15 @@ struct sSideParams {
     {
         aesBlock = nullptr;
         aesBlock_curSize = 0;
+        ctx = nullptr;
+        ctrPending = 0;
     }
     ~sSideParams()
     {
         cleanAESBlock();
         memset(handShakeIV,0,sizeof(handShakeIV));
-
+        if (!ctrBuffer.empty()) memset(ctrBuffer.data(),0,ctrBuffer.size());
+        if (ctx) EVP_CIPHER_CTX_free(ctx);
     }
     void cleanAESBlock( char * nAesBlock = nullptr , size_t nAesBlock_curSize = 0 )
     {
@@ -93,6 +111,23 @@ struct sSideParams {
     sHandShakeHeader handshake;
     char * aesBlock;
     size_t aesBlock_curSize;
+
+    /**
+     * @brief ctx persistent cipher context (reused for every block in this direction)
+     */
+    EVP_CIPHER_CTX * ctx;
+    /**
+     * @brief ctrBuffer reused buffer for the encrypted output (CTR mode)
+     */
+    std::vector<unsigned char> ctrBuffer;
+    /**
+     * @brief ctrPending encrypted bytes in ctrBuffer not transmitted yet (CTR mode)
+     */
+    size_t ctrPending;
+    /**
+     * @brief regenPlainText/regenCipherText reused buffers for the block regeneration (legacy mode)
+     */
+    std::vector<unsigned char> regenPlainText, regenCipherText;
 };
 
 /**
@@ -112,6 +147,12 @@ public:
      * @param value block size.
      */
     void setAESRegenBlockSize(const size_t &value = 1024);
+    /**
+     * @brief setAESMode Set the stream encryption mode used after the handshake,
+     *        should only be used before the communication starts, and both peers should use the same mode.
+     * @param value AES_CHAINMODE_XORBLOCKS (default) or AES_CHAINMODE_CTR
+     */
+    void setAESMode(const eAESChainMode &value = AES_CHAINMODE_XORBLOCKS);
 
     /**
      * @brief setPhase1Key Set Phase 1 (header interchange) AES Key
@@ -124,6 +165,11 @@ public:
     // Overwritten functions:
     int partialRead(void * data, const uint32_t & datalen) override;
     int partialWrite(const void * data, const uint32_t & datalen) override;
+    int shutdownSocket(int mode = SHUT_RDWR) override;
+
+    bool isActive() const override { return isInProcessLayer()? isLowerActive() : StreamSocket::isActive(); }
+    bool isInProcessCapable() override { return true; }
+    bool isRawStream() override { return false; }
 
     bool postAcceptSubInitialization() override;
     bool postConnectSubInitialization() override;
@@ -139,10 +185,16 @@ private:
     bool appendNewAESBlock(sSideParams * params, const char * key, const char * iv);
     void regenIV(sSideParams * param);
     /**
-     * @brief genPlainText Get Plain Text for generating the AES Block.
-     * @return plain text (you should delete it with delete[])
+     * @brief initCTR Initialize the persistent AES-256-CTR context for this direction (after the handshake)
+     */
+    bool initCTR(sSideParams * params);
+    int partialReadCTR(void * data, const uint32_t & datalen);
+    int partialWriteCTR(const void * data, const uint32_t & datalen);
+    /**
+     * @brief genPlainText Fill the Plain Text for generating the AES Block.
+     * @param plainText buffer (aesRegenBlockSize bytes)
      */
-    char * genPlainText();
+    void genPlainText(unsigned char * plainText);
     /**
      * @brief phase1Key Key Negotiation Password... (PSK)
      */
@@ -157,6 +209,7 @@ private:
     sSideParams writeParams;
 
     size_t aesRegenBlockSize;
+    eAESChainMode aesMode;
     bool initialized;
     const static EVP_CIPHER *cipher;
 
@@ -14,13 +14,12 @@ int SocketChain_XOR::partialRead(void *data, const uint32_t &datalen)
 {
     if (!datalen) return 0;
 
-    int r = CX2::Network::Sockets::Socket::partialRead(data,datalen);
+    int r = lowerPartialRead(data,datalen);
     if (r<=0) return r;
 
-    char * datacp = getXorCopy(data,r);
-    if (!datacp) return 0;
-    memcpy(data,datacp,r);
-    delete [] datacp;
+    // XOR in place (the data is already ours)
+    for (int i=0; i<r; i++)
+        ((char *)data)[i] ^= xorByte;
 
     return r;
 }
@@ -32,11 +31,16 @@ int SocketChain_XOR::partialWrite(const void *data, const uint32_t &datalen)
     char * datacp = getXorCopy(data,datalen);
     if (!datacp) return 0;
 
-    int r = CX2::Network::Sockets::Socket::partialWrite(datacp,datalen);
+    int r = lowerPartialWrite(datacp,datalen);
     delete [] datacp;
     return r;
 }
 
+int SocketChain_XOR::shutdownSocket(int mode)
+{
+    return lowerShutdownSocket(mode);
+}
+
 char SocketChain_XOR::getXorByte() const
 {
     return xorByte;
@@ -18,6 +18,11 @@ public:
     // Overwritten functions:
     int partialRead(void * data, const uint32_t & datalen);
     int partialWrite(const void * data, const uint32_t & datalen);
+    int shutdownSocket(int mode = SHUT_RDWR) override;
+
+    bool isActive() const override { return isInProcessLayer()? isLowerActive() : StreamSocket::isActive(); }
+    bool isInProcessCapable() override { return true; }
+    bool isRawStream() override { return false; }
 
     // Private functions:
     char getXorByte() const;
@@ -96,8 +96,11 @@ std::pair<CX2::Network::Streams::StreamSocket *, CX2::Network::Streams::StreamSo
     return std::make_pair (((sChainVectorItem *)socketLayers[layer])->sock[0],((sChainVectorItem *)socketLayers[layer])->sock[1]);
 }
 
-bool ChainSockets::addToChain(SocketChainBase *chainElement)
+bool ChainSockets::addToChain(SocketChainBase *chainElement, bool inProcessIfCapable)
 {
+    if (inProcessIfCapable && chainElement->isInProcessCapable())
+        return addToChainInProcess(chainElement);
+
     return addToChain( chainElement->makeSocketChainPair(),
                              false, // First socket wont be deleted because it's SocketChainXOR (use false here) // TODO: check this
                              true, // Second socket is generated by makeSocketChainPair, should be automatically deleted.
@@ -165,6 +168,48 @@ bool ChainSockets::addToChain(std::pair<CX2::Network::Streams::StreamSocket *, C
     return r;
 }
 
+bool ChainSockets::addToChainInProcess(SocketChainBase *chainElement)
+{
+    if (endPointReached) return false;
+    if (chainElement->isEndPoint()) endPointReached = true;
+
+    CX2::Network::Streams::StreamSocket * lowerLayer = socketLayers.size()==0? baseSocket : ((sChainVectorItem *)socketLayers[socketLayers.size()-1])->sock[0];
+
+    sChainVectorItem * item = new sChainVectorItem;
+
+    // Register on chain (no threads to wait for)
+    item->deleteFirstSocketOnExit = false;
+    item->deleteSecondSocketOnExit = false;
+    item->sock[0] = chainElement->makeInProcessLayer(lowerLayer);
+    item->sock[1] = nullptr;
+    item->modeServer = chainElement->isServerMode();
+    item->inProcess = true;
+    item->detached = true;
+    socketLayers.push_back(item);
+
+    ///////////////////////////////////
+    // Now we init this socket (the handshake goes through the lower layers)...
+    bool r;
+    if (item->modeServer)
+        r = item->sock[0]->postAcceptSubInitialization();
+    else
+        r = item->sock[0]->postConnectSubInitialization();
+
+    if (!r)
+    {
+        item->sock[0]->shutdownSocket();
+    }
+
+    return r;
+}
+
+bool ChainSockets::isActive() const
+{
+    if (socketLayers.size() == 0 && !baseSocket) return false;
+    CX2::Network::Streams::StreamSocket * curSocket = !socketLayers.size()? baseSocket : ((sChainVectorItem *)socketLayers[socketLayers.size()-1])->sock[0];
+    return curSocket->isActive();
+}
+
 int ChainSockets::shutdownSocket(int mode)
 {
     if (socketLayers.size() == 0 && !baseSocket) return -1;
@@ -19,6 +19,14 @@
                    /
  write() -------->*
 
+
+  In-process mode (layers that are isInProcessCapable, eg. XOR/AES):
+
+  read() <-------- layer[n-1] <-------- ... <-------- layer[0] <-------- baseSocket (O/S Network)
+  write() -------> layer[n-1] --------> ... --------> layer[0] --------> baseSocket (O/S Network)
+
+  Each layer transforms the buffer and calls the lower one in the caller's thread (no socketpair, no threads).
+  Both modes can be mixed in the same chain (eg. TLS over in-process AES).
 */
 
 namespace CX2 { namespace Network { namespace Chains {
@@ -32,10 +40,12 @@ struct sChainVectorItem {
         w1[1]=true;
         detached = false;
         finished = false;
+        inProcess = false;
     }
 
     /**
      * @brief sock connected pair sockets (sock[0]: up socket  sock[1]: down socket)
+     *        in-process layers only have sock[0] (sock[1] is nullptr)
      */
     CX2::Network::Streams::StreamSocket * sock[2];
     std::thread thr1,thr2;
@@ -47,6 +57,7 @@ struct sChainVectorItem {
     std::atomic<bool> detached, finished;
     bool deleteFirstSocketOnExit, deleteSecondSocketOnExit;
     bool modeServer;
+    bool inProcess;
 };
 
 struct sChainTElement {
@@ -65,9 +76,11 @@ public:
     /**
      * @brief addToChain Add the chain element to the socket chains...
      * @param chainElement chain element (should be deleted later)
+     * @param inProcessIfCapable if the element is in-process capable, run it as a buffer filter in the caller's thread
+     *                           instead of creating a socketpair and two threads.
      * @return true if successfully initialized
      */
-    bool addToChain(SocketChainBase * chainElement);
+    bool addToChain(SocketChainBase * chainElement, bool inProcessIfCapable = false);
     bool addToChain(std::pair<CX2::Network::Streams::StreamSocket *, CX2::Network::Streams::StreamSocket *> sockPairs,
                     bool deleteFirstSocketOnExit = false,
                     bool deleteSecondSocketOnExit = true,
@@ -87,7 +100,7 @@ public:
      * @brief getLayerReadResultValue Read thread last read error. (don't use before waitUntilFinish)
      * @param layer Layer number [0..n-1]
      * @param fwd true: sock[1]->baseSocket, false: baseSocket->sock[1]
-     * @return socket last read error. (0 shutdown, -1 error, -2 layer does not exist)
+     * @return socket last read error. (0 shutdown, -1 error, -2 layer does not exist, always 0 on in-process layers)
      */
     int getLayerReadResultValue(size_t layer, bool fwd);
     /**
@@ -100,19 +113,22 @@ public:
     /**
      * @brief getSocketPairLayer Get Sockets Pair from layer (don't use with )
      * @param layer layer number [0..n-1]
+     * note: in-process layers return (layer socket, nullptr)
      * @return pair of CX2::Network::Streams::StreamSocket ptr
      */
     std::pair<CX2::Network::Streams::StreamSocket *, CX2::Network::Streams::StreamSocket *> getSocketPairLayer(size_t layer);
 
     ////////////////////
     // virtuals:
+    bool isActive() const override;
+    bool isRawStream() override { return false; }
     int shutdownSocket(int mode = SHUT_WR) override;
     int partialRead(void * data, const uint32_t & datalen) override;
     int partialWrite(const void * data, const uint32_t & datalen) override;
 
 private:
     static void chainThread(sChainTElement * chain);
-
+    bool addToChainInProcess(SocketChainBase * chainElement);
 
 
     bool endPointReached;
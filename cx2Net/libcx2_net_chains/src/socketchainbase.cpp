@@ -6,6 +6,7 @@ using namespace CX2::Network::Chains;
 
 SocketChainBase::SocketChainBase()
 {
+    lowerLayer = nullptr;
     serverMode = false;
 }
 
@@ -19,6 +20,11 @@ bool SocketChainBase::isEndPoint()
     return false;
 }
 
+bool SocketChainBase::isInProcessCapable()
+{
+    return false;
+}
+
 std::pair<CX2::Network::Streams::StreamSocket *, CX2::Network::Streams::StreamSocket *> SocketChainBase::makeSocketChainPair()
 {
     std::pair<CX2::Network::Streams::StreamSocket *, CX2::Network::Streams::StreamSocket *> pair = CX2::Network::Streams::StreamSocket::GetSocketPair();
@@ -32,6 +38,12 @@ std::pair<CX2::Network::Streams::StreamSocket *, CX2::Network::Streams::StreamSo
     return pair;
 }
 
+CX2::Network::Streams::StreamSocket *SocketChainBase::makeInProcessLayer(CX2::Network::Streams::StreamSocket *lowerLayer)
+{
+    this->lowerLayer = lowerLayer;
+    return (CX2::Network::Streams::StreamSocket *)getThis();
+}
+
 bool SocketChainBase::isServerMode() const
 {
     return serverMode;
@@ -42,3 +54,34 @@ void SocketChainBase::setServerMode(bool value)
     serverMode = value;
 }
 
+bool SocketChainBase::isInProcessLayer() const
+{
+    return lowerLayer != nullptr;
+}
+
+bool SocketChainBase::isLowerActive() const
+{
+    return lowerLayer && lowerLayer->isActive();
+}
+
+int SocketChainBase::lowerPartialRead(void *data, const uint32_t &datalen)
+{
+    if (lowerLayer)
+        return lowerLayer->partialRead(data,datalen);
+    return ((CX2::Network::Streams::StreamSocket *)getThis())->Sockets::Socket::partialRead(data,datalen);
+}
+
+int SocketChainBase::lowerPartialWrite(const void *data, const uint32_t &datalen)
+{
+    if (lowerLayer)
+        return lowerLayer->partialWrite(data,datalen);
+    return ((CX2::Network::Streams::StreamSocket *)getThis())->Sockets::Socket::partialWrite(data,datalen);
+}
+
+int SocketChainBase::lowerShutdownSocket(int mode)
+{
+    if (lowerLayer)
+        return lowerLayer->shutdownSocket(mode);
+    return ((CX2::Network::Streams::StreamSocket *)getThis())->Sockets::Socket::shutdownSocket(mode);
+}
+
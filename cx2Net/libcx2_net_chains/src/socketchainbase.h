@@ -14,14 +14,49 @@ public:
     virtual ~SocketChainBase();
 
     virtual bool isEndPoint();
+    /**
+     * @brief isInProcessCapable Check if this layer can work as an in-process buffer filter
+     *        (without an O/S file descriptor).
+     * @return true if the layer only transforms the stream and can run in the caller's thread.
+     */
+    virtual bool isInProcessCapable();
     std::pair<CX2::Network::Streams::StreamSocket *, CX2::Network::Streams::StreamSocket*> makeSocketChainPair();
+    /**
+     * @brief makeInProcessLayer Link this layer on top of the lower layer socket (no socketpair, no threads)
+     * @param lowerLayer lower layer socket (eg. the base socket or the previous layer)
+     * @return this layer as StreamSocket.
+     */
+    CX2::Network::Streams::StreamSocket * makeInProcessLayer(CX2::Network::Streams::StreamSocket * lowerLayer);
     bool isServerMode() const;
     void setServerMode(bool value);
 
 protected:
     virtual void * getThis() = 0;
 
+    /**
+     * @brief isInProcessLayer Check if this layer is linked to a lower layer (in-process mode)
+     */
+    bool isInProcessLayer() const;
+    /**
+     * @brief isLowerActive Check if the lower layer is active (in-process mode only)
+     */
+    bool isLowerActive() const;
+
+    /**
+     * @brief lowerPartialRead Read from the lower layer (in-process mode) or from the socket file descriptor.
+     */
+    int lowerPartialRead(void * data, const uint32_t & datalen);
+    /**
+     * @brief lowerPartialWrite Write to the lower layer (in-process mode) or to the socket file descriptor.
+     */
+    int lowerPartialWrite(const void * data, const uint32_t & datalen);
+    /**
+     * @brief lowerShutdownSocket Shutdown the lower layer (in-process mode) or the socket file descriptor.
+     */
+    int lowerShutdownSocket(int mode);
+
 private:
+    CX2::Network::Streams::StreamSocket * lowerLayer;
     bool serverMode;
 };
 
@@ -6,6 +6,9 @@
 #ifndef WIN32
 #include <sys/ioctl.h>
 #include <linux/if_tun.h>
+#include <linux/if_ether.h>
+#include <poll.h>
+#include <errno.h>
 #include <pwd.h>
 #include <grp.h>
 #include "netifconfig.h"
@@ -20,12 +23,19 @@
 
 using namespace CX2::Network::Interfaces;
 
+#ifndef WIN32
+// sizeof(struct virtio_net_hdr), the default TUNSETVNETHDRSZ (linux/virtio_net.h is not C++ compatible)
+#define VNET_HDR_SIZE 10
+#endif
+
 VirtualNetworkInterface::VirtualNetworkInterface()
 {
 #ifdef WIN32
     fd = INVALID_HANDLE_VALUE;
 #else
     fd = -1;
+    vnetHdr = false;
+    nonBlocking = false;
 #endif
 }
 
@@ -34,7 +44,7 @@ VirtualNetworkInterface::~VirtualNetworkInterface()
     stop();
 }
 
-bool VirtualNetworkInterface::start(NetIfConfig * netcfg, const std::string &netIfaceName)
+bool VirtualNetworkInterface::start(NetIfConfig * netcfg, const std::string &netIfaceName, const uint32_t &queuesCount, bool vnetHdr, bool nonBlocking)
 {
     interfaceName = netIfaceName;
 
@@ -57,36 +67,60 @@ bool VirtualNetworkInterface::start(NetIfConfig * netcfg, const std::string &net
     }
     return fd!=INVALID_HANDLE_VALUE;
 #else
-    // Open the TUN/TAP device...
-    if((fd = open("/dev/net/tun", O_RDWR)) < 0)
+    this->vnetHdr = vnetHdr;
+    this->nonBlocking = nonBlocking;
+
+    // One file descriptor per queue, the first one creates the tun/tap interface and the others are attached to it.
+    for (uint32_t i=0; i<(queuesCount?queuesCount:1); i++)
     {
-        lastError = "/dev/net/tun error";
-        return false;
-    }
+        int qfd;
+        // Open the TUN/TAP device...
+        if((qfd = open("/dev/net/tun", nonBlocking? O_RDWR | O_NONBLOCK : O_RDWR)) < 0)
+        {
+            lastError = "/dev/net/tun error";
+            stop();
+            return false;
+        }
 
-    struct ifreq ifr;
-    memset(&ifr, 0, sizeof(ifr));
+        sQueue * queue = new sQueue;
+        queue->fd = qfd;
+        queues.push_back(queue);
+        if (i == 0)
+            fd = qfd;
 
-    // Create the tun/tap interface.
-    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+        struct ifreq ifr;
+        memset(&ifr, 0, sizeof(ifr));
 
-    if (interfaceName.c_str()[interfaceName.size()-1]>='0' && interfaceName.c_str()[interfaceName.size()-1]<='9')
-    {
-        snprintf(ifr.ifr_name, IFNAMSIZ, "%s",interfaceName.c_str() );
-    }
-    else
-    {
-        snprintf(ifr.ifr_name, IFNAMSIZ, "%s%%d",interfaceName.c_str() );
-    }
+        // Create the tun/tap interface.
+        ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+        if (queuesCount>1)
+            ifr.ifr_flags |= IFF_MULTI_QUEUE;
+        if (vnetHdr)
+            ifr.ifr_flags |= IFF_VNET_HDR;
 
-    if(ioctl(fd, TUNSETIFF, (void*) &ifr) < 0)
-    {
-        lastError = "TUNSETIFF error";
-        stop();
-        return false;
-    }
+        if (i>0)
+        {
+            snprintf(ifr.ifr_name, IFNAMSIZ, "%s",interfaceRealName.c_str() );
+        }
+        else if (interfaceName.c_str()[interfaceName.size()-1]>='0' && interfaceName.c_str()[interfaceName.size()-1]<='9')
+        {
+            snprintf(ifr.ifr_name, IFNAMSIZ, "%s",interfaceName.c_str() );
+        }
+        else
+        {
+            snprintf(ifr.ifr_name, IFNAMSIZ, "%s%%d",interfaceName.c_str() );
+        }
+
+        if(ioctl(qfd, TUNSETIFF, (void*) &ifr) < 0)
+        {
+            lastError = "TUNSETIFF error";
+            stop();
+            return false;
+        }
 
-    interfaceRealName = ifr.ifr_name;
+        if (i == 0)
+            interfaceRealName = ifr.ifr_name;
+    }
     if (netcfg)
     {
         if (netcfg->openInterface(interfaceRealName))
@@ -121,8 +155,12 @@ void VirtualNetworkInterface::stop()
         lastError = "Error closing the device.";
     fd = INVALID_HANDLE_VALUE;
 #else
-    if (fd>=0)
-        close(fd);
+    for (sQueue * queue : queues)
+    {
+        close(queue->fd);
+        delete queue;
+    }
+    queues.clear();
     fd = -1;
 #endif
 }
@@ -131,18 +169,123 @@ void VirtualNetworkInterface::stop()
 #ifndef WIN32
 ssize_t VirtualNetworkInterface::writePacket(const void *packet, unsigned int len)
 {
-    std::unique_lock<std::mutex> lock(mutexWrite);
-    return write(fd,packet,len);
+    if (queues.empty()) return -1;
+    std::unique_lock<std::mutex> lock(queues[0]->mutexWrite);
+    ssize_t r;
+    while ((r=write(fd,packet,len)) < 0 && errno == EAGAIN && waitQueue(fd,POLLOUT,-1))
+    {
+    }
+    return r;
 }
 
 ssize_t VirtualNetworkInterface::readPacket(void *packet, unsigned int len)
 {
-    return read(fd,packet,len);
+    ssize_t r;
+    while ((r=read(fd,packet,len)) < 0 && errno == EAGAIN && waitQueue(fd,POLLIN,-1))
+    {
+    }
+    return r;
+}
+
+ssize_t VirtualNetworkInterface::writePackets(const uint32_t &queue, const std::vector<sVirtualNetworkPacket> &packets)
+{
+    if (queue>=queues.size()) return -1;
+    std::unique_lock<std::mutex> lock(queues[queue]->mutexWrite);
+
+    int qfd = queues[queue]->fd;
+    ssize_t written = 0;
+    for (const sVirtualNetworkPacket & packet : packets)
+    {
+        ssize_t r;
+        while ((r=write(qfd,packet.data,packet.len)) < 0 && errno == EAGAIN && waitQueue(qfd,POLLOUT,-1))
+        {
+        }
+        if (r<0)
+            return written?written:-1;
+        written++;
+    }
+    return written;
 }
 
-int VirtualNetworkInterface::getInterfaceHandler()
+ssize_t VirtualNetworkInterface::readPackets(const uint32_t &queue, unsigned char *arena, const size_t &arenaSize, std::vector<sVirtualNetworkPacket> &packets, const int &timeoutMS)
 {
-    return fd;
+    if (queue>=queues.size()) return -1;
+
+    int qfd = queues[queue]->fd;
+    size_t maxPacketSize = getMaxPacketSize(), offset = 0;
+    ssize_t count = 0;
+
+    // Wait for the first packet:
+    if (!waitQueue(qfd,POLLIN,timeoutMS))
+        return -1;
+
+    // Then take the available ones (one packet per read), stored one after another:
+    while (arenaSize-offset >= maxPacketSize)
+    {
+        // Don't block in a blocking descriptor once the queue is drained (or when the wait timed out):
+        if (!nonBlocking && !isQueueReadable(qfd))
+            break;
+
+        ssize_t r = read(qfd,arena+offset,arenaSize-offset);
+        if (r<0)
+        {
+            if (errno == EAGAIN)
+                break;
+            return count?count:-1;
+        }
+        packets.push_back({arena+offset,static_cast<size_t>(r)});
+        offset+=static_cast<size_t>(r);
+        count++;
+    }
+    return count;
+}
+
+bool VirtualNetworkInterface::waitQueue(const int &qfd, short events, const int &timeoutMS)
+{
+    struct pollfd pfd;
+    pfd.fd = qfd;
+    pfd.events = events;
+    pfd.revents = 0;
+
+    int r;
+    while ((r=poll(&pfd,1,timeoutMS)) < 0 && errno == EINTR)
+    {
+    }
+    // Timeout is not an error (the caller will get EAGAIN/0 packets):
+    return r>=0;
+}
+
+bool VirtualNetworkInterface::isQueueReadable(const int &qfd)
+{
+    struct pollfd pfd;
+    pfd.fd = qfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd,1,0) > 0 && (pfd.revents & POLLIN);
+}
+
+int VirtualNetworkInterface::getInterfaceHandler(const uint32_t &queue)
+{
+    return queue<queues.size()?queues[queue]->fd:-1;
+}
+
+uint32_t VirtualNetworkInterface::getQueuesCount()
+{
+    return static_cast<uint32_t>(queues.size());
+}
+
+size_t VirtualNetworkInterface::getMaxPacketSize()
+{
+    // GSO/GRO packets are up to 64KiB + the ethernet header:
+    return 65535 + ETH_HLEN + (vnetHdr?VNET_HDR_SIZE:0);
+}
+
+bool VirtualNetworkInterface::setOffload(unsigned int flags)
+{
+    if (fd<0 || !vnetHdr) return false;
+    if (ioctl(fd, TUNSETOFFLOAD, flags) < 0)
+        return false;
+    return true;
 }
 
 bool VirtualNetworkInterface::setPersistentMode(bool mode)
@@ -4,6 +4,7 @@
 #include "netifconfig.h"
 #include <string>
 #include <mutex>
+#include <vector>
 #include <stdint.h>
 
 #ifdef WIN32
@@ -14,7 +15,16 @@ namespace CX2 { namespace Network { namespace Interfaces {
 
 // LICENSE WARNING: This class is licensed under GPLv2 (not LGPL) for WIN32 applications.
 
-#ifdef WIN32
+#ifndef WIN32
+struct sVirtualNetworkPacket
+{
+    /**
+     * @brief data packet bytes (into the arena for readPackets), with the virtio_net_hdr if started with vnetHdr
+     */
+    unsigned char * data;
+    size_t len;
+};
+#else
 struct WINTAP_VERSION{
     std::string toString()
     {
@@ -38,9 +48,15 @@ public:
      * @param netcfg Network Configuration to Apply, the inteface will be openned within this function.
      * @param NETCLSID win32: parameter for specifying the classid of the network interface.
      *                 linux: network interface name (eg. tun100 or tun%d)
+     * @param queuesCount linux: number of queues (IFF_MULTI_QUEUE if more than one), one file descriptor per queue,
+     *                    the kernel distributes the packets between them, so each worker can read/write its own queue.
+     * @param vnetHdr linux: prefix each packet with the virtio_net_hdr (IFF_VNET_HDR), required by setOffload.
+     * @param nonBlocking linux: open the queue descriptors with O_NONBLOCK (for an external event loop using getInterfaceHandler),
+     *                    the read/write functions of this class block (or wait) in both modes, but readPackets drains
+     *                    a blocking queue with one extra poll per packet.
      * @return true if started.
      */
-    bool start(NetIfConfig * netcfg = nullptr, const std::string & netIfaceName = "");
+    bool start(NetIfConfig * netcfg = nullptr, const std::string & netIfaceName = "", const uint32_t & queuesCount = 1, bool vnetHdr = false, bool nonBlocking = false);
     /**
      * @brief stop Stop the TAP Interface.
      */
@@ -79,10 +95,27 @@ public:
      */
     bool setGroup(const char * groupName);
     /**
-     * @brief getInterfaceHandler Get Interface Handler (file descriptor)
+     * @brief setOffload Set the offloads accepted by the application (TUNSETOFFLOAD, eg. TUN_F_CSUM|TUN_F_TSO4|TUN_F_TSO6),
+     *                   then the kernel can read/write GSO/GRO coalesced packets of up to 64KiB (described in the
+     *                   virtio_net_hdr). Requires vnetHdr.
+     * @param flags TUN_F_* flags
+     * @return true if succeed.
+     */
+    bool setOffload(unsigned int flags);
+    /**
+     * @brief getInterfaceHandler Get Interface Handler (file descriptor, non-blocking if started with nonBlocking)
+     * @param queue queue number
      * @return file descriptor
      */
-    int getInterfaceHandler();
+    int getInterfaceHandler(const uint32_t & queue = 0);
+    /**
+     * @brief getQueuesCount Get the number of opened queues
+     */
+    uint32_t getQueuesCount();
+    /**
+     * @brief getMaxPacketSize Max size of one packet (including the virtio_net_hdr if enabled)
+     */
+    size_t getMaxPacketSize();
 
     //////////////////////////////////////////////
     /**
@@ -99,6 +132,24 @@ public:
      * @return packet bytes read.
      */
     ssize_t readPacket(void *packet, unsigned int len);
+    /**
+     * @brief writePackets Write the packets to the interface queue (sync)
+     * @param queue queue number
+     * @param packets packets to write.
+     * @return number of packets written, or -1 on error.
+     */
+    ssize_t writePackets(const uint32_t & queue, const std::vector<sVirtualNetworkPacket> & packets);
+    /**
+     * @brief readPackets Wait for the first packet, then read the packets already available on the interface queue,
+     *                    one after another into the arena (while there is space for a max sized packet).
+     * @param queue queue number
+     * @param arena buffer to store the packets.
+     * @param arenaSize arena size in bytes (at least getMaxPacketSize()).
+     * @param packets the read packets are appended here (pointing to the arena).
+     * @param timeoutMS time to wait for the first packet in milliseconds (-1 for no timeout).
+     * @return number of packets read (0 on timeout), or -1 on error.
+     */
+    ssize_t readPackets(const uint32_t & queue, unsigned char * arena, const size_t & arenaSize, std::vector<sVirtualNetworkPacket> & packets, const int & timeoutMS = -1);
 #else
     // Windows specific functions:
     /**
@@ -149,10 +200,29 @@ public:
 #endif
 
 private:
+#ifndef WIN32
+    struct sQueue
+    {
+        int fd;
+        /**
+         * @brief mutexWrite Mutex used for write operations
+         */
+        std::mutex mutexWrite;
+    };
+    bool waitQueue(const int & qfd, short events, const int & timeoutMS);
+    bool isQueueReadable(const int & qfd);
+
+    /**
+     * @brief queues Queues (the first one is fd)
+     */
+    std::vector<sQueue *> queues;
+    bool vnetHdr, nonBlocking;
+#else
     /**
      * @brief mutexWrite Mutex used for write operations
      */
     std::mutex mutexWrite;
+#endif
     /**
      * @brief lastError Last error string
      */
@@ -7,6 +7,7 @@ SOURCES += \
     src/bridge/streamsocketsbridge.cpp \
     src/bridge/streamsocketsbridge_thread.cpp \
     src/crypto/cryptostream.cpp \
+    src/datagrams/datagramblockpool.cpp \
     src/datagrams/datagramsocket.cpp \
     src/socket.cpp \
     src/socket_tcp.cpp \
@@ -24,6 +25,7 @@ HEADERS += \
     src/bridge/streamsocketsbridge.h \
     src/bridge/streamsocketsbridge_thread.h \
     src/crypto/cryptostream.h \
+    src/datagrams/datagramblockpool.h \
     src/datagrams/datagramsocket.h \
     src/socket.h \
     src/socket_tcp.h \
@@ -39,6 +41,14 @@ HEADERS += \
 !win32:SOURCES+=src/socket_unix.cpp
 !win32:HEADERS+=src/socket_unix.h
 
+# Zero-copy epoll bridges (splice) are only available on linux.
+linux:SOURCES+=src/bridge/streamsocketsbridge_epoll.cpp
+linux:HEADERS+=src/bridge/streamsocketsbridge_epoll.h
+
+# io_uring stream engine is only available on linux.
+linux:SOURCES+=src/streams/streamsockets_uring.cpp
+linux:HEADERS+=src/streams/streamsockets_uring.h
+
 win32:LIBS+= -L$$PREFIX/lib -lcx2_thr_threads2 -lcx2_hlp_functions2 -lcx2_mem_vars2 -lssl -lcrypto -lws2_32
 
 # -lcx2_thr_mutex2 -lcx2_thr_safecontainers2 -lcx2_hlp_functions2
@@ -108,6 +108,8 @@ public:
     void setCustomPipeProcessor(StreamsSocketsBridge_Thread *value, bool deleteOnExit = false);
 
 private:
+    friend class StreamSocketsBridge_EPoll;
+
     static void remotePeerThread(StreamSocketsBridge * stp);
 
     static void pipeThread(StreamSocketsBridge * stp);
@@ -0,0 +1,270 @@
+#include "streamsocketsbridge_epoll.h"
+
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+using namespace CX2::Network::Streams;
+
+// Max splice rounds for a direction before giving the thread to other bridges.
+#define EPOLL_BRIDGE_MAX_ROUNDS 16
+
+StreamSocketsBridge_EPoll::StreamSocketsBridge_EPoll()
+{
+    epollFD = epoll_create1(EPOLL_CLOEXEC);
+    stopping = false;
+    setBlockSize();
+}
+
+StreamSocketsBridge_EPoll::~StreamSocketsBridge_EPoll()
+{
+    stop();
+
+    // Threads are down, finalize the remaining bridges.
+    std::set<sEPollBridge *> remaining;
+    {
+        std::lock_guard<std::mutex> lock(mtBridges);
+        remaining = bridges;
+    }
+    for (sEPollBridge * item : remaining)
+    {
+        item->bridge->socket_peers[0]->shutdownSocket();
+        item->bridge->socket_peers[1]->shutdownSocket();
+        finalizeBridge(item);
+    }
+
+    if (epollFD!=-1) close(epollFD);
+}
+
+bool StreamSocketsBridge_EPoll::start(const size_t &threadsCount)
+{
+    if (epollFD == -1 || !threads.empty()) return false;
+
+    stopping = false;
+    for (size_t i=0; i<threadsCount; i++)
+        threads.push_back(std::thread(epollThread, this));
+
+    return true;
+}
+
+void StreamSocketsBridge_EPoll::stop()
+{
+    stopping = true;
+    for (std::thread & thr : threads)
+        thr.join();
+    threads.clear();
+}
+
+bool StreamSocketsBridge_EPoll::addBridge(StreamSocketsBridge *bridge)
+{
+    if (epollFD == -1) return false;
+
+    StreamSocket ** peers = bridge->socket_peers;
+    if (!peers[0] || !peers[1] || !peers[0]->isRawStream() || !peers[1]->isRawStream())
+        return false;
+
+    sEPollBridge * item = new sEPollBridge;
+    item->bridge = bridge;
+
+    bool ok = true;
+    for (unsigned char cur=0; cur<2; cur++)
+    {
+        sEPollBridgeDirection * dir = &(item->dirs[cur]);
+        dir->bridge = item;
+        dir->cur = cur;
+        dir->srcFD = peers[cur]->getSocketFD();
+        dir->outFD = dup(peers[cur==0?1:0]->getSocketFD());
+        if (dir->outFD == -1 || pipe2(dir->pipeFD, O_NONBLOCK|O_CLOEXEC) == -1)
+            ok = false;
+    }
+
+    if (!ok || !peers[0]->setBlockingMode(false) || !peers[1]->setBlockingMode(false))
+    {
+        for (unsigned char cur=0; cur<2; cur++)
+        {
+            sEPollBridgeDirection * dir = &(item->dirs[cur]);
+            if (dir->outFD!=-1) close(dir->outFD);
+            if (dir->pipeFD[0]!=-1) close(dir->pipeFD[0]);
+            if (dir->pipeFD[1]!=-1) close(dir->pipeFD[1]);
+        }
+        peers[0]->setBlockingMode(true);
+        peers[1]->setBlockingMode(true);
+        delete item;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtBridges);
+        bridges.insert(item);
+    }
+
+    // Register both sources (from now, the epoll threads own the item).
+    for (unsigned char cur=0; cur<2; cur++)
+    {
+        struct epoll_event ev;
+        ev.events = EPOLLIN|EPOLLRDHUP|EPOLLONESHOT;
+        ev.data.ptr = &(item->dirs[cur]);
+        if (epoll_ctl(epollFD, EPOLL_CTL_ADD, item->dirs[cur].srcFD, &ev) == -1)
+            finishDirection(&(item->dirs[cur]),-1);
+    }
+
+    return true;
+}
+
+size_t StreamSocketsBridge_EPoll::getActiveBridges()
+{
+    std::lock_guard<std::mutex> lock(mtBridges);
+    return bridges.size();
+}
+
+void StreamSocketsBridge_EPoll::setBlockSize(const uint32_t &value)
+{
+    blockSize = value;
+}
+
+void StreamSocketsBridge_EPoll::epollThread(StreamSocketsBridge_EPoll *mgr)
+{
+    struct epoll_event events[64];
+    while (!mgr->stopping)
+    {
+        int n = epoll_wait(mgr->epollFD, events, 64, 250);
+        for (int i=0; i<n; i++)
+        {
+            // Registrations are one-shot, only this thread is handling this direction now.
+            mgr->processDirection((sEPollBridgeDirection *)events[i].data.ptr);
+        }
+    }
+}
+
+void StreamSocketsBridge_EPoll::processDirection(sEPollBridgeDirection *dir)
+{
+    StreamSocketsBridge * bridge = dir->bridge->bridge;
+    std::atomic<uint64_t> * bytesCounter = dir->cur==0?&(bridge->sentBytes):&(bridge->recvBytes);
+
+    for (size_t round=0; round<EPOLL_BRIDGE_MAX_ROUNDS; round++)
+    {
+        if (dir->inPipe)
+        {
+            // Pipe -> destination socket
+            ssize_t bytesSent = splice(dir->pipeFD[0], nullptr, dir->outFD, nullptr, dir->inPipe, SPLICE_F_MOVE|SPLICE_F_NONBLOCK|SPLICE_F_MORE);
+            if (bytesSent>0)
+            {
+                dir->inPipe-=bytesSent;
+                *bytesCounter+=bytesSent;
+            }
+            else if (bytesSent<0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                if (!armOut(dir)) finishDirection(dir,-2);
+                return;
+            }
+            else
+            {
+                finishDirection(dir,-2);
+                return;
+            }
+        }
+        else
+        {
+            // Source socket -> pipe
+            ssize_t bytesReceived = splice(dir->srcFD, nullptr, dir->pipeFD[1], nullptr, blockSize, SPLICE_F_MOVE|SPLICE_F_NONBLOCK);
+            if (bytesReceived>0)
+                dir->inPipe+=bytesReceived;
+            else if (bytesReceived<0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                if (!armIn(dir)) finishDirection(dir,-1);
+                return;
+            }
+            else
+            {
+                finishDirection(dir,-1);
+                return;
+            }
+        }
+    }
+
+    // Too much work in this direction, give other bridges the chance to run.
+    if (dir->inPipe)
+    {
+        if (!armOut(dir)) finishDirection(dir,-2);
+    }
+    else if (!armIn(dir)) finishDirection(dir,-1);
+}
+
+bool StreamSocketsBridge_EPoll::armIn(sEPollBridgeDirection *dir)
+{
+    struct epoll_event ev;
+    ev.events = EPOLLIN|EPOLLRDHUP|EPOLLONESHOT;
+    ev.data.ptr = dir;
+    return epoll_ctl(epollFD, EPOLL_CTL_MOD, dir->srcFD, &ev) == 0;
+}
+
+bool StreamSocketsBridge_EPoll::armOut(sEPollBridgeDirection *dir)
+{
+    struct epoll_event ev;
+    ev.events = EPOLLOUT|EPOLLONESHOT;
+    ev.data.ptr = dir;
+    // The output is registered only when needed (unarmed registrations could report EPOLLHUP)
+    if (!dir->outRegistered)
+    {
+        dir->outRegistered = true;
+        return epoll_ctl(epollFD, EPOLL_CTL_ADD, dir->outFD, &ev) == 0;
+    }
+    return epoll_ctl(epollFD, EPOLL_CTL_MOD, dir->outFD, &ev) == 0;
+}
+
+void StreamSocketsBridge_EPoll::finishDirection(sEPollBridgeDirection *dir, int reason)
+{
+    StreamSocketsBridge * bridge = dir->bridge->bridge;
+    unsigned char next = dir->cur==0?1:0;
+
+    // Same behavior as StreamSocketsBridge::processPeer
+    if (reason==-1 && bridge->shutdownRemotePeerOnFinish)
+    {
+        bridge->socket_peers[next]->shutdownSocket();
+        bridge->finishingPeer = dir->cur;
+    }
+
+    // The last direction finalize the bridge.
+    if (dir->bridge->finishedDirections.fetch_add(1) == 1)
+        finalizeBridge(dir->bridge);
+}
+
+void StreamSocketsBridge_EPoll::finalizeBridge(sEPollBridge *item)
+{
+    StreamSocketsBridge * bridge = item->bridge;
+
+    {
+        std::lock_guard<std::mutex> lock(mtBridges);
+        bridges.erase(item);
+    }
+
+    for (unsigned char cur=0; cur<2; cur++)
+    {
+        sEPollBridgeDirection * dir = &(item->dirs[cur]);
+        epoll_ctl(epollFD, EPOLL_CTL_DEL, dir->srcFD, nullptr);
+        if (dir->outRegistered) epoll_ctl(epollFD, EPOLL_CTL_DEL, dir->outFD, nullptr);
+        close(dir->outFD);
+        close(dir->pipeFD[0]);
+        close(dir->pipeFD[1]);
+    }
+    delete item;
+
+    // All connections terminated.
+    if (bridge->closeRemotePeerOnFinish)
+    {
+        // close them also.
+        bridge->socket_peers[1]->closeSocket();
+        bridge->socket_peers[0]->closeSocket();
+    }
+    else
+    {
+        bridge->socket_peers[0]->setBlockingMode(true);
+        bridge->socket_peers[1]->setBlockingMode(true);
+    }
+
+    if (bridge->isAutoDeleteStreamPipeOnThreadExit())
+    {
+        delete bridge;
+    }
+}
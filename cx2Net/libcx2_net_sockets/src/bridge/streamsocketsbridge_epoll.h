@@ -0,0 +1,124 @@
+#ifndef STREAMSOCKETSBRIDGE_EPOLL_H
+#define STREAMSOCKETSBRIDGE_EPOLL_H
+
+#include "streamsocketsbridge.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace CX2 { namespace Network { namespace Streams {
+
+struct sEPollBridge;
+
+struct sEPollBridgeDirection {
+    sEPollBridgeDirection()
+    {
+        bridge = nullptr;
+        cur = 0;
+        srcFD = -1;
+        outFD = -1;
+        outRegistered = false;
+        pipeFD[0] = -1;
+        pipeFD[1] = -1;
+        inPipe = 0;
+    }
+
+    sEPollBridge * bridge;
+    /**
+     * @brief cur source peer number (0: peer 0 -> peer 1, 1: peer 1 -> peer 0)
+     */
+    unsigned char cur;
+    /**
+     * @brief srcFD source socket (waits for EPOLLIN)
+     */
+    int srcFD;
+    /**
+     * @brief outFD dup() of the destination socket (waits for EPOLLOUT, the original fd is already registered for input)
+     */
+    int outFD;
+    bool outRegistered;
+    /**
+     * @brief pipeFD intermediate pipe used by splice, also works as the buffer when the destination blocks.
+     */
+    int pipeFD[2];
+    size_t inPipe;
+};
+
+struct sEPollBridge {
+    sEPollBridge()
+    {
+        bridge = nullptr;
+        finishedDirections = 0;
+    }
+    StreamSocketsBridge * bridge;
+    sEPollBridgeDirection dirs[2];
+    std::atomic<int> finishedDirections;
+};
+
+/**
+ * @brief The StreamSocketsBridge_EPoll class serve many raw stream bridges (eg. TCP<->TCP, TCP<->UNIX)
+ *        from a small set of threads using epoll and zero-copy splice (Linux only).
+ *        Bridges with TLS/chained sockets or custom pipe processors should use StreamSocketsBridge::start.
+ */
+class StreamSocketsBridge_EPoll
+{
+public:
+    StreamSocketsBridge_EPoll();
+    /**
+     * @brief ~StreamSocketsBridge_EPoll stop the threads, and finalize the remaining bridges.
+     */
+    ~StreamSocketsBridge_EPoll();
+    /**
+     * @brief start Start the epoll threads.
+     * @param threadsCount number of threads serving the bridges.
+     * @return true if initialized, false if not.
+     */
+    bool start(const size_t & threadsCount = 2);
+    /**
+     * @brief stop Stop the epoll threads (the bridges are kept until destruction).
+     */
+    void stop();
+    /**
+     * @brief addBridge Serve a bridge from the epoll threads, sockets are going to be in non-blocking mode while bridged.
+     *                  The bridge shutdown/close/auto-delete options are honored when both peers finish.
+     * @param bridge bridge with both peers configured (both should be raw streams)
+     * @return true if added, false if not (eg. peers not raw streams, or out of file descriptors)
+     */
+    bool addBridge(StreamSocketsBridge * bridge);
+    /**
+     * @brief getActiveBridges Get the number of bridges in progress
+     * @return number of bridges
+     */
+    size_t getActiveBridges();
+    /**
+     * @brief setBlockSize Set the max bytes moved in every splice operation
+     * @param value block size, default 65536
+     */
+    void setBlockSize(const uint32_t &value = 65536);
+
+private:
+    static void epollThread(StreamSocketsBridge_EPoll * mgr);
+
+    void processDirection(sEPollBridgeDirection * dir);
+    bool armIn(sEPollBridgeDirection * dir);
+    bool armOut(sEPollBridgeDirection * dir);
+    void finishDirection(sEPollBridgeDirection * dir, int reason);
+    void finalizeBridge(sEPollBridge * item);
+
+    int epollFD;
+    std::atomic<bool> stopping;
+    std::atomic<uint32_t> blockSize;
+    std::vector<std::thread> threads;
+
+    std::mutex mtBridges;
+    std::set<sEPollBridge *> bridges;
+};
+
+}}}
+
+#endif // STREAMSOCKETSBRIDGE_EPOLL_H
@@ -1,5 +1,10 @@
 #include "streamsocketsbridge_thread.h"
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace CX2::Network::Streams;
 
 StreamsSocketsBridge_Thread::StreamsSocketsBridge_Thread()
@@ -7,12 +12,23 @@ StreamsSocketsBridge_Thread::StreamsSocketsBridge_Thread()
     block_fwd = nullptr;
     block_rev = nullptr;
     setBlockSize(8192);
+#ifdef __linux__
+    spliceFD[0][0] = spliceFD[0][1] = -1;
+    spliceFD[1][0] = spliceFD[1][1] = -1;
+#endif
 }
 
 StreamsSocketsBridge_Thread::~StreamsSocketsBridge_Thread()
 {
     delete [] block_fwd;
     delete [] block_rev;
+#ifdef __linux__
+    for (int i=0;i<2;i++)
+    {
+        if (spliceFD[i][0]!=-1) close(spliceFD[i][0]);
+        if (spliceFD[i][1]!=-1) close(spliceFD[i][1]);
+    }
+#endif
 }
 
 void StreamsSocketsBridge_Thread::setStreamSockets(StreamSocket *src, StreamSocket *dst)
@@ -54,6 +70,11 @@ bool StreamsSocketsBridge_Thread::writeBlockL(const void *data, const uint32_t &
 
 int StreamsSocketsBridge_Thread::simpleProcessPipe(bool fwd)
 {
+#ifdef __linux__
+    if (src->isRawStream() && dst->isRawStream())
+        return spliceProcessPipe(fwd);
+#endif
+
     char * curBlock = fwd?block_fwd:block_rev;
 
     int bytesReceived;
@@ -70,3 +91,31 @@ int StreamsSocketsBridge_Thread::partialReadL(void *data, const uint32_t &datale
 {
     return (fwd?src:dst)->partialRead(data,datalen);
 }
+
+#ifdef __linux__
+int StreamsSocketsBridge_Thread::spliceProcessPipe(bool fwd)
+{
+    int * pipeFD = spliceFD[fwd?0:1];
+    StreamSocket * srcX = fwd?src:dst, * dstX = fwd?dst:src;
+
+    if (pipeFD[0] == -1 && pipe(pipeFD) == -1)
+    {
+        pipeFD[0] = pipeFD[1] = -1;
+        return -2;
+    }
+
+    // Move the data from the src socket into the pipe (no user-space copy)...
+    ssize_t bytesReceived = splice(srcX->getSocketFD(), nullptr, pipeFD[1], nullptr, blockSize, SPLICE_F_MOVE|SPLICE_F_MORE);
+    if (bytesReceived<=0) return -1;
+
+    // And from the pipe into the dst socket.
+    std::lock_guard<std::mutex> lock(fwd?mt_fwd:mt_rev);
+    for (ssize_t left = bytesReceived; left>0;)
+    {
+        ssize_t bytesSent = splice(pipeFD[0], nullptr, dstX->getSocketFD(), nullptr, left, SPLICE_F_MOVE|SPLICE_F_MORE);
+        if (bytesSent<=0) return -2;
+        left-=bytesSent;
+    }
+    return bytesReceived;
+}
+#endif
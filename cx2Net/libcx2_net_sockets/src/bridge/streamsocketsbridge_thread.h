@@ -57,7 +57,18 @@ private:
      * @return -1 if src terminated the connection, -2 if dst terminated the connection, otherwise, bytes processed.
      */
     int simpleProcessPipe(bool fwd);
-
+#ifdef __linux__
+    /**
+     * @brief spliceProcessPipe zero-copy pipe processor (kernel socket->pipe->socket using splice)
+     *                          only used when both sockets are raw streams.
+     * @return -1 if src terminated the connection, -2 if dst terminated the connection, otherwise, bytes processed.
+     */
+    int spliceProcessPipe(bool fwd);
+    /**
+     * @brief spliceFD splice intermediate pipes (0: fwd, 1: rev), -1 if not created yet.
+     */
+    int spliceFD[2][2];
+#endif
 
     StreamSocket * dst;
     char * block_rev;
@@ -0,0 +1,74 @@
+#include "datagramblockpool.h"
+
+using namespace CX2::Network::Sockets::Datagram;
+
+void BlockView::release()
+{
+    pool->release(this);
+}
+
+BlockPool::BlockPool(const size_t &blocksCount, const size_t &blockSize)
+{
+    this->blockSize = blockSize;
+    buffer = new unsigned char[blocksCount*blockSize];
+
+    blocks.resize(blocksCount);
+    freeBlocks.reserve(blocksCount);
+    for (size_t i=0; i<blocksCount; i++)
+    {
+        blocks[i].addrlen = 0;
+        blocks[i].data = buffer + i*blockSize;
+        blocks[i].datalen = -1;
+        blocks[i].truncated = false;
+        blocks[i].pool = this;
+        freeBlocks.push_back(&blocks[i]);
+    }
+}
+
+BlockPool::~BlockPool()
+{
+    delete [] buffer;
+}
+
+size_t BlockPool::acquire(std::vector<BlockView *> &blocks, const size_t &count)
+{
+    std::unique_lock<std::mutex> lock(mutexFree);
+    size_t r = 0;
+    while (r<count && !freeBlocks.empty())
+    {
+        blocks.push_back(freeBlocks.back());
+        freeBlocks.pop_back();
+        r++;
+    }
+    return r;
+}
+
+BlockView *BlockPool::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutexFree);
+    if (freeBlocks.empty())
+        return nullptr;
+    BlockView * r = freeBlocks.back();
+    freeBlocks.pop_back();
+    return r;
+}
+
+void BlockPool::release(BlockView *block)
+{
+    block->addrlen = 0;
+    block->datalen = -1;
+
+    std::unique_lock<std::mutex> lock(mutexFree);
+    freeBlocks.push_back(block);
+}
+
+size_t BlockPool::getBlockSize() const
+{
+    return blockSize;
+}
+
+size_t BlockPool::getFreeBlocks()
+{
+    std::unique_lock<std::mutex> lock(mutexFree);
+    return freeBlocks.size();
+}
@@ -0,0 +1,98 @@
+#ifndef DATAGRAMBLOCKPOOL_H
+#define DATAGRAMBLOCKPOOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+#include <mutex>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#endif
+
+namespace CX2 { namespace Network { namespace Sockets { namespace Datagram {
+
+class BlockPool;
+
+/**
+ * @brief BlockView Datagram on a pool buffer (no copies), give it back with release() when done.
+ */
+struct BlockView
+{
+    /**
+     * @brief release Return the buffer to the pool (the view can't be used after this)
+     */
+    void release();
+
+    /**
+     * @brief addr source address (received) or destination address (to send, if addrlen is 0 the socket remote
+     *             address is used)
+     */
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    /**
+     * @brief data pool buffer (BlockPool::getBlockSize() bytes)
+     */
+    unsigned char * data;
+    /**
+     * @brief datalen datagram size in bytes
+     */
+    int datalen;
+    /**
+     * @brief truncated the received datagram was larger than the block (only the first datalen bytes were kept)
+     */
+    bool truncated;
+
+    BlockPool * pool;
+};
+
+/**
+ * @brief BlockPool Fixed set of datagram buffers in one allocation, recycled between the batched reads/writes.
+ */
+class BlockPool
+{
+public:
+    /**
+     * @brief BlockPool
+     * @param blocksCount number of buffers
+     * @param blockSize buffer size (the default fits the datagrams of an ethernet MTU, use 65536 for any UDP datagram,
+     *                  larger datagrams are received as truncated)
+     */
+    BlockPool(const size_t & blocksCount = 256, const size_t & blockSize = 2048);
+    ~BlockPool();
+
+    /**
+     * @brief acquire Take up to count free blocks
+     * @param blocks the taken blocks are appended here
+     * @param count max blocks to take
+     * @return number of taken blocks (0 if the pool is exhausted)
+     */
+    size_t acquire(std::vector<BlockView *> & blocks, const size_t & count);
+    /**
+     * @brief acquire Take one free block
+     * @return block or nullptr if the pool is exhausted
+     */
+    BlockView * acquire();
+    /**
+     * @brief release Give back the block to the pool
+     */
+    void release(BlockView * block);
+
+    size_t getBlockSize() const;
+    size_t getFreeBlocks();
+
+private:
+    unsigned char * buffer;
+    size_t blockSize;
+    std::vector<BlockView> blocks;
+    std::vector<BlockView *> freeBlocks;
+    std::mutex mutexFree;
+};
+
+}}}}
+
+#endif // DATAGRAMBLOCKPOOL_H
@@ -474,6 +474,11 @@ bool Socket::setReadTimeout(unsigned int _timeout)
     return true;
 }
 
+unsigned int Socket::getReadTimeout() const
+{
+    return readTimeout;
+}
+
 bool Socket::setWriteTimeout(unsigned int _timeout)
 {
     if (!isActive()) return false;
@@ -516,6 +521,11 @@ int Socket::adquireSocketFD()
     return sockret;
 }
 
+int Socket::getSocketFD() const
+{
+    return sockfd;
+}
+
 void Socket::getRemotePair(char * address) const
 {
     strncpy(address, remotePair, INET6_ADDRSTRLEN);
@@ -60,6 +60,11 @@ public:
      * @param _timeout timeout in seconds
      */
     bool setReadTimeout(unsigned int _timeout);
+    /**
+     * Get Read timeout.
+     * @return timeout in seconds (0: no timeout)
+     */
+    unsigned int getReadTimeout() const;
     /**
      * Set Write timeout.
      * @param _timeout timeout in seconds
@@ -91,6 +96,11 @@ public:
      * @return socket file descriptor
      */
     int adquireSocketFD();
+    /**
+     * Get Current Socket file descriptor (the object keeps the ownership)
+     * @return socket file descriptor (-1 if not initialized)
+     */
+    int getSocketFD() const;
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Socket Status:
@@ -98,7 +108,7 @@ public:
      * Check if we have an initialized socket.
      * @return true if the socket is a valid file descriptor
      */
-    bool isActive() const;
+    virtual bool isActive() const;
     /**
      * Check if the remote pair is connected or not.
      * @param true if is it connected
@@ -231,6 +241,12 @@ public:
     virtual int iShutdown(int mode = SHUT_RDWR);
 
     virtual bool isSecure() { return false; };
+    /**
+     * @brief isRawStream Check if the data goes as is to the file descriptor (no protocol transformation in partialRead/partialWrite)
+     *                    useful for zero-copy operations (eg. splice)
+     * @return true if the socket does not transform the data.
+     */
+    virtual bool isRawStream() { return false; };
 
     /**
      * @brief getUseIPv6 Get if using IPv6 Functions
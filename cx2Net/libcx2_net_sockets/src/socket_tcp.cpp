@@ -332,6 +332,11 @@ bool Socket_TCP::isSecure()
 {
     return false;
 }
+
+bool Socket_TCP::isRawStream()
+{
+    return true;
+}
 /*
 bool Socket_TCP::postConnectSubInitialization()
 {
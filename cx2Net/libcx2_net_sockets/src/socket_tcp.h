@@ -56,6 +56,11 @@ public:
     void overrideWriteTimeout(int32_t tout = -1);
 
     virtual bool isSecure() override;
+    /**
+     * @brief isRawStream The data goes as is to the file descriptor (sub-classes like TLS override it)
+     * @return true
+     */
+    virtual bool isRawStream() override;
 
 protected:
 
@@ -271,6 +271,8 @@ int Socket_TLS::iShutdown(int mode)
 
 bool Socket_TLS::isSecure() { return true; }
 
+bool Socket_TLS::isRawStream() { return false; }
+
 std::string Socket_TLS::getCertificateAuthorityPath() const
 {
     return ca_file;
@@ -142,6 +142,7 @@ public:
     int iShutdown(int mode) override;
 
     bool isSecure() override;
+    bool isRawStream() override;
 
 
 protected:
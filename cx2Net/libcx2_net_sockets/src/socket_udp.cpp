@@ -160,3 +160,109 @@ std::shared_ptr<Datagram::Block> Socket_UDP::readBlock()
     return datagramBlock;
 }
 
+
+int Socket_UDP::readBlocks(Datagram::BlockPool *pool, std::vector<Datagram::BlockView *> &blocks, const size_t &maxBlocks)
+{
+    if (!isActive()) return -1;
+
+    size_t first = blocks.size();
+    size_t count = pool->acquire(blocks,maxBlocks);
+    if (!count) return 0;
+
+    int received;
+#ifdef __linux__
+    readHeaders.resize(count);
+    readIov.resize(count);
+    for (size_t i=0; i<count; i++)
+    {
+        Datagram::BlockView * block = blocks[first+i];
+        readIov[i].iov_base = block->data;
+        readIov[i].iov_len = pool->getBlockSize();
+        memset(&readHeaders[i],0,sizeof(struct mmsghdr));
+        readHeaders[i].msg_hdr.msg_name = &(block->addr);
+        readHeaders[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        readHeaders[i].msg_hdr.msg_iov = &readIov[i];
+        readHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Wait for one, then take what is available:
+    received = recvmmsg(sockfd, readHeaders.data(), static_cast<unsigned int>(count), MSG_WAITFORONE, nullptr);
+    for (int i=0; i<received; i++)
+    {
+        blocks[first+i]->datalen = static_cast<int>(readHeaders[i].msg_len);
+        blocks[first+i]->addrlen = readHeaders[i].msg_hdr.msg_namelen;
+        blocks[first+i]->truncated = (readHeaders[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+#else
+    // One datagram per call:
+    Datagram::BlockView * block = blocks[first];
+    block->addrlen = sizeof(struct sockaddr_storage);
+    block->datalen = recvfrom(sockfd, (char *) block->data, static_cast<int>(pool->getBlockSize()), 0, (struct sockaddr *) &(block->addr), &(block->addrlen));
+    block->truncated = false;
+#ifdef _WIN32
+    // The buffer is filled, but the rest of the datagram is discarded:
+    if (block->datalen<0 && WSAGetLastError()==WSAEMSGSIZE)
+    {
+        block->datalen = static_cast<int>(pool->getBlockSize());
+        block->truncated = true;
+    }
+#endif
+    received = block->datalen<0 ? -1 : 1;
+#endif
+
+    // Give back the unused blocks:
+    size_t used = received<0 ? 0 : static_cast<size_t>(received);
+    for (size_t i=first+used; i<first+count; i++)
+        blocks[i]->release();
+    blocks.resize(first+used);
+
+    return received<0 ? -1 : received;
+}
+
+int Socket_UDP::writeBlocks(const std::vector<Datagram::BlockView *> &blocks)
+{
+    if (!isActive()) return -1;
+    if (blocks.empty()) return 0;
+
+    for (Datagram::BlockView * block : blocks)
+    {
+        // Without destination address:
+        if (!block->addrlen && !res) return -1;
+    }
+
+    size_t sent = 0;
+#ifdef __linux__
+    writeHeaders.resize(blocks.size());
+    writeIov.resize(blocks.size());
+    for (size_t i=0; i<blocks.size(); i++)
+    {
+        Datagram::BlockView * block = blocks[i];
+        writeIov[i].iov_base = block->data;
+        writeIov[i].iov_len = block->datalen<0 ? 0 : static_cast<size_t>(block->datalen);
+        memset(&writeHeaders[i],0,sizeof(struct mmsghdr));
+        writeHeaders[i].msg_hdr.msg_name = block->addrlen ? (void *)&(block->addr) : (void *)res->ai_addr;
+        writeHeaders[i].msg_hdr.msg_namelen = block->addrlen ? block->addrlen : res->ai_addrlen;
+        writeHeaders[i].msg_hdr.msg_iov = &writeIov[i];
+        writeHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // sendmmsg may send only a part of the batch:
+    while (sent < blocks.size())
+    {
+        int r = sendmmsg(sockfd, writeHeaders.data()+sent, static_cast<unsigned int>(blocks.size()-sent), 0);
+        if (r <= 0)
+            return sent ? static_cast<int>(sent) : -1;
+        sent += static_cast<size_t>(r);
+    }
+#else
+    for (Datagram::BlockView * block : blocks)
+    {
+        if (sendto(sockfd, (char *) block->data, block->datalen<0 ? 0 : block->datalen, 0,
+                   block->addrlen ? (struct sockaddr *) &(block->addr) : res->ai_addr,
+                   block->addrlen ? block->addrlen : res->ai_addrlen) == -1)
+            return sent ? static_cast<int>(sent) : -1;
+        sent++;
+    }
+#endif
+    return static_cast<int>(sent);
+}
@@ -2,10 +2,16 @@
 #define SOCKET_UDP_H
 
 #include "datagramsocket.h"
+#include "datagramblockpool.h"
+
+#include <vector>
 
 #ifndef _WIN32
 #include <netdb.h>
 #endif
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
 
 namespace CX2 { namespace Network { namespace Sockets {
 
@@ -66,6 +72,26 @@ public:
      */
     std::shared_ptr<Datagram::Block> readBlock() override;
 
+    /**
+     * Read up to maxBlocks datagrams with one system call (recvmmsg) directly into the pool buffers.
+     * Waits for the first datagram, then takes the ones already received.
+     * Datagrams larger than the pool block size are flagged as truncated (BlockView::truncated).
+     * Not thread-safe against other readBlocks calls on the same socket.
+     * @param pool buffers pool
+     * @param blocks the received datagrams are appended here (release them when done)
+     * @param maxBlocks max datagrams to read
+     * @return number of received datagrams (0 if the pool is exhausted), or -1 on error.
+     */
+    int readBlocks(Datagram::BlockPool * pool, std::vector<Datagram::BlockView *> & blocks, const size_t & maxBlocks = 64);
+    /**
+     * Write the datagrams with one system call (sendmmsg), blocks without destination address are sent to the
+     * remote pair.
+     * Not thread-safe against other writeBlocks calls on the same socket.
+     * @param blocks datagrams to send (they are not released)
+     * @return number of sent datagrams, or -1 on error.
+     */
+    int writeBlocks(const std::vector<Datagram::BlockView *> & blocks);
+
     /**
      * Minimum read size allowed on read funcion.
      */
@@ -74,6 +100,12 @@ public:
 private:
     void freeAddrInfo();
     addrinfo *res;
+
+#ifdef __linux__
+    // Batch headers (reused between calls):
+    std::vector<struct mmsghdr> readHeaders, writeHeaders;
+    std::vector<struct iovec> readIov, writeIov;
+#endif
 };
 
 typedef std::shared_ptr<Socket_UDP> Socket_UDP_SP;
@@ -96,7 +96,7 @@ Streams::StreamSocket * Socket_UNIX::acceptConnection()
 
     if ((sdconn = accept(sockfd, nullptr, nullptr)) >= 0)
     {
-        cursocket = new StreamSocket;
+        cursocket = new Socket_UNIX;
         // Set the proper socket-
         cursocket->setSocketFD(sdconn);
     }
@@ -109,3 +109,8 @@ Streams::StreamSocket * Socket_UNIX::acceptConnection()
     // return the socket class.
     return cursocket;
 }
+
+bool Socket_UNIX::isRawStream()
+{
+    return true;
+}
@@ -37,6 +37,11 @@ public:
      * @return returns a socket with the new connection.
      */
     StreamSocket *acceptConnection() override;
+    /**
+     * @brief isRawStream The data goes as is to the file descriptor
+     * @return true
+     */
+    bool isRawStream() override;
 };
 
 typedef std::shared_ptr<Socket_UNIX> Socket_UNIX_SP;
@@ -1,21 +1,37 @@
 #include "streamsocket.h"
 
 #ifndef _WIN32
+#include "socket_unix.h"
 #include <sys/socket.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 #else
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include "socket_tcp.h"
 
 #endif
+#include <cx2_mem_vars/b_chunks.h>
+
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
 
 using namespace CX2;
 using namespace CX2::Network::Streams;
 
 StreamSocket::StreamSocket()
 {
+    readMinSize = STREAMSOCKET_READ_MINSIZE;
+    readMaxSize = STREAMSOCKET_READ_MAXSIZE;
+
+    statReads = 0;
+    statBytes = 0;
+    statFullReads = 0;
+    statBufferGrows = 0;
+    statBufferShrinks = 0;
+    statReadSize = 0;
 }
 
 StreamSocket::~StreamSocket()
@@ -29,36 +45,128 @@ void StreamSocket::writeEOF(bool)
 
 bool StreamSocket::streamTo(Memory::Streams::Streamable *out, Memory::Streams::Status &wrsStat)
 {
-    char data[8192];
-    Memory::Streams::Status cur;
+    // Received directly into the container chunks (no intermediate copy):
+    Memory::Containers::B_Chunks * chunksOut = dynamic_cast<Memory::Containers::B_Chunks *>(out);
+
+    uint32_t minSize = readMinSize, maxSize = readMaxSize;
+    if (!minSize) minSize = STREAMSOCKET_READ_MINSIZE;
+
+    // Don't read more than what the kernel can keep for us:
+    int rcvBuf = 0;
+    socklen_t rcvBufLen = sizeof(rcvBuf);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, (char *)&rcvBuf, &rcvBufLen)==0 && rcvBuf>0 && (uint32_t)rcvBuf<maxSize)
+        maxSize = (uint32_t)rcvBuf;
+    // Keep every read inside one chunk:
+    if (chunksOut && chunksOut->getMaxChunkSize()<maxSize)
+        maxSize = chunksOut->getMaxChunkSize();
+    if (maxSize<minSize) maxSize = minSize;
+
+    uint32_t readSize = minSize, smallReads = 0;
+    char * data = nullptr;
+    bool ret = true;
+
+    statReadSize = readSize;
+
     for (;;)
     {
-        int r = partialRead(data,sizeof(data));
-        switch (r)
+        if (!data) data = new char[readSize];
+
+        int r = partialRead(data,readSize);
+        if (r == -1)
         {
-        case -1: // ERR.
+            // ERR.
             out->writeEOF(false);
-            return false;
-        case 0: // EOF.
+            ret = false;
+            break;
+        }
+        if (r == 0)
+        {
+            // EOF.
             out->writeEOF(true);
-            return true;
-        default:
-            if (!(cur=out->writeFullStream(data,r,wrsStat)).succeed || cur.finish)
+            break;
+        }
+
+        bool fullRead = (uint32_t)r == readSize;
+        updateReadStats(r,fullRead);
+
+        Memory::Streams::Status cur;
+        if (chunksOut)
+        {
+            std::pair<bool,uint64_t> appended;
+            // Small reads are copied to avoid keeping chunks with too much unused space.
+            if ((uint32_t)r >= readSize/2)
             {
-                if (!cur.succeed)
-                {
-                    out->writeEOF(false);
-                    return false;
-                }
-                else
-                {
-                    out->writeEOF(true);
-                    return true;
-                }
+                appended = chunksOut->appendChunk(data,r);
+                data = nullptr;
             }
-        break;
+            else
+                appended = chunksOut->append(data,r);
+
+            cur.bytesWritten = appended.second;
+            wrsStat.bytesWritten += appended.second;
+            if (!appended.first)
+                cur.succeed = wrsStat.succeed = false;
+        }
+        else
+            cur = out->writeFullStream(data,r,wrsStat);
+
+        if (!cur.succeed || cur.finish)
+        {
+            out->writeEOF(cur.succeed);
+            ret = cur.succeed;
+            break;
+        }
+
+        // Adapt the read size (shrink only after some consecutive small reads, to avoid oscillations):
+        uint32_t nextReadSize = readSize;
+        smallReads = (uint32_t)r < readSize/4 ? smallReads+1 : 0;
+        if (fullRead && readSize<maxSize)
+        {
+            nextReadSize = readSize*2>maxSize? maxSize : readSize*2;
+            statBufferGrows++;
+        }
+        else if (smallReads>=STREAMSOCKET_READ_SHRINK_AFTER && readSize>minSize)
+        {
+            nextReadSize = readSize/2<minSize? minSize : readSize/2;
+            smallReads = 0;
+            statBufferShrinks++;
+        }
+
+        if (nextReadSize != readSize)
+        {
+            readSize = statReadSize = nextReadSize;
+            delete [] data;
+            data = nullptr;
         }
     }
+
+    delete [] data;
+    return ret;
+}
+
+void StreamSocket::setReadSizeLimits(const uint32_t &minSize, const uint32_t &maxSize)
+{
+    readMinSize = minSize;
+    readMaxSize = maxSize;
+}
+
+sStreamSocketReadStats StreamSocket::getReadStats()
+{
+    sStreamSocketReadStats r;
+    r.reads = statReads;
+    r.bytes = statBytes;
+    r.fullReads = statFullReads;
+    r.bufferGrows = statBufferGrows;
+    r.bufferShrinks = statBufferShrinks;
+    r.readSize = statReadSize;
+    return r;
+}
+
+void StreamSocket::updateReadStats(const uint32_t &bytes, bool fullRead)
+{
+    statReads++;
+    statBytes+=bytes;
+    if (fullRead) statFullReads++;
 }
 
 Memory::Streams::Status StreamSocket::write(const void *buf, const size_t &count, Memory::Streams::Status &wrStat)
@@ -76,6 +184,76 @@ Memory::Streams::Status StreamSocket::write(const void *buf, const size_t &count
     return cur;
 }
 
+bool StreamSocket::supportsWriteFromFile()
+{
+#ifndef _WIN32
+    return true;
+#else
+    return false;
+#endif
+}
+
+Memory::Streams::Status StreamSocket::writeFromFile(int fd, const uint64_t &offset, const uint64_t &count, Memory::Streams::Status &wrStat)
+{
+    Memory::Streams::Status cur;
+#ifndef _WIN32
+    uint64_t left = count;
+#ifdef __linux__
+    if (isRawStream())
+    {
+        // Zero-Copy: from the page cache to the socket.
+        off_t fileOffset = offset;
+        while (left)
+        {
+            ssize_t sent = sendfile(sockfd, fd, &fileOffset, left>0x7ffff000?0x7ffff000:left);
+            if (sent == -1 && errno == EINTR)
+                continue;
+            if (sent <= 0)
+            {
+                shutdownSocket();
+                wrStat.succeed=cur.succeed=setFailedWriteState();
+                return cur;
+            }
+            left-=sent;
+            cur.bytesWritten+=sent;
+            wrStat.bytesWritten+=sent;
+        }
+        return cur;
+    }
+#endif
+    // Transformed streams (TLS/Chains): read 16KiB blocks (max TLS record) and write them at once.
+    char data[16384];
+    while (left)
+    {
+        ssize_t r = pread(fd,data,left>sizeof(data)?sizeof(data):left,offset+(count-left));
+        if (r == -1 && errno == EINTR)
+            continue;
+        if (r <= 0)
+        {
+            wrStat.succeed=cur.succeed=setFailedWriteState();
+            return cur;
+        }
+        for (ssize_t w=0; w<r; )
+        {
+            int x = partialWrite(data+w,r-w);
+            if (x<=0)
+            {
+                shutdownSocket();
+                wrStat.succeed=cur.succeed=setFailedWriteState();
+                return cur;
+            }
+            w+=x;
+        }
+        left-=r;
+        cur.bytesWritten+=r;
+        wrStat.bytesWritten+=r;
+    }
+#else
+    wrStat.succeed=cur.succeed=setFailedWriteState();
+#endif
+    return cur;
+}
+
 std::pair<StreamSocket *,StreamSocket *> StreamSocket::GetSocketPair()
 {
     std::pair<StreamSocket *,StreamSocket *> p;
@@ -91,8 +269,8 @@ std::pair<StreamSocket *,StreamSocket *> StreamSocket::GetSocketPair()
     }
     else
     {
-        p.first = new StreamSocket();
-        p.second = new StreamSocket();
+        p.first = new Sockets::Socket_UNIX();
+        p.second = new Sockets::Socket_UNIX();
 
         p.first->setSocketFD(sockets[0]);
         p.second->setSocketFD(sockets[1]);
@@ -234,6 +412,11 @@ int StreamSocket::iShutdown(int mode)
     return -1;
 }
 
+bool StreamSocket::isRawStream()
+{
+    return false;
+}
+
 bool StreamSocket::isConnected()
 {
     if (!isActive()) return false;
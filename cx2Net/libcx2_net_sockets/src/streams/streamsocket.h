@@ -5,10 +5,47 @@
 #include "streamsocketreader.h"
 #include "streamsocketwriter.h"
 #include <utility>
+#include <atomic>
 #include <cx2_mem_vars/streamable.h>
 
+// Adaptive read size limits for streamTo (the max is also limited by the socket receive buffer size)
+#define STREAMSOCKET_READ_MINSIZE 8192
+#define STREAMSOCKET_READ_MAXSIZE (256*1024)
+// Consecutive small reads (less than 1/4 of the buffer) before shrinking the read size
+#define STREAMSOCKET_READ_SHRINK_AFTER 4
+
 namespace CX2 { namespace Network { namespace Streams {
 
+struct sStreamSocketReadStats
+{
+    sStreamSocketReadStats()
+    {
+        reads = 0;
+        bytes = 0;
+        fullReads = 0;
+        bufferGrows = 0;
+        bufferShrinks = 0;
+        readSize = 0;
+    }
+    /**
+     * @brief reads successful reads on streamTo
+     */
+    uint64_t reads;
+    /**
+     * @brief bytes total bytes read
+     */
+    uint64_t bytes;
+    /**
+     * @brief fullReads reads that filled the whole buffer (more data was probably waiting)
+     */
+    uint64_t fullReads;
+    uint64_t bufferGrows, bufferShrinks;
+    /**
+     * @brief readSize current read size
+     */
+    uint32_t readSize;
+};
+
 class StreamSocket : public Memory::Streams::Streamable, public Sockets::Socket, public StreamSocketReader, public StreamSocketWriter
 {
 public:
@@ -17,9 +54,45 @@ public:
 
     virtual void writeEOF(bool) override;
 
+    /**
+     * @brief streamTo Read the socket until EOF and write the data into out.
+     *                 The read size adapts to the traffic: it grows (up to the socket receive buffer) while the
+     *                 reads fill the buffer, and shrinks when the reads are small.
+     *                 If out is a B_Chunks container, the data is received directly into new container chunks
+     *                 (the read size is limited to the container max chunk size).
+     * @param out data destination
+     * @param wrsStat write status.
+     * @return true if the stream ended by EOF or finished by the destination, false on error.
+     */
     bool streamTo(Memory::Streams::Streamable * out, Memory::Streams::Status & wrsStat) override;
+    /**
+     * @brief setReadSizeLimits Set the adaptive read size limits used in streamTo
+     * @param minSize initial/min read size in bytes
+     * @param maxSize max read size in bytes
+     */
+    void setReadSizeLimits(const uint32_t & minSize = STREAMSOCKET_READ_MINSIZE, const uint32_t & maxSize = STREAMSOCKET_READ_MAXSIZE);
+    /**
+     * @brief getReadStats Get the streamTo read statistics of this connection (useful for tuning the read sizes)
+     * @return read statistics
+     */
+    sStreamSocketReadStats getReadStats();
 
     Memory::Streams::Status write(const void * buf, const size_t &count, Memory::Streams::Status & wrStatUpd) override;
+    /**
+     * @brief supportsWriteFromFile Stream sockets can transmit file ranges (used by file backed containers)
+     * @return true (false on windows)
+     */
+    bool supportsWriteFromFile() override;
+    /**
+     * @brief writeFromFile Transmit a file range using sendfile on raw streams (linux), or using large
+     *                      blocks (one full TLS record per write) on TLS/chained streams.
+     * @param fd file descriptor.
+     * @param offset file offset in bytes.
+     * @param count bytes to be transmitted.
+     * @param wrStatUpd write status.
+     * @return status of the current write.
+     */
+    Memory::Streams::Status writeFromFile(int fd, const uint64_t & offset, const uint64_t & count, Memory::Streams::Status & wrStatUpd) override;
 
     /**
      * @brief GetSocketPair Create a Pair of interconnected sockets
@@ -28,6 +101,12 @@ public:
     static std::pair<StreamSocket *, StreamSocket *> GetSocketPair();
 
     virtual bool isConnected() override;
+    /**
+     * @brief isRawStream Check if the data goes as is to the file descriptor (the plain TCP/UNIX sockets),
+     *                    unknown sub-classes may transform the data (eg. TLS, chains).
+     * @return false
+     */
+    virtual bool isRawStream() override;
     // This methods are virtual and should be implemented in sub-classes.
     // TODO: virtual redefinition?
     virtual bool listenOn(const uint16_t & port, const char * listenOnAddr = "*", const int32_t & recvbuffer = 0, const int32_t &backlog = 10) override;
@@ -82,6 +161,12 @@ public:
      */
     virtual int iShutdown(int mode = SHUT_RDWR) override;
 
+private:
+    void updateReadStats(const uint32_t & bytes, bool fullRead);
+
+    std::atomic<uint32_t> readMinSize, readMaxSize;
+    std::atomic<uint64_t> statReads, statBytes, statFullReads, statBufferGrows, statBufferShrinks;
+    std::atomic<uint32_t> statReadSize;
 
 };
 
@@ -0,0 +1,627 @@
+#include "streamsockets_uring.h"
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace CX2::Network::Streams;
+
+// Submission/completion queue entries per ring.
+#define URING_ENTRIES 1024
+// Provided buffers group ID.
+#define URING_BUFFER_GROUP 0
+
+// The operation goes in the low bits of the user data (the connections are 8-byte aligned).
+#define URING_OP_WAKEUP 0
+#define URING_OP_RECV 1
+#define URING_OP_SEND 2
+#define URING_OP_MASK 7
+
+enum eURingCommand {
+    URING_CMD_ADD = 0,
+    URING_CMD_SEND = 1,
+    URING_CMD_FINISH = 2
+};
+
+struct sURingCommand {
+    int command;
+    uint64_t connectionID;
+    // New connection (URING_CMD_ADD only):
+    sURingConnection * connection;
+    std::string data;
+};
+
+struct CX2::Network::Streams::sURing {
+    sURing()
+    {
+        ringFD = -1;
+        wakeFD = -1;
+        sqPtr = MAP_FAILED;
+        cqPtr = MAP_FAILED;
+        sqes = (struct io_uring_sqe *)MAP_FAILED;
+        bufRing = (struct io_uring_buf_ring *)MAP_FAILED;
+        buffers = nullptr;
+        sqLocalTail = 0;
+        toSubmit = 0;
+        bufTail = 0;
+        wakeArmed = false;
+    }
+
+    int ringFD, wakeFD;
+
+    // Submission queue:
+    void * sqPtr;
+    size_t sqSize;
+    unsigned * sqHead, * sqTail, * sqMask, * sqArray, sqEntries, sqLocalTail, toSubmit;
+    struct io_uring_sqe * sqes;
+    size_t sqesSize;
+
+    // Completion queue:
+    void * cqPtr;
+    size_t cqSize;
+    unsigned * cqHead, * cqTail, * cqMask;
+    struct io_uring_cqe * cqes;
+
+    // Provided receive buffers:
+    struct io_uring_buf_ring * bufRing;
+    size_t bufRingSize;
+    unsigned char * buffers;
+    uint16_t buffersCount, bufTail;
+    uint32_t bufferSize;
+
+    // Eventfd to wake up the ring thread (commands/stop):
+    uint64_t wakeValue;
+    bool wakeArmed;
+
+    // Commands from other threads:
+    std::mutex mtCommands;
+    std::list<sURingCommand> commands;
+
+    // Connections by ID (ring thread only):
+    std::map<uint64_t, sURingConnection *> connections;
+    std::thread::id threadId;
+};
+
+static int uringSetup(unsigned entries, struct io_uring_params * p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static int uringRegister(int fd, unsigned opcode, void * arg, unsigned nrArgs)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+}
+
+static int uringSubmit(sURing * ring, unsigned minComplete)
+{
+    // Publish the new entries, then let the kernel take them:
+    __atomic_store_n(ring->sqTail, ring->sqLocalTail, __ATOMIC_RELEASE);
+    int r = uringEnter(ring->ringFD, ring->toSubmit, minComplete, minComplete?IORING_ENTER_GETEVENTS:0);
+    if (r>0)
+        ring->toSubmit -= r<(int)ring->toSubmit?(unsigned)r:ring->toSubmit;
+    return r;
+}
+
+static struct io_uring_sqe * uringGetSQE(sURing * ring)
+{
+    if (ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries)
+    {
+        // Full, submit first:
+        uringSubmit(ring,0);
+        if (ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries)
+            return nullptr;
+    }
+
+    unsigned idx = ring->sqLocalTail & *ring->sqMask;
+    struct io_uring_sqe * sqe = &(ring->sqes[idx]);
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ring->sqArray[idx] = idx;
+    ring->sqLocalTail++;
+    ring->toSubmit++;
+    return sqe;
+}
+
+static void uringRecycleBuffer(sURing * ring, uint16_t bid)
+{
+    // The entries start at the ring base (in C++ the bufs flexible array member is not placed at offset 0):
+    struct io_uring_buf * buf = ((struct io_uring_buf *)ring->bufRing) + (ring->bufTail & (ring->buffersCount-1));
+    buf->addr = (uint64_t)(ring->buffers + (size_t)bid*ring->bufferSize);
+    buf->len = ring->bufferSize;
+    buf->bid = bid;
+    ring->bufTail++;
+    __atomic_store_n(&(ring->bufRing->tail), ring->bufTail, __ATOMIC_RELEASE);
+}
+
+static void uringArmWakeUp(sURing * ring)
+{
+    struct io_uring_sqe * sqe = uringGetSQE(ring);
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = ring->wakeFD;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = URING_OP_WAKEUP;
+    ring->wakeArmed = true;
+}
+
+StreamSocketsURing::StreamSocketsURing()
+{
+    stopping = false;
+    nextConnectionID = 0;
+    activeConnections = 0;
+}
+
+StreamSocketsURing::~StreamSocketsURing()
+{
+    stop();
+}
+
+bool StreamSocketsURing::start(const size_t &threadsCount, const uint16_t &buffersCount, const uint32_t &bufferSize)
+{
+    if (!rings.empty() || !threadsCount || !bufferSize) return false;
+    // The provided buffers ring size should be power of 2:
+    if (!buffersCount || (buffersCount & (buffersCount-1)) || buffersCount>32768) return false;
+
+    for (size_t i=0; i<threadsCount; i++)
+    {
+        sURing * ring = new sURing;
+        rings.push_back(ring);
+        if (!initRing(ring,buffersCount,bufferSize))
+        {
+            for (sURing * r : rings)
+                destroyRing(r);
+            rings.clear();
+            return false;
+        }
+    }
+
+    stopping = false;
+    for (sURing * ring : rings)
+        threads.push_back(std::thread(ringThread, this, ring));
+
+    return true;
+}
+
+void StreamSocketsURing::stop()
+{
+    stopping = true;
+    for (sURing * ring : rings)
+    {
+        uint64_t one = 1;
+        if (write(ring->wakeFD, &one, sizeof(one))) {}
+    }
+    for (std::thread & thr : threads)
+        thr.join();
+    threads.clear();
+
+    // Threads are down, destroy the rings (cancelling the pending operations) and finalize the remaining connections.
+    for (sURing * ring : rings)
+    {
+        std::list<sURingConnection *> remaining;
+        for (const auto & i : ring->connections)
+            remaining.push_back(i.second);
+        for (const sURingCommand & command : ring->commands)
+        {
+            if (command.command == URING_CMD_ADD)
+                remaining.push_back(command.connection);
+        }
+        destroyRing(ring);
+
+        for (sURingConnection * connection : remaining)
+        {
+            shutdown(connection->fd, SHUT_RDWR);
+            connection->streamable->writeEOF(false);
+            if (connection->callbackOnFinish)
+                connection->callbackOnFinish(connection->obj, connection->sock);
+            delete connection;
+            activeConnections--;
+        }
+    }
+    rings.clear();
+}
+
+uint64_t StreamSocketsURing::addConnection(StreamSocket *sock, Memory::Streams::Streamable *streamable, void (*callbackOnFinish)(void *, StreamSocket *), void *obj)
+{
+    if (rings.empty() || !sock || !streamable || !sock->isRawStream())
+        return 0;
+
+    sURingConnection * connection = new sURingConnection;
+    // The ID also selects the ring (IDs start at 1, 0 is invalid):
+    connection->id = ++nextConnectionID;
+    connection->ring = getRing(connection->id);
+    connection->sock = sock;
+    connection->fd = sock->getSocketFD();
+    connection->streamable = streamable;
+    connection->callbackOnFinish = callbackOnFinish;
+    connection->obj = obj;
+
+    activeConnections++;
+    uint64_t connectionID = connection->id;
+    // From here, the connection belongs to the ring thread:
+    enqueueCommand(connection->ring, URING_CMD_ADD, connectionID, connection);
+    return connectionID;
+}
+
+bool StreamSocketsURing::send(const uint64_t &connectionID, const void *data, const size_t &datalen)
+{
+    sURing * ring = getRing(connectionID);
+    if (!ring) return false;
+    if (std::this_thread::get_id() == ring->threadId)
+    {
+        // From the ring thread (eg. answering from the streamable), no need to wake up anyone:
+        auto i = ring->connections.find(connectionID);
+        if (i == ring->connections.end() || i->second->finishing) return false;
+        i->second->sends.push_back(std::string((const char *)data,datalen));
+        armSend(i->second);
+        return true;
+    }
+    enqueueCommand(ring, URING_CMD_SEND, connectionID, nullptr, std::string((const char *)data,datalen));
+    return true;
+}
+
+void StreamSocketsURing::finish(const uint64_t &connectionID)
+{
+    sURing * ring = getRing(connectionID);
+    if (!ring) return;
+    if (std::this_thread::get_id() == ring->threadId)
+    {
+        auto i = ring->connections.find(connectionID);
+        if (i == ring->connections.end()) return;
+        sURingConnection * connection = i->second;
+        finishConnection(connection,true);
+        finalizeConnectionIfDone(connection);
+        return;
+    }
+    enqueueCommand(ring, URING_CMD_FINISH, connectionID);
+}
+
+size_t StreamSocketsURing::getActiveConnections()
+{
+    return activeConnections;
+}
+
+void StreamSocketsURing::ringThread(StreamSocketsURing *mgr, sURing *ring)
+{
+    ring->threadId = std::this_thread::get_id();
+    uringArmWakeUp(ring);
+    mgr->processWakeUp(ring);
+
+    while (!mgr->stopping)
+    {
+        // Submit and wait for at least one completion in the same system call:
+        if (uringSubmit(ring,1) < 0 && errno != EINTR && errno != EBUSY)
+            break;
+        mgr->processRing(ring);
+    }
+}
+
+bool StreamSocketsURing::initRing(sURing *ring, const uint16_t &buffersCount, const uint32_t &bufferSize)
+{
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    if ((ring->ringFD = uringSetup(URING_ENTRIES, &p)) < 0)
+        return false;
+
+    // Map the submission/completion queues and the submission entries:
+    ring->sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cqSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring->cqSize > ring->sqSize) ring->sqSize = ring->cqSize;
+        ring->cqSize = ring->sqSize;
+    }
+
+    ring->sqPtr = mmap(nullptr, ring->sqSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring->ringFD, IORING_OFF_SQ_RING);
+    if (ring->sqPtr == MAP_FAILED)
+        return false;
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        ring->cqPtr = ring->sqPtr;
+    else if ((ring->cqPtr = mmap(nullptr, ring->cqSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring->ringFD, IORING_OFF_CQ_RING)) == MAP_FAILED)
+        return false;
+
+    ring->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *)mmap(nullptr, ring->sqesSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring->ringFD, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+        return false;
+
+    unsigned char * sq = (unsigned char *)ring->sqPtr, * cq = (unsigned char *)ring->cqPtr;
+    ring->sqHead = (unsigned *)(sq + p.sq_off.head);
+    ring->sqTail = (unsigned *)(sq + p.sq_off.tail);
+    ring->sqMask = (unsigned *)(sq + p.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(sq + p.sq_off.array);
+    ring->sqEntries = p.sq_entries;
+    ring->sqLocalTail = *ring->sqTail;
+    ring->cqHead = (unsigned *)(cq + p.cq_off.head);
+    ring->cqTail = (unsigned *)(cq + p.cq_off.tail);
+    ring->cqMask = (unsigned *)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+    // Provided buffers (the kernel picks one for each received chunk):
+    ring->buffersCount = buffersCount;
+    ring->bufferSize = bufferSize;
+    ring->bufRingSize = buffersCount * sizeof(struct io_uring_buf);
+    ring->bufRing = (struct io_uring_buf_ring *)mmap(nullptr, ring->bufRingSize, PROT_READ|PROT_WRITE, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+    if (ring->bufRing == MAP_FAILED)
+        return false;
+    ring->buffers = new unsigned char[(size_t)buffersCount*bufferSize];
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)ring->bufRing;
+    reg.ring_entries = buffersCount;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (uringRegister(ring->ringFD, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        return false;
+
+    ring->bufRing->tail = 0;
+    for (uint16_t bid=0; bid<buffersCount; bid++)
+        uringRecycleBuffer(ring,bid);
+
+    if ((ring->wakeFD = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC)) < 0)
+        return false;
+
+    return true;
+}
+
+void StreamSocketsURing::destroyRing(sURing *ring)
+{
+    if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqPtr != MAP_FAILED && ring->cqPtr != ring->sqPtr) munmap(ring->cqPtr, ring->cqSize);
+    if (ring->sqPtr != MAP_FAILED) munmap(ring->sqPtr, ring->sqSize);
+    // Closing the ring cancels the pending operations:
+    if (ring->ringFD != -1) close(ring->ringFD);
+    if (ring->bufRing != MAP_FAILED) munmap(ring->bufRing, ring->bufRingSize);
+    if (ring->buffers) delete [] ring->buffers;
+    if (ring->wakeFD != -1) close(ring->wakeFD);
+    delete ring;
+}
+
+void StreamSocketsURing::processRing(sURing *ring)
+{
+    unsigned head = *ring->cqHead;
+    unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++)
+    {
+        struct io_uring_cqe * cqe = &(ring->cqes[head & *ring->cqMask]);
+        uint64_t userData = cqe->user_data;
+        int res = cqe->res;
+        uint32_t flags = cqe->flags;
+
+        sURingConnection * connection = (sURingConnection *)(userData & ~((uint64_t)URING_OP_MASK));
+        switch (userData & URING_OP_MASK)
+        {
+        case URING_OP_WAKEUP:
+            if (!(flags & IORING_CQE_F_MORE))
+                ring->wakeArmed = false;
+            processWakeUp(ring);
+            break;
+        case URING_OP_RECV:
+            processRecv(connection, res, flags);
+            break;
+        case URING_OP_SEND:
+            processSend(connection, res);
+            break;
+        default:
+            break;
+        }
+    }
+
+    __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+}
+
+void StreamSocketsURing::processWakeUp(sURing *ring)
+{
+    if (read(ring->wakeFD, &(ring->wakeValue), sizeof(ring->wakeValue))) {}
+    if (!ring->wakeArmed)
+        uringArmWakeUp(ring);
+
+    std::list<sURingCommand> commands;
+    ring->mtCommands.lock();
+    commands.swap(ring->commands);
+    ring->mtCommands.unlock();
+
+    for (sURingCommand & command : commands)
+    {
+        sURingConnection * connection = command.connection;
+        if (command.command == URING_CMD_ADD)
+        {
+            ring->connections[connection->id] = connection;
+            armRecv(connection);
+            // No submission entry available: nothing is armed, so no completion will finalize it.
+            finalizeConnectionIfDone(connection);
+            continue;
+        }
+
+        // The connection may be already finalized (the IDs are not reused):
+        auto i = ring->connections.find(command.connectionID);
+        if (i == ring->connections.end())
+            continue;
+        connection = i->second;
+
+        if (command.command == URING_CMD_SEND)
+        {
+            if (!connection->finishing)
+            {
+                connection->sends.push_back(std::string());
+                connection->sends.back().swap(command.data);
+                armSend(connection);
+            }
+        }
+        else if (command.command == URING_CMD_FINISH)
+        {
+            finishConnection(connection,true);
+            finalizeConnectionIfDone(connection);
+        }
+    }
+}
+
+void StreamSocketsURing::processRecv(sURingConnection *connection, int res, uint32_t flags)
+{
+    sURing * ring = connection->ring;
+
+    if (res > 0 && (flags & IORING_CQE_F_BUFFER))
+    {
+        uint16_t bid = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (!connection->finishing)
+        {
+            // Push the data into the streamable (eg. Parser::write)
+            Memory::Streams::Status wrStat, cur;
+            if (!(cur=connection->streamable->writeFullStream(ring->buffers + (size_t)bid*ring->bufferSize, (size_t)res, wrStat)).succeed || cur.finish)
+                finishConnection(connection, cur.succeed);
+        }
+        // Give back the buffer to the kernel:
+        uringRecycleBuffer(ring,bid);
+    }
+
+    if (!(flags & IORING_CQE_F_MORE))
+    {
+        connection->recvArmed = false;
+        if (!connection->finishing)
+        {
+            if (res > 0 || res == -ENOBUFS)
+            {
+                // The multishot receive ended (eg. all the buffers are in use), arm it again:
+                armRecv(connection);
+            }
+            else
+            {
+                // 0: remote shutdown, <0: error.
+                finishConnection(connection, res == 0);
+            }
+        }
+        finalizeConnectionIfDone(connection);
+    }
+}
+
+void StreamSocketsURing::processSend(sURingConnection *connection, int res)
+{
+    connection->sendInFlight = false;
+
+    if (res < 0)
+    {
+        connection->sends.clear();
+        connection->sendOffset = 0;
+        finishConnection(connection, false);
+    }
+    else
+    {
+        connection->sendOffset += (size_t)res;
+        if (connection->sendOffset >= connection->sends.front().size())
+        {
+            connection->sends.pop_front();
+            connection->sendOffset = 0;
+        }
+
+        if (!connection->sends.empty())
+            armSend(connection);
+        else if (connection->finishing)
+        {
+            // All the data is sent, now the connection can be shut down.
+            shutdown(connection->fd, SHUT_RDWR);
+        }
+    }
+
+    finalizeConnectionIfDone(connection);
+}
+
+void StreamSocketsURing::armRecv(sURingConnection *connection)
+{
+    struct io_uring_sqe * sqe = uringGetSQE(connection->ring);
+    if (!sqe)
+    {
+        finishConnection(connection, false);
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connection->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = (uint64_t)connection | URING_OP_RECV;
+    connection->recvArmed = true;
+}
+
+void StreamSocketsURing::armSend(sURingConnection *connection)
+{
+    if (connection->sendInFlight || connection->sends.empty())
+        return;
+
+    struct io_uring_sqe * sqe = uringGetSQE(connection->ring);
+    if (!sqe)
+    {
+        connection->sends.clear();
+        connection->sendOffset = 0;
+        finishConnection(connection, false);
+        return;
+    }
+    const std::string & data = connection->sends.front();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = connection->fd;
+    sqe->addr = (uint64_t)(data.data() + connection->sendOffset);
+    sqe->len = (uint32_t)(data.size() - connection->sendOffset);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (uint64_t)connection | URING_OP_SEND;
+    connection->sendInFlight = true;
+}
+
+void StreamSocketsURing::finishConnection(sURingConnection *connection, bool succeed)
+{
+    if (connection->finishing)
+        return;
+    connection->finishing = true;
+    connection->succeed = succeed;
+
+    if (!succeed)
+    {
+        // Discard the pending data (except the one in flight, still referenced by the kernel):
+        while (connection->sends.size() > (connection->sendInFlight?1:0))
+            connection->sends.pop_back();
+    }
+
+    // Shut down now (the armed receive ends), or after the pending data is sent:
+    if (!connection->sendInFlight)
+        shutdown(connection->fd, SHUT_RDWR);
+}
+
+void StreamSocketsURing::finalizeConnectionIfDone(sURingConnection *connection)
+{
+    if (!connection->finishing || connection->recvArmed || connection->sendInFlight)
+        return;
+
+    connection->ring->connections.erase(connection->id);
+    connection->streamable->writeEOF(connection->succeed);
+    if (connection->callbackOnFinish)
+        connection->callbackOnFinish(connection->obj, connection->sock);
+    delete connection;
+    activeConnections--;
+}
+
+sURing *StreamSocketsURing::getRing(const uint64_t &connectionID)
+{
+    if (!connectionID || rings.empty())
+        return nullptr;
+    return rings[connectionID % rings.size()];
+}
+
+void StreamSocketsURing::enqueueCommand(sURing *ring, int command, const uint64_t &connectionID, sURingConnection *connection, const std::string &data)
+{
+    ring->mtCommands.lock();
+    ring->commands.push_back({command,connectionID,connection,data});
+    ring->mtCommands.unlock();
+
+    uint64_t one = 1;
+    if (write(ring->wakeFD, &one, sizeof(one))) {}
+}
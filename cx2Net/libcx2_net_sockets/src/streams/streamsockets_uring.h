@@ -0,0 +1,148 @@
+#ifndef STREAMSOCKETS_URING_H
+#define STREAMSOCKETS_URING_H
+
+#include "streamsocket.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CX2 { namespace Network { namespace Streams {
+
+struct sURing;
+
+struct sURingConnection {
+    sURingConnection()
+    {
+        id = 0;
+        ring = nullptr;
+        sock = nullptr;
+        streamable = nullptr;
+        callbackOnFinish = nullptr;
+        obj = nullptr;
+        fd = -1;
+        recvArmed = false;
+        sendInFlight = false;
+        sendOffset = 0;
+        finishing = false;
+        succeed = true;
+    }
+
+    uint64_t id;
+    sURing * ring;
+    StreamSocket * sock;
+    Memory::Streams::Streamable * streamable;
+    void (*callbackOnFinish)(void *, StreamSocket *);
+    void * obj;
+    int fd;
+
+    // Only accessed from the ring thread:
+    bool recvArmed;
+    /**
+     * @brief sends pending data (one send in flight at time to keep the order)
+     */
+    std::deque<std::string> sends;
+    bool sendInFlight;
+    size_t sendOffset;
+    bool finishing;
+    /**
+     * @brief succeed false if the connection is ending by an error (reported in writeEOF)
+     */
+    bool succeed;
+};
+
+/**
+ * @brief The StreamSocketsURing class serve many raw stream connections from a small set of threads, each one owning
+ *        an io_uring (Linux only).
+ *        The connections are owned by their ring thread, and referenced from other threads by ID (the ring thread
+ *        ignores the commands for connections already finalized).
+ *        The data is received with multishot receives into a ring of provided buffers (registered in the kernel) and
+ *        pushed into the connection streamable (eg. a Parser) from the ring thread, without a thread per connection
+ *        and without a system call per read.
+ *        Connections with TLS/chained sockets should use the StreamSocket functions.
+ */
+class StreamSocketsURing
+{
+public:
+    StreamSocketsURing();
+    /**
+     * @brief ~StreamSocketsURing stop the threads, and finalize the remaining connections.
+     */
+    ~StreamSocketsURing();
+    /**
+     * @brief start Create the rings and start their threads.
+     * @param threadsCount number of rings/threads serving the connections.
+     * @param buffersCount provided receive buffers per ring (power of 2, max 32768).
+     * @param bufferSize receive buffer size.
+     * @return true if initialized, false if not (eg. io_uring not available in this kernel).
+     */
+    bool start(const size_t & threadsCount = 2, const uint16_t & buffersCount = 256, const uint32_t & bufferSize = 16384);
+    /**
+     * @brief stop Stop the threads and finalize the connections.
+     */
+    void stop();
+    /**
+     * @brief addConnection Serve a connection from a ring thread.
+     *                      The received data is written into the streamable, then writeEOF is called when the
+     *                      connection ends (remote shutdown, error, or the streamable stopped accepting data), and
+     *                      finally the callback receives the socket (the connection can't be used after it).
+     * @param sock raw stream socket (the ownership goes to the callback)
+     * @param streamable received data destination
+     * @param callbackOnFinish called from the ring thread when the connection is finalized (optional)
+     * @param obj object passed to the callback
+     * @return connection ID or 0 if the socket is not a raw stream or the rings are not started.
+     */
+    uint64_t addConnection(StreamSocket * sock, Memory::Streams::Streamable * streamable,
+                                      void (*callbackOnFinish)(void *, StreamSocket *) = nullptr, void * obj = nullptr);
+    /**
+     * @brief send Send data through the connection (the data is copied, sent in order from the ring thread).
+     * @param connectionID connection ID
+     * @param data data to send
+     * @param datalen data length
+     * @return true if queued (the data is discarded if the connection is already finishing).
+     */
+    bool send(const uint64_t & connectionID, const void * data, const size_t & datalen);
+    /**
+     * @brief finish End the connection (shutdown), the callback will be called when the pending operations are done.
+     * @param connectionID connection ID
+     */
+    void finish(const uint64_t & connectionID);
+    /**
+     * @brief getActiveConnections Get the number of connections in progress
+     * @return number of connections
+     */
+    size_t getActiveConnections();
+
+private:
+    static void ringThread(StreamSocketsURing * mgr, sURing * ring);
+
+    bool initRing(sURing * ring, const uint16_t & buffersCount, const uint32_t & bufferSize);
+    void destroyRing(sURing * ring);
+    void processRing(sURing * ring);
+    void processWakeUp(sURing * ring);
+    void processRecv(sURingConnection * connection, int res, uint32_t flags);
+    void processSend(sURingConnection * connection, int res);
+    void armRecv(sURingConnection * connection);
+    void armSend(sURingConnection * connection);
+    void finishConnection(sURingConnection * connection, bool succeed);
+    void finalizeConnectionIfDone(sURingConnection * connection);
+    sURing * getRing(const uint64_t & connectionID);
+    void enqueueCommand(sURing * ring, int command, const uint64_t & connectionID, sURingConnection * connection = nullptr, const std::string & data = "");
+
+    std::atomic<bool> stopping;
+    std::vector<sURing *> rings;
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> nextConnectionID;
+    std::atomic<size_t> activeConnections;
+};
+
+}}}
+
+#endif // STREAMSOCKETS_URING_H
@@ -14,9 +14,9 @@ SOURCES += \
     src/httpv1_server.cpp \
     src/httpv1_client.cpp \
     src/helpers/http_date.cpp \
+    src/helpers/http_serverconfig.cpp \
     src/cookies/http_cookies_clientside.cpp \
     src/cookies/http_cookies_serverside.cpp \
-    src/urlvars/http_urlvarcontent_subparser.cpp \
     src/urlvars/http_urlvars.cpp \
     src/urlvars/streamdecoder_url.cpp \
     src/urlvars/streamencoder_url.cpp
@@ -36,11 +36,11 @@ HEADERS += \
     src/httpv1_server.h \
     src/httpv1_client.h \
     src/helpers/http_date.h \
+    src/helpers/http_serverconfig.h \
     src/cookies/http_cookies_clientside.h \
     src/cookies/http_cookies_serverside.h \
     src/helpers/fullrequest.h \
     src/helpers/fullresponse.h \
-    src/urlvars/http_urlvarcontent_subparser.h \
     src/urlvars/http_urlvars.h \
     src/urlvars/streamdecoder_url.h \
     src/urlvars/streamencoder_url.h
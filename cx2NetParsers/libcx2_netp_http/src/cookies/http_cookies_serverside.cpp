@@ -21,6 +21,12 @@ HTTP_Cookies_ServerSide::~HTTP_Cookies_ServerSide()
     for (auto & cookie : cookiesMap) delete cookie.second;
 }
 
+void HTTP_Cookies_ServerSide::clear()
+{
+    for (auto & cookie : cookiesMap) delete cookie.second;
+    cookiesMap.clear();
+}
+
 void HTTP_Cookies_ServerSide::putOnHeaders(MIME::MIME_Sub_Header *headers) const
 {
     for (const auto & cookie :cookiesMap )
@@ -29,6 +35,16 @@ void HTTP_Cookies_ServerSide::putOnHeaders(MIME::MIME_Sub_Header *headers) const
     }
 }
 
+void HTTP_Cookies_ServerSide::appendSetCookieHeaders(string &out) const
+{
+    for (const auto & cookie :cookiesMap )
+    {
+        out+="Set-Cookie: ";
+        out+=((HTTP_Cookie *)cookie.second)->toSetCookieString(cookie.first);
+        out+="\r\n";
+    }
+}
+
 string HTTP_Cookies_ServerSide::getCookieValueByName(const string &cookieName)
 {
     HTTP_Cookie * cookieValue = getCookieByName(cookieName);
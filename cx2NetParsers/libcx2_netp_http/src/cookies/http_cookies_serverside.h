@@ -18,6 +18,11 @@ public:
     ~HTTP_Cookies_ServerSide();
 
     void putOnHeaders(MIME::MIME_Sub_Header * headers) const;
+    /**
+     * @brief appendSetCookieHeaders Append the Set-Cookie header lines to a string.
+     * @param out output string
+     */
+    void appendSetCookieHeaders(std::string & out) const;
 
     std::string getCookieValueByName(const std::string & cookieName);
     HTTP_Cookie *getCookieByName(const std::string & cookieName);
@@ -30,6 +35,10 @@ public:
      * @param cookieName cookie Name
      */
     void addClearSecureCookie(const std::string & cookieName);
+    /**
+     * @brief clear Remove all the cookies
+     */
+    void clear();
 
 private:
     std::map<std::string,HTTP_Cookie *> cookiesMap;
@@ -1,6 +1,7 @@
 #include "http_date.h"
 
 #include <string.h>
+#include <atomic>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <iostream>
 #include <sstream>
@@ -11,6 +12,14 @@ using namespace CX2::Network::HTTP;
 using namespace CX2;
 using namespace boost::posix_time;
 
+#define HTTP_DATE_CACHE_SIZE 64
+
+// Current date shared by all the threads: formatted in the slot not being read, then published
+// with its time ((seconds<<1)|slot). Only one thread formats it at a time.
+static std::atomic<uint64_t> cachedDateStamp(0);
+static std::atomic_flag cachedDateUpdating = ATOMIC_FLAG_INIT;
+static char cachedDates[2][HTTP_DATE_CACHE_SIZE];
+
 HTTP_Date::HTTP_Date()
 {
     setCurrentTime();
@@ -35,7 +44,8 @@ std::string HTTP_Date::toString()
     ptime t = from_time_t(rawTime);
     timeinfo = to_tm(t);
 
-    strftime (buffer,80,"%a, %d %b %Y %T %Z",&timeinfo);
+    // The time is in UTC (RFC 7231 IMF-fixdate)
+    strftime (buffer,sizeof(buffer),"%a, %d %b %Y %T GMT",&timeinfo);
     return std::string(buffer);
 }
 
@@ -70,3 +80,40 @@ void HTTP_Date::incTime(const uint32_t &seconds)
 {
     rawTime += seconds;
 }
+
+void HTTP_Date::appendCurrentDate(std::string &out)
+{
+    time_t now = time(nullptr);
+    uint64_t stamp = cachedDateStamp.load(std::memory_order_acquire);
+
+    if ((time_t)(stamp>>1) == now)
+    {
+        char date[HTTP_DATE_CACHE_SIZE];
+        memcpy(date, cachedDates[stamp&1], sizeof(date));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // The slot is rewritten only after publishing the other one:
+        if (cachedDateStamp.load(std::memory_order_relaxed) == stamp)
+        {
+            out+=date;
+            return;
+        }
+    }
+
+    HTTP_Date currentDate;
+    currentDate.setRawTime(now);
+    std::string date = currentDate.toString();
+    out+=date;
+
+    // Publish it (if other thread is already doing it, this one keeps its own copy):
+    if (date.size() < HTTP_DATE_CACHE_SIZE && !cachedDateUpdating.test_and_set(std::memory_order_acquire))
+    {
+        stamp = cachedDateStamp.load(std::memory_order_relaxed);
+        if ((time_t)(stamp>>1) < now)
+        {
+            uint64_t slot = (stamp&1)^1;
+            memcpy(cachedDates[slot], date.c_str(), date.size()+1);
+            cachedDateStamp.store(((uint64_t)now<<1)|slot, std::memory_order_release);
+        }
+        cachedDateUpdating.clear(std::memory_order_release);
+    }
+}
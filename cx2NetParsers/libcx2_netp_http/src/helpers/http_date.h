@@ -20,6 +20,13 @@ public:
     void setCurrentTime();
     void incTime(const uint32_t &seconds);
 
+    /**
+     * @brief appendCurrentDate Append the current date (as in toString) to a string.
+     *                          The formatted date is shared by all the threads (without locks) and is refreshed once per second.
+     * @param out output string
+     */
+    static void appendCurrentDate(std::string & out);
+
 private:
     time_t rawTime;
 };
@@ -0,0 +1,88 @@
+#include "http_serverconfig.h"
+
+using namespace CX2::Network::HTTP;
+using namespace CX2;
+
+HTTP_ServerConfig::HTTP_ServerConfig(const std::string &serverName)
+{
+    this->serverName = serverName;
+    prepareInvariantHeaders();
+}
+
+std::string HTTP_ServerConfig::getServerName() const
+{
+    return serverName;
+}
+
+void HTTP_ServerConfig::setServerName(const std::string &value)
+{
+    serverName = value;
+    prepareInvariantHeaders();
+}
+
+HTTP_Security_XFrameOpts HTTP_ServerConfig::getSecXFrameOpts() const
+{
+    return secXFrameOpts;
+}
+
+void HTTP_ServerConfig::setSecXFrameOpts(const HTTP_Security_XFrameOpts &value)
+{
+    secXFrameOpts = value;
+    prepareInvariantHeaders();
+}
+
+HTTP_Security_XSSProtection HTTP_ServerConfig::getSecXSSProtection() const
+{
+    return secXSSProtection;
+}
+
+void HTTP_ServerConfig::setSecXSSProtection(const HTTP_Security_XSSProtection &value)
+{
+    secXSSProtection = value;
+    prepareInvariantHeaders();
+}
+
+HTTP_Security_HSTS HTTP_ServerConfig::getSecHSTS() const
+{
+    return secHSTS;
+}
+
+void HTTP_ServerConfig::setSecHSTS(const HTTP_Security_HSTS &value)
+{
+    secHSTS = value;
+    prepareInvariantHeaders();
+}
+
+bool HTTP_ServerConfig::matches(const std::string &serverName, const HTTP_Security_XFrameOpts &secXFrameOpts,
+                                const HTTP_Security_XSSProtection &secXSSProtection, const HTTP_Security_HSTS &secHSTS) const
+{
+    return this->serverName == serverName && this->secXFrameOpts == secXFrameOpts &&
+            this->secXSSProtection == secXSSProtection && this->secHSTS == secHSTS;
+}
+
+const std::string &HTTP_ServerConfig::getInvariantHeaders() const
+{
+    return invariantHeaders;
+}
+
+void HTTP_ServerConfig::appendInvariantHeaders(std::string &out, const std::string &serverName, HTTP_Security_XFrameOpts &secXFrameOpts,
+                                               HTTP_Security_XSSProtection &secXSSProtection, HTTP_Security_HSTS &secHSTS)
+{
+    if (!serverName.empty())
+        out+="Server: " + serverName + "\r\n";
+
+    out+="X-XSS-Protection: " + secXSSProtection.toValue() + "\r\n";
+
+    if (!secXFrameOpts.isNotActivated())
+        out+="X-Frame-Options: " + secXFrameOpts.toValue() + "\r\n";
+
+    // TODO: check if this is a secure connection.. (Over TLS?)
+    if (secHSTS.getActivated())
+        out+="Strict-Transport-Security: " + secHSTS.toValue() + "\r\n";
+}
+
+void HTTP_ServerConfig::prepareInvariantHeaders()
+{
+    invariantHeaders.clear();
+    appendInvariantHeaders(invariantHeaders, serverName, secXFrameOpts, secXSSProtection, secHSTS);
+}
@@ -0,0 +1,63 @@
+#ifndef HTTP_SERVERCONFIG_H
+#define HTTP_SERVERCONFIG_H
+
+#include "http_security_xframeopts.h"
+#include "http_security_xssprotection.h"
+#include "http_security_hsts.h"
+
+#include <string>
+
+namespace CX2 { namespace Network { namespace HTTP {
+
+/**
+ * @brief The HTTP_ServerConfig class Response defaults shared by the server connections (server name and security options)
+ *                                    Their headers are formatted once, when configured. Set it up before accepting
+ *                                    connections, it's only read while serving.
+ */
+class HTTP_ServerConfig
+{
+public:
+    HTTP_ServerConfig(const std::string & serverName = "");
+
+    std::string getServerName() const;
+    void setServerName(const std::string &value);
+
+    HTTP_Security_XFrameOpts getSecXFrameOpts() const;
+    void setSecXFrameOpts(const HTTP_Security_XFrameOpts &value);
+
+    HTTP_Security_XSSProtection getSecXSSProtection() const;
+    void setSecXSSProtection(const HTTP_Security_XSSProtection &value);
+
+    HTTP_Security_HSTS getSecHSTS() const;
+    void setSecHSTS(const HTTP_Security_HSTS &value);
+
+    /**
+     * @brief matches Check if the response uses these defaults (and can transmit the formatted headers)
+     * @return true if the server name and the security options are the same
+     */
+    bool matches(const std::string & serverName, const HTTP_Security_XFrameOpts & secXFrameOpts,
+                 const HTTP_Security_XSSProtection & secXSSProtection, const HTTP_Security_HSTS & secHSTS) const;
+    /**
+     * @brief getInvariantHeaders Get the server name and security options headers
+     * @return headers (each one ended with \r\n)
+     */
+    const std::string & getInvariantHeaders() const;
+
+    /**
+     * @brief appendInvariantHeaders Append the server name and security options headers to a string
+     */
+    static void appendInvariantHeaders(std::string & out, const std::string & serverName, HTTP_Security_XFrameOpts & secXFrameOpts,
+                                       HTTP_Security_XSSProtection & secXSSProtection, HTTP_Security_HSTS & secHSTS);
+
+private:
+    void prepareInvariantHeaders();
+
+    std::string serverName, invariantHeaders;
+    HTTP_Security_XFrameOpts secXFrameOpts;
+    HTTP_Security_XSSProtection secXSSProtection;
+    HTTP_Security_HSTS secHSTS;
+};
+
+}}}
+
+#endif // HTTP_SERVERCONFIG_H
@@ -43,6 +43,22 @@ void HTTPv1_Base::endProtocol()
 
 }
 
+void HTTPv1_Base::resetParsers()
+{
+    std::string serverName = _serverHeaders.getOptionRawStringByName("Server");
+
+    _clientRequest.reset();
+    _clientHeaders.reset();
+    _clientContentData.reset();
+
+    _serverCodeResponse.reset();
+    _serverHeaders.reset();
+    _serverContentData.reset();
+
+    if (!serverName.empty())
+        _serverHeaders.replace("Server", serverName);
+}
+
 void HTTPv1_Base::setInternalProductVersion(const std::string &prodName, const std::string &extraInfo, const uint32_t &versionMajor, const uint32_t &versionMinor)
 {
     _serverHeaders .replace("Server",
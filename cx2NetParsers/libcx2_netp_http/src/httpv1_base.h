@@ -46,6 +46,11 @@ public:
 protected:
     virtual bool initProtocol() override;
     virtual void endProtocol() override;
+    /**
+     * @brief resetParsers Reset the request/response sub-parsers to handle the next message
+     *                     on the same connection (keep-alive). The Server header is kept.
+     */
+    void resetParsers();
 
     virtual void * getThis()=0;
     virtual bool changeToNextParser()  override = 0;
@@ -1,6 +1,7 @@
 #include "httpv1_server.h"
 
 #include <vector>
+#include <set>
 
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string.hpp>
@@ -21,12 +22,49 @@ using namespace boost::algorithm;
 using namespace CX2::Network::HTTP;
 using namespace CX2;
 
+// Headers always generated by the server (the ones in the server headers with these names are not transmitted)
+static const char * alwaysGeneratedHeaders[] = {
+    "CONNECTION", "CONTENT-LENGTH", "SET-COOKIE", "X-XSS-PROTECTION"
+};
+
+// Headers generated depending on the response/server settings (the application ones are transmitted otherwise)
+enum eHTTP_GeneratedHeaders {
+    HTTP_GENERATED_CONTENT_TYPE=0x01,
+    HTTP_GENERATED_DATE=0x02,
+    HTTP_GENERATED_SERVER=0x04,
+    HTTP_GENERATED_STRICT_TRANSPORT_SECURITY=0x08,
+    HTTP_GENERATED_TRANSFER_ENCODING=0x10,
+    HTTP_GENERATED_X_CONTENT_TYPE_OPTIONS=0x20,
+    HTTP_GENERATED_X_FRAME_OPTIONS=0x40
+};
+static const std::pair<uint32_t,const char *> conditionallyGeneratedHeaders[] = {
+    { HTTP_GENERATED_CONTENT_TYPE, "CONTENT-TYPE" },
+    { HTTP_GENERATED_DATE, "DATE" },
+    { HTTP_GENERATED_SERVER, "SERVER" },
+    { HTTP_GENERATED_STRICT_TRANSPORT_SECURITY, "STRICT-TRANSPORT-SECURITY" },
+    { HTTP_GENERATED_TRANSFER_ENCODING, "TRANSFER-ENCODING" },
+    { HTTP_GENERATED_X_CONTENT_TYPE_OPTIONS, "X-CONTENT-TYPE-OPTIONS" },
+    { HTTP_GENERATED_X_FRAME_OPTIONS, "X-FRAME-OPTIONS" }
+};
+
 HTTPv1_Server::HTTPv1_Server(Memory::Streams::Streamable *sobject) : HTTPv1_Base(false, sobject)
 {
     badAnswer = false;
+    responseIsStaticFile = false;
+    keepAlive = false;
+    keepConnection = false;
+    waitingNextRequest = false;
+    keepAliveMaxRequests = 100;
+    requestCount = 0;
     remotePairAddress[0]=0;
     currentParser = (Memory::Streams::Parsing::SubParser *)(&_clientRequest);
 
+    // The server name is transmitted with the shared headers (by default, the internal product version):
+    static const HTTP_ServerConfig defaultServerConfig(_serverHeaders.getOptionRawStringByName("Server"));
+    _serverHeaders.remove("Server");
+    setServerConfig(&defaultServerConfig);
+    skippedHeadersMask = std::numeric_limits<uint32_t>::max();
+
     // Default Mime Types (ref: https://developer.mozilla.org/en-US/docs/Web/HTTP/Basics_of_HTTP/MIME_types/Common_types)
     mimeTypes[".aac"] = "audio/aac";
     mimeTypes[".abw"] = "application/x-abiword";
@@ -175,7 +213,16 @@ Memory::Abstract::Vars *HTTPv1_Server::getRequestVars(const HTTP_VarSource &sour
 
 void HTTPv1_Server::setResponseServerName(const string &sServerName)
 {
-    _serverHeaders.replace("Server", sServerName);
+    serverName = sServerName;
+}
+
+void HTTPv1_Server::setServerConfig(const HTTP_ServerConfig *config)
+{
+    serverConfig = config;
+    serverName = config->getServerName();
+    secXFrameOpts = config->getSecXFrameOpts();
+    secXSSProtection = config->getSecXSSProtection();
+    secHSTS = config->getSecHSTS();
 }
 
 bool HTTPv1_Server::getLocalFilePathFromURI(const string &sServerDir, string *sRealRelativePath, string *sRealFullPath, const string &defaultFileAppend)
@@ -213,6 +260,7 @@ bool HTTPv1_Server::getLocalFilePathFromURI(const string &sServerDir, string *sR
                 *sRealFullPath = sFullPath;
                 *sRealRelativePath = cFullPath+cServerDirSize;
                 setResponseDataStreamer(bFile,true);
+                responseIsStaticFile = true;
                 setResponseContentTypeByFileExtension(*sRealRelativePath);
 
                 struct stat attrib;
@@ -282,6 +330,10 @@ eHTTP_RetCode HTTPv1_Server::processClientRequest()
     return HTTP_RET_200_OK;
 }
 
+void HTTPv1_Server::onWaitingNextRequest(bool)
+{
+}
+
 bool HTTPv1_Server::changeToNextParser()
 {
     // Server Mode:
@@ -375,54 +427,147 @@ bool HTTPv1_Server::changeToNextParserOnClientContentData()
     return answer(ansBytes);
 }
 
-bool HTTPv1_Server::streamServerHeaders(Memory::Streams::Status &wrStat)
+bool HTTPv1_Server::streamServerHeaders(Memory::Streams::Status &wrStat, bool &contentIncluded)
 {
     // Act as a server. Send data from here.
-    uint64_t strsize;
+    uint64_t strsize = _serverContentData.getStreamSize();
+
+    responseHead.clear();
+    _serverCodeResponse.appendTo(responseHead);
+
+    bool chunked = strsize == std::numeric_limits<uint64_t>::max() && _serverContentData.getTransmitionMode() == HTTP_CONTENT_TRANSMODE_CHUNKS;
+
+    // Options set by the application (but the ones generated below):
+    uint32_t generated = (chunked? HTTP_GENERATED_TRANSFER_ENCODING : 0) |
+            (includeServerDate? HTTP_GENERATED_DATE : 0) |
+            (!contentType.empty()? HTTP_GENERATED_CONTENT_TYPE : 0) |
+            (!contentType.empty() && bNoSniff? HTTP_GENERATED_X_CONTENT_TYPE_OPTIONS : 0) |
+            (!serverName.empty()? HTTP_GENERATED_SERVER : 0) |
+            (!secXFrameOpts.isNotActivated()? HTTP_GENERATED_X_FRAME_OPTIONS : 0) |
+            (secHSTS.getActivated()? HTTP_GENERATED_STRICT_TRANSPORT_SECURITY : 0);
+    if (generated != skippedHeadersMask)
+        prepareSkippedHeaders(generated);
+    _serverHeaders.appendTo(responseHead, &skippedHeaders);
+
+    if (chunked)
+        responseHead+="Transfer-Encoding: Chunked\r\n";
+    else if (strsize != std::numeric_limits<uint64_t>::max())
+    {
+        responseHead+="Content-Length: ";
+        responseHead+=std::to_string(strsize);
+        responseHead+="\r\n";
+    }
 
-    if ((strsize=_serverContentData.getStreamSize()) == std::numeric_limits<uint64_t>::max())
+    // Without a defined length, the end of the response is the end of the connection.
+    responseHead+=keepConnection? "Connection: Keep-Alive\r\n" : "Connection: Close\r\n";
+
+    if (includeServerDate)
+    {
+        responseHead+="Date: ";
+        HTTP_Date::appendCurrentDate(responseHead);
+        responseHead+="\r\n";
+    }
+
+    // Establish the cookies
+    setCookies.appendSetCookieHeaders(responseHead);
+
+    // Content Type...
+    if (!contentType.empty())
     {
-        // TODO: connection keep alive.
-        _serverHeaders.add("Connetion", "Close");
-        _serverHeaders.remove("Content-Length");
-        /////////////////////
-        if (_serverContentData.getTransmitionMode() == HTTP_CONTENT_TRANSMODE_CHUNKS)
-            _serverHeaders.replace("Transfer-Encoding", "Chunked");
+        responseHead+="Content-Type: ";
+        responseHead+=contentType;
+        responseHead+="\r\n";
+        if (bNoSniff) responseHead+="X-Content-Type-Options: nosniff\r\n";
     }
+
+    // Server name and security options (the security options can be modified through responseData())...
+    if (serverConfig->matches(serverName, secXFrameOpts, secXSSProtection, secHSTS))
+        responseHead+=serverConfig->getInvariantHeaders();
     else
+        HTTP_ServerConfig::appendInvariantHeaders(responseHead, serverName, secXFrameOpts, secXSSProtection, secHSTS);
+
+    responseHead+="\r\n";
+
+    // Small contents goes in the same write.
+    contentIncluded = _serverContentData.appendTo(responseHead, HTTP_SERVER_MAX_INLINE_CONTENT_SIZE);
+
+    return streamableObject->writeString(responseHead, wrStat).succeed;
+}
+
+void HTTPv1_Server::prepareSkippedHeaders(const uint32_t &generated)
+{
+    skippedHeaders.clear();
+    for (const char * header : alwaysGeneratedHeaders)
+        skippedHeaders.insert(header);
+    for (const auto & header : conditionallyGeneratedHeaders)
     {
-        _serverHeaders.remove("Connetion");
-        _serverHeaders.replace("Content-Length", std::to_string(strsize));
+        if (generated & header.first)
+            skippedHeaders.insert(header.second);
     }
+    skippedHeadersMask = generated;
+}
 
-    HTTP_Date currentDate;
-    currentDate.setCurrentTime();
-    if (includeServerDate)
-        _serverHeaders.add("Date", currentDate.toString());
+void HTTPv1_Server::prepareServerRangeResponse()
+{
+    // Only static files answered with 200 can be partially transmitted.
+    if (!responseIsStaticFile || _serverCodeResponse.getRetCode()!=200)
+        return;
 
-    // Establish the cookies
-    _serverHeaders.remove("Set-Cookie");
-    setCookies.putOnHeaders(&_serverHeaders);
+    uint64_t fileSize = _serverContentData.getStreamSize();
+    if (fileSize == std::numeric_limits<uint64_t>::max())
+        return;
 
-    // Security Options...
+    _serverHeaders.replace("Accept-Ranges", "bytes");
 
-    _serverHeaders.replace("X-XSS-Protection", secXSSProtection.toValue());
+    // We don't emit validators (ETag), so If-Range requests get the full content.
+    string range = _clientHeaders.getOptionValueStringByName("Range");
+    if (range.empty() || !_clientHeaders.getOptionValueStringByName("If-Range").empty())
+        return;
 
-    if (!secXFrameOpts.isNotActivated())
-        _serverHeaders.replace("X-Frame-Options", secXFrameOpts.toValue());
+    // Only one range is supported (bytes=first-last, bytes=first-, bytes=-suffix), otherwise send the whole file.
+    if (!istarts_with(range,"bytes=") || range.find(',')!=string::npos)
+        return;
+    string spec = trim_copy(range.substr(6));
+    size_t dash = spec.find('-');
+    if (dash == string::npos)
+        return;
+    string sFirst = trim_copy(spec.substr(0,dash)), sLast = trim_copy(spec.substr(dash+1));
+    if ((!sFirst.empty() && !all(sFirst,is_digit())) || (!sLast.empty() && !all(sLast,is_digit())) || (sFirst.empty() && sLast.empty()))
+        return;
 
-    // TODO: check if this is a secure connection.. (Over TLS?)
-    if (secHSTS.getActivated())
-        _serverHeaders.replace("Strict-Transport-Security", secHSTS.toValue());
+    uint64_t first, last = fileSize-1;
+    bool satisfiable;
+    if (sFirst.empty())
+    {
+        // Suffix range (last n bytes)
+        uint64_t suffix = strtoull(sLast.c_str(),nullptr,10);
+        satisfiable = suffix>0 && fileSize>0;
+        first = suffix>=fileSize?0:fileSize-suffix;
+    }
+    else
+    {
+        first = strtoull(sFirst.c_str(),nullptr,10);
+        if (!sLast.empty())
+        {
+            uint64_t reqLast = strtoull(sLast.c_str(),nullptr,10);
+            if (reqLast<first)
+                return; // Invalid range, ignore it.
+            if (reqLast<last) last = reqLast;
+        }
+        satisfiable = first<fileSize;
+    }
 
-    // Content Type...
-    if (!contentType.empty())
+    if (!satisfiable)
     {
-        _serverHeaders.replace("Content-Type", contentType);
-        if (bNoSniff) _serverHeaders.replace("X-Content-Type-Options", "nosniff");
+        _serverCodeResponse.setRetCode(HTTP_RET_416_RANGE_NOT_SATISFIABLE);
+        setResponseDataStreamer(nullptr);
+        _serverHeaders.replace("Content-Range", "bytes */" + std::to_string(fileSize));
+        return;
     }
 
-    return _serverHeaders.stream(wrStat);
+    _serverCodeResponse.setRetCode(HTTP_RET_206_PARTIAL_CONTENT);
+    _serverContentData.setStreamRange(first,last-first+1);
+    _serverHeaders.replace("Content-Range", "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(fileSize));
 }
 
 void HTTPv1_Server::prepareServerVersionOnURI()
@@ -479,18 +624,26 @@ bool HTTPv1_Server::answer(Memory::Streams::Status &wrStat)
     wrStat.bytesWritten = 0;
 
     // Process client petition here.
-    if (!badAnswer) _serverCodeResponse.setRetCode(processClientRequest());
+    if (!badAnswer)
+    {
+        _serverCodeResponse.setRetCode(processClientRequest());
+        prepareServerRangeResponse();
+    }
 
     //  printf("@%p attending %s\n", this, _clientRequest.getURI().c_str()); fflush(stdout);
 
-    // Answer is the last... close the connection after it.
+    // Answer is the last... close the connection after it (unless keep-alive).
     currentParser = nullptr;
+    requestCount++;
+    keepConnection = isKeepAliveAnswer();
 
-    if (!_serverCodeResponse.stream(wrStat))
-        return false;
-    if (!streamServerHeaders(wrStat))
+    bool contentIncluded;
+    if (!streamServerHeaders(wrStat,contentIncluded))
+    {
+        _serverContentData.preemptiveDestroyStreamableOuput();
         return false;
-    if (!_serverContentData.stream(wrStat))
+    }
+    if (!contentIncluded && !_serverContentData.stream(wrStat))
     {
         _serverContentData.preemptiveDestroyStreamableOuput();
         return false;
@@ -498,9 +651,91 @@ bool HTTPv1_Server::answer(Memory::Streams::Status &wrStat)
 
     // If all the data was sent OK, ret true, and destroy the external container.
     _serverContentData.preemptiveDestroyStreamableOuput();
+
+    // The response ends the connection.
+    if (!keepConnection)
+        streamableObject->writeEOF(true);
+
+    // Pipelined requests already received will be parsed after this answer (in order).
+    if (keepConnection)
+        prepareForNextRequest();
     return true;
 }
 
+bool HTTPv1_Server::isKeepAliveAnswer()
+{
+    // Bad requests (or requests answered before receiving the content) close the connection.
+    if (!keepAlive || badAnswer || requestCount>=keepAliveMaxRequests)
+        return false;
+    // The response size should be known to delimit the next response.
+    if (_serverContentData.getStreamSize() == std::numeric_limits<uint64_t>::max())
+        return false;
+    // Chunked requests are not parsed by this server, so the request end is unknown.
+    if (_clientHeaders.exist("Transfer-Encoding"))
+        return false;
+
+    string connection = _clientHeaders.getOptionValueStringByName("Connection");
+    if (_clientRequest.getHTTPVersion()->getVersionMinor()>=1)
+        return !icontains(connection,"close");
+    return icontains(connection,"keep-alive");
+}
+
+void HTTPv1_Server::prepareForNextRequest()
+{
+    resetParsers();
+    setCookies.clear();
+
+    responseIsStaticFile = false;
+    contentType.clear();
+    currentFileExtension.clear();
+    virtualHost.clear();
+    virtualPort = 80;
+
+    // The response options changed by the previous request go back to the server defaults:
+    secXFrameOpts = serverConfig->getSecXFrameOpts();
+    secXSSProtection = serverConfig->getSecXSSProtection();
+    secHSTS = serverConfig->getSecHSTS();
+    ansBytes = Memory::Streams::Status();
+    badAnswer = false;
+
+    currentParser = &_clientRequest;
+    waitingNextRequest = true;
+    onWaitingNextRequest(true);
+}
+
+Memory::Streams::Status HTTPv1_Server::write(const void *buf, const size_t &count, Memory::Streams::Status &wrStat)
+{
+    if (count && waitingNextRequest)
+    {
+        waitingNextRequest = false;
+        onWaitingNextRequest(false);
+    }
+    return HTTPv1_Base::write(buf,count,wrStat);
+}
+
+void HTTPv1_Server::writeEOF(bool b)
+{
+    // The client closed the connection (or the idle timeout expired) between requests.
+    if (waitingNextRequest)
+        return;
+    HTTPv1_Base::writeEOF(b);
+}
+
+void HTTPv1_Server::setKeepAlive(bool value)
+{
+    keepAlive = value;
+}
+
+void HTTPv1_Server::setKeepAliveMaxRequests(const uint32_t &value)
+{
+    keepAliveMaxRequests = value;
+}
+
+uint32_t HTTPv1_Server::getRequestCount() const
+{
+    return requestCount;
+}
+
 std::string HTTPv1_Server::getContentType() const
 {
     return contentType;
@@ -644,6 +879,7 @@ uint16_t HTTPv1_Server::getRequestVirtualPort() const
 
 void HTTPv1_Server::setResponseDataStreamer(Memory::Streams::Streamable *dsOut, bool bDeleteAfter)
 {
+    responseIsStaticFile = false;
     _serverContentData.setStreamableOutput(dsOut,bDeleteAfter);
 }
 
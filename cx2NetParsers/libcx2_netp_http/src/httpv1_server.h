@@ -8,6 +8,9 @@
 
 #include "http_cookies_clientside.h"
 #include "http_cookies_serverside.h"
+#include "http_serverconfig.h"
+
+#include <set>
 
 // TODO: https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Access-Control-Allow-Credentials
 
@@ -15,6 +18,9 @@
 #define INET6_ADDRSTRLEN 46
 #endif
 
+// Responses with contents up to this size are transmitted with the headers in one write.
+#define HTTP_SERVER_MAX_INLINE_CONTENT_SIZE 16384
+
 namespace CX2 { namespace Network { namespace HTTP {
 
 enum HTTP_VarSource
@@ -91,12 +97,19 @@ public:
     // RESPONSE:
     sHTTP_ResponseData responseData();
     /**
-     * @brief setServerTokens Set Server Header
+     * @brief setServerTokens Set Server Header (the Server option in the response headers is ignored)
      * @param serverTokens Server Header Product Name and Version (eg. MyLLS/5.0)
      */
     void setResponseServerName(const std::string &sServerName);
+    /**
+     * @brief setServerConfig Use the response defaults shared by the server connections (server name and security options)
+     *                        Their preformatted headers are transmitted when the response doesn't change them.
+     * @param config shared configuration (should outlive this connection, and not be modified while serving)
+     */
+    void setServerConfig(const HTTP_ServerConfig * config);
     /**
      * @brief getLocalFilePathFromURI Set the container as MMAP from file
+     *                                (static files are served with Range support and transmitted using sendfile when possible)
      * @param sServerDir
      * @param sRealRelativePath
      * @param sRealFullPath
@@ -211,6 +224,34 @@ public:
     bool getIsSecure() const;
     void setIsSecure(bool value);
 
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // KEEP-ALIVE:
+    /**
+     * @brief setKeepAlive Keep the connection open after answering the request (HTTP/1.1 persistent connections, default: false)
+     *                     The idle timeout between requests should be enforced by the socket read timeout (see onWaitingNextRequest).
+     * @param value true to keep the connection when the client accepts it and the response has a defined length
+     */
+    void setKeepAlive(bool value);
+    /**
+     * @brief setKeepAliveMaxRequests Set the max requests answered on the same connection (default: 100)
+     * @param value max requests
+     */
+    void setKeepAliveMaxRequests(const uint32_t &value);
+    /**
+     * @brief getRequestCount Get the requests answered on this connection
+     * @return request count
+     */
+    uint32_t getRequestCount() const;
+
+    /**
+     * @brief write Parse the incoming data (marks the connection as active when waiting the next request)
+     */
+    Memory::Streams::Status write(const void * buf, const size_t &count, Memory::Streams::Status &wrStat) override;
+    /**
+     * @brief writeEOF Connection ended, idle keep-alive connections don't have anything to parse.
+     */
+    void writeEOF(bool) override;
+
 
 
 
@@ -232,6 +273,11 @@ protected:
     * @return true
     */
     virtual eHTTP_RetCode processClientRequest();
+    /**
+    * @brief onWaitingNextRequest Virtual function called when the connection starts (true) or ends (false)
+    *                             waiting for the next keep-alive request (eg. to apply an idle timeout).
+    */
+    virtual void onWaitingNextRequest(bool waiting);
 
     void * getThis() override { return this; }
     bool changeToNextParser() override;
@@ -242,7 +288,19 @@ private:
     bool changeToNextParserOnClientHeaders();
     bool changeToNextParserOnClientRequest();
     bool changeToNextParserOnClientContentData();
-    bool streamServerHeaders(Memory::Streams::Status &wrStat);
+    /**
+     * @brief streamServerHeaders Transmit the status line and the headers in one write (and the content if it's small)
+     * @param contentIncluded true if the content was transmitted with the headers
+     */
+    bool streamServerHeaders(Memory::Streams::Status &wrStat, bool &contentIncluded);
+    /**
+     * @brief prepareSkippedHeaders Set the application headers to be omitted (the ones generated by the server)
+     * @param generated eHTTP_GeneratedHeaders flags of the conditionally generated headers
+     */
+    void prepareSkippedHeaders(const uint32_t & generated);
+    void prepareServerRangeResponse();
+    bool isKeepAliveAnswer();
+    void prepareForNextRequest();
     void prepareServerVersionOnURI();
 
     void prepareServerVersionOnOptions();
@@ -255,13 +313,24 @@ private:
     HTTP_Security_XSSProtection secXSSProtection;
     HTTP_Security_HSTS secHSTS;
 
+    std::string serverName;
+    // Response defaults (and their headers), shared by the server connections.
+    const HTTP_ServerConfig * serverConfig;
+    // Application headers omitted because the server generates them, rebuilt when the generated ones change.
+    std::set<std::string> skippedHeaders;
+    uint32_t skippedHeadersMask;
+    // Response status line/headers serialization buffer (reused between requests).
+    std::string responseHead;
+
     bool badAnswer;
     Memory::Streams::Status ansBytes;
     uint16_t virtualPort;
     std::string virtualHost;
     std::string contentType;
     std::string currentFileExtension;
-    bool bNoSniff, isSecure, includeServerDate;
+    bool bNoSniff, isSecure, includeServerDate, responseIsStaticFile;
+    bool keepAlive, keepConnection, waitingNextRequest;
+    uint32_t keepAliveMaxRequests, requestCount;
     std::map<std::string,std::string> mimeTypes;
 };
 
@@ -103,3 +103,13 @@ bool HTTP_Security_HSTS::fromValue(const std::string &sValue)
     }
     return true;
 }
+
+bool HTTP_Security_HSTS::operator==(const HTTP_Security_HSTS &other) const
+{
+    return activated==other.activated && preload==other.preload && includeSubDomains==other.includeSubDomains && maxAge==other.maxAge;
+}
+
+bool HTTP_Security_HSTS::operator!=(const HTTP_Security_HSTS &other) const
+{
+    return !(*this==other);
+}
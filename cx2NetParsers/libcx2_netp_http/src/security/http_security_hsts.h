@@ -31,6 +31,12 @@ public:
     std::string toValue();
     bool fromValue(const std::string & sValue);
 
+    /**
+     * @brief operator == Compare all the options (eg. to know if the header value changed)
+     */
+    bool operator==(const HTTP_Security_HSTS & other) const;
+    bool operator!=(const HTTP_Security_HSTS & other) const;
+
 private:
     bool activated,preload,includeSubDomains;
     uint32_t maxAge;
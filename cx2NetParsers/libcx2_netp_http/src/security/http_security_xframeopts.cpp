@@ -98,3 +98,13 @@ eHTTP_Security_XFrameOptsValues HTTP_Security_XFrameOpts::getValue() const
 {
     return value;
 }
+
+bool HTTP_Security_XFrameOpts::operator==(const HTTP_Security_XFrameOpts &other) const
+{
+    return value==other.value && fromURL==other.fromURL;
+}
+
+bool HTTP_Security_XFrameOpts::operator!=(const HTTP_Security_XFrameOpts &other) const
+{
+    return !(*this==other);
+}
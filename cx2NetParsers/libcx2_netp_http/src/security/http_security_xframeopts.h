@@ -23,6 +23,12 @@ public:
     std::string toValue();
     bool fromValue(const std::string & sValue);
 
+    /**
+     * @brief operator == Compare all the options (eg. to know if the header value changed)
+     */
+    bool operator==(const HTTP_Security_XFrameOpts & other) const;
+    bool operator!=(const HTTP_Security_XFrameOpts & other) const;
+
     std::string getFromURL() const;
     void setFromURL(const std::string &value);
 
@@ -98,3 +98,13 @@ bool HTTP_Security_XSSProtection::fromValue(const string &sValue)
     }
     return true;
 }
+
+bool HTTP_Security_XSSProtection::operator==(const HTTP_Security_XSSProtection &other) const
+{
+    return activated==other.activated && blocking==other.blocking && reportURL==other.reportURL;
+}
+
+bool HTTP_Security_XSSProtection::operator!=(const HTTP_Security_XSSProtection &other) const
+{
+    return !(*this==other);
+}
@@ -24,6 +24,12 @@ public:
     std::string toValue();
     bool fromValue(const std::string & sValue);
 
+    /**
+     * @brief operator == Compare all the options (eg. to know if the header value changed)
+     */
+    bool operator==(const HTTP_Security_XSSProtection & other) const;
+    bool operator!=(const HTTP_Security_XSSProtection & other) const;
+
 
 private:
     bool activated;
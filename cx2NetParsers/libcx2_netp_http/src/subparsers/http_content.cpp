@@ -17,6 +17,9 @@ HTTP_Content::HTTP_Content()
     containerType = HTTP_CONTAINERTYPE_BIN;
     outStream = &binDataContainer;
     deleteOutStream = false;
+    useStreamRange = false;
+    streamRangeOffset = 0;
+    streamRangeCount = 0;
 }
 
 HTTP_Content::~HTTP_Content()
@@ -194,12 +197,57 @@ bool HTTP_Content::stream(Memory::Streams::Status & wrStat)
     case HTTP_CONTENT_TRANSMODE_CONTENT_LENGTH:
     case HTTP_CONTENT_TRANSMODE_CONNECTION_CLOSE:
     {
+        // Memory containers are appended without signaling the EOF (the connection may transmit another message)
+        Memory::Containers::B_Base * container = dynamic_cast<Memory::Containers::B_Base *>(outStream);
+        if (container)
+        {
+            std::pair<bool,uint64_t> appended = useStreamRange? container->appendTo(*upStream, wrStat, streamRangeCount, streamRangeOffset) :
+                                                                container->appendTo(*upStream, wrStat);
+            return appended.first && (!useStreamRange || appended.second==streamRangeCount) && upStream->getFailedWriteState()==0;
+        }
+        if (useStreamRange)
+            return outStream->streamRangeTo(upStream, wrStat, streamRangeOffset, streamRangeCount) && upStream->getFailedWriteState()==0;
         return outStream->streamTo(upStream, wrStat) && upStream->getFailedWriteState()==0;
     }
     }
     return true;
 }
 
+bool HTTP_Content::appendTo(std::string &out, const uint64_t &maxBytes)
+{
+    if (transmitionMode == HTTP_CONTENT_TRANSMODE_CHUNKS)
+        return false;
+
+    Memory::Containers::B_Base * container = dynamic_cast<Memory::Containers::B_Base *>(outStream);
+    uint64_t bytes = getStreamSize();
+    if (!container || bytes>maxBytes)
+        return false;
+
+    size_t prevSize = out.size();
+    out.resize(prevSize+bytes);
+    std::pair<bool,uint64_t> copied = container->copyOut(&out[prevSize], bytes, useStreamRange?streamRangeOffset:0);
+    if (!copied.first || copied.second!=bytes)
+    {
+        out.resize(prevSize);
+        return false;
+    }
+    return true;
+}
+
+void HTTP_Content::reset()
+{
+    SubParser::reset();
+    preemptiveDestroyStreamableOuput();
+    outStream = &binDataContainer;
+    useStreamRange = false;
+    urlVars.reset();
+    multiPartVars.reset();
+    transmitionMode = HTTP_CONTENT_TRANSMODE_CONNECTION_CLOSE;
+    currentMode = HTTP_CONTENTDATA_CURRMODE_CONTENT_LENGTH;
+    currentContentLengthSize = 0;
+    containerType = HTTP_CONTAINERTYPE_BIN;
+}
+
 void HTTP_Content::setTransmitionMode(const eHTTP_Content_Transmition_Mode &value)
 {
     transmitionMode = value;
@@ -281,6 +329,7 @@ void HTTP_Content::setStreamableOutput(Memory::Streams::Streamable *outDataConta
 
     this->deleteOutStream = deleteOutStream;
     this->outStream = outDataContainer;
+    this->useStreamRange = false;
 
     if (this->outStream == nullptr)
     {
@@ -289,8 +338,17 @@ void HTTP_Content::setStreamableOutput(Memory::Streams::Streamable *outDataConta
     }
 }
 
+void HTTP_Content::setStreamRange(const uint64_t &offset, const uint64_t &count)
+{
+    useStreamRange = true;
+    streamRangeOffset = offset;
+    streamRangeCount = count;
+}
+
 uint64_t HTTP_Content::getStreamSize()
 {
+    if (useStreamRange)
+        return streamRangeCount;
     return outStream->size();
 }
 
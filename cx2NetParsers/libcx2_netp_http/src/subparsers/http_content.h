@@ -55,7 +55,14 @@ public:
     Memory::Streams::Streamable * getStreamableOuput();
     void setStreamableOutput(Memory::Streams::Streamable * outStream, bool deleteOutStream = false);
     /**
-     * @brief getStreamSize Get stream full size ()
+     * @brief setStreamRange Transmit only a range of the streamable output (eg. HTTP Range requests)
+     *                       the range is cleared when the streamable output is replaced.
+     * @param offset starting offset in bytes.
+     * @param count bytes to be transmitted.
+     */
+    void setStreamRange(const uint64_t & offset, const uint64_t & count);
+    /**
+     * @brief getStreamSize Get stream full size () or the range size if a range was defined.
      * @return std::numeric_limits<uint64_t>::max() if size not defined, or >=0 if size defined.
      */
     uint64_t getStreamSize();
@@ -67,6 +74,18 @@ public:
     void setSecurityMaxHttpChunkSize(const uint32_t &value);
 
     bool stream(Memory::Streams::Status & wrStat) override;
+    /**
+     * @brief appendTo Append the content to a string (to be transmitted with the headers)
+     *                 Only content with a defined length kept in a memory container can be appended.
+     * @param out output string
+     * @param maxBytes max content size to be appended
+     * @return true if appended, false if the content should be transmitted using stream().
+     */
+    bool appendTo(std::string & out, const uint64_t & maxBytes);
+    /**
+     * @brief reset Release the streamable output and clear the content vars/state (to reuse this object on a new message)
+     */
+    void reset() override;
 
     eHTTP_ContainerType getContainerType() const;
 
@@ -82,6 +101,9 @@ private:
     Memory::Streams::Streamable * outStream;
     bool deleteOutStream;
 
+    bool useStreamRange;
+    uint64_t streamRangeOffset, streamRangeCount;
+
     uint32_t parseHttpChunkSize();
 
     // Parsing Optimization:
@@ -35,6 +35,15 @@ bool HTTP_Request::stream(Memory::Streams::Status & wrStat)
     return true;
 }
 
+void HTTP_Request::reset()
+{
+    SubParser::reset();
+    requestMethod = "GET";
+    requestURI.clear();
+    requestURIParameters.clear();
+    getVars.reset();
+}
+
 Memory::Streams::Parsing::ParseStatus HTTP_Request::parse()
 {
     std::string clientRequest = getParsedData()->toString();
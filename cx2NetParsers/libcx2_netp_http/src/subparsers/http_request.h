@@ -23,6 +23,10 @@ public:
      * @return true if written successfully/
      */
     bool stream(Memory::Streams::Status & wrStat) override;
+    /**
+     * @brief reset Clear the request line and GET vars (to parse a new request on the same connection)
+     */
+    void reset() override;
 
     ////////////////////////////////////////////////
     // Objects:
@@ -114,11 +114,18 @@ void HTTP_Status::setResponseMessage(const std::string &value)
 bool HTTP_Status::stream(Memory::Streams::Status & wrStat)
 {
     // Act as a client. Send data from here.
-    return upStream->writeString(  httpVersion.getHTTPVersionString()
-                                 +  " "
-                                 +  std::to_string(responseCode)
-                                 +  " "
-                                 +  responseMessage + "\r\n",wrStat).succeed;
+    std::string statusLine;
+    appendTo(statusLine);
+    return upStream->writeString(statusLine,wrStat).succeed;
+}
+
+void HTTP_Status::appendTo(string &out)
+{
+    char w[64];
+    snprintf(w,sizeof(w),"HTTP/%u.%u %u ", httpVersion.getVersionMajor(), httpVersion.getVersionMinor(), responseCode);
+    out+=w;
+    out+=responseMessage;
+    out+="\r\n";
 }
 
 void HTTP_Status::setRetCodeValue(unsigned short value)
@@ -57,6 +57,11 @@ public:
     void setResponseMessage(const std::string &value);
 
     bool stream(Memory::Streams::Status & wrStat) override;
+    /**
+     * @brief appendTo Append the status line (eg. HTTP/1.1 200 OK\r\n) to a string.
+     * @param out output string
+     */
+    void appendTo(std::string & out);
 protected:
     Memory::Streams::Parsing::ParseStatus parse() override;
 
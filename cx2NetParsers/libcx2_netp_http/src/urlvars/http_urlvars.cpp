@@ -1,30 +1,81 @@
 #include "http_urlvars.h"
 
 #include "streamencoder_url.h"
-#include <boost/algorithm/string.hpp>
+#include <cx2_hlp_functions/mem.h>
+
+#include <random>
+
+#include <string.h>
+#include <ctype.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-using namespace boost;
-using namespace boost::algorithm;
 using namespace CX2::Network::HTTP;
 using namespace CX2;
 
-HTTP_URLVars::HTTP_URLVars(Memory::Streams::Streamable *value) : Memory::Streams::Parsing::Parser(value,false)
+/**
+ * @brief findSpecialByte Find the next byte that needs processing ('&', '%', '+' and '=' in names).
+ * @return position of the byte (or count)
+ */
+static size_t findSpecialByte(const char * buf, const size_t & count, bool parsingValue)
 {
-    initSubParser(&_urlVarParser);
+    size_t i = 0;
+#ifdef __SSE2__
+    // Compare 16 bytes at time:
+    const __m128i amp = _mm_set1_epi8('&'), pct = _mm_set1_epi8('%'), plus = _mm_set1_epi8('+');
+    const __m128i eq = _mm_set1_epi8(parsingValue? '&' : '=');
+    for (; i+16<=count; i+=16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(buf+i));
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v,amp),_mm_cmpeq_epi8(v,eq)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v,pct),_mm_cmpeq_epi8(v,plus)));
+        int mask = _mm_movemask_epi8(m);
+        if (mask)
+            return i+__builtin_ctz(mask);
+    }
+#endif
+    for (; i<count; i++)
+    {
+        char c = buf[i];
+        if (c=='&' || c=='%' || c=='+' || (c=='=' && !parsingValue))
+            return i;
+    }
+    return count;
+}
 
-    initialized = initProtocol();
-    currentStat = URLV_STAT_WAITING_NAME;
-    _urlVarParser.setVarType(true);
+static inline int hexValue(unsigned char byte)
+{
+    if (byte>='0' && byte<='9') return byte-'0';
+    else if (byte>='A' && byte<='F') return byte-'A'+10;
+    else if (byte>='a' && byte<='f') return byte-'a'+10;
+    return -1;
+}
 
+HTTP_URLVars::HTTP_URLVars(Memory::Streams::Streamable *)
+{
     setMaxVarNameSize(4096);
     setMaxVarContentSize(4096);
-
-    currentParser = &_urlVarParser;
+    reset();
 }
 
 HTTP_URLVars::~HTTP_URLVars()
 {
-    for (auto & i : vars) delete i.second;
+}
+
+void HTTP_URLVars::reset()
+{
+    arena.clear();
+    vars.clear();
+    index.clear();
+    valueViews.clear();
+    namesCount = 0;
+    parsePos = decodedPos = tokenOffset = 0;
+    currentNameOffset = currentNameSize = 0;
+    parsingValue = false;
+    finished = false;
+    setFailedWriteState(0);
 }
 
 bool HTTP_URLVars::isEmpty()
@@ -36,7 +87,7 @@ bool HTTP_URLVars::streamTo(Memory::Streams::Streamable *out, Memory::Streams::S
 {
     Memory::Streams::Status cur;
     bool firstVar = true;
-    for (auto & i : vars)
+    for (const sURLVar & var : vars)
     {
         if (firstVar) firstVar=false;
         else
@@ -45,25 +96,20 @@ bool HTTP_URLVars::streamTo(Memory::Streams::Streamable *out, Memory::Streams::S
                 return false;
         }
 
-        Memory::Containers::B_Chunks varName;
-        varName.append(i.first.c_str(), i.first.size());
-
         Memory::Streams::Encoders::URL varNameEncoder(out);
-        //bytesWritten+=varNameEncoder.getFinalBytesWritten();
-        if (!(cur+=varName.streamTo(&varNameEncoder, wrsStat)).succeed)
+        if (!(cur+=varNameEncoder.writeFullStream(arena.data()+var.nameOffset, var.nameSize, wrsStat)).succeed)
         {
             out->writeEOF(false);
             return false;
         }
 
-        if (((Memory::Containers::B_Chunks *)i.second)->size())
+        if (var.valueSize)
         {
             if (!(cur+=out->writeString("=",wrsStat)).succeed)
                 return false;
 
-            Memory::Streams::Encoders::URL varNameEncoder2(out);
-            //writtenBytes+=varNameEncoder2.getFinalBytesWritten();
-            if (!((Memory::Containers::B_Chunks *)i.second)->streamTo(&varNameEncoder2,wrsStat))
+            Memory::Streams::Encoders::URL varValueEncoder(out);
+            if (!(cur+=varValueEncoder.writeFullStream(arena.data()+var.valueOffset, var.valueSize, wrsStat)).succeed)
             {
                 out->writeEOF(false);
                 return false;
@@ -74,95 +120,270 @@ bool HTTP_URLVars::streamTo(Memory::Streams::Streamable *out, Memory::Streams::S
     return true;
 }
 
+Memory::Streams::Status HTTP_URLVars::write(const void *buf, const size_t &count, Memory::Streams::Status &wrStatUpd)
+{
+    Memory::Streams::Status cur;
+
+    if (finished || getFailedWriteState())
+    {
+        cur.succeed=wrStatUpd.succeed=setFailedWriteState();
+        return cur;
+    }
+
+    const char * prevArena = arena.data();
+    arena.insert(arena.end(), (const char *)buf, (const char *)buf+count);
+
+    // The arena moved, move the value views too:
+    if (arena.data()!=prevArena)
+    {
+        for (sURLVar & var : vars)
+        {
+            if (var.value)
+                var.value->reference(arena.data()+var.valueOffset, var.valueSize);
+        }
+    }
+
+    if (!parseArena(false))
+    {
+        cur.succeed=wrStatUpd.succeed=setFailedWriteState();
+        return cur;
+    }
+
+    cur+=(uint64_t)count;
+    wrStatUpd+=(uint64_t)count;
+    return cur;
+}
+
+void HTTP_URLVars::writeEOF(bool)
+{
+    if (finished || getFailedWriteState())
+        return;
+    if (!parseArena(true))
+        setFailedWriteState();
+    finished = true;
+}
+
 uint32_t HTTP_URLVars::varCount(const std::string &varName)
 {
     uint32_t i=0;
-    auto range = vars.equal_range(boost::to_upper_copy(varName));
-    for (auto iterator = range.first; iterator != range.second;) i++;
+    for (size_t pos = findVar(varName.c_str(), varName.size(), hashName(varName.c_str(), varName.size()));
+         pos != SIZE_MAX; pos = vars[pos].nextSameName)
+        i++;
     return i;
 }
 
 Memory::Containers::B_Base *HTTP_URLVars::getValue(const std::string &varName)
 {
-    auto range = vars.equal_range(boost::to_upper_copy(varName));
-    for (auto iterator = range.first; iterator != range.second;) return iterator->second;
-    return nullptr;
+    size_t pos = findVar(varName.c_str(), varName.size(), hashName(varName.c_str(), varName.size()));
+    if (pos == SIZE_MAX)
+        return nullptr;
+    return getValueView(vars[pos]);
 }
 
 std::list<Memory::Containers::B_Base *> HTTP_URLVars::getValues(const std::string &varName)
 {
     std::list<Memory::Containers::B_Base *> r;
-    auto range = vars.equal_range(boost::to_upper_copy(varName));
-    for (auto iterator = range.first; iterator != range.second;) r.push_back(iterator->second);
+    for (size_t pos = findVar(varName.c_str(), varName.size(), hashName(varName.c_str(), varName.size()));
+         pos != SIZE_MAX; pos = vars[pos].nextSameName)
+        r.push_back(getValueView(vars[pos]));
     return r;
 }
 
 std::set<std::string> HTTP_URLVars::getKeysList()
 {
     std::set<std::string> r;
-    for ( const auto & i : vars ) r.insert(i.first);
+    for ( const sURLVar & var : vars )
+    {
+        std::string name(arena.data()+var.nameOffset, var.nameSize);
+        for (char & c : name) c = toupper((unsigned char)c);
+        r.insert(name);
+    }
     return r;
 }
 
-bool HTTP_URLVars::initProtocol()
+bool HTTP_URLVars::parseArena(bool eof)
 {
+    char * a = arena.data();
+    size_t end = arena.size();
+
+    // The decoded data is written over the already scanned data (it's never longer):
+    while (parsePos<end)
+    {
+        size_t plainBytes = findSpecialByte(a+parsePos, end-parsePos, parsingValue);
+        if (plainBytes)
+        {
+            if (decodedPos!=parsePos)
+                memmove(a+decodedPos, a+parsePos, plainBytes);
+            decodedPos+=plainBytes;
+            parsePos+=plainBytes;
+        }
+
+        if (decodedPos-tokenOffset > (parsingValue? maxVarContentSize : maxVarNameSize))
+            return false;
+
+        if (parsePos==end)
+            break;
+
+        switch (a[parsePos])
+        {
+        case '+':
+            a[decodedPos++] = ' ';
+            parsePos++;
+            break;
+        case '%':
+        {
+            if (end-parsePos<3 && !eof)
+                return true; // Wait for the rest of the escape sequence.
+
+            int h, l;
+            if (end-parsePos>=3 && (h=hexValue(a[parsePos+1]))!=-1 && (l=hexValue(a[parsePos+2]))!=-1)
+            {
+                a[decodedPos++] = (char)(h*0x10+l);
+                parsePos+=3;
+            }
+            else
+            {
+                // Not an escape sequence, keep it as is.
+                a[decodedPos++] = '%';
+                parsePos++;
+            }
+        }break;
+        case '=':
+            currentNameOffset = tokenOffset;
+            currentNameSize = decodedPos-tokenOffset;
+            tokenOffset = decodedPos;
+            parsingValue = true;
+            parsePos++;
+            break;
+        case '&':
+            completeVar();
+            parsePos++;
+            break;
+        default:
+            break;
+        }
+
+        if (decodedPos-tokenOffset > (parsingValue? maxVarContentSize : maxVarNameSize))
+            return false;
+    }
+
+    if (eof && (parsingValue || decodedPos!=tokenOffset))
+        completeVar();
+
     return true;
 }
 
-void HTTP_URLVars::endProtocol()
+void HTTP_URLVars::completeVar()
 {
+    if (parsingValue)
+        insertVar(currentNameOffset, currentNameSize, tokenOffset, decodedPos-tokenOffset);
+    else
+        insertVar(tokenOffset, decodedPos-tokenOffset, decodedPos, 0);
+
+    parsingValue = false;
+    tokenOffset = decodedPos;
 }
 
-bool HTTP_URLVars::changeToNextParser()
+void HTTP_URLVars::insertVar(const size_t &nameOffset, const size_t &nameSize, const size_t &valueOffset, const size_t &valueSize)
 {
-    switch(currentStat)
-    {
-    case URLV_STAT_WAITING_NAME:
+    // Vars without name are discarded.
+    if (!nameSize)
+        return;
+
+    sURLVar var;
+    var.nameOffset = nameOffset;
+    var.nameSize = nameSize;
+    var.valueOffset = valueOffset;
+    var.valueSize = valueSize;
+    var.nameHash = hashName(arena.data()+nameOffset, nameSize);
+    var.nextSameName = SIZE_MAX;
+    var.lastSameName = SIZE_MAX;
+    var.value = nullptr;
+
+    size_t pos = vars.size();
+    size_t first = findVar(arena.data()+nameOffset, nameSize, var.nameHash);
+    if (first != SIZE_MAX)
     {
-        currentVarName = _urlVarParser.flushRetrievedContentAsString();
-        if (_urlVarParser.getDelimiterFound() == "&" || _urlVarParser.isStreamEnded())
-        {
-            // AMP / END:
-            insertVar(currentVarName, _urlVarParser.flushRetrievedContentAsBC());
-        }
-        else
-        {
-            // EQUAL:
-            currentStat = URLV_STAT_WAITING_CONTENT;
-            _urlVarParser.setVarType(false);
-            _urlVarParser.setMaxObjectSize(maxVarContentSize);
-        }
-    }break;
-    case URLV_STAT_WAITING_CONTENT:
+        // Link after the last var with the same name:
+        vars[vars[first].lastSameName==SIZE_MAX? first : vars[first].lastSameName].nextSameName = pos;
+        vars[first].lastSameName = pos;
+    }
+    else
     {
-        insertVar(currentVarName, _urlVarParser.flushRetrievedContentAsBC());
-        currentStat = URLV_STAT_WAITING_NAME;
-        _urlVarParser.setVarType(true);
-        _urlVarParser.setMaxObjectSize(maxVarNameSize);
-    }break;
-    default:
-        break;
+        // New name, index it (keeping the table at most half full):
+        if ((namesCount+1)*2 > index.size())
+            growIndex();
+        size_t mask = index.size()-1;
+        size_t i = var.nameHash & mask;
+        while (index[i]) i = (i+1) & mask;
+        index[i] = pos+1;
+        namesCount++;
     }
 
-    return true;
+    vars.push_back(var);
 }
 
-void HTTP_URLVars::insertVar(const std::string &varName, Memory::Containers::B_Chunks *data)
+size_t HTTP_URLVars::findVar(const char *name, const size_t &nameSize, const uint64_t &nameHash)
 {
-    //vars.insert(std::pair<std::string,Memory::Containers::B_Chunks*>(currentVarName, _urlVarParser.flushRetrievedContentAsBC()));
-    if (!varName.empty())
-        vars.insert(std::pair<std::string,Memory::Containers::B_Chunks*>(boost::to_upper_copy(varName), data));
-    else
-        delete data;
+    if (index.empty())
+        return SIZE_MAX;
+
+    size_t mask = index.size()-1;
+    for (size_t i = nameHash & mask; index[i]; i = (i+1) & mask)
+    {
+        const sURLVar & var = vars[index[i]-1];
+        if (var.nameHash == nameHash && var.nameSize == nameSize &&
+                !Helpers::Mem::memicmp2(arena.data()+var.nameOffset, name, nameSize, false))
+            return index[i]-1;
+    }
+    return SIZE_MAX;
 }
 
+void HTTP_URLVars::growIndex()
+{
+    std::vector<size_t> nIndex(index.empty()? 16 : index.size()*2, 0);
+    size_t mask = nIndex.size()-1;
+    for (size_t slot : index)
+    {
+        if (!slot) continue;
+        size_t i = vars[slot-1].nameHash & mask;
+        while (nIndex[i]) i = (i+1) & mask;
+        nIndex[i] = slot;
+    }
+    index.swap(nIndex);
+}
 
-void HTTP_URLVars::iSetMaxVarContentSize()
+Memory::Containers::B_MEM *HTTP_URLVars::getValueView(sURLVar &var)
 {
-    if (currentStat == URLV_STAT_WAITING_CONTENT) _urlVarParser.setMaxObjectSize(maxVarContentSize);
+    if (!var.value)
+    {
+        valueViews.emplace_back(arena.data()+var.valueOffset, var.valueSize);
+        var.value = &valueViews.back();
+    }
+    return var.value;
 }
 
-void HTTP_URLVars::iSetMaxVarNameSize()
+uint64_t HTTP_URLVars::hashName(const char *name, const size_t &size)
 {
-    if (currentStat == URLV_STAT_WAITING_NAME) _urlVarParser.setMaxObjectSize(maxVarNameSize);
+    // Random per process, so the names that collide in the index can't be precomputed by the client:
+    static const uint64_t seed = []() {
+        std::random_device rd;
+        return ((uint64_t)rd() << 32) ^ rd();
+    }();
+
+    // Seeded FNV-1a over the upper case name:
+    uint64_t h = 14695981039346656037ULL ^ seed;
+    for (size_t i=0; i<size; i++)
+    {
+        h ^= (unsigned char)toupper((unsigned char)name[i]);
+        h *= 1099511628211ULL;
+    }
+
+    // Final avalanche (murmur3 fmix64), the index uses the low bits:
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
 }
@@ -1,21 +1,21 @@
 #ifndef HTTPURLFORMATTEDVARS_H
 #define HTTPURLFORMATTEDVARS_H
 
-#include <cx2_mem_vars/streamparser.h>
+#include <cx2_mem_vars/streamable.h>
 #include <cx2_mem_vars/vars.h>
-#include <map>
+#include <cx2_mem_vars/b_mem.h>
 
-#include "http_urlvarcontent_subparser.h"
+#include <deque>
+#include <vector>
 
 namespace CX2 { namespace Network { namespace HTTP {
 
-enum eHTTP_URLVarStat
-{
-    URLV_STAT_WAITING_NAME,
-    URLV_STAT_WAITING_CONTENT
-};
-
-class HTTP_URLVars : public Memory::Abstract::Vars, public Memory::Streams::Parsing::Parser
+/**
+ * @brief The HTTP_URLVars class parse application/x-www-form-urlencoded data (eg. query strings and POST forms).
+ *        The data is kept in one memory arena, and decoded in place while it's scanned (only once), the
+ *        variables are indexed by name (case insensitive) in a flat hash table (with a per-process hash seed).
+ */
+class HTTP_URLVars : public Memory::Abstract::Vars, public Memory::Streams::Streamable
 {
 public:
     HTTP_URLVars(Memory::Streams::Streamable *value = nullptr);
@@ -24,31 +24,74 @@ public:
     /////////////////////////////////////////////////////
     // Stream Parsing:
     bool streamTo(Memory::Streams::Streamable * out, Memory::Streams::Status & wrsStat) override;
+    Memory::Streams::Status write(const void * buf, const size_t &count, Memory::Streams::Status & wrStatUpd) override;
+    /**
+     * @brief writeEOF Complete the last variable.
+     */
+    void writeEOF(bool) override;
+    /**
+     * @brief reset Remove all the variables and restart the parser.
+     */
+    void reset();
 
     /////////////////////////////////////////////////////
     // Variables Container:
     uint32_t varCount(const std::string & varName) override;
     Memory::Containers::B_Base * getValue(const std::string & varName) override;
     std::list<Memory::Containers::B_Base *> getValues(const std::string & varName) override;
+    /**
+     * @brief getKeysList Get the variable names (in upper case)
+     * @return variable names
+     */
     std::set<std::string> getKeysList() override;
     bool isEmpty() override;
 
-protected:
-    void iSetMaxVarContentSize() override;
-    void iSetMaxVarNameSize() override;
-
-    bool initProtocol() override;
-    void endProtocol() override;
-    bool changeToNextParser() override;
 private:
-    void insertVar(const std::string & varName, Memory::Containers::B_Chunks * data);
+    struct sURLVar {
+        size_t nameOffset, nameSize;
+        size_t valueOffset, valueSize;
+        uint64_t nameHash;
+        // next variable with the same name (or SIZE_MAX), the first one also keeps the last one.
+        size_t nextSameName, lastSameName;
+        // view of the value in the arena (created when requested)
+        Memory::Containers::B_MEM * value;
+    };
 
-    eHTTP_URLVarStat currentStat;
+    /**
+     * @brief parseArena Decode and index the received data that is not parsed yet.
+     * @param eof true to complete the last variable (and the incomplete escape sequences)
+     * @return false if a name/value exceeds the max size.
+     */
+    bool parseArena(bool eof);
+    void completeVar();
+    void insertVar(const size_t &nameOffset, const size_t &nameSize, const size_t &valueOffset, const size_t &valueSize);
+    /**
+     * @brief findVar Find the first variable with this name (case insensitive)
+     * @return variable position or SIZE_MAX if not found.
+     */
+    size_t findVar(const char * name, const size_t & nameSize, const uint64_t & nameHash);
+    void growIndex();
+    Memory::Containers::B_MEM * getValueView(sURLVar & var);
+    static uint64_t hashName(const char * name, const size_t & size);
 
-    std::string currentVarName;
-    std::multimap<std::string, Memory::Containers::B_Chunks *> vars;
+    /**
+     * @brief arena received data, decoded in place (decoded names/values are before parsePos)
+     */
+    std::vector<char> arena;
+    size_t parsePos, decodedPos, tokenOffset;
+    size_t currentNameOffset, currentNameSize;
+    bool parsingValue, finished;
 
-    HTTP_URLVarContent_SubParser _urlVarParser;
+    /**
+     * @brief vars variables in the received order
+     */
+    std::vector<sURLVar> vars;
+    /**
+     * @brief index open addressing hash table (var position+1, 0 for empty) of the first variable of every name.
+     */
+    std::vector<size_t> index;
+    size_t namesCount;
+    std::deque<Memory::Containers::B_MEM> valueViews;
 };
 }}}
 #endif // HTTPURLFORMATTEDVARS_H
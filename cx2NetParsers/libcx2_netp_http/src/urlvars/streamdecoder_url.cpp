@@ -1,5 +1,7 @@
 #include "streamdecoder_url.h"
 
+#include <string.h>
+
 using namespace CX2::Memory::Streams;
 using namespace CX2::Memory::Streams::Decoders;
 
@@ -17,7 +19,9 @@ bool URL::streamTo(Memory::Streams::Streamable *, Status & )
 
 Status URL::write(const void *buf, const size_t &count, Status &wrStat)
 {
-    Status cur;
+    // The consumed bytes are reported (not the decoded ones), so writeFullStream don't retry the input.
+    Status cur, out;
+    const unsigned char * data = (const unsigned char *)buf;
     size_t pos=0;
 
     while (pos<count)
@@ -27,11 +31,12 @@ Status URL::write(const void *buf, const size_t &count, Status &wrStat)
         case 0:
         {
             size_t bytesToTransmitInPlain;
-            if ((bytesToTransmitInPlain=getPlainBytesSize(((unsigned char *)buf)+pos,count-pos))>0)
+            if ((bytesToTransmitInPlain=getPlainBytesSize(data+pos,count-pos))>0)
             {
-                if (!(cur+=orig->writeFullStream(((unsigned char *)buf)+pos,bytesToTransmitInPlain,wrStat)).succeed)
+                if (!(out+=orig->writeFullStream(data+pos,bytesToTransmitInPlain,wrStat)).succeed)
                 {
-                    finalBytesWritten+=cur.bytesWritten;
+                    finalBytesWritten+=out.bytesWritten;
+                    cur.succeed = false;
                     return cur;
                 }
                 pos+=bytesToTransmitInPlain;
@@ -44,57 +49,47 @@ Status URL::write(const void *buf, const size_t &count, Status &wrStat)
             }
         }break;
         case 1:
+        case 2:
         {
-            bytes[1]=*(((unsigned char *)buf)+pos);
-            pos++;
-            filled = 2;
-            if (!isHexByte(bytes[1]))
+            if (!isHexByte(data[pos]))
             {
-                // Write original 2 bytes...
-                if (!(cur+=flushBytes(wrStat)).succeed)
+                // Not an escape sequence: write the bytes as is and process this byte again (eg. "%%41")
+                if (!(out+=flushBytes(wrStat)).succeed)
                 {
-                    finalBytesWritten+=cur.bytesWritten;
+                    finalBytesWritten+=out.bytesWritten;
+                    cur.succeed = false;
                     return cur;
                 }
+                filled = 0;
+                break;
             }
-        }break;
-        case 2:
-        {
-            bytes[2]=*(((unsigned char *)buf)+pos);
-            filled = 0;
-            pos++;
-            if (!isHexByte(bytes[2]))
+
+            bytes[filled++]=data[pos++];
+            if (filled==3)
             {
-                // Write original 2 bytes...
-                if (!(cur+=flushBytes(wrStat)).succeed)
+                filled = 0;
+                unsigned char val = hex2uchar();
+                if (!(out+=orig->writeFullStream(&val,1, wrStat)).succeed)
                 {
-                    finalBytesWritten+=cur.bytesWritten;
+                    finalBytesWritten+=out.bytesWritten;
+                    cur.succeed = false;
                     return cur;
                 }
             }
-            unsigned char val[2];
-            val[0] = hex2uchar();
-            if (!(cur+=orig->writeFullStream(val,1, wrStat)).succeed)
-            {
-                finalBytesWritten+=cur.bytesWritten;
-                return cur;
-            }
         }break;
         default:
             break;
         }
     }
-    finalBytesWritten+=cur.bytesWritten;
+    finalBytesWritten+=out.bytesWritten;
+    cur+=(uint64_t)count;
     return cur;
 }
 
 size_t URL::getPlainBytesSize(const unsigned char *buf, size_t count)
 {
-    for (size_t i=0;i<count;i++)
-    {
-        if (buf[i]=='%') return i;
-    }
-    return count;
+    const unsigned char * p = (const unsigned char *)memchr(buf,'%',count);
+    return p? p-buf : count;
 }
 
 Status URL::flushBytes(Status & wrStat)
@@ -132,4 +127,5 @@ void URL::writeEOF(bool )
     // flush intermediary bytes...
     Status w;
     flushBytes(w);
+    filled = 0;
 }
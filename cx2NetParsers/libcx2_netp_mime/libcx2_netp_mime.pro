@@ -2,6 +2,7 @@ QT       -= core gui
 
 SOURCES += \
     src/mime_vars.cpp \
+    src/mime_filesink.cpp \
     src/subparsers/mime_sub_header.cpp \
     src/subparsers/mime_sub_content.cpp \
     src/mime_partmessage.cpp \
@@ -9,6 +10,7 @@ SOURCES += \
     src/subparsers/mime_sub_endpboundary.cpp
 HEADERS += \
     src/mime_vars.h \
+    src/mime_filesink.h \
     src/subparsers/mime_sub_header.h \
     src/subparsers/mime_sub_content.h \
     src/mime_partmessage.h \
@@ -19,7 +21,7 @@ isEmpty(PREFIX) {
     PREFIX = /usr/local
 }
 
-win32:LIBS+= -L$$PREFIX/lib -lcx2_mem_vars2 -lcx2_hlp_functions2 -lcx2_thr_threads2 -lcx2_thr_mutex2 -lboost_thread-mt-x32 -lboost_regex-mt-x32
+win32:LIBS+= -L$$PREFIX/lib -lcx2_mem_vars2 -lcx2_hlp_functions2 -lcx2_thr_threads2 -lcx2_thr_mutex2 -lboost_thread-mt-x32 -lboost_regex-mt-x32 -lcrypto
 
 # -lcx2_net_sockets2 -ljsoncpp -lssl -lcrypto -lws2_32
 
@@ -0,0 +1,309 @@
+#include "mime_filesink.h"
+
+#include <cx2_hlp_functions/encoders.h>
+
+#include <algorithm>
+#include <random>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+using namespace CX2::Network::MIME;
+using namespace CX2;
+
+MIME_FileSink::MIME_FileSink()
+{
+    fd = -1;
+    batch = nullptr;
+    batchUsed = 0;
+    bytesWritten = 0;
+    allocatedSize = 0;
+    directIO = false;
+    committed = false;
+    failed = false;
+    sha2 = nullptr;
+}
+
+MIME_FileSink::~MIME_FileSink()
+{
+    if (!committed)
+        abort();
+    if (batch)
+        free(batch);
+    if (sha2)
+        EVP_MD_CTX_free(sha2);
+}
+
+bool MIME_FileSink::open(const std::string &filePath, bool directIO)
+{
+    if (fd!=-1 || committed)
+        return false;
+
+    this->filePath = filePath;
+
+    if (!sha2 && !(sha2 = EVP_MD_CTX_new()))
+        return false;
+    if (EVP_DigestInit_ex(sha2, EVP_sha256(), nullptr)!=1)
+        return false;
+
+#ifndef _WIN32
+    if (posix_memalign((void **)&batch, MIME_FILESINK_ALIGNMENT, MIME_FILESINK_BATCH_SIZE))
+        batch = nullptr;
+#else
+    batch = (char *)malloc(MIME_FILESINK_BATCH_SIZE);
+#endif
+    if (!batch)
+        return false;
+
+    // Create an unique temporary file in the destination directory (so the rename does not copy the data):
+    std::random_device rd;
+    for (int i=0; i<16 && fd==-1; i++)
+    {
+        char suffix[32];
+        snprintf(suffix,sizeof(suffix),".upload-%08x", (unsigned int)rd());
+        tmpFilePath = filePath + suffix;
+        fd = ::open(tmpFilePath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_BINARY, 0600);
+        if (fd==-1 && errno!=EEXIST)
+            break;
+    }
+    if (fd==-1)
+    {
+        tmpFilePath.clear();
+        return false;
+    }
+
+#ifdef __linux__
+    // Some filesystems (eg. tmpfs) don't support O_DIRECT, go with the page cache there.
+    if (directIO && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_DIRECT)==0)
+        this->directIO = true;
+#endif
+
+    return true;
+}
+
+bool MIME_FileSink::commit()
+{
+    if (fd==-1 || failed)
+        return false;
+
+    if (!flushBatch(true))
+        return false;
+
+    // Release the preallocated space beyond the data:
+    if (allocatedSize>bytesWritten && ftruncate(fd, bytesWritten)!=0)
+    {
+        failed = true;
+        return false;
+    }
+
+    // The data should be on disk before the rename makes it visible:
+#ifdef _WIN32
+    if (_commit(fd)!=0)
+#else
+    if (fsync(fd)!=0)
+#endif
+    {
+        failed = true;
+        return false;
+    }
+
+    closeFile();
+
+#ifdef _WIN32
+    remove(filePath.c_str());
+#endif
+    if (rename(tmpFilePath.c_str(), filePath.c_str())!=0)
+    {
+        failed = true;
+        return false;
+    }
+
+    // And the rename itself (the directory entry) should survive a crash too:
+    if (!syncDirectory())
+    {
+        failed = true;
+        return false;
+    }
+
+    unsigned char buffer_sha2[EVP_MAX_MD_SIZE];
+    unsigned int sha2Len = 0;
+    if (EVP_DigestFinal_ex(sha2, buffer_sha2, &sha2Len)==1)
+        sha256 = Helpers::Encoders::toHex(buffer_sha2,sha2Len);
+
+    tmpFilePath.clear();
+    committed = true;
+    return true;
+}
+
+void MIME_FileSink::abort()
+{
+    closeFile();
+    if (!tmpFilePath.empty())
+    {
+        remove(tmpFilePath.c_str());
+        tmpFilePath.clear();
+    }
+    failed = true;
+}
+
+bool MIME_FileSink::streamTo(Memory::Streams::Streamable *, Memory::Streams::Status &)
+{
+    return false;
+}
+
+Memory::Streams::Status MIME_FileSink::write(const void *buf, const size_t &count, Memory::Streams::Status &wrStatUpd)
+{
+    Memory::Streams::Status cur;
+
+    if (fd==-1 || failed)
+    {
+        cur.succeed=wrStatUpd.succeed=setFailedWriteState();
+        return cur;
+    }
+
+    if (EVP_DigestUpdate(sha2, buf, count)!=1)
+    {
+        cur.succeed=wrStatUpd.succeed=setFailedWriteState();
+        return cur;
+    }
+
+    size_t pos = 0;
+    while (pos<count)
+    {
+        size_t toCopy = std::min(count-pos, (size_t)MIME_FILESINK_BATCH_SIZE-batchUsed);
+        memcpy(batch+batchUsed, (const char *)buf+pos, toCopy);
+        batchUsed+=toCopy;
+        pos+=toCopy;
+
+        if (batchUsed == MIME_FILESINK_BATCH_SIZE && !flushBatch(false))
+        {
+            cur.succeed=wrStatUpd.succeed=setFailedWriteState();
+            return cur;
+        }
+    }
+
+    cur+=(uint64_t)count;
+    wrStatUpd+=(uint64_t)count;
+    return cur;
+}
+
+uint64_t MIME_FileSink::getBytesWritten() const
+{
+    return bytesWritten+batchUsed;
+}
+
+std::string MIME_FileSink::getSHA256() const
+{
+    return sha256;
+}
+
+std::string MIME_FileSink::getFilePath() const
+{
+    return filePath;
+}
+
+bool MIME_FileSink::isCommitted() const
+{
+    return committed;
+}
+
+bool MIME_FileSink::isUsingDirectIO() const
+{
+    return directIO;
+}
+
+bool MIME_FileSink::flushBatch(bool last)
+{
+    if (!batchUsed)
+        return true;
+
+    preallocate(bytesWritten+batchUsed);
+
+#ifdef __linux__
+    // O_DIRECT requires aligned sizes, the last (unaligned) piece goes through the page cache.
+    if (last && directIO && (batchUsed % MIME_FILESINK_ALIGNMENT)!=0)
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+#else
+    (void)last;
+#endif
+
+    size_t pos = 0;
+    while (pos<batchUsed)
+    {
+        ssize_t r = ::write(fd, batch+pos, batchUsed-pos);
+        if (r<0 && errno==EINTR)
+            continue;
+        if (r<=0)
+        {
+            failed = true;
+            return false;
+        }
+        pos+=r;
+    }
+
+    bytesWritten+=batchUsed;
+    batchUsed = 0;
+    return true;
+}
+
+void MIME_FileSink::preallocate(const uint64_t &size)
+{
+#ifdef __linux__
+    if (size<=allocatedSize)
+        return;
+
+    // Grow geometrically, so big uploads only preallocate a few times:
+    uint64_t step = allocatedSize;
+    if (step<MIME_FILESINK_PREALLOC_MIN) step = MIME_FILESINK_PREALLOC_MIN;
+    if (step>MIME_FILESINK_PREALLOC_MAX) step = MIME_FILESINK_PREALLOC_MAX;
+    while (allocatedSize+step<size)
+        step+=MIME_FILESINK_PREALLOC_MAX;
+
+    if (fallocate(fd, 0, allocatedSize, step)==0)
+        allocatedSize+=step;
+    else // Not supported here, don't try again.
+        allocatedSize = UINT64_MAX;
+#else
+    (void)size;
+#endif
+}
+
+bool MIME_FileSink::syncDirectory()
+{
+#ifndef _WIN32
+    size_t slash = filePath.find_last_of('/');
+    std::string dirPath = slash==std::string::npos? "." : (slash==0? "/" : filePath.substr(0,slash));
+
+    int dirfd = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirfd==-1)
+        return false;
+    bool r = fsync(dirfd)==0;
+    ::close(dirfd);
+    return r;
+#else
+    return true;
+#endif
+}
+
+void MIME_FileSink::closeFile()
+{
+    if (fd!=-1)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef MIME_FILESINK_H
+#define MIME_FILESINK_H
+
+#include <cx2_mem_vars/streamable.h>
+#include <openssl/evp.h>
+
+#include <string>
+
+// Data is written to the file in batches of this size (multiple of the alignment).
+#define MIME_FILESINK_BATCH_SIZE (1024*1024)
+// Buffer/offset/size alignment required by O_DIRECT.
+#define MIME_FILESINK_ALIGNMENT 4096
+// The file space is preallocated in growing steps between these sizes.
+#define MIME_FILESINK_PREALLOC_MIN (8*1024*1024)
+#define MIME_FILESINK_PREALLOC_MAX (256*1024*1024)
+
+namespace CX2 { namespace Network { namespace MIME {
+
+/**
+ * @brief The MIME_FileSink class write an upload directly into a temporary file next to the destination, then rename
+ *        it into place on commit.
+ *        The data is written in big aligned batches (optionally with O_DIRECT to bypass the page cache), the file
+ *        space is preallocated with fallocate, and the SHA256 of the data is computed while writing.
+ */
+class MIME_FileSink : public Memory::Streams::Streamable
+{
+public:
+    MIME_FileSink();
+    /**
+     * @brief ~MIME_FileSink removes the temporary file if it was not commited.
+     */
+    ~MIME_FileSink() override;
+
+    /**
+     * @brief open Create the temporary file for filePath
+     * @param filePath final file path (the temporary file is created in the same directory)
+     * @param directIO use O_DIRECT (linux), ignored if the filesystem does not support it.
+     * @return true if the temporary file was created.
+     */
+    bool open(const std::string & filePath, bool directIO = false);
+    /**
+     * @brief commit Write the pending data, release the unused preallocated space, sync it to disk and rename the
+     *               temporary file into the final path (syncing the directory after).
+     * @return true if succeed
+     */
+    bool commit();
+    /**
+     * @brief abort Close and remove the temporary file.
+     */
+    void abort();
+
+    /**
+     * @brief streamTo the sink can't be read (use the file from getFilePath after commit)
+     * @return false
+     */
+    bool streamTo(Memory::Streams::Streamable * out, Memory::Streams::Status & wrStatUpd) override;
+    Memory::Streams::Status write(const void * buf, const size_t &count, Memory::Streams::Status & wrStatUpd) override;
+
+    uint64_t getBytesWritten() const;
+    /**
+     * @brief getSHA256 Get the hex SHA256 of the written data
+     * @return sha256 in hex (empty until commited)
+     */
+    std::string getSHA256() const;
+    std::string getFilePath() const;
+    bool isCommitted() const;
+    bool isUsingDirectIO() const;
+
+private:
+    bool flushBatch(bool last);
+    void preallocate(const uint64_t & size);
+    bool syncDirectory();
+    void closeFile();
+
+    int fd;
+    std::string filePath, tmpFilePath;
+
+    char * batch;
+    size_t batchUsed;
+
+    uint64_t bytesWritten, allocatedSize;
+    bool directIO, committed, failed;
+
+    EVP_MD_CTX * sha2;
+    std::string sha256;
+};
+
+}}}
+
+#endif // MIME_FILESINK_H
@@ -33,6 +33,25 @@ MIME_Vars::~MIME_Vars()
     for (MIME_PartMessage * i : parts) delete i;
 }
 
+void MIME_Vars::reset()
+{
+    for (MIME_PartMessage * i : parts) delete i;
+    parts.clear();
+    partsByName.clear();
+    dataSizeExceptions.clear();
+    varToFS.clear();
+    varToFSDirectIO.clear();
+
+    if (currentPart) delete currentPart;
+    renewCurrentPart();
+
+    subFirstBoundary.reset();
+    subEndPBoundary.reset();
+
+    currentParser = &subFirstBoundary;
+    currentState = MP_STATE_FIRST_BOUNDARY;
+}
+
 bool MIME_Vars::streamTo(Memory::Streams::Streamable *out, Memory::Streams::Status &wrStat)
 {
     Memory::Streams::Status cur;
@@ -97,6 +116,7 @@ void MIME_Vars::renewCurrentPart()
     initSubParser(currentPart->getHeader());
 
     currentPart->getContent()->setMaxContentSize(maxVarContentSize);
+    currentPart->getContent()->setBoundary(multiPartBoundary);
 
     // Header:
     currentPart->getHeader()->setMaxOptions(maxHeaderOptionsCount);
@@ -166,9 +186,13 @@ void MIME_Vars::makeDataSizeExceptionForPart(const std::string &partName, const
     dataSizeExceptions[partName] = size;
 }
 
-void MIME_Vars::writeVarToFS(const std::string &varName, const std::string &fileName)
+void MIME_Vars::writeVarToFS(const std::string &varName, const std::string &fileName, bool directIO)
 {
     varToFS[varName] = fileName;
+    if (directIO)
+        varToFSDirectIO.insert(varName);
+    else
+        varToFSDirectIO.erase(varName);
 }
 
 bool MIME_Vars::changeToNextParser()
@@ -197,12 +221,14 @@ bool MIME_Vars::changeToNextParser()
         std::string currentPartName = getMultiPartMessageName(currentPart);
         if (varToFS.find(currentPartName) != varToFS.end())
         {
-            // TODO: why mmap
-            Memory::Containers::B_MMAP * fContainer = new Memory::Containers::B_MMAP;
-            if (fContainer->referenceFile(varToFS[currentPartName]))
-                currentPart->getContent()->replaceContentContainer(fContainer);
+            MIME_FileSink * fileSink = new MIME_FileSink;
+            if (fileSink->open(varToFS[currentPartName], varToFSDirectIO.find(currentPartName) != varToFSDirectIO.end()))
+                currentPart->getContent()->setFileSink(fileSink);
             else // Can't write on this location :(
+            {
+                delete fileSink;
                 currentParser = nullptr;
+            }
         }
         if (dataSizeExceptions.find(currentPartName) != dataSizeExceptions.end())
             currentPart->getContent()->setMaxContentSize(dataSizeExceptions[currentPartName]);
@@ -277,6 +303,7 @@ void MIME_Vars::setMultiPartBoundary(const std::string &value)
 {
     multiPartBoundary = value;
     subFirstBoundary.setBoundary(multiPartBoundary);
+    currentPart->getContent()->setBoundary(multiPartBoundary);
 }
 
 bool MIME_Vars::initProtocol()
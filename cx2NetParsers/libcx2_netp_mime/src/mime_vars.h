@@ -2,6 +2,7 @@
 #define MIME_MULTIPART_H
 
 #include <map>
+#include <set>
 
 #include <cx2_mem_vars/vars.h>
 #include <cx2_mem_vars/streamparser.h>
@@ -28,6 +29,10 @@ public:
     ~MIME_Vars() override;
 
     bool streamTo(Memory::Streams::Streamable * out, Memory::Streams::Status & wrStat) override;
+    /**
+     * @brief reset Remove all the parts and restart the parser (security limits are kept)
+     */
+    void reset();
 
     ///////////////////////////////////////
     // Virtuals for Vars...
@@ -38,7 +43,15 @@ public:
     bool isEmpty() override;
 
     void makeDataSizeExceptionForPart(const std::string & partName, const uint64_t & size);
-    void writeVarToFS(const std::string &varName, const std::string &fileName);
+    /**
+     * @brief writeVarToFS Write the part content directly into a file (streamed in batches into a temporary file
+     *                     that is renamed to fileName when the part is complete).
+     *                     The SHA256 of the content is available from getContent()->getFileSink() of the part.
+     * @param varName part name
+     * @param fileName destination file
+     * @param directIO use O_DIRECT for writing the file (bypass the page cache, useful for huge uploads)
+     */
+    void writeVarToFS(const std::string &varName, const std::string &fileName, bool directIO = false);
 
     // TODO: decode as BC pos reference (for file reading).
     std::list<MIME_PartMessage *> getMultiPartMessagesByName(const std::string & varName);
@@ -90,6 +103,7 @@ private:
 
     std::map<std::string,uint64_t> dataSizeExceptions;
     std::map<std::string,std::string> varToFS;
+    std::set<std::string> varToFSDirectIO;
     std::list<MIME_PartMessage *> parts;
     std::multimap<std::string,MIME_PartMessage *> partsByName;
 
@@ -17,6 +17,7 @@ MIME_Sub_Content::MIME_Sub_Content()
 #endif
 
     contentContainer = nullptr;
+    fileSink = nullptr;
     replaceContentContainer(new Memory::Containers::B_Chunks);
     setParseMode(Memory::Streams::Parsing::PARSE_MODE_DIRECT_DELIMITER);
     setBoundary("XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX");
@@ -25,6 +26,7 @@ MIME_Sub_Content::MIME_Sub_Content()
 MIME_Sub_Content::~MIME_Sub_Content()
 {
     if (contentContainer) delete contentContainer;
+    if (fileSink) delete fileSink;
 }
 
 bool MIME_Sub_Content::stream(Memory::Streams::Status &wrStat)
@@ -70,6 +72,9 @@ void MIME_Sub_Content::setFsTmpFolder(const std::string &value)
 Memory::Streams::Parsing::ParseStatus MIME_Sub_Content::parse()
 {
     // TODO: interpret content encoding...
+    if (fileSink)
+        return parseToFileSink();
+
     getParsedData()->appendTo(*contentContainer);
     if (getDelimiterFound().size())
     {
@@ -101,3 +106,37 @@ void MIME_Sub_Content::replaceContentContainer(Memory::Containers::B_Base *value
     if (contentContainer) delete contentContainer;
     contentContainer = value;
 }
+
+MIME_FileSink *MIME_Sub_Content::getFileSink() const
+{
+    return fileSink;
+}
+
+void MIME_Sub_Content::setFileSink(MIME_FileSink *value)
+{
+    if (fileSink) delete fileSink;
+    fileSink = value;
+}
+
+Memory::Streams::Parsing::ParseStatus MIME_Sub_Content::parseToFileSink()
+{
+    if (!getParsedData()->appendTo(*fileSink).first)
+        return Memory::Streams::Parsing::PARSE_STAT_ERROR;
+
+    if (getDelimiterFound().size())
+    {
+        // finished (delimiter found), put the file in place and use it as the content:
+        if (!fileSink->commit())
+            return Memory::Streams::Parsing::PARSE_STAT_ERROR;
+
+        Memory::Containers::B_MMAP * fContainer = new Memory::Containers::B_MMAP;
+        if (!fContainer->referenceFile(fileSink->getFilePath(),true,false))
+        {
+            delete fContainer;
+            return Memory::Streams::Parsing::PARSE_STAT_ERROR;
+        }
+        replaceContentContainer(fContainer);
+        return Memory::Streams::Parsing::PARSE_STAT_GOTO_NEXT_SUBPARSER;
+    }
+    return Memory::Streams::Parsing::PARSE_STAT_GET_MORE_DATA;
+}
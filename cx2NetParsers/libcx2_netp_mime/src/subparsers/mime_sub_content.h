@@ -2,6 +2,7 @@
 #define MIME_SUB_CONTENT_H
 
 #include <cx2_mem_vars/substreamparser.h>
+#include "mime_filesink.h"
 
 namespace CX2 { namespace Network { namespace MIME {
 
@@ -23,6 +24,19 @@ public:
     Memory::Containers::B_Base *getContentContainer() const;
     void replaceContentContainer(Memory::Containers::B_Base *value);
 
+    /**
+     * @brief getFileSink Get the file sink (if the content is being written directly to a file)
+     * @return file sink or nullptr
+     */
+    MIME_FileSink *getFileSink() const;
+    /**
+     * @brief setFileSink Write the content directly into the file sink (the ownership goes to this class).
+     *                    When the content is complete, the sink is commited and the file becomes the content container
+     *                    (read-only mmap).
+     * @param value opened file sink
+     */
+    void setFileSink(MIME_FileSink *value);
+
     std::string getBoundary() const;
     void setBoundary(const std::string &value);
 
@@ -33,7 +47,10 @@ public:
 protected:
     Memory::Streams::Parsing::ParseStatus parse() override;
 private:
+    Memory::Streams::Parsing::ParseStatus parseToFileSink();
+
     Memory::Containers::B_Base * contentContainer;
+    MIME_FileSink * fileSink;
 
     std::string fsTmpFolder, boundary;
     uint64_t maxContentSize;
@@ -32,6 +32,13 @@ Memory::Streams::Parsing::ParseStatus MIME_Sub_EndPBoundary::parse()
     return Memory::Streams::Parsing::PARSE_STAT_ERROR;
 }
 
+void MIME_Sub_EndPBoundary::reset()
+{
+    SubParser::reset();
+    status = ENDP_STAT_UNINITIALIZED;
+    setParseDataTargetSize(2);
+}
+
 int MIME_Sub_EndPBoundary::getStatus() const
 {
     return status;
@@ -16,6 +16,7 @@ class MIME_Sub_EndPBoundary : public Memory::Streams::Parsing::SubParser
 public:
     MIME_Sub_EndPBoundary();
     bool stream(Memory::Streams::Status &wrStat) override;
+    void reset() override;
     int getStatus() const;
 
 protected:
@@ -20,8 +20,9 @@ std::string MIME_Sub_FirstBoundary::getBoundary() const
 
 void MIME_Sub_FirstBoundary::setBoundary(const std::string &value)
 {
-    setParseDelimiter("--" + value + "\r\n");
-    setParseDataTargetSize(value.size()+4);
+    // The following CRLF (or the final "--") is parsed by the endpoint boundary.
+    setParseDelimiter("--" + value);
+    setParseDataTargetSize(value.size()+2);
     boundary = value;
 }
 
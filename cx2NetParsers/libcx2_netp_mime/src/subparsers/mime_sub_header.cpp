@@ -31,16 +31,29 @@ MIME_Sub_Header::~MIME_Sub_Header()
 
 bool MIME_Sub_Header::stream(Memory::Streams::Status & wrStat)
 {
-    Memory::Streams::Status cur;
+    // Write out the header option values at once...
+    std::string x;
+    appendTo(x);
+    x+="\r\n";
+    return upStream->writeString( x, wrStat ).succeed;
+}
 
-    // Write out the header option values...
+void MIME_Sub_Header::appendTo(string &out, const std::set<string> *skipOptions) const
+{
     for (auto & i : headers)
     {
-        std::string x = i.second->getString() + std::string("\r\n");
-        if (!(cur+=upStream->writeString( x, wrStat )).succeed) return false;
+        if (skipOptions && skipOptions->find(i.first)!=skipOptions->end())
+            continue;
+        i.second->appendTo(out);
     }
-    if (!(cur+=upStream->writeString("\r\n", wrStat)).succeed) return false;
-    return true;
+}
+
+void MIME_Sub_Header::reset()
+{
+    SubParser::reset();
+    for ( auto & i : headers ) delete i.second;
+    headers.clear();
+    lastOpt = nullptr;
 }
 
 bool MIME_Sub_Header::exist(const std::string &optionName) const
@@ -399,6 +412,14 @@ std::string MIME_HeaderOption::getString()
 
 }
 
+void MIME_HeaderOption::appendTo(string &out) const
+{
+    out+=origName;
+    out+=": ";
+    out+=origValue;
+    out+="\r\n";
+}
+
 
 bool MIME_HeaderOption::isPermited7bitCharset(const std::string &varX)
 {
@@ -6,6 +6,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <set>
 
 /*
  * TODO: Security: check if other servers can handle the MIME properly...
@@ -33,6 +34,11 @@ public:
     }
 
     std::string getString();
+    /**
+     * @brief appendTo Append the option line ("Name: Value\r\n") to a string.
+     * @param out output string
+     */
+    void appendTo(std::string & out) const;
 
     void addSubVar(const std::string & varName, const std::string & varValue);
 
@@ -70,6 +76,16 @@ public:
     ~MIME_Sub_Header() override;
 
     bool stream(Memory::Streams::Status &wrStat) override;
+    /**
+     * @brief appendTo Append the header options to a string (without the empty line that ends the header)
+     * @param out output string
+     * @param skipOptions upper case names of the options to be omitted (or nullptr)
+     */
+    void appendTo(std::string & out, const std::set<std::string> * skipOptions = nullptr) const;
+    /**
+     * @brief reset Remove all the header options and the parsing state (to reuse this header on a new message)
+     */
+    void reset() override;
 
     /**
      * @brief exist exist option.
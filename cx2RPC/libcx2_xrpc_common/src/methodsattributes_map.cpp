@@ -1,5 +1,7 @@
 #include "methodsattributes_map.h"
 
+#include <cx2_thr_mutex/lock_shared.h>
+
 using namespace CX2::Authentication;
 
 MethodsAttributes_Map::MethodsAttributes_Map()
@@ -10,13 +12,43 @@ MethodsAttributes_Map::MethodsAttributes_Map()
 void MethodsAttributes_Map::addMethodAttributes(const std::string &methodName, const std::set<sApplicationAttrib> &attribs)
 {
     for (const sApplicationAttrib & attrib : attribs)
+    {
         methodAttribs.insert(std::make_pair(methodName, attrib));
+
+        // Assign a bit to the new attribs:
+        if (attribBitIndexes.find(attrib) == attribBitIndexes.end())
+        {
+            attribBitIndexes[attrib] = static_cast<uint32_t>(bitAttribs.size());
+            bitAttribs.push_back(attrib);
+        }
+    }
+
+    compileMethod(methodName);
+
+    // The granted bits does not cover the new attribs:
+    if (!attribs.empty())
+    {
+        Threads::Sync::Lock_RW lock(mutexGranted);
+        grantedAttribs.clear();
+    }
 }
 
 void MethodsAttributes_Map::addAttribPassIndexes(const sApplicationAttrib &attrib, const std::set<uint32_t> &passIndexes)
 {
     for (const uint32_t & passIndex : passIndexes)
         attribPassIndexes.insert(std::make_pair(attrib, passIndex));
+
+    auto bit = attribBitIndexes.find(attrib);
+    if (bit == attribBitIndexes.end())
+        return;
+
+    // Recompile the methods that requires this attrib:
+    for (const auto & i : methodIds)
+    {
+        const std::vector<uint64_t> & attribBits = methodPermissions[i.second].attribBits;
+        if ( bit->second/64 < attribBits.size() && (attribBits[bit->second/64] & (1ULL << (bit->second%64))) )
+            compileMethod(i.first);
+    }
 }
 
 bool MethodsAttributes_Map::validateMethod(Manager *auth, Session *session,  const std::string &methodName, const std::set<uint32_t> & extraTmpIndexes, std::set<uint32_t> *passIndexesLeft, std::set<sApplicationAttrib> *attribsLeft)
@@ -51,6 +83,118 @@ bool MethodsAttributes_Map::validateMethod(Manager *auth, Session *session,  con
     return passIndexesLeft->empty() && attribsLeft->empty();
 }
 
+bool MethodsAttributes_Map::validateMethod(Manager *auth, Session *session, const std::string &methodName, const std::set<uint32_t> &extraTmpIndexes)
+{
+    static const sMethodPermissions noPermissions;
+
+    auto i = methodIds.find(methodName);
+    const sMethodPermissions & permissions = i==methodIds.end()? noPermissions : methodPermissions[i->second];
+
+    // Validate the required pass indexes for attribs/method
+    if ( requireAllMethodsToBeAuthenticated
+         && extraTmpIndexes.find(0) == extraTmpIndexes.end()
+         && (!session || !IS_PASSWORD_AUTHENTICATED(session->getIdxAuthenticationStatus(0))) )
+        return false;
+
+    for ( const uint32_t & passIndex : permissions.passIndexes )
+    {
+        if ( extraTmpIndexes.find(passIndex) == extraTmpIndexes.end()
+             && (!session || !IS_PASSWORD_AUTHENTICATED(session->getIdxAuthenticationStatus(passIndex))) )
+            return false;
+    }
+
+    if (permissions.attribs.empty())
+        return true;
+    if (!session)
+        return false;
+
+    return validateGrantedAttribs(auth,session->getAuthUser(),permissions);
+}
+
+void MethodsAttributes_Map::compileMethod(const std::string &methodName)
+{
+    auto i = methodIds.find(methodName);
+    if (i == methodIds.end())
+    {
+        i = methodIds.insert(std::make_pair(methodName, static_cast<uint32_t>(methodPermissions.size()))).first;
+        methodPermissions.push_back(sMethodPermissions());
+    }
+
+    sMethodPermissions & permissions = methodPermissions[i->second];
+
+    std::set<sApplicationAttrib> requiredAttribs = getMethodAttribs(methodName);
+    permissions.attribs.assign(requiredAttribs.begin(),requiredAttribs.end());
+    permissions.attribBits.assign((bitAttribs.size()+63)/64,0);
+    for (const sApplicationAttrib & attrib : requiredAttribs)
+    {
+        uint32_t bit = attribBitIndexes[attrib];
+        permissions.attribBits[bit/64] |= (1ULL << (bit%64));
+    }
+
+    // The pass index 0 is validated apart (requireAllMethodsToBeAuthenticated can change later)
+    std::set<uint32_t> requiredPassIndexes;
+    for (const sApplicationAttrib & attrib : requiredAttribs)
+    {
+        for (const uint32_t & passIndex : getAttribPassIndexes(attrib))
+            requiredPassIndexes.insert(passIndex);
+    }
+    permissions.passIndexes.assign(requiredPassIndexes.begin(),requiredPassIndexes.end());
+}
+
+bool MethodsAttributes_Map::validateGrantedAttribs(Manager *auth, const std::string &sAccountName, const sMethodPermissions &permissions)
+{
+    uint64_t authVersion = auth->authorizationVersion();
+
+    if (!authVersion)
+    {
+        // The manager does not track the changes, validate every required attrib:
+        for ( const sApplicationAttrib & attrib : permissions.attribs )
+        {
+            if (!auth->accountValidateAttribute(sAccountName, attrib))
+                return false;
+        }
+        return true;
+    }
+
+    {
+        Threads::Sync::Lock_RD lock(mutexGranted);
+        auto i = grantedAttribs.find(auth);
+        if (i != grantedAttribs.end())
+        {
+            auto j = i->second.find(sAccountName);
+            if (j != i->second.end() && j->second.authVersion == authVersion)
+                return containsBits(j->second.attribBits, permissions.attribBits);
+        }
+    }
+
+    // Not granted yet (or outdated), compile the granted attribs for this account:
+    sGrantedAttribs granted;
+    granted.authVersion = authVersion;
+    granted.attribBits.assign((bitAttribs.size()+63)/64,0);
+    for (size_t bit=0; bit<bitAttribs.size(); bit++)
+    {
+        if (auth->accountValidateAttribute(sAccountName, bitAttribs[bit]))
+            granted.attribBits[bit/64] |= (1ULL << (bit%64));
+    }
+
+    bool r = containsBits(granted.attribBits, permissions.attribBits);
+
+    Threads::Sync::Lock_RW lock(mutexGranted);
+    grantedAttribs[auth][sAccountName] = granted;
+
+    return r;
+}
+
+bool MethodsAttributes_Map::containsBits(const std::vector<uint64_t> &granted, const std::vector<uint64_t> &required)
+{
+    for (size_t w=0; w<required.size(); w++)
+    {
+        if ( required[w] & ~(w<granted.size()?granted[w]:0) )
+            return false;
+    }
+    return true;
+}
+
 std::set<uint32_t> MethodsAttributes_Map::getAttribPassIndexes(const sApplicationAttrib &attrib)
 {
     std::set<uint32_t> r = {0};
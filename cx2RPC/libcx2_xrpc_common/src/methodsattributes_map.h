@@ -4,11 +4,13 @@
 #include <map>
 #include <string>
 #include <set>
+#include <vector>
 
 #include <cx2_auth/manager.h>
 #include <cx2_auth/session.h>
 
 #include <cx2_auth/accountsecret_validation.h>
+#include <cx2_thr_mutex/mutex_shared.h>
 
 namespace CX2 { namespace Authentication {
 
@@ -37,11 +39,43 @@ public:
      * @return
      */
     bool validateMethod(Manager *auth, Session * authSession, const std::string & methodName, const std::set<uint32_t> &extraTmpIndexes, std::set<uint32_t> * passIndexesLeft, std::set<sApplicationAttrib> *attribsLeft );
+    /**
+     * @brief validateMethod Validate account attribs (and if they are authenticated) using the compiled permission table
+     *                       (without allocating the sets, use the previous one to report what is failing)
+     * @param auth authenticator
+     * @param authSession session
+     * @param methodName method name
+     * @param extraTmpIndexes temporary authenticated pass indexes
+     * @return true if the method is authorized
+     */
+    bool validateMethod(Manager *auth, Session * authSession, const std::string & methodName, const std::set<uint32_t> &extraTmpIndexes);
 
     bool getRequireAllMethodsToBeAuthenticated() const;
     void setRequireAllMethodsToBeAuthenticated(bool value);
 
 private:
+    struct sMethodPermissions
+    {
+        // Required attribs (one bit per attrib):
+        std::vector<uint64_t> attribBits;
+        std::vector<sApplicationAttrib> attribs;
+        // Required pass indexes:
+        std::vector<uint32_t> passIndexes;
+    };
+    struct sGrantedAttribs
+    {
+        sGrantedAttribs()
+        {
+            authVersion = 0;
+        }
+        uint64_t authVersion;
+        std::vector<uint64_t> attribBits;
+    };
+
+    void compileMethod(const std::string & methodName);
+    bool validateGrantedAttribs(Manager *auth, const std::string & sAccountName, const sMethodPermissions & permissions);
+    static bool containsBits(const std::vector<uint64_t> & granted, const std::vector<uint64_t> & required);
+
     std::set<uint32_t> getAttribPassIndexes(const sApplicationAttrib &attrib);
     std::set<sApplicationAttrib> getMethodAttribs(const std::string & methodName);
     std::set<uint32_t> getMethodPassIndexes(const std::string & methodName);
@@ -51,6 +85,17 @@ private:
     // Method requite ->
     std::multimap<std::string,sApplicationAttrib> methodAttribs;
 
+    // Compiled permission table: method name -> method id -> required attrib bits/pass indexes
+    std::map<std::string,uint32_t> methodIds;
+    std::vector<sMethodPermissions> methodPermissions;
+    // attrib -> bit / bit -> attrib
+    std::map<sApplicationAttrib,uint32_t> attribBitIndexes;
+    std::vector<sApplicationAttrib> bitAttribs;
+
+    // Granted attribs per account (manager -> account -> attrib bits), invalidated by the manager authorization version.
+    std::map<Manager *,std::map<std::string,sGrantedAttribs>> grantedAttribs;
+    Threads::Sync::Mutex_Shared mutexGranted;
+
     bool requireAllMethodsToBeAuthenticated;
 };
 
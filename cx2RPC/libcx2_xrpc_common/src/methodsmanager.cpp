@@ -5,18 +5,22 @@
 
 #include <cx2_thr_mutex/lock_shared.h>
 
+#include <algorithm>
+
 using namespace CX2::RPC;
 using namespace CX2;
 
 MethodsManager::MethodsManager(const std::string &appName)
 {
     this->appName = appName;
+    methodsFrozen = false;
+    metrics = nullptr;
 }
 
 bool MethodsManager::addRPCMethod(const std::string &methodName, const std::set<std::string> &reqAttribs, const sRPCMethod &rpcMethod, bool requireFullAuth)
 {
     Threads::Sync::Lock_RW lock(smutexMethods);
-    if (methods.find(methodName) == methods.end() )
+    if (!methodsFrozen && methods.find(methodName) == methods.end() )
     {
         // Put the method.
         methods[methodName] = rpcMethod;
@@ -25,66 +29,115 @@ bool MethodsManager::addRPCMethod(const std::string &methodName, const std::set<
         methodsAttribs.addMethodAttributes(methodName,getAppAttribs(reqAttribs));
 
         methodRequireFullAuth[methodName] = requireFullAuth;
+        methodMetrics[methodName] = createMethodMetrics(methodName);
 
         return true;
     }
     return false;
 }
 
+void MethodsManager::freezeMethods()
+{
+    Threads::Sync::Lock_RW lock(smutexMethods);
+    if (methodsFrozen)
+        return;
+
+    // std::map is already sorted by name:
+    for (const auto & i : methods)
+        frozenMethods.push_back({i.first,i.second,methodRequireFullAuth[i.first],methodMetrics[i.first]});
+
+    methodsFrozen = true;
+}
+
 int MethodsManager::runRPCMethod(CX2::Authentication::Domains * authDomain, const std::string & domainName,CX2::Authentication::Session * session, const std::string & methodName, const Json::Value & payload,  Json::Value *payloadOut)
 {
-    Threads::Sync::Lock_RD lock(smutexMethods);
+    sRPCMethod rpcMethod;
+    sRPCMethodMetrics rpcMethodMetrics;
 
-    if (methods.find(methodName) == methods.end())
-        return METHOD_RET_CODE_METHODNOTFOUND;
+    if (methodsFrozen)
+    {
+        // Immutable table, no lock required:
+        const sFrozenRPCMethod * frozenMethod = findFrozenMethod(methodName);
+        if (!frozenMethod)
+            return METHOD_RET_CODE_METHODNOTFOUND;
+        rpcMethod = frozenMethod->rpcMethod;
+        rpcMethodMetrics = frozenMethod->metrics;
+    }
     else
     {
-        CX2::Authentication::Manager * auth;
-        if ((auth=authDomain->openDomain(domainName))!=nullptr)
-        {
-            *payloadOut = methods[methodName].rpcMethod(methods[methodName].obj, auth, session,payload);
-            authDomain->closeDomain(domainName);
-            return METHOD_RET_CODE_SUCCESS;
-        }
-        else
+        Threads::Sync::Lock_RD lock(smutexMethods);
+        auto i = methods.find(methodName);
+        if (i == methods.end())
+            return METHOD_RET_CODE_METHODNOTFOUND;
+        rpcMethod = i->second;
+        rpcMethodMetrics = methodMetrics[methodName];
+    }
+
+    CX2::Authentication::Manager * auth;
+    if ((auth=authDomain->openDomain(domainName))!=nullptr)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        *payloadOut = rpcMethod.rpcMethod(rpcMethod.obj, auth, session,payload);
+        if (rpcMethodMetrics.execution)
         {
-            return METHOD_RET_CODE_INVALIDDOMAIN;
+            rpcMethodMetrics.execution->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-start).count()));
+            rpcMethodMetrics.calls->add();
         }
-
+        authDomain->closeDomain(domainName);
+        return METHOD_RET_CODE_SUCCESS;
+    }
+    else
+    {
+        return METHOD_RET_CODE_INVALIDDOMAIN;
     }
 }
 
 eMethodValidationCodes MethodsManager::validateRPCMethodPerms(CX2::Authentication::Manager * auth, CX2::Authentication::Session *session, const std::string &methodName, const std::set<uint32_t> & extraTmpIndexes, Json::Value *reasons)
 {
-    std::set<uint32_t> passIndexesLeft;
-    std::set<CX2::Authentication::sApplicationAttrib> attribsLeft;
+    if (methodsFrozen)
+    {
+        // Immutable table, no lock required:
+        const sFrozenRPCMethod * frozenMethod = findFrozenMethod(methodName);
+        if (!frozenMethod)
+            return VALIDATION_METHODNOTFOUND;
+        return validateRPCMethodPerms(auth,session,methodName,frozenMethod->requireFullAuth,extraTmpIndexes,reasons);
+    }
+
     Threads::Sync::Lock_RD lock(smutexMethods);
 
     // Check if the method exist at all:
-    if (methods.find(methodName) == methods.end())
+    auto i = methodRequireFullAuth.find(methodName);
+    if (i == methodRequireFullAuth.end())
         return VALIDATION_METHODNOTFOUND;
 
+    return validateRPCMethodPerms(auth,session,methodName,i->second,extraTmpIndexes,reasons);
+}
+
+eMethodValidationCodes MethodsManager::validateRPCMethodPerms(CX2::Authentication::Manager *auth, CX2::Authentication::Session *session, const std::string &methodName, bool requireFullAuth, const std::set<uint32_t> &extraTmpIndexes, Json::Value *reasons)
+{
     // If requires full authentication, check that the session report that is fully authenticated (all required ID's) and it's also a persistent session.
-    if (methodRequireFullAuth[methodName])
+    if (requireFullAuth)
     {
         if (!session || !session->getIsFullyLoggedIn(CX2::Authentication::CHECK_DISALLOW_EXPIRED_PASSWORDS) || !session->getIsPersistentSession())
             return VALIDATION_NOTAUTHORIZED;
     }
     // else: otherwise, the method will only be validated against authenticated attribs/indexes
 
-    // Validate that the method haves the required attribs/pass indexes:
-    if (methodsAttribs.validateMethod(auth,session,methodName,extraTmpIndexes,&passIndexesLeft,&attribsLeft))
-    {
+    // Validate that the method haves the required attribs/pass indexes (using the compiled table):
+    if (methodsAttribs.validateMethod(auth,session,methodName,extraTmpIndexes))
         return VALIDATION_OK;
-    }
-    else
-    {
-        // The method is not authorized for this authentication level.. Report what is failing.
-        (*reasons)["passIndexesLeft"] = toValue(passIndexesLeft);
-        (*reasons)["attribsLeft"] = toValue(attribsLeft);
-        return VALIDATION_NOTAUTHORIZED;
-    }
 
+    Threads::Metrics::MetricsRegistry * registry = metrics;
+    if (registry)
+        registry->getCounter("rpc_method_denied_total",Threads::Metrics::MetricsRegistry::label("method",methodName))->add();
+
+    // The method is not authorized for this authentication level.. Report what is failing.
+    std::set<uint32_t> passIndexesLeft;
+    std::set<CX2::Authentication::sApplicationAttrib> attribsLeft;
+    methodsAttribs.validateMethod(auth,session,methodName,extraTmpIndexes,&passIndexesLeft,&attribsLeft);
+    (*reasons)["passIndexesLeft"] = toValue(passIndexesLeft);
+    (*reasons)["attribsLeft"] = toValue(attribsLeft);
+    return VALIDATION_NOTAUTHORIZED;
 }
 
 CX2::Authentication::MethodsAttributes_Map *MethodsManager::getMethodsAttribs()
@@ -94,8 +147,50 @@ CX2::Authentication::MethodsAttributes_Map *MethodsManager::getMethodsAttribs()
 
 bool MethodsManager::getMethodRequireFullSession(const std::string &methodName)
 {
+    if (methodsFrozen)
+    {
+        const sFrozenRPCMethod * frozenMethod = findFrozenMethod(methodName);
+        return frozenMethod && frozenMethod->requireFullAuth;
+    }
+
     Threads::Sync::Lock_RD lock(smutexMethods);
-    return methodRequireFullAuth[methodName];
+    auto i = methodRequireFullAuth.find(methodName);
+    return i != methodRequireFullAuth.end() && i->second;
+}
+
+void MethodsManager::setMetrics(Threads::Metrics::MetricsRegistry *registry)
+{
+    Threads::Sync::Lock_RW lock(smutexMethods);
+    metrics = registry;
+    for (auto & i : methodMetrics)
+        i.second = createMethodMetrics(i.first);
+}
+
+Threads::Metrics::MetricsRegistry *MethodsManager::getMetrics()
+{
+    return metrics;
+}
+
+MethodsManager::sRPCMethodMetrics MethodsManager::createMethodMetrics(const std::string &methodName)
+{
+    sRPCMethodMetrics r;
+    Threads::Metrics::MetricsRegistry * registry = metrics;
+    if (registry)
+    {
+        std::string labels = Threads::Metrics::MetricsRegistry::label("method",methodName);
+        r.calls = registry->getCounter("rpc_method_calls_total",labels);
+        r.execution = registry->getHistogram("rpc_method_execution_microseconds",labels);
+    }
+    return r;
+}
+
+const MethodsManager::sFrozenRPCMethod *MethodsManager::findFrozenMethod(const std::string &methodName)
+{
+    auto i = std::lower_bound(frozenMethods.begin(), frozenMethods.end(), methodName,
+                              [](const sFrozenRPCMethod & m, const std::string & name) { return m.methodName < name; });
+    if (i == frozenMethods.end() || i->methodName != methodName)
+        return nullptr;
+    return &(*i);
 }
 
 std::set<CX2::Authentication::sApplicationAttrib> MethodsManager::getAppAttribs(const std::set<std::string> &reqAttribs)
@@ -3,11 +3,14 @@
 
 #include <map>
 #include <list>
+#include <vector>
+#include <atomic>
 
 #include <json/json.h>
 
 #include <cx2_auth/domains.h>
 #include <cx2_thr_mutex/mutex_shared.h>
+#include <cx2_thr_threads/metricsregistry.h>
 
 #include "validation_codes.h"
 #include "methodsattributes_map.h"
@@ -52,6 +55,21 @@ public:
      * @return
      */
     bool addRPCMethod(const std::string & methodName, const std::set<std::string> & reqAttribs, const sRPCMethod & rpcMethod, bool requireFullAuth = true);
+    /**
+     * @brief freezeMethods Freeze the registered methods into an immutable dispatch table (no more methods can be added),
+     *                      then the methods are resolved and validated without locking.
+     */
+    void freezeMethods();
+    /**
+     * @brief setMetrics Record the per-method calls, execution times and denials in the metrics registry (call it before freezeMethods)
+     * @param registry metrics registry (nullptr to disable)
+     */
+    void setMetrics(Threads::Metrics::MetricsRegistry * registry);
+    /**
+     * @brief getMetrics Get the metrics registry
+     * @return metrics registry or nullptr if disabled
+     */
+    Threads::Metrics::MetricsRegistry * getMetrics();
     /**
      * @brief runRPCMethod2
      * @param methodName
@@ -85,6 +103,29 @@ public:
     std::string getAppName() const;
 
 private:
+    struct sRPCMethodMetrics
+    {
+        sRPCMethodMetrics()
+        {
+            calls = nullptr;
+            execution = nullptr;
+        }
+        Threads::Metrics::Counter * calls;
+        Threads::Metrics::LatencyHistogram * execution;
+    };
+    struct sFrozenRPCMethod
+    {
+        std::string methodName;
+        sRPCMethod rpcMethod;
+        bool requireFullAuth;
+        sRPCMethodMetrics metrics;
+    };
+
+    sRPCMethodMetrics createMethodMetrics(const std::string & methodName);
+
+    const sFrozenRPCMethod * findFrozenMethod(const std::string & methodName);
+    eMethodValidationCodes validateRPCMethodPerms(Authentication::Manager *auth, CX2::Authentication::Session *session, const std::string & methodName, bool requireFullAuth, const std::set<uint32_t> &extraTmpIndexes, Json::Value * reasons);
+
     std::set<CX2::Authentication::sApplicationAttrib> getAppAttribs(const std::set<std::string> & reqAttribs);
 
     Json::Value toValue(const std::set<CX2::Authentication::sApplicationAttrib> &t);
@@ -99,11 +140,19 @@ private:
     // method name -> bool (requireFullAuth).
     std::map<std::string,bool> methodRequireFullAuth;
 
+    // method name -> metrics.
+    std::map<std::string,sRPCMethodMetrics> methodMetrics;
+    std::atomic<Threads::Metrics::MetricsRegistry *> metrics;
+
     std::string appName;
     CX2::Authentication::MethodsAttributes_Map methodsAttribs;
 
     // lock for methods manipulation...
     Threads::Sync::Mutex_Shared smutexMethods;
+
+    // Frozen methods (sorted by name), immutable once methodsFrozen is set:
+    std::vector<sFrozenRPCMethod> frozenMethods;
+    std::atomic<bool> methodsFrozen;
 };
 
 }}
@@ -1,13 +1,23 @@
 #include "fastrpc.h"
 #include <cx2_thr_mutex/lock_shared.h>
 
+#include <algorithm>
+
 using namespace CX2::RPC::Fast;
 using namespace CX2;
 using Ms = std::chrono::milliseconds;
 
+// Reserved methods for the method ID's/features negotiation and the metrics:
+static const char * methodIdsMethodName = ".methodIds";
+static const char * featuresMethodName = ".features";
+static const char * metricsMethodName = ".metrics";
+
 FastRPC::FastRPC(uint32_t threadsCount, uint32_t taskQueues)
 {
     threadPool = new CX2::Threads::Pool::ThreadPool(threadsCount, taskQueues);
+    methodsFrozen = false;
+    metrics = nullptr;
+    metricsExported = false;
 
     setRemoteExecutionTimeoutInMS();
     setMaxMessageSize();
@@ -34,26 +44,212 @@ void FastRPC::setQueuePushTimeoutInMS(const uint32_t &value)
 bool FastRPC::addMethod(const std::string &methodName, const sFastRPCMethod &rpcMethod)
 {
     Threads::Sync::Lock_RW lock(smutexMethods);
-    if (methods.find(methodName) == methods.end() )
+    if (!methodsFrozen && methods.find(methodName) == methods.end() )
     {
         // Put the method.
-        methods[methodName] = rpcMethod;
+        methods[methodName].rpcMethod = rpcMethod;
+        setMethodMetrics(methodName,&methods[methodName]);
         return true;
     }
     return false;
 }
 
+void FastRPC::freezeMethods()
+{
+    Threads::Sync::Lock_RW lock(smutexMethods);
+    if (methodsFrozen)
+        return;
+
+    // std::map is already sorted by name:
+    for (const auto & i : methods)
+        frozenMethods.push_back({i.first,i.second});
+
+    methodsFrozen = true;
+}
+
 Json::Value FastRPC::runLocalRPCMethod(const std::string &methodName, const Json::Value & payload)
 {
-    Json::Value r;
+    if (methodName == methodIdsMethodName)
+        return frozenMethodIds();
+    if (methodName == featuresMethodName)
+        return features();
+    if (methodName == metricsMethodName && metricsExported)
+        return metricsToJSON(metrics);
+
+    if (methodsFrozen)
+    {
+        // Immutable table, no lock required:
+        auto i = std::lower_bound(frozenMethods.begin(), frozenMethods.end(), methodName,
+                                  [](const sFastRPCFrozenMethod & m, const std::string & name) { return m.methodName < name; });
+        if (i == frozenMethods.end() || i->methodName != methodName)
+            return Json::Value();
+        return runMethod(i->method,payload);
+    }
+
     Threads::Sync::Lock_RD lock(smutexMethods);
-    if (methods.find(methodName) != methods.end())
+    auto i = methods.find(methodName);
+    if (i == methods.end())
+        return Json::Value();
+    return runMethod(i->second,payload);
+}
+
+Json::Value FastRPC::runLocalRPCMethod(const uint32_t &methodId, const Json::Value &payload)
+{
+    if (!methodsFrozen || methodId >= frozenMethods.size())
+        return Json::Value();
+    return runMethod(frozenMethods[methodId].method,payload);
+}
+
+Json::Value FastRPC::runMethod(const sFastRPCRegisteredMethod &method, const Json::Value &payload)
+{
+    if (!method.execution)
+        return method.rpcMethod.rpcMethod(method.rpcMethod.obj,payload);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Json::Value r = method.rpcMethod.rpcMethod(method.rpcMethod.obj,payload);
+    method.execution->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-start).count()));
+    method.calls->add();
+    return r;
+}
+
+void FastRPC::setMetrics(Threads::Metrics::MetricsRegistry *registry, bool exportToPeers)
+{
+    Threads::Sync::Lock_RW lock(smutexMethods);
+    metrics = registry;
+    metricsExported = exportToPeers;
+    threadPool->setMetrics(registry,"fastrpc");
+    for (auto & i : methods)
+        setMethodMetrics(i.first,&i.second);
+}
+
+Json::Value FastRPC::metricsToJSON(Threads::Metrics::MetricsRegistry *registry)
+{
+    Json::Value r;
+    if (!registry)
+        return r;
+
+    int i=0;
+    for (const Threads::Metrics::sCounterSnapshot & counter : registry->getCounters())
+    {
+        r["counters"][i]["name"] = counter.name;
+        r["counters"][i]["labels"] = counter.labels;
+        r["counters"][i]["value"] = static_cast<Json::UInt64>(counter.value);
+        i++;
+    }
+    i=0;
+    for (const Threads::Metrics::sNamedHistogramSnapshot & histogram : registry->getHistograms())
+    {
+        r["histograms"][i]["name"] = histogram.name;
+        r["histograms"][i]["labels"] = histogram.labels;
+        r["histograms"][i]["count"] = static_cast<Json::UInt64>(histogram.histogram.count);
+        r["histograms"][i]["sum"] = static_cast<Json::UInt64>(histogram.histogram.sum);
+        r["histograms"][i]["max"] = static_cast<Json::UInt64>(histogram.histogram.max);
+        r["histograms"][i]["p50"] = static_cast<Json::UInt64>(histogram.histogram.percentile(50));
+        r["histograms"][i]["p90"] = static_cast<Json::UInt64>(histogram.histogram.percentile(90));
+        r["histograms"][i]["p99"] = static_cast<Json::UInt64>(histogram.histogram.percentile(99));
+        r["histograms"][i]["p999"] = static_cast<Json::UInt64>(histogram.histogram.percentile(99.9));
+        i++;
+    }
+    return r;
+}
+
+void FastRPC::setMethodMetrics(const std::string &methodName, sFastRPCRegisteredMethod *method)
+{
+    Threads::Metrics::MetricsRegistry * registry = metrics;
+    if (!registry)
     {
-        r = methods[methodName].rpcMethod(methods[methodName].obj,payload);
+        method->calls = nullptr;
+        method->execution = nullptr;
+        return;
     }
+    std::string labels = Threads::Metrics::MetricsRegistry::label("method",methodName);
+    method->calls = registry->getCounter("fastrpc_method_calls_total",labels);
+    method->execution = registry->getHistogram("fastrpc_method_execution_microseconds",labels);
+}
+
+void FastRPC::incrementCounter(const std::string &name, const std::string &labelKey, const std::string &labelValue)
+{
+    Threads::Metrics::MetricsRegistry * registry = metrics;
+    if (registry)
+        registry->getCounter(name,Threads::Metrics::MetricsRegistry::label(labelKey,labelValue))->add();
+}
+
+std::string FastRPC::methodLabel(const sFastRPCParameters *params)
+{
+    if (params->methodId != FASTRPC_NO_METHODID)
+        return methodsFrozen && params->methodId < frozenMethods.size()? frozenMethods[params->methodId].methodName : "unknown";
+
+    if (methodsFrozen)
+    {
+        // Immutable table, no lock required:
+        auto i = std::lower_bound(frozenMethods.begin(), frozenMethods.end(), params->methodName,
+                                  [](const sFastRPCFrozenMethod & m, const std::string & name) { return m.methodName < name; });
+        return i != frozenMethods.end() && i->methodName == params->methodName? i->methodName : "unknown";
+    }
+
+    Threads::Sync::Lock_RD lock(smutexMethods);
+    return methods.find(params->methodName) != methods.end()? params->methodName : "unknown";
+}
+
+Json::Value FastRPC::frozenMethodIds()
+{
+    // Method names ordered by ID (null if the methods are not frozen).
+    Json::Value r;
+    if (!methodsFrozen)
+        return r;
+    for (size_t i=0; i<frozenMethods.size(); i++)
+        r[static_cast<int>(i)] = frozenMethods[i].methodName;
+    return r;
+}
+
+Json::Value FastRPC::features()
+{
+    Json::Value r;
+    r["deadlines"] = true;
     return r;
 }
 
+bool FastRPC::negotiateMethodIds(const std::string &connectionKey)
+{
+    Json::Value ids = runRemoteRPCMethod(connectionKey, methodIdsMethodName, Json::Value());
+    if (!ids.isArray())
+        return false;
+
+    std::map<std::string,uint32_t> remoteMethodIds;
+    for (Json::ArrayIndex i=0; i<ids.size(); i++)
+    {
+        if (!ids[i].isString())
+            return false;
+        remoteMethodIds[ids[i].asString()] = i;
+    }
+
+    FastRPC_Connection * connection;
+    if ((connection=(FastRPC_Connection *)connectionsByKeyId.openElement(connectionKey))==nullptr)
+        return false;
+
+    connection->mtRemoteMethodIds.lock();
+    connection->remoteMethodIds.swap(remoteMethodIds);
+    connection->mtRemoteMethodIds.unlock();
+
+    connectionsByKeyId.closeElement(connectionKey);
+    return true;
+}
+
+bool FastRPC::negotiateFeatures(const std::string &connectionKey)
+{
+    // Old peers don't know this method (null answer):
+    Json::Value r = runRemoteRPCMethod(connectionKey, featuresMethodName, Json::Value());
+    if (!r.isObject() || !r["deadlines"].isBool() || !r["deadlines"].asBool())
+        return false;
+
+    FastRPC_Connection * connection;
+    if ((connection=(FastRPC_Connection *)connectionsByKeyId.openElement(connectionKey))==nullptr)
+        return false;
+    connection->remoteDeadlines = true;
+    connectionsByKeyId.closeElement(connectionKey);
+    return true;
+}
+
 void FastRPC::eventUnexpectedAnswerReceived(FastRPC_Connection *, const std::string & )
 {
 }
@@ -109,12 +305,15 @@ int FastRPC::processAnswer(FastRPC_Connection * connection)
     return 0;
 }
 
-int FastRPC::processQuery(Network::Streams::StreamSocket *stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared * mtDone, Threads::Sync::Mutex * mtSocket)
+int FastRPC::processQuery(FastRPC_Connection *connection, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared * mtDone, bool byMethodId)
 {
+    Network::Streams::StreamSocket * stream = connection->stream;
     uint32_t maxAlloc = maxMessageSize;
     uint64_t requestId;
     char * payloadBytes;
     bool ok;
+    std::string methodName;
+    uint32_t methodId = FASTRPC_NO_METHODID;
 
     ////////////////////////////////////////////////////////////
     // READ THE REQUEST ID.
@@ -123,8 +322,11 @@ int FastRPC::processQuery(Network::Streams::StreamSocket *stream, const std::str
     {
         return -1;
     }
-    // READ THE METHOD NAME.
-    std::string methodName = stream->readString(&ok,8);
+    // READ THE METHOD NAME/ID.
+    if (byMethodId)
+        methodId = stream->readU32(&ok);
+    else
+        methodName = stream->readString(&ok,8);
     if (!ok)
     {
         return -2;
@@ -142,11 +344,21 @@ int FastRPC::processQuery(Network::Streams::StreamSocket *stream, const std::str
     sFastRPCParameters * params = new sFastRPCParameters;
     params->requestId = requestId;
     params->methodName = methodName;
+    params->methodId = methodId;
     params->done = mtDone;
-    params->mtSocket = mtSocket;
+    params->mtSocket = connection->mtSocket;
     params->streamBack = stream;
     params->caller = this;
     params->maxMessageSize = maxMessageSize;
+    params->connection = connection;
+
+    // Deadline received just before this query:
+    if (connection->nextQueryHasDeadline)
+    {
+        params->hasDeadline = true;
+        params->deadline = std::chrono::steady_clock::now() + Ms(connection->nextQueryTimeoutInMS);
+        connection->nextQueryHasDeadline = false;
+    }
 
     bool parsingSuccessful = reader.parse( payloadBytes, params->payload );
     delete [] payloadBytes;
@@ -160,9 +372,20 @@ int FastRPC::processQuery(Network::Streams::StreamSocket *stream, const std::str
     else
     {
         params->done->lock_shared();
+
+        // Register before pushing, the task may finish before pushTask returns:
+        connection->mtReceivedQueries.lock();
+        connection->receivedQueries[requestId] = params;
+        connection->mtReceivedQueries.unlock();
+
         if (!threadPool->pushTask(executeRPCTask,params,queuePushTimeoutInMS,priority,key))
         {
+            connection->mtReceivedQueries.lock();
+            connection->receivedQueries.erase(requestId);
+            connection->mtReceivedQueries.unlock();
+
             // Can't push the task in the queue. Null answer.
+            incrementCounter("fastrpc_queue_drops_total","method",methodLabel(params));
             eventFullQueueDrop(params);
             sendRPCAnswer(params,"");
             params->done->unlock_shared();
@@ -172,6 +395,40 @@ int FastRPC::processQuery(Network::Streams::StreamSocket *stream, const std::str
     return 0;
 }
 
+int FastRPC::processDeadline(FastRPC_Connection *connection)
+{
+    bool ok;
+    ////////////////////////////////////////////////////////////
+    // READ THE REMAINING TIME FOR THE NEXT QUERY.
+    uint32_t timeoutInMS = connection->stream->readU32(&ok);
+    if (!ok)
+    {
+        return -1;
+    }
+    connection->nextQueryHasDeadline = true;
+    connection->nextQueryTimeoutInMS = timeoutInMS;
+    return 0;
+}
+
+int FastRPC::processCancel(FastRPC_Connection *connection)
+{
+    ////////////////////////////////////////////////////////////
+    // READ THE REQUEST ID.
+    uint64_t requestId=connection->stream->readU64();
+    if (!requestId)
+    {
+        return -1;
+    }
+
+    // If still queued or executing, discard it (the caller is not waiting for the answer anymore):
+    connection->mtReceivedQueries.lock();
+    auto i = connection->receivedQueries.find(requestId);
+    if (i != connection->receivedQueries.end())
+        i->second->cancelled = true;
+    connection->mtReceivedQueries.unlock();
+    return 0;
+}
+
 void FastRPC::setRemoteExecutionTimeoutInMS(const uint32_t &value)
 {
     remoteExecutionTimeoutInMS = value;
@@ -204,7 +461,19 @@ int FastRPC::processConnection(Network::Streams::StreamSocket *stream, const std
             ret = processAnswer(connection);
             break;
         case 'Q':
-            ret = processQuery(stream,key,priority,&mtDone,&mtSocket);
+            ret = processQuery(connection,key,priority,&mtDone,false);
+            break;
+        case 'q':
+            // Query by method ID:
+            ret = processQuery(connection,key,priority,&mtDone,true);
+            break;
+        case 'D':
+            // Deadline for the next query:
+            ret = processDeadline(connection);
+            break;
+        case 'C':
+            // Cancel query:
+            ret = processCancel(connection);
             break;
         default:
         case 0:
@@ -229,12 +498,31 @@ int FastRPC::processConnection(Network::Streams::StreamSocket *stream, const std
 void FastRPC::executeRPCTask(void *taskData)
 {
     sFastRPCParameters * params = (sFastRPCParameters *)(taskData);
+    FastRPC * caller = (FastRPC *)params->caller;
+
+    // Expired while queued, or cancelled: the caller already gave up, don't execute it.
+    if (params->cancelled)
+        caller->incrementCounter("fastrpc_cancelled_tasks_total","method",caller->methodLabel(params));
+    else if (params->hasDeadline && std::chrono::steady_clock::now() >= params->deadline)
+        caller->incrementCounter("fastrpc_expired_tasks_total","method",caller->methodLabel(params));
+    else
+    {
+        Json::FastWriter fastWriter;
+        Json::Value r = params->methodId == FASTRPC_NO_METHODID ?
+                    caller->runLocalRPCMethod(params->methodName,params->payload) :
+                    caller->runLocalRPCMethod(params->methodId,params->payload);
+
+        // Cancelled during the execution: don't answer.
+        if (!params->cancelled)
+            sendRPCAnswer(params,fastWriter.write(r));
+    }
+
+    params->connection->mtReceivedQueries.lock();
+    params->connection->receivedQueries.erase(params->requestId);
+    params->connection->mtReceivedQueries.unlock();
 
-    Json::FastWriter fastWriter;
-    Json::Value r = ((FastRPC *)params->caller)->runLocalRPCMethod(params->methodName,params->payload);
-    std::string output = fastWriter.write(r);
-    sendRPCAnswer(params,output);
     params->done->unlock_shared();
+    delete params;
 }
 
 void FastRPC::sendRPCAnswer(sFastRPCParameters *params, const std::string &answer)
@@ -254,7 +542,7 @@ void FastRPC::setMaxMessageSize(const uint32_t &value)
     maxMessageSize = value;
 }
 
-Json::Value FastRPC::runRemoteRPCMethod(const std::string &connectionKey, const std::string &methodName, const Json::Value &payload)
+Json::Value FastRPC::runRemoteRPCMethod(const std::string &connectionKey, const std::string &methodName, const Json::Value &payload, const uint32_t &timeoutInMS)
 {
     Json::Value r;
 
@@ -267,6 +555,10 @@ Json::Value FastRPC::runRemoteRPCMethod(const std::string &connectionKey, const
     FastRPC_Connection * connection;
     if ((connection=(FastRPC_Connection *)connectionsByKeyId.openElement(connectionKey))!=nullptr)
     {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        uint32_t callTimeoutInMS = timeoutInMS?timeoutInMS:remoteExecutionTimeoutInMS.load();
+        std::chrono::steady_clock::time_point deadline = start + Ms(callTimeoutInMS);
+        bool remoteDeadlines = connection->remoteDeadlines;
         uint64_t requestId;
         // Create a request ID.
         connection->mtReqIdCt.lock();
@@ -280,54 +572,91 @@ Json::Value FastRPC::runRemoteRPCMethod(const std::string &connectionKey, const
             connection->pendingRequests.insert(requestId);
         }
 
+        // Use the negotiated method ID if available:
+        uint32_t methodId = FASTRPC_NO_METHODID;
+        connection->mtRemoteMethodIds.lock();
+        auto i = connection->remoteMethodIds.find(methodName);
+        if (i != connection->remoteMethodIds.end())
+            methodId = i->second;
+        connection->mtRemoteMethodIds.unlock();
+
         connection->mtSocket->lock();
-        if (    connection->stream->writeU8('Q') && // ANSWER
-                connection->stream->writeU64(requestId) &&
-                connection->stream->writeString8(methodName) &&
-                connection->stream->writeString32( output,maxMessageSize ) )
+        // The remaining time goes before the query (if the remote peer accepts deadlines):
+        if (    !remoteDeadlines ||
+                ( connection->stream->writeU8('D') && // DEADLINE FOR THE NEXT QUERY
+                  connection->stream->writeU32(callTimeoutInMS) ) )
         {
+            if (methodId != FASTRPC_NO_METHODID)
+            {
+                if (    connection->stream->writeU8('q') && // QUERY BY ID
+                        connection->stream->writeU64(requestId) &&
+                        connection->stream->writeU32(methodId) &&
+                        connection->stream->writeString32( output,maxMessageSize ) )
+                {
+                }
+            }
+            else if (    connection->stream->writeU8('Q') && // QUERY
+                         connection->stream->writeU64(requestId) &&
+                         connection->stream->writeString8(methodName) &&
+                         connection->stream->writeString32( output,maxMessageSize ) )
+            {
+            }
         }
         connection->mtSocket->unlock();
 
-        // Time to wait for answers...
-        for (;;)
+        // Time to wait for answers (the answer may be already there)...
+        bool timedOut = false;
+        if (1)
         {
             std::unique_lock<std::mutex> lk(connection->mtAnswers);
 
-            // Process multiple signals until our answer comes...
-
-            if (connection->cvAnswers.wait_for(lk,Ms(remoteExecutionTimeoutInMS)) == std::cv_status::timeout )
+            // Process multiple signals until our answer comes or the deadline is reached...
+            while ( connection->answers.find(requestId) == connection->answers.end() && !connection->terminated )
             {
-                // break by timeout. (no answer)
-                eventRemoteExecutionTimedOut(connectionKey,methodName,payload);
-                break;
+                if (connection->cvAnswers.wait_until(lk,deadline) == std::cv_status::timeout)
+                {
+                    timedOut = connection->answers.find(requestId) == connection->answers.end();
+                    break;
+                }
             }
 
-            if ( lk.owns_lock() && connection->answers.find(requestId) != connection->answers.end())
+            if ( connection->answers.find(requestId) != connection->answers.end())
             {
-                // break by element found. (answer)
+                // Answer:
                 r = connection->answers[requestId];
-                break;
-            }
-
-            if ( lk.owns_lock() && connection->terminated )
-            {
-                break;
             }
-        }
 
-        if (1)
-        {
-            std::unique_lock<std::mutex> lk(connection->mtAnswers);
             // Revoke authorization to be inserted, clean results...
             connection->answers.erase(requestId);
             connection->pendingRequests.erase(requestId);
         }
 
+        if (timedOut)
+        {
+            // Tell the remote peer to discard the task:
+            if (remoteDeadlines)
+            {
+                connection->mtSocket->lock();
+                if (    connection->stream->writeU8('C') && // CANCEL
+                        connection->stream->writeU64(requestId) )
+                {
+                }
+                connection->mtSocket->unlock();
+            }
+            incrementCounter("fastrpc_remote_timeouts_total","method",methodName);
+            eventRemoteExecutionTimedOut(connectionKey,methodName,payload);
+        }
+
+        Threads::Metrics::MetricsRegistry * registry = metrics;
+        if (registry)
+            registry->getHistogram("fastrpc_remote_call_microseconds",Threads::Metrics::MetricsRegistry::label("method",methodName))->record(
+                        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-start).count()));
+
         connectionsByKeyId.closeElement(connectionKey);
     }
     else
     {
+        incrementCounter("fastrpc_remote_disconnected_total","method",methodName);
         eventRemotePeerDisconnected(connectionKey,methodName,payload);
     }
     return r;
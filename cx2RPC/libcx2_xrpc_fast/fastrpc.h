@@ -4,11 +4,19 @@
 #include <json/json.h>
 
 #include <cx2_thr_threads/threadpool.h>
+#include <cx2_thr_threads/metricsregistry.h>
 #include <cx2_thr_mutex/mutex_shared.h>
 #include <cx2_thr_mutex/mutex.h>
 #include <cx2_net_sockets/streamsocket.h>
 #include <cx2_thr_safecontainers/map.h>
 
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+// Method ID used when the method is called by name:
+#define FASTRPC_NO_METHODID 0xFFFFFFFF
+
 namespace CX2 { namespace RPC { namespace Fast {
 
 struct sFastRPCMethod
@@ -22,17 +30,31 @@ struct sFastRPCMethod
      */
     void * obj;
 };
+class FastRPC_Connection;
+
 struct sFastRPCParameters
 {
+    sFastRPCParameters()
+    {
+        hasDeadline = false;
+        cancelled = false;
+    }
     Network::Streams::StreamSocket *streamBack;
     uint32_t maxMessageSize;
     void * caller;
     Threads::Sync::Mutex_Shared * done;
     Threads::Sync::Mutex * mtSocket;
     std::string methodName;
+    // Method ID (FASTRPC_NO_METHODID if called by name)
+    uint32_t methodId;
     Json::Value payload;
     //std::string key;
     uint64_t requestId;
+    // Caller deadline (if provided), the task is discarded when expired or cancelled:
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<bool> cancelled;
+    FastRPC_Connection * connection;
 };
 
 class FastRPC_Connection : public CX2::Threads::Safe::Map_Element
@@ -42,6 +64,9 @@ public:
     {
         requestIdCounter = 1;
         terminated = false;
+        remoteDeadlines = false;
+        nextQueryHasDeadline = false;
+        nextQueryTimeoutInMS = 0;
     }
     // Socket
     CX2::Network::Streams::StreamSocket * stream;
@@ -57,6 +82,21 @@ public:
     std::condition_variable cvAnswers;
     std::set<uint64_t> pendingRequests;
 
+    // Remote method ID's (negotiated):
+    std::map<std::string,uint32_t> remoteMethodIds;
+    std::mutex mtRemoteMethodIds;
+
+    // Remote peer accepts deadlines and cancellations (negotiated):
+    std::atomic<bool> remoteDeadlines;
+
+    // Deadline for the next received query (only used by the connection reader):
+    bool nextQueryHasDeadline;
+    uint32_t nextQueryTimeoutInMS;
+
+    // Received queries (queued or executing) by request ID, for the cancellations:
+    std::map<uint64_t,sFastRPCParameters *> receivedQueries;
+    std::mutex mtReceivedQueries;
+
     // Finalization:
     bool terminated;
 };
@@ -84,6 +124,38 @@ public:
      * @param rpcMethod Method function and Object
      */
     bool addMethod(const std::string & methodName, const sFastRPCMethod & rpcMethod);
+    /**
+     * @brief freezeMethods Freeze the registered methods into an immutable dispatch table (no more methods can be added),
+     *                      then the methods are resolved without locking and the remote peers can call them by numeric ID.
+     */
+    void freezeMethods();
+    /**
+     * @brief negotiateMethodIds Retrieve the method ID's from the remote peer (the peer should have frozen methods), then
+     *                           runRemoteRPCMethod will send the method ID instead of the method name in this connection.
+     * @param connectionKey Connection ID
+     * @return true if the remote peer provided the method ID's
+     */
+    bool negotiateMethodIds(const std::string &connectionKey);
+    /**
+     * @brief negotiateFeatures Check if the remote peer accepts deadlines and cancellations, then runRemoteRPCMethod
+     *                          will send the remaining time with each query and cancel the timed out queries, so the
+     *                          remote peer discards the expired tasks instead of executing them and answering.
+     * @param connectionKey Connection ID
+     * @return true if the remote peer accepts deadlines and cancellations
+     */
+    bool negotiateFeatures(const std::string &connectionKey);
+    /**
+     * @brief setMetrics Record the per-method calls/execution times, the thread pool queue wait times, the remote calls
+     *                   latencies and the timeouts/drops in the metrics registry (call it before freezeMethods).
+     *                   The series are labeled by method (never by connection, so they don't grow with the connections).
+     * @param registry metrics registry (nullptr to disable)
+     * @param exportToPeers export them as JSON to any connected peer through the reserved ".metrics" method (default: false)
+     */
+    void setMetrics(Threads::Metrics::MetricsRegistry * registry, bool exportToPeers = false);
+    /**
+     * @brief metricsToJSON Convert the metrics registry snapshot to JSON
+     */
+    static Json::Value metricsToJSON(Threads::Metrics::MetricsRegistry * registry);
     /**
      * @brief processConnection Process Connection Stream and manage bidirectional events from each side (Q/A).
      *                          Additional security should be configured at the TLS Connections, like peer validation
@@ -115,13 +187,15 @@ public:
      * @param connectionKey Connection ID (this class can thread-safe handle multiple connections at time)
      * @param methodName Method Name
      * @param payload Function Payload
+     * @param timeoutInMS timeout (and remote deadline) for this call in milliseconds, 0 for the remote execution timeout.
      * @return Answer, or Json::nullValue if answer is not received or if timed out.
      */
-    Json::Value runRemoteRPCMethod( const std::string &connectionKey, const std::string &methodName, const Json::Value &payload );
+    Json::Value runRemoteRPCMethod( const std::string &connectionKey, const std::string &methodName, const Json::Value &payload, const uint32_t & timeoutInMS = 0 );
 
     //////////////////////////////////////////////////////////
     // For Internal use only:
     Json::Value runLocalRPCMethod(const std::string & methodName, const Json::Value &payload);
+    Json::Value runLocalRPCMethod(const uint32_t & methodId, const Json::Value &payload);
 
 protected:
     virtual void eventUnexpectedAnswerReceived(FastRPC_Connection *connection, const std::string &answer);
@@ -130,20 +204,55 @@ protected:
     virtual void eventRemoteExecutionTimedOut(const std::string &connectionKey, const std::string &methodName, const Json::Value &payload);
 
 private:
+    struct sFastRPCRegisteredMethod
+    {
+        sFastRPCRegisteredMethod()
+        {
+            calls = nullptr;
+            execution = nullptr;
+        }
+        sFastRPCMethod rpcMethod;
+        // Metrics (if enabled):
+        Threads::Metrics::Counter * calls;
+        Threads::Metrics::LatencyHistogram * execution;
+    };
+    struct sFastRPCFrozenMethod
+    {
+        std::string methodName;
+        sFastRPCRegisteredMethod method;
+    };
+
     static void executeRPCTask(void * taskData);
     static void sendRPCAnswer(sFastRPCParameters * parameters, const std::string & answer);
 
     int processAnswer(FastRPC_Connection *connection);
-    int processQuery(CX2::Network::Streams::StreamSocket * stream, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared * mtDone, Threads::Sync::Mutex * mtSocket);
+    int processQuery(FastRPC_Connection *connection, const std::string &key, const float &priority, Threads::Sync::Mutex_Shared * mtDone, bool byMethodId);
+    int processDeadline(FastRPC_Connection *connection);
+    int processCancel(FastRPC_Connection *connection);
+    Json::Value features();
+    Json::Value frozenMethodIds();
+    Json::Value runMethod(const sFastRPCRegisteredMethod & method, const Json::Value &payload);
+    void setMethodMetrics(const std::string & methodName, sFastRPCRegisteredMethod * method);
+    void incrementCounter(const std::string & name, const std::string & labelKey, const std::string & labelValue);
+    /**
+     * @brief methodLabel Get the registered method name of the task for the metric labels ("unknown" if the peer requested
+     *                    a non-existent method, so the peers can't create unbounded label values)
+     */
+    std::string methodLabel(const sFastRPCParameters * params);
 
     CX2::Threads::Safe::Map<std::string> connectionsByKeyId;
 
     std::atomic<uint32_t> queuePushTimeoutInMS,maxMessageSize, remoteExecutionTimeoutInMS;
     // Methods:
     // method name -> method.
-    std::map<std::string,sFastRPCMethod> methods;
+    std::map<std::string,sFastRPCRegisteredMethod> methods;
     Threads::Sync::Mutex_Shared smutexMethods;
+    // Frozen methods (sorted by name, the method ID is the position), immutable once methodsFrozen is set:
+    std::vector<sFastRPCFrozenMethod> frozenMethods;
+    std::atomic<bool> methodsFrozen;
     CX2::Threads::Pool::ThreadPool * threadPool;
+    std::atomic<Threads::Metrics::MetricsRegistry *> metrics;
+    std::atomic<bool> metricsExported;
 };
 
 }}}
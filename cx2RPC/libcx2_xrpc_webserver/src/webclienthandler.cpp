@@ -1,9 +1,11 @@
 #include "webclienthandler.h"
 
 #include <cx2_mem_vars/b_mmap.h>
+#include <cx2_mem_vars/b_chunks.h>
 #include <cx2_xrpc_common/json_streamable.h>
 #include <cx2_xrpc_common/retcodes.h>
 #include <cx2_hlp_functions/crypto.h>
+#include <cx2_net_sockets/streamsocket.h>
 
 #include <stdarg.h>
 #include <fstream>
@@ -33,6 +35,8 @@ WebClientHandler::WebClientHandler(void *parent, Memory::Streams::Streamable *so
     authDomains = nullptr;
     sessionsManager = nullptr;
     resourceFilter = nullptr;
+    keepAliveIdleTimeout = 0;
+    requestReadTimeout = 0;
 }
 
 WebClientHandler::~WebClientHandler()
@@ -50,6 +54,7 @@ eHTTP_RetCode WebClientHandler::processClientRequest()
     std::string sRealRelativePath, sRealFullPath;
     eHTTP_RetCode ret  = HTTP_RET_404_NOT_FOUND;
     if (getRequestURI() == "/api") return processRPCRequest();
+    if (!metricsURI.empty() && getRequestURI() == metricsURI) return processMetricsRequest();
 
     // WEB MODE:
     std::string sSessionId = getRequestCookie("sessionId");
@@ -102,6 +107,25 @@ eHTTP_RetCode WebClientHandler::processClientRequest()
     return ret;
 }
 
+eHTTP_RetCode WebClientHandler::processMetricsRequest()
+{
+    Threads::Metrics::MetricsRegistry * registry = methodsManager->getMetrics();
+    if (!registry)
+    {
+        setResponseDataStreamer(nullptr,false);
+        return HTTP_RET_404_NOT_FOUND;
+    }
+
+    // Prometheus text format:
+    std::string metrics = registry->toPrometheus();
+    Memory::Containers::B_Chunks * metricsOut = new Memory::Containers::B_Chunks;
+    metricsOut->append(metrics.c_str(),metrics.size());
+
+    setResponseDataStreamer(metricsOut,true);
+    setResponseContentType("text/plain; version=0.0.4",true);
+    return HTTP_RET_200_OK;
+}
+
 // TODO: documentar los privilegios cargados de un usuario
 
 eHTTP_RetCode WebClientHandler::processHTMLIEngine( const std::string & sRealFullPath,WebSession * hSession )
@@ -955,6 +979,11 @@ void WebClientHandler::setUseHTMLIEngine(bool value)
     useHTMLIEngine = value;
 }
 
+void WebClientHandler::setMetricsURI(const std::string &value)
+{
+    metricsURI = value;
+}
+
 void WebClientHandler::setSoftwareVersion(const std::string &value)
 {
     softwareVersion = value;
@@ -969,6 +998,22 @@ void WebClientHandler::setWebServerName(const std::string &value)
     }
 }
 
+void WebClientHandler::setKeepAliveIdleTimeout(const uint32_t &value)
+{
+    Network::Streams::StreamSocket * sock = dynamic_cast<Network::Streams::StreamSocket *>(streamableObject);
+    keepAliveIdleTimeout = value;
+    requestReadTimeout = sock? sock->getReadTimeout() : 0;
+}
+
+void WebClientHandler::onWaitingNextRequest(bool waiting)
+{
+    Network::Streams::StreamSocket * sock = dynamic_cast<Network::Streams::StreamSocket *>(streamableObject);
+    if (!sock || !keepAliveIdleTimeout)
+        return;
+    // Idle keep-alive connections will be closed by the read timeout.
+    sock->setReadTimeout(waiting? keepAliveIdleTimeout : requestReadTimeout);
+}
+
 void WebClientHandler::setUsingCSRFToken(bool value)
 {
     usingCSRFToken = value;
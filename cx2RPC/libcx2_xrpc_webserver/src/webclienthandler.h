@@ -33,9 +33,16 @@ public:
     void setResourcesLocalPath(const std::string &value);
     void setUsingCSRFToken(bool value);
     void setUseHTMLIEngine(bool value);
+    void setMetricsURI(const std::string &value);
 
     void setWebServerName(const std::string &value);
     void setSoftwareVersion(const std::string &value);
+    /**
+     * @brief setKeepAliveIdleTimeout Set the socket read timeout used while waiting for the next keep-alive request
+     *                                (the current read timeout is restored when the request arrives)
+     * @param value timeout in seconds
+     */
+    void setKeepAliveIdleTimeout(const uint32_t &value);
 
 
     std::string getAppName() const;
@@ -50,9 +57,14 @@ protected:
      * @return http responce code.
      */
     Network::HTTP::eHTTP_RetCode processClientRequest() override;
+    /**
+     * @brief onWaitingNextRequest Apply the keep-alive idle timeout between requests
+     */
+    void onWaitingNextRequest(bool waiting) override;
 
 private:
     Network::HTTP::eHTTP_RetCode processHTMLIEngine(const std::string &sRealFullPath,WebSession * hSession);
+    Network::HTTP::eHTTP_RetCode processMetricsRequest();
     Network::HTTP::eHTTP_RetCode processRPCRequest();
     Network::HTTP::eHTTP_RetCode processRPCRequest_VERSION();
     Network::HTTP::eHTTP_RetCode processRPCRequest_AUTHINFO(WebSession * wSession, const uint32_t & uMaxAge);
@@ -81,8 +93,10 @@ private:
     std::string remoteIP, remoteTLSCN, remoteUserAgent;
     std::string resourcesLocalPath;
     bool useFormattedJSONOutput, usingCSRFToken, useHTMLIEngine;
+    std::string metricsURI;
     std::string webServerName;
     std::string softwareVersion;
+    uint32_t keepAliveIdleTimeout, requestReadTimeout;
 };
 
 }}}
@@ -18,6 +18,9 @@ WebServer::WebServer()
     useFormattedJSONOutput = true;
     usingCSRFToken = true;
     useHTMLIEngine = true;
+    keepAlive = true;
+    keepAliveIdleTimeout = 5;
+    keepAliveMaxRequests = 100;
     authenticator = nullptr;
     methodManagers = nullptr;
 }
@@ -83,9 +86,20 @@ bool WebServer::_callbackOnConnect(void * obj, Network::Streams::StreamSocket *
     webHandler.setUsingCSRFToken(webserver->getUsingCSRFToken());
     webHandler.setResourceFilter(webserver->getResourceFilter());
     webHandler.setResourcesLocalPath(webserver->getResourcesLocalPath());
+    if (!webserver->getWebServerName().empty())
+        webHandler.setServerConfig(webserver->getHTTPServerConfig());
     webHandler.setWebServerName(webserver->getWebServerName());
     webHandler.setSoftwareVersion(webserver->getSoftwareVersion());
     webHandler.setUseHTMLIEngine(webserver->getUseHTMLIEngine());
+    webHandler.setMetricsURI(webserver->getMetricsURI());
+
+    if (webserver->getKeepAlive())
+    {
+        // Idle keep-alive connections will be closed by the read timeout (only applied between requests).
+        webHandler.setKeepAliveIdleTimeout(webserver->getKeepAliveIdleTimeout());
+        webHandler.setKeepAlive(true);
+        webHandler.setKeepAliveMaxRequests(webserver->getKeepAliveMaxRequests());
+    }
 
     if (webserver->getExtCallBackOnConnect().call(obj,s,remotePairIPAddr,isSecure))
     {
@@ -144,6 +158,38 @@ void WebServer::setUseHTMLIEngine(bool value)
     useHTMLIEngine = value;
 }
 
+void WebServer::setMetricsURI(const std::string &value)
+{
+    metricsURI = value;
+}
+
+std::string WebServer::getMetricsURI() const
+{
+    return metricsURI;
+}
+
+void WebServer::setKeepAlive(bool value, const uint32_t &idleTimeout, const uint32_t &maxRequests)
+{
+    keepAlive = value;
+    keepAliveIdleTimeout = idleTimeout;
+    keepAliveMaxRequests = maxRequests;
+}
+
+bool WebServer::getKeepAlive() const
+{
+    return keepAlive;
+}
+
+uint32_t WebServer::getKeepAliveIdleTimeout() const
+{
+    return keepAliveIdleTimeout;
+}
+
+uint32_t WebServer::getKeepAliveMaxRequests() const
+{
+    return keepAliveMaxRequests;
+}
+
 std::string WebServer::getWebServerName() const
 {
     return webServerName;
@@ -152,6 +198,12 @@ std::string WebServer::getWebServerName() const
 void WebServer::setWebServerName(const std::string &value)
 {
     webServerName = value;
+    httpServerConfig.setServerName(value);
+}
+
+const Network::HTTP::HTTP_ServerConfig *WebServer::getHTTPServerConfig() const
+{
+    return &httpServerConfig;
 }
 
 std::string WebServer::getSoftwareVersion() const
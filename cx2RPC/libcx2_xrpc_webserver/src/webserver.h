@@ -7,6 +7,7 @@
 #include <cx2_net_sockets/streamsocket.h>
 #include <cx2_net_sockets/socket_acceptor_poolthreaded.h>
 #include <cx2_net_sockets/socket_acceptor_multithreaded.h>
+#include <cx2_netp_http/http_serverconfig.h>
 #include <cx2_auth/domains.h>
 #include <cx2_xrpc_common/methodsmanager.h>
 #include <cx2_prg_logs/rpclog.h>
@@ -140,6 +141,19 @@ public:
      * @param value true for using, false for not.
      */
     void setUseHTMLIEngine(bool value);
+    /**
+     * @brief setKeepAlive Set persistent HTTP connections (default: true, 5 seconds idle timeout, 100 requests per connection)
+     * @param value true to keep the connections open between requests
+     * @param idleTimeout max seconds waiting for data from the client (applied as socket read timeout)
+     * @param maxRequests max requests answered by each connection
+     */
+    void setKeepAlive(bool value, const uint32_t & idleTimeout = 5, const uint32_t & maxRequests = 100);
+    /**
+     * @brief setMetricsURI Set the URI where the methods manager metrics are exported in prometheus text format
+     *                      (default: empty/disabled, the methods manager should have a metrics registry)
+     * @param value URI (eg. /metrics)
+     */
+    void setMetricsURI(const std::string & value);
 
     ////////////////////////////////////////////////////////////////////////////////
     // Internal Methods (ClientHandler->Webserver), don't use them
@@ -156,9 +170,16 @@ public:
     sWebServerCallBack getExtCallBackOnTimeOut() const;
     std::string getSoftwareVersion() const;
     std::string getWebServerName() const;
+    const Network::HTTP::HTTP_ServerConfig * getHTTPServerConfig() const;
 
     bool getUseHTMLIEngine() const;
 
+    bool getKeepAlive() const;
+    uint32_t getKeepAliveIdleTimeout() const;
+    uint32_t getKeepAliveMaxRequests() const;
+
+    std::string getMetricsURI() const;
+
     std::string getAppName() const;
 
     Application::Logs::RPCLog *getRPCLog() const;
@@ -190,9 +211,14 @@ private:
     MethodsManager *methodManagers;
     SessionsManager sessionsManager;
     bool useFormattedJSONOutput, usingCSRFToken, useHTMLIEngine;
+    bool keepAlive;
+    uint32_t keepAliveIdleTimeout, keepAliveMaxRequests;
     std::string resourcesLocalPath;
+    std::string metricsURI;
     std::string webServerName;
     std::string softwareVersion;
+    // Response defaults shared by the client handlers (with the Server header formatted once).
+    Network::HTTP::HTTP_ServerConfig httpServerConfig;
 };
 
 }}}
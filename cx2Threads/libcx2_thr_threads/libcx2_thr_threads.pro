@@ -4,11 +4,13 @@ CONFIG += c++11
 SOURCES += \ 
     src/threaded.cpp \
     src/threadpool.cpp \
-    src/garbagecollector.cpp
+    src/garbagecollector.cpp \
+    src/metricsregistry.cpp
 HEADERS += \ 
     src/threaded.h \
     src/threadpool.h \
-    src/garbagecollector.h
+    src/garbagecollector.h \
+    src/metricsregistry.h
 
 isEmpty(PREFIX) {
     PREFIX = /usr/local
@@ -0,0 +1,246 @@
+#include "metricsregistry.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+using namespace CX2::Threads::Metrics;
+
+static size_t currentShard()
+{
+    // Each thread takes the next shard on its first use.
+    static std::atomic<size_t> nextShard(0);
+    static thread_local size_t shard = (nextShard++) % METRICS_SHARDS;
+    return shard;
+}
+
+Counter::Counter()
+{
+    for (size_t i=0; i<METRICS_SHARDS; i++)
+        shards[i].value = 0;
+}
+
+void Counter::add(const uint64_t &value)
+{
+    shards[currentShard()].value.fetch_add(value,std::memory_order_relaxed);
+}
+
+uint64_t Counter::get() const
+{
+    uint64_t r = 0;
+    for (size_t i=0; i<METRICS_SHARDS; i++)
+        r += shards[i].value.load(std::memory_order_relaxed);
+    return r;
+}
+
+uint64_t sHistogramSnapshot::percentile(const double &p) const
+{
+    if (!count)
+        return 0;
+
+    uint64_t target = static_cast<uint64_t>((p/100.0)*count + 0.5);
+    if (target == 0) target = 1;
+    if (target > count) target = count;
+
+    uint64_t accumulated = 0;
+    for (size_t i=0; i<buckets.size(); i++)
+    {
+        accumulated += buckets[i];
+        if (accumulated >= target)
+        {
+            // Don't report more than the max observed value:
+            uint64_t r = LatencyHistogram::bucketUpperBound(i);
+            return r>max?max:r;
+        }
+    }
+    return max;
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    for (size_t i=0; i<METRICS_SHARDS; i++)
+    {
+        shards[i].count = 0;
+        shards[i].sum = 0;
+        shards[i].max = 0;
+        for (size_t b=0; b<HISTOGRAM_BUCKETS; b++)
+            shards[i].buckets[b] = 0;
+    }
+}
+
+void LatencyHistogram::record(const uint64_t &value)
+{
+    sShard & shard = shards[currentShard()];
+
+    shard.buckets[bucketIndex(value)].fetch_add(1,std::memory_order_relaxed);
+    shard.count.fetch_add(1,std::memory_order_relaxed);
+    shard.sum.fetch_add(value,std::memory_order_relaxed);
+
+    uint64_t currentMax = shard.max.load(std::memory_order_relaxed);
+    while (value > currentMax && !shard.max.compare_exchange_weak(currentMax,value,std::memory_order_relaxed))
+    {
+    }
+}
+
+sHistogramSnapshot LatencyHistogram::snapshot() const
+{
+    sHistogramSnapshot r;
+    r.buckets.resize(HISTOGRAM_BUCKETS,0);
+    for (size_t i=0; i<METRICS_SHARDS; i++)
+    {
+        r.count += shards[i].count.load(std::memory_order_relaxed);
+        r.sum += shards[i].sum.load(std::memory_order_relaxed);
+        uint64_t max = shards[i].max.load(std::memory_order_relaxed);
+        if (max > r.max) r.max = max;
+        for (size_t b=0; b<HISTOGRAM_BUCKETS; b++)
+            r.buckets[b] += shards[i].buckets[b].load(std::memory_order_relaxed);
+    }
+    return r;
+}
+
+size_t LatencyHistogram::bucketIndex(const uint64_t &value)
+{
+    const uint64_t subBuckets = 1<<HISTOGRAM_SUBBUCKET_BITS;
+
+    // Exact values:
+    if (value < subBuckets)
+        return static_cast<size_t>(value);
+
+    // Overflow:
+    if (value >> HISTOGRAM_MAX_BITS)
+        return HISTOGRAM_BUCKETS-1;
+
+    // Magnitude (most significant bit) + the next significant bits:
+    size_t msb = 63 - static_cast<size_t>(__builtin_clzll(value));
+    size_t shift = msb - HISTOGRAM_SUBBUCKET_BITS;
+    return static_cast<size_t>( subBuckets + shift*subBuckets + ((value >> shift) & (subBuckets-1)) );
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(const size_t &bucket)
+{
+    const uint64_t subBuckets = 1<<HISTOGRAM_SUBBUCKET_BITS;
+
+    if (bucket < subBuckets)
+        return bucket;
+    if (bucket >= HISTOGRAM_BUCKETS-1)
+        return UINT64_MAX;
+
+    uint64_t shift = (bucket - subBuckets) / subBuckets;
+    uint64_t sub = (bucket - subBuckets) % subBuckets;
+    return ((subBuckets + sub + 1) << shift) - 1;
+}
+
+MetricsRegistry::MetricsRegistry()
+{
+}
+
+MetricsRegistry::~MetricsRegistry()
+{
+    for (auto & i : counters)
+        delete i.second;
+    for (auto & i : histograms)
+        delete i.second;
+}
+
+Counter *MetricsRegistry::getCounter(const std::string &name, const std::string &labels)
+{
+    std::unique_lock<std::mutex> lock(mutexMetrics);
+    Counter *& r = counters[std::make_pair(name,labels)];
+    if (!r)
+        r = new Counter;
+    return r;
+}
+
+LatencyHistogram *MetricsRegistry::getHistogram(const std::string &name, const std::string &labels)
+{
+    std::unique_lock<std::mutex> lock(mutexMetrics);
+    LatencyHistogram *& r = histograms[std::make_pair(name,labels)];
+    if (!r)
+        r = new LatencyHistogram;
+    return r;
+}
+
+std::list<sCounterSnapshot> MetricsRegistry::getCounters()
+{
+    std::list<sCounterSnapshot> r;
+    std::unique_lock<std::mutex> lock(mutexMetrics);
+    for (const auto & i : counters)
+        r.push_back({i.first.first,i.first.second,i.second->get()});
+    return r;
+}
+
+std::list<sNamedHistogramSnapshot> MetricsRegistry::getHistograms()
+{
+    std::list<sNamedHistogramSnapshot> r;
+    std::unique_lock<std::mutex> lock(mutexMetrics);
+    for (const auto & i : histograms)
+        r.push_back({i.first.first,i.first.second,i.second->snapshot()});
+    return r;
+}
+
+std::string MetricsRegistry::toPrometheus()
+{
+    char value[64];
+    std::string r, lastName;
+
+    for (const sCounterSnapshot & counter : getCounters())
+    {
+        if (counter.name != lastName)
+            r += "# TYPE " + counter.name + " counter\n";
+        lastName = counter.name;
+
+        snprintf(value,sizeof(value)," %" PRIu64 "\n", counter.value);
+        r += counter.name + (counter.labels.empty()?"":"{" + counter.labels + "}") + value;
+    }
+
+    std::list<sNamedHistogramSnapshot> snapshots = getHistograms();
+    for (const sNamedHistogramSnapshot & histogram : snapshots)
+    {
+        if (histogram.name != lastName)
+            r += "# TYPE " + histogram.name + " summary\n";
+        lastName = histogram.name;
+
+        std::string labelsPrefix = histogram.labels.empty()? "" : histogram.labels + ",";
+        for (const char * quantile : { "0.5", "0.9", "0.99", "0.999" })
+        {
+            snprintf(value,sizeof(value)," %" PRIu64 "\n", histogram.histogram.percentile(atof(quantile)*100.0));
+            r += histogram.name + "{" + labelsPrefix + "quantile=\"" + quantile + "\"}" + value;
+        }
+
+        std::string labels = histogram.labels.empty()?"":"{" + histogram.labels + "}";
+        snprintf(value,sizeof(value)," %" PRIu64 "\n", histogram.histogram.sum);
+        r += histogram.name + "_sum" + labels + value;
+        snprintf(value,sizeof(value)," %" PRIu64 "\n", histogram.histogram.count);
+        r += histogram.name + "_count" + labels + value;
+    }
+
+    // The max values goes in their own family:
+    lastName.clear();
+    for (const sNamedHistogramSnapshot & histogram : snapshots)
+    {
+        if (histogram.name != lastName)
+            r += "# TYPE " + histogram.name + "_max gauge\n";
+        lastName = histogram.name;
+
+        snprintf(value,sizeof(value)," %" PRIu64 "\n", histogram.histogram.max);
+        r += histogram.name + "_max" + (histogram.labels.empty()?"":"{" + histogram.labels + "}") + value;
+    }
+
+    return r;
+}
+
+std::string MetricsRegistry::label(const std::string &key, const std::string &value)
+{
+    std::string r = key + "=\"";
+    for (const char & c : value)
+    {
+        switch (c)
+        {
+        case '\\': r += "\\\\"; break;
+        case '"': r += "\\\""; break;
+        case '\n': r += "\\n"; break;
+        default: r += c;
+        }
+    }
+    return r + "\"";
+}
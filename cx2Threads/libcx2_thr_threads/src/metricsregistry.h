@@ -0,0 +1,150 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <mutex>
+
+// Shards per counter/histogram (threads are distributed between them to avoid contention)
+#define METRICS_SHARDS 8
+// Histogram: 3 significant bits (12.5% max error), exact values below 8us, up to 2^32us, then overflow.
+#define HISTOGRAM_SUBBUCKET_BITS 3
+#define HISTOGRAM_MAX_BITS 32
+#define HISTOGRAM_BUCKETS ( (1<<HISTOGRAM_SUBBUCKET_BITS) + (HISTOGRAM_MAX_BITS-HISTOGRAM_SUBBUCKET_BITS)*(1<<HISTOGRAM_SUBBUCKET_BITS) + 1 )
+
+namespace CX2 { namespace Threads { namespace Metrics {
+
+/**
+ * @brief Counter Per-thread sharded counter (lock-free increments, the readers sum the shards)
+ */
+class Counter
+{
+public:
+    Counter();
+    /**
+     * @brief add Add value to the counter
+     */
+    void add(const uint64_t & value = 1);
+    /**
+     * @brief get Get the counter value (sum of all the shards)
+     */
+    uint64_t get() const;
+
+private:
+    struct sShard
+    {
+        std::atomic<uint64_t> value;
+        char padding[64-sizeof(std::atomic<uint64_t>)];
+    };
+    sShard shards[METRICS_SHARDS];
+};
+
+struct sHistogramSnapshot
+{
+    sHistogramSnapshot()
+    {
+        count = 0;
+        sum = 0;
+        max = 0;
+    }
+    /**
+     * @brief percentile Get the value (bucket upper bound) for the percentile
+     * @param p percentile between 0 and 100 (eg. 99.9)
+     */
+    uint64_t percentile(const double & p) const;
+
+    uint64_t count, sum, max;
+    std::vector<uint64_t> buckets;
+};
+
+/**
+ * @brief LatencyHistogram Per-thread sharded log-linear (HDR-style) histogram for latencies in microseconds
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    /**
+     * @brief record Record a value (lock-free)
+     * @param value value in microseconds
+     */
+    void record(const uint64_t & value);
+    /**
+     * @brief snapshot Get the merged shards
+     */
+    sHistogramSnapshot snapshot() const;
+
+    static size_t bucketIndex(const uint64_t & value);
+    static uint64_t bucketUpperBound(const size_t & bucket);
+
+private:
+    struct sShard
+    {
+        std::atomic<uint64_t> count, sum, max;
+        std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS];
+        char padding[64];
+    };
+    sShard shards[METRICS_SHARDS];
+};
+
+struct sCounterSnapshot
+{
+    std::string name, labels;
+    uint64_t value;
+};
+
+struct sNamedHistogramSnapshot
+{
+    std::string name, labels;
+    sHistogramSnapshot histogram;
+};
+
+/**
+ * @brief MetricsRegistry Named counters and latency histograms.
+ *        The metrics are created on the first use and live until the registry is destroyed, so the callers can keep
+ *        the pointers and record without any lookup.
+ */
+class MetricsRegistry
+{
+public:
+    MetricsRegistry();
+    ~MetricsRegistry();
+
+    /**
+     * @brief getCounter Get (or create) the counter
+     * @param name metric name (eg. fastrpc_method_calls_total)
+     * @param labels prometheus formatted labels (use label() for building them)
+     */
+    Counter * getCounter(const std::string & name, const std::string & labels = "");
+    /**
+     * @brief getHistogram Get (or create) the latency histogram
+     * @param name metric name (eg. fastrpc_method_execution_microseconds)
+     * @param labels prometheus formatted labels (use label() for building them)
+     */
+    LatencyHistogram * getHistogram(const std::string & name, const std::string & labels = "");
+
+    std::list<sCounterSnapshot> getCounters();
+    std::list<sNamedHistogramSnapshot> getHistograms();
+
+    /**
+     * @brief toPrometheus Export the metrics in the prometheus text format (histograms are exported as summaries)
+     */
+    std::string toPrometheus();
+
+    /**
+     * @brief label Build an escaped prometheus label (key="value")
+     */
+    static std::string label(const std::string & key, const std::string & value);
+
+private:
+    std::map<std::pair<std::string,std::string>,Counter *> counters;
+    std::map<std::pair<std::string,std::string>,LatencyHistogram *> histograms;
+    std::mutex mutexMetrics;
+};
+
+}}}
+
+#endif // METRICSREGISTRY_H
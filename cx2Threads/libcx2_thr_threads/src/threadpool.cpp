@@ -15,6 +15,9 @@ ThreadPool::ThreadPool(uint32_t threadsCount, uint32_t taskQueues)
 
     terminate = false;
     queuedElements = 0;
+    metricQueueWait = nullptr;
+    metricPushed = nullptr;
+    metricRejected = nullptr;
     this->threadsCount = threadsCount;
     for (size_t i =0; i<taskQueues;i++)
     {
@@ -51,9 +54,14 @@ bool ThreadPool::pushTask(void (*task)(void *), void *data, uint32_t timeoutMS,
     // TODO: put to best place first
     std::unique_lock<std::mutex> lk(mutexQueues);
 
+    Metrics::Counter * rejected = metricRejected;
+
     // Don't insert on termination...
     if (terminate)
+    {
+        if (rejected) rejected->add();
         return false;
+    }
 
     // Check if the queue is up the limit
     while ( queues[currentQueue].tasks.size() > tasksByQueueLimit  )
@@ -66,6 +74,7 @@ bool ThreadPool::pushTask(void (*task)(void *), void *data, uint32_t timeoutMS,
         {
             if (queues[currentQueue].cond_removedElement.wait_for(lk, std::chrono::milliseconds(timeoutMS)) == std::cv_status::timeout)
             {
+                if (rejected) rejected->add();
                 return false;
             }
         }
@@ -75,8 +84,13 @@ bool ThreadPool::pushTask(void (*task)(void *), void *data, uint32_t timeoutMS,
     Task toInsert;
     toInsert.data = data;
     toInsert.task = task;
+    if (metricQueueWait)
+        toInsert.queuedTime = std::chrono::steady_clock::now();
     queues[currentQueue].tasks.push( toInsert );
 
+    Metrics::Counter * pushed = metricPushed;
+    if (pushed) pushed->add();
+
     // Notify that there is one element in one of the lists...
     lk.unlock();
     cond_insertedElement.notify_one();
@@ -110,6 +124,10 @@ Task ThreadPool::popTask()
     // Notify!
     lk.unlock();
     tq->cond_removedElement.notify_one();
+
+    Metrics::LatencyHistogram * queueWait = metricQueueWait;
+    if (queueWait && r.queuedTime.time_since_epoch().count())
+        queueWait->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-r.queuedTime).count()));
     return r;
 }
 
@@ -172,6 +190,22 @@ void ThreadPool::setTasksByQueueLimit(const uint32_t &value)
     for (auto & i : queues) i.second.cond_removedElement.notify_all();
 }
 
+void ThreadPool::setMetrics(Metrics::MetricsRegistry *registry, const std::string &poolName)
+{
+    if (!registry)
+    {
+        metricQueueWait = nullptr;
+        metricPushed = nullptr;
+        metricRejected = nullptr;
+        return;
+    }
+
+    std::string labels = Metrics::MetricsRegistry::label("pool",poolName);
+    metricPushed = registry->getCounter("threadpool_tasks_total",labels);
+    metricRejected = registry->getCounter("threadpool_rejected_tasks_total",labels);
+    metricQueueWait = registry->getHistogram("threadpool_queue_wait_microseconds",labels);
+}
+
 void ThreadPool::taskProcessor(ThreadPool *tp)
 {
     for (Task task = tp->popTask();
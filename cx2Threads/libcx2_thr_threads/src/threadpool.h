@@ -8,6 +8,9 @@
 #include <queue>
 #include <map>
 #include <condition_variable>
+#include <chrono>
+
+#include "metricsregistry.h"
 
 namespace CX2 { namespace Threads {
 
@@ -28,6 +31,8 @@ struct Task
 
     void (*task) (void *);
     void * data;
+    // Insertion time (for the queue wait time metrics)
+    std::chrono::steady_clock::time_point queuedTime;
 };
 
 struct TasksQueue
@@ -41,7 +46,6 @@ struct TasksQueue
     bool init;
 };
 
-// TODO: statistics
 /**
  * @brief Advanced Thread Pool.
  */
@@ -87,6 +91,12 @@ public:
      * @brief getTasksByQueueLimit Set max tasks will receive a queue
      */
     void setTasksByQueueLimit(const uint32_t &value);
+    /**
+     * @brief setMetrics Record the queue wait time and the pushed/rejected tasks in the metrics registry
+     * @param registry metrics registry (nullptr to disable)
+     * @param poolName pool name used as the metrics label
+     */
+    void setMetrics(Metrics::MetricsRegistry * registry, const std::string & poolName);
 
 private:
 
@@ -112,6 +122,10 @@ private:
     std::condition_variable empty;
     uint32_t queuedElements;
 
+    // METRICS:
+    std::atomic<Metrics::LatencyHistogram *> metricQueueWait;
+    std::atomic<Metrics::Counter *> metricPushed, metricRejected;
+
     // RANDOM:
     std::hash<std::string> hash_fn;
     std::mutex mutexRandom;
@@ -19,3 +19,6 @@ SUBDIRS += extras
 
 # Not ready yet:
 #SUBDIRS += programs
+
+# Benchmarks and model checks (against the installed libraries):
+#SUBDIRS += tests
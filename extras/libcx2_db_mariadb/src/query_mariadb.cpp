@@ -17,7 +17,7 @@ Query_MariaDB::Query_MariaDB()
 Query_MariaDB::~Query_MariaDB()
 {
     // Destroy binded values.
-    for (size_t pos=0;pos<keysByPos.size();pos++)
+    for (size_t pos=0;bindedInputParams && pos<keysByPos.size();pos++)
     {
         if (bindedInputParams[pos].buffer)
         {
@@ -154,6 +154,138 @@ bool Query_MariaDB::exec(const ExecType &execType)
     return true;
 }
 
+bool Query_MariaDB::execBatch(const std::list<std::map<std::string, CX2::Memory::Abstract::Var *> > &inputRows)
+{
+    if (stmt)
+    {
+        throw std::runtime_error("Re-using queries is not supported.");
+        return false;
+    }
+
+    ((SQLConnector_MariaDB*)sqlConnector)->getDatabaseConnector(this);
+
+    if (!dbCnt)
+        return false;
+
+    if (inputRows.empty())
+        return true;
+
+    // Replace the keys (taken from the first row) for ?:
+    std::list<std::string> keysIn;
+    for (auto & i : inputRows.front()) keysIn.push_back(i.first);
+    while (replaceFirstKey(query,keysIn,keysByPos, "?"))
+    {}
+
+    // Create the columns arrays:
+    std::vector<sBatchColumn> columns(keysByPos.size());
+    for (size_t pos=0; pos<keysByPos.size(); pos++)
+    {
+        if (!mariaDBFillBatchColumn(columns[pos],keysByPos[pos],inputRows))
+            return false;
+    }
+
+    std::unique_lock<std::mutex> lock(*mtDatabaseLock);
+
+    stmt = mysql_stmt_init(dbCnt);
+    if (stmt==nullptr)
+    {
+        return false;
+    }
+
+    if ((lastSQLReturnValue = mysql_stmt_prepare(stmt, query.c_str(), query.size())) != 0)
+    {
+        lastSQLError = mysql_stmt_error(stmt);
+        return false;
+    }
+
+    if (mysql_query(dbCnt, "START TRANSACTION;"))
+    {
+        lastSQLError = mysql_error(dbCnt);
+        return false;
+    }
+
+    bool ok = true;
+    std::vector<MYSQL_BIND> binds(columns.size());
+
+#if defined(MARIADB_PACKAGE_VERSION_ID) && MARIADB_PACKAGE_VERSION_ID >= 30000
+    // MariaDB Connector/C: column-wise array binding, all the rows are sent in one execution.
+    unsigned int arraySize = inputRows.size();
+    for (size_t pos=0; pos<columns.size(); pos++)
+    {
+        for (auto & null : columns[pos].nulls)
+            null = null?STMT_INDICATOR_NULL:STMT_INDICATOR_NONE;
+
+        memset(&(binds[pos]),0,sizeof(MYSQL_BIND));
+        binds[pos].buffer_type = columns[pos].bufferType;
+        binds[pos].is_unsigned = columns[pos].isUnsigned;
+        binds[pos].u.indicator = columns[pos].nulls.data();
+
+        switch (columns[pos].bufferType)
+        {
+        case MYSQL_TYPE_LONGLONG:
+            binds[pos].buffer = columns[pos].iValues.data();
+            break;
+        case MYSQL_TYPE_DOUBLE:
+            binds[pos].buffer = columns[pos].dValues.data();
+            break;
+        default:
+            binds[pos].buffer = columns[pos].sValues.data();
+            binds[pos].length = columns[pos].lengths.data();
+            break;
+        }
+    }
+
+    ok =    mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, &arraySize) == 0
+         && mysql_stmt_bind_param(stmt, binds.data()) == 0
+         && (lastSQLReturnValue = mysql_stmt_execute(stmt)) == 0;
+#else
+    // Other clients: re-use the prepared statement for each row.
+    for (size_t row=0; ok && row<inputRows.size(); row++)
+    {
+        for (size_t pos=0; pos<columns.size(); pos++)
+        {
+            memset(&(binds[pos]),0,sizeof(MYSQL_BIND));
+            binds[pos].buffer_type = columns[pos].bufferType;
+            binds[pos].is_unsigned = columns[pos].isUnsigned;
+            binds[pos].is_null_value = columns[pos].nulls[row];
+
+            switch (columns[pos].bufferType)
+            {
+            case MYSQL_TYPE_LONGLONG:
+                binds[pos].buffer = &(columns[pos].iValues[row]);
+                break;
+            case MYSQL_TYPE_DOUBLE:
+                binds[pos].buffer = &(columns[pos].dValues[row]);
+                break;
+            default:
+                binds[pos].buffer = columns[pos].sValues[row];
+                binds[pos].buffer_length = columns[pos].lengths[row];
+                break;
+            }
+        }
+
+        ok =    mysql_stmt_bind_param(stmt, binds.data()) == 0
+             && (lastSQLReturnValue = mysql_stmt_execute(stmt)) == 0;
+    }
+#endif
+
+    if (!ok)
+    {
+        lastSQLError = mysql_stmt_error(stmt);
+        mysql_rollback(dbCnt);
+        return false;
+    }
+
+    if (mysql_commit(dbCnt))
+    {
+        lastSQLError = mysql_error(dbCnt);
+        mysql_rollback(dbCnt);
+        return false;
+    }
+
+    return true;
+}
+
 bool Query_MariaDB::step0()
 {
     bool r = mysql_stmt_fetch (stmt) == 0;
@@ -507,6 +639,135 @@ bool Query_MariaDB::postBindInputVars()
 }
 
 
+bool Query_MariaDB::mariaDBFillBatchColumn(sBatchColumn &column, const std::string &key, const std::list<std::map<std::string, CX2::Memory::Abstract::Var *> > &inputRows)
+{
+    // The column type is given by the first non-null value:
+    for (const auto & row : inputRows)
+    {
+        auto it = row.find(key);
+        if (it == row.end())
+        {
+            lastSQLError = "Input variable " + key + " not found";
+            return false;
+        }
+
+        switch (it->second->getVarType())
+        {
+        case Memory::Abstract::TYPE_BOOL:
+        case Memory::Abstract::TYPE_INT8:
+        case Memory::Abstract::TYPE_INT16:
+        case Memory::Abstract::TYPE_INT32:
+        case Memory::Abstract::TYPE_INT64:
+        case Memory::Abstract::TYPE_UINT8:
+        case Memory::Abstract::TYPE_UINT16:
+        case Memory::Abstract::TYPE_UINT32:
+            column.bufferType = MYSQL_TYPE_LONGLONG;
+            break;
+        case Memory::Abstract::TYPE_UINT64:
+            column.bufferType = MYSQL_TYPE_LONGLONG;
+            column.isUnsigned = true;
+            break;
+        case Memory::Abstract::TYPE_DOUBLE:
+            column.bufferType = MYSQL_TYPE_DOUBLE;
+            break;
+        case Memory::Abstract::TYPE_BIN:
+            column.bufferType = MYSQL_TYPE_BLOB;
+            break;
+        case Memory::Abstract::TYPE_NULL:
+            break;
+        default:
+            column.bufferType = MYSQL_TYPE_STRING;
+            break;
+        }
+
+        if (column.bufferType != MYSQL_TYPE_NULL)
+            break;
+    }
+
+    for (const auto & row : inputRows)
+    {
+        auto it = row.find(key);
+        if (it == row.end())
+        {
+            lastSQLError = "Input variable " + key + " not found";
+            return false;
+        }
+        Memory::Abstract::Var * var = it->second;
+
+        long long iValue = 0;
+        double dValue = 0;
+        char * sValue = nullptr;
+        unsigned long length = 0;
+        bool null = false;
+
+        switch (var->getVarType())
+        {
+        case Memory::Abstract::TYPE_BOOL:
+            iValue = ABSTRACT_PTR_AS(BOOL,var)->getValue()?1:0;
+            break;
+        case Memory::Abstract::TYPE_INT8:
+            iValue = ABSTRACT_PTR_AS(INT8,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_INT16:
+            iValue = ABSTRACT_PTR_AS(INT16,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_INT32:
+            iValue = ABSTRACT_PTR_AS(INT32,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_INT64:
+            iValue = ABSTRACT_PTR_AS(INT64,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_UINT8:
+            iValue = ABSTRACT_PTR_AS(UINT8,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_UINT16:
+            iValue = ABSTRACT_PTR_AS(UINT16,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_UINT32:
+            iValue = ABSTRACT_PTR_AS(UINT32,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_UINT64:
+            iValue = (long long)ABSTRACT_PTR_AS(UINT64,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_DOUBLE:
+            dValue = ABSTRACT_PTR_AS(DOUBLE,var)->getValue();
+            break;
+        case Memory::Abstract::TYPE_BIN:
+        {
+            Memory::Abstract::sBinContainer * i = ABSTRACT_PTR_AS(BINARY,var)->getValue();
+            sValue = i->ptr;
+            length = i->dataSize;
+        } break;
+        case Memory::Abstract::TYPE_NULL:
+            null = true;
+            break;
+        default:
+        {
+            std::string * str = createDestroyableStringForInput(var->toString());
+            sValue = (char *) str->c_str();
+            length = str->size();
+        } break;
+        }
+
+        // Every non-null value in the column should be of the same kind:
+        bool isNumeric = var->getVarType() <= Memory::Abstract::TYPE_UINT64;
+        if (!null && (   (column.bufferType == MYSQL_TYPE_LONGLONG) != isNumeric
+                      || (column.bufferType == MYSQL_TYPE_DOUBLE) != (var->getVarType() == Memory::Abstract::TYPE_DOUBLE)))
+        {
+            lastSQLError = "Input variable " + key + " have different types between rows";
+            return false;
+        }
+
+        column.iValues.push_back(iValue);
+        column.dValues.push_back(dValue);
+        column.sValues.push_back(sValue);
+        column.lengths.push_back(length);
+        column.nulls.push_back(null?1:0);
+    }
+
+    return true;
+}
+
 unsigned long Query_MariaDB::mariaDBfetchVarSize(const size_t &col, const enum_field_types & fieldType)
 {
     unsigned long r;
@@ -15,6 +15,7 @@ public:
 
     // Direct Query:
     bool exec(const ExecType & execType);
+    bool execBatch(const std::list<std::map<std::string,Memory::Abstract::Var *>> & inputRows);
 
     // MariaDB specific functions:
     void mariaDBSetDatabaseConnector( MYSQL *dbCnt );
@@ -26,6 +27,23 @@ protected:
     bool postBindInputVars();
 
 private:
+    struct sBatchColumn
+    {
+        sBatchColumn()
+        {
+            bufferType = MYSQL_TYPE_NULL;
+            isUnsigned = false;
+        }
+        enum_field_types bufferType;
+        bool isUnsigned;
+        std::vector<long long> iValues;
+        std::vector<double> dValues;
+        std::vector<char *> sValues;
+        std::vector<unsigned long> lengths;
+        std::vector<char> nulls;
+    };
+    bool mariaDBFillBatchColumn(sBatchColumn & column, const std::string & key, const std::list<std::map<std::string,Memory::Abstract::Var *>> & inputRows);
+
     unsigned long mariaDBfetchVarSize(const size_t & col , const enum_field_types &fieldType = MYSQL_TYPE_STRING);
 
     MYSQL * dbCnt;
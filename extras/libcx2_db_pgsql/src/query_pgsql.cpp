@@ -6,6 +6,84 @@
 
 using namespace CX2::Database;
 
+// Built-in type OIDs (catalog/pg_type_d.h is not part of the client headers):
+#define PSQL_BOOLOID 16
+#define PSQL_INT8OID 20
+#define PSQL_INT2OID 21
+#define PSQL_INT4OID 23
+#define PSQL_OIDOID 26
+#define PSQL_FLOAT4OID 700
+#define PSQL_FLOAT8OID 701
+#define PSQL_INETOID 869
+#define PSQL_CIDROID 650
+#define PSQL_DATEOID 1082
+#define PSQL_TIMESTAMPOID 1114
+#define PSQL_TIMESTAMPTZOID 1184
+
+// Rows sent before collecting the results in pipeline mode
+#define PSQL_PIPELINE_SYNC_ROWS 1024
+
+// 2000-01-01 00:00:00 UTC (PostgreSQL epoch) in unix time
+#define PSQL_EPOCH_2000 946684800LL
+
+static uint64_t binaryToUInt(const char * value, const int & length)
+{
+    // Network byte order:
+    uint64_t r = 0;
+    for (int i=0; i<length; i++)
+        r = (r<<8) | (unsigned char)value[i];
+    return r;
+}
+
+static bool binaryToNumber(const Oid & type, const char * value, const int & length, int64_t & iValue, double & dValue)
+{
+    switch (type)
+    {
+    case PSQL_BOOLOID:
+        if (length!=1) return false;
+        iValue = value[0]!=0;
+        break;
+    case PSQL_INT2OID:
+        if (length!=2) return false;
+        iValue = (int16_t)binaryToUInt(value,2);
+        break;
+    case PSQL_INT4OID:
+        if (length!=4) return false;
+        iValue = (int32_t)binaryToUInt(value,4);
+        break;
+    case PSQL_OIDOID:
+        if (length!=4) return false;
+        iValue = (uint32_t)binaryToUInt(value,4);
+        break;
+    case PSQL_INT8OID:
+        if (length!=8) return false;
+        iValue = (int64_t)binaryToUInt(value,8);
+        break;
+    case PSQL_FLOAT4OID:
+    {
+        if (length!=4) return false;
+        uint32_t bits = (uint32_t)binaryToUInt(value,4);
+        float f;
+        memcpy(&f,&bits,4);
+        dValue = f;
+        iValue = (int64_t)dValue;
+        return true;
+    }
+    case PSQL_FLOAT8OID:
+    {
+        if (length!=8) return false;
+        uint64_t bits = binaryToUInt(value,8);
+        memcpy(&dValue,&bits,8);
+        iValue = (int64_t)dValue;
+        return true;
+    }
+    default:
+        return false;
+    }
+    dValue = (double)iValue;
+    return true;
+}
+
 Query_PostgreSQL::Query_PostgreSQL()
 {
     result = nullptr;
@@ -20,10 +98,27 @@ Query_PostgreSQL::Query_PostgreSQL()
 
     dbCnt = nullptr;
     result = nullptr;
+
+    bBinaryResults = false;
+    bSingleRowMode = false;
+    bStreaming = false;
 }
 
 Query_PostgreSQL::~Query_PostgreSQL()
 {
+    if (bStreaming)
+    {
+        // Rows left: cancel the query before consuming the remaining results.
+        PGcancel * cancel = PQgetCancel(dbCnt);
+        if (cancel)
+        {
+            char errbuf[256];
+            PQcancel(cancel,errbuf,sizeof(errbuf));
+            PQfreeCancel(cancel);
+        }
+        psqlFinishStreaming();
+    }
+
     if (result) PQclear(result);
     result = nullptr;
 
@@ -49,14 +144,79 @@ bool Query_PostgreSQL::exec(const ExecType &execType)
 
     std::unique_lock<std::mutex> lock(*mtDatabaseLock);
 
-    // Prepare the query:
-    result = PQexecPrepared(dbCnt,
-                            query.c_str(),
-                            paramCount,
-                            paramValues,
-                            paramLengths,
-                            paramFormats,
-                            0);
+    int resultFormat = bBinaryResults?1:0;
+
+    if (execType==EXEC_TYPE_SELECT && bSingleRowMode)
+    {
+        // Send the query and retrieve the rows one by one (the connection remains locked until the last row is read):
+        if (!PQsendQueryParams(dbCnt,
+                               query.c_str(),
+                               paramCount,
+                               nullptr,
+                               paramValues,
+                               paramLengths,
+                               paramFormats,
+                               resultFormat))
+        {
+            lastSQLError = PQerrorMessage(dbCnt);
+            return false;
+        }
+        if (!PQsetSingleRowMode(dbCnt))
+        {
+            // Single row mode not available: retrieve the whole (buffered) result instead.
+            result = PQgetResult(dbCnt);
+            PGresult * pending;
+            while ((pending = PQgetResult(dbCnt)) != nullptr)
+                PQclear(pending);
+
+            execStatus = PQresultStatus(result);
+            if (execStatus == PGRES_TUPLES_OK)
+                return true;
+
+            if (result)
+            {
+                lastSQLError = PQresultErrorMessage(result);
+                PQclear(result);
+                result = nullptr;
+            }
+            return false;
+        }
+
+        streamLock = std::move(lock);
+        bStreaming = true;
+
+        result = PQgetResult(dbCnt);
+        execStatus = PQresultStatus(result);
+
+        if (execStatus == PGRES_SINGLE_TUPLE)
+            return true;
+
+        if (execStatus == PGRES_TUPLES_OK)
+        {
+            // Empty result set.
+            psqlFinishStreaming();
+            return true;
+        }
+
+        if (result)
+        {
+            lastSQLError = PQresultErrorMessage(result);
+            PQclear(result);
+            result = nullptr;
+        }
+        psqlFinishStreaming();
+        return false;
+    }
+
+    // Execute the query:
+    result = PQexecParams(dbCnt,
+                          query.c_str(),
+                          paramCount,
+                          nullptr,
+                          paramValues,
+                          paramLengths,
+                          paramFormats,
+                          resultFormat);
 
     execStatus = PQresultStatus(result);
 
@@ -65,7 +225,11 @@ bool Query_PostgreSQL::exec(const ExecType &execType)
             execStatus==PGRES_FATAL_ERROR
             )
     {
-        PQclear(result);
+        if (result)
+        {
+            lastSQLError = PQresultErrorMessage(result);
+            PQclear(result);
+        }
         result = nullptr;
         return false;
     }
@@ -85,87 +249,179 @@ bool Query_PostgreSQL::step0()
 {
     //  :)
     if (!result) return false;
-    if (execStatus != PGRES_TUPLES_OK) return false;
 
-    int i = currentRow;
+    while (currentRow >= PQntuples(result))
+    {
+        // In single row mode, each row comes in a separated result:
+        if (!bStreaming || !psqlFetchNextResult())
+            return false;
+    }
+
+    if (execStatus != PGRES_TUPLES_OK && execStatus != PGRES_SINGLE_TUPLE) return false;
+
+    if (bBinaryResults)
+        fillRowFromBinary(currentRow);
+    else
+        fillRowFromText(currentRow);
+
+    currentRow++;
+
+    return true;
+}
+
+bool Query_PostgreSQL::psqlFetchNextResult()
+{
+    PQclear(result);
+    result = PQgetResult(dbCnt);
+    currentRow = 0;
+
+    execStatus = PQresultStatus(result);
+
+    if (execStatus == PGRES_SINGLE_TUPLE)
+        return true;
 
-    if (currentRow >= PQntuples(result)) return false;
+    // PGRES_TUPLES_OK: no more rows, otherwise: error.
+    if (result && execStatus != PGRES_TUPLES_OK)
+        lastSQLError = PQresultErrorMessage(result);
 
+    psqlFinishStreaming();
+    return false;
+}
+
+bool Query_PostgreSQL::psqlExecCommand(PGresult *r)
+{
+    ExecStatusType status = PQresultStatus(r);
+    bool ok = status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK;
+    if (!ok && r && lastSQLError.empty())
+        lastSQLError = PQresultErrorMessage(r);
+    PQclear(r);
+    return ok;
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+bool Query_PostgreSQL::psqlPipelineSync()
+{
+    if (!PQpipelineSync(dbCnt))
+    {
+        lastSQLError = PQerrorMessage(dbCnt);
+        return false;
+    }
+
+    bool ok = true;
+    for (;;)
+    {
+        PGresult * r = PQgetResult(dbCnt);
+        if (!r)
+        {
+            // End of one statement results.
+            if (PQstatus(dbCnt) != CONNECTION_OK)
+                return false;
+            continue;
+        }
+
+        if (PQresultStatus(r) == PGRES_PIPELINE_SYNC)
+        {
+            PQclear(r);
+            return ok;
+        }
+
+        if (!psqlExecCommand(r))
+            ok = false;
+    }
+}
+#endif
+
+void Query_PostgreSQL::psqlFinishStreaming()
+{
+    if (!bStreaming)
+        return;
+
+    // Consume the remaining results to leave the connection ready for the next query.
+    PGresult * pending;
+    while ((pending = PQgetResult(dbCnt)) != nullptr)
+        PQclear(pending);
+
+    bStreaming = false;
+    streamLock.unlock();
+}
+
+void Query_PostgreSQL::fillRowFromText(const int &row)
+{
     int columnpos = 0;
     for ( const auto &outputVar : resultVars)
     {
-        isNull.push_back(PQgetisnull(result,i,columnpos));
+        isNull.push_back(PQgetisnull(result,row,columnpos));
 
         switch (outputVar->getVarType())
         {
         case Memory::Abstract::TYPE_BOOL:
-            ABSTRACT_PTR_AS(BOOL,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(BOOL,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_INT8:
-            ABSTRACT_PTR_AS(INT8,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(INT8,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_INT16:
-            ABSTRACT_PTR_AS(INT16,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(INT16,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_INT32:
-            ABSTRACT_PTR_AS(INT32,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(INT32,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_INT64:
-            ABSTRACT_PTR_AS(INT64,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(INT64,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_UINT8:
-            ABSTRACT_PTR_AS(UINT8,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(UINT8,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_UINT16:
-            ABSTRACT_PTR_AS(UINT16,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(UINT16,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_UINT32:
-            ABSTRACT_PTR_AS(UINT32,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(UINT32,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_UINT64:
-            ABSTRACT_PTR_AS(UINT64,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(UINT64,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_DOUBLE:
-            ABSTRACT_PTR_AS(DOUBLE,outputVar)->fromString(PQgetvalue(result,i,columnpos));
+            ABSTRACT_PTR_AS(DOUBLE,outputVar)->fromString(PQgetvalue(result,row,columnpos));
             break;
         case Memory::Abstract::TYPE_BIN:
         {
             Memory::Abstract::sBinContainer binContainer;
-            binContainer.ptr = (char *)PQgetvalue(result,i,columnpos);
+            binContainer.ptr = (char *)PQgetvalue(result,row,columnpos);
             // TODO: should bytes need to be 64-bit for blob64?
-            binContainer.dataSize = PQgetlength(result,i,columnpos);
+            binContainer.dataSize = PQgetlength(result,row,columnpos);
             ABSTRACT_PTR_AS(BINARY,outputVar)->setValue( &binContainer );
             binContainer.ptr = nullptr; // don't destroy the data.
         } break;
         case Memory::Abstract::TYPE_VARCHAR:
         {
             // This will copy the memory.
-            ABSTRACT_PTR_AS(VARCHAR,outputVar)->setValue( PQgetvalue(result,i,columnpos) );
+            ABSTRACT_PTR_AS(VARCHAR,outputVar)->setValue( PQgetvalue(result,row,columnpos) );
         } break;
         case Memory::Abstract::TYPE_STRING:
         {
-            ABSTRACT_PTR_AS(STRING,outputVar)->setValue( PQgetvalue(result,i,columnpos) );
+            ABSTRACT_PTR_AS(STRING,outputVar)->setValue( PQgetvalue(result,row,columnpos) );
         }break;
         case Memory::Abstract::TYPE_STRINGLIST:
         {
-            ABSTRACT_PTR_AS(STRINGLIST,outputVar)->fromString( PQgetvalue(result,i,columnpos) );
+            ABSTRACT_PTR_AS(STRINGLIST,outputVar)->fromString( PQgetvalue(result,row,columnpos) );
         }break;
         case Memory::Abstract::TYPE_DATETIME:
         {
-            ABSTRACT_PTR_AS(DATETIME,outputVar)->fromString( PQgetvalue(result,i,columnpos) );
+            ABSTRACT_PTR_AS(DATETIME,outputVar)->fromString( PQgetvalue(result,row,columnpos) );
         }break;
         case Memory::Abstract::TYPE_IPV4:
         {
-            ABSTRACT_PTR_AS(IPV4,outputVar)->fromString( PQgetvalue(result,i,columnpos) );
+            ABSTRACT_PTR_AS(IPV4,outputVar)->fromString( PQgetvalue(result,row,columnpos) );
         }break;
         case Memory::Abstract::TYPE_IPV6:
         {
-            ABSTRACT_PTR_AS(IPV6,outputVar)->fromString( PQgetvalue(result,i,columnpos) );
+            ABSTRACT_PTR_AS(IPV6,outputVar)->fromString( PQgetvalue(result,row,columnpos) );
         }break;
         case Memory::Abstract::TYPE_PTR:
         {
             // This will reference the memory, but will disappear on the next step
-            ABSTRACT_PTR_AS(PTR,outputVar)->setValue( PQgetvalue(result,i,columnpos) );
+            ABSTRACT_PTR_AS(PTR,outputVar)->setValue( PQgetvalue(result,row,columnpos) );
         } break;
         case Memory::Abstract::TYPE_NULL:
             // Don't copy the value (not needed).
@@ -175,9 +431,240 @@ bool Query_PostgreSQL::step0()
         columnpos++;
     }
 
-    currentRow++;
+}
 
-    return false;
+void Query_PostgreSQL::fillRowFromBinary(const int &row)
+{
+    int columnpos = 0;
+    for ( const auto &outputVar : resultVars)
+    {
+        bool null = PQgetisnull(result,row,columnpos);
+        isNull.push_back(null);
+
+        if (null || outputVar->getVarType() == Memory::Abstract::TYPE_NULL)
+        {
+            columnpos++;
+            continue;
+        }
+
+        Oid type = PQftype(result,columnpos);
+        const char * value = PQgetvalue(result,row,columnpos);
+        int length = PQgetlength(result,row,columnpos);
+
+        int64_t iValue = 0;
+        double dValue = 0;
+        bool isNumber = binaryToNumber(type,value,length,iValue,dValue);
+
+        switch (outputVar->getVarType())
+        {
+        case Memory::Abstract::TYPE_BOOL:
+            if (isNumber) ABSTRACT_PTR_AS(BOOL,outputVar)->setValue(iValue!=0);
+            else ABSTRACT_PTR_AS(BOOL,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_INT8:
+            if (isNumber) ABSTRACT_PTR_AS(INT8,outputVar)->setValue((int8_t)iValue);
+            else ABSTRACT_PTR_AS(INT8,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_INT16:
+            if (isNumber) ABSTRACT_PTR_AS(INT16,outputVar)->setValue((int16_t)iValue);
+            else ABSTRACT_PTR_AS(INT16,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_INT32:
+            if (isNumber) ABSTRACT_PTR_AS(INT32,outputVar)->setValue((int32_t)iValue);
+            else ABSTRACT_PTR_AS(INT32,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_INT64:
+            if (isNumber) ABSTRACT_PTR_AS(INT64,outputVar)->setValue(iValue);
+            else ABSTRACT_PTR_AS(INT64,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_UINT8:
+            if (isNumber) ABSTRACT_PTR_AS(UINT8,outputVar)->setValue((uint8_t)iValue);
+            else ABSTRACT_PTR_AS(UINT8,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_UINT16:
+            if (isNumber) ABSTRACT_PTR_AS(UINT16,outputVar)->setValue((uint16_t)iValue);
+            else ABSTRACT_PTR_AS(UINT16,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_UINT32:
+            if (isNumber) ABSTRACT_PTR_AS(UINT32,outputVar)->setValue((uint32_t)iValue);
+            else ABSTRACT_PTR_AS(UINT32,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_UINT64:
+            if (isNumber) ABSTRACT_PTR_AS(UINT64,outputVar)->setValue((uint64_t)iValue);
+            else ABSTRACT_PTR_AS(UINT64,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_DOUBLE:
+            if (isNumber) ABSTRACT_PTR_AS(DOUBLE,outputVar)->setValue(dValue);
+            else ABSTRACT_PTR_AS(DOUBLE,outputVar)->fromString(std::string(value,length));
+            break;
+        case Memory::Abstract::TYPE_BIN:
+        {
+            // bytea comes without any escaping in binary mode.
+            Memory::Abstract::sBinContainer binContainer;
+            binContainer.ptr = (char *)value;
+            binContainer.dataSize = length;
+            ABSTRACT_PTR_AS(BINARY,outputVar)->setValue( &binContainer );
+            binContainer.ptr = nullptr; // don't destroy the data.
+        } break;
+        case Memory::Abstract::TYPE_VARCHAR:
+        {
+            // Same conversion as STRING (numbers are sent in binary form):
+            std::string str = !isNumber? std::string(value,length) :
+                                         type==PSQL_FLOAT4OID || type==PSQL_FLOAT8OID ? std::to_string(dValue) : std::to_string(iValue);
+            // This will copy the memory.
+            ABSTRACT_PTR_AS(VARCHAR,outputVar)->setValue( (char *)str.c_str() );
+        } break;
+        case Memory::Abstract::TYPE_STRING:
+        {
+            if (isNumber)
+                ABSTRACT_PTR_AS(STRING,outputVar)->setValue( type==PSQL_FLOAT4OID || type==PSQL_FLOAT8OID ? std::to_string(dValue) : std::to_string(iValue) );
+            else
+                ABSTRACT_PTR_AS(STRING,outputVar)->setValue( std::string(value,length) );
+        }break;
+        case Memory::Abstract::TYPE_STRINGLIST:
+        {
+            ABSTRACT_PTR_AS(STRINGLIST,outputVar)->fromString( std::string(value,length) );
+        }break;
+        case Memory::Abstract::TYPE_DATETIME:
+        {
+            // Timestamps are microseconds since 2000-01-01, dates are days since 2000-01-01.
+            if ((type==PSQL_TIMESTAMPOID || type==PSQL_TIMESTAMPTZOID) && length==8)
+            {
+                int64_t usecs = (int64_t)binaryToUInt(value,8);
+                int64_t secs = usecs/1000000 - (usecs%1000000<0?1:0);
+                ABSTRACT_PTR_AS(DATETIME,outputVar)->setValue( (time_t)(PSQL_EPOCH_2000 + secs) );
+            }
+            else if (type==PSQL_DATEOID && length==4)
+                ABSTRACT_PTR_AS(DATETIME,outputVar)->setValue( (time_t)(PSQL_EPOCH_2000 + (int64_t)((int32_t)binaryToUInt(value,4))*86400) );
+            else
+                ABSTRACT_PTR_AS(DATETIME,outputVar)->fromString( std::string(value,length) );
+        }break;
+        case Memory::Abstract::TYPE_IPV4:
+        {
+            // inet/cidr: family, bits, is_cidr, address length, address.
+            if ((type==PSQL_INETOID || type==PSQL_CIDROID) && length==8 && value[3]==4)
+            {
+                in_addr addr;
+                memcpy(&addr,value+4,4);
+                ABSTRACT_PTR_AS(IPV4,outputVar)->setValue( addr );
+            }
+            else
+                ABSTRACT_PTR_AS(IPV4,outputVar)->fromString( std::string(value,length) );
+        }break;
+        case Memory::Abstract::TYPE_IPV6:
+        {
+            if ((type==PSQL_INETOID || type==PSQL_CIDROID) && length==20 && value[3]==16)
+            {
+                in6_addr addr;
+                memcpy(&addr,value+4,16);
+                ABSTRACT_PTR_AS(IPV6,outputVar)->setValue( addr );
+            }
+            else
+                ABSTRACT_PTR_AS(IPV6,outputVar)->fromString( std::string(value,length) );
+        }break;
+        case Memory::Abstract::TYPE_PTR:
+        {
+            // This will reference the memory, but will disappear on the next step
+            ABSTRACT_PTR_AS(PTR,outputVar)->setValue( (void *)value );
+        } break;
+        case Memory::Abstract::TYPE_NULL:
+            // Don't copy the value (not needed).
+            break;
+        }
+
+        columnpos++;
+    }
+}
+
+bool Query_PostgreSQL::execBatch(const std::list<std::map<std::string, CX2::Memory::Abstract::Var *> > &inputRows)
+{
+    if (result)
+    {
+        throw std::runtime_error("Re-using queries is not supported.");
+        return false;
+    }
+
+    ((SQLConnector_PostgreSQL*)sqlConnector)->getDatabaseConnector(this);
+
+    if (!dbCnt)
+        return false;
+
+    if (inputRows.empty())
+        return true;
+
+    // The keys are taken from the first row:
+    if (!psqlBindKeys(inputRows.front()))
+        return false;
+
+    std::unique_lock<std::mutex> lock(*mtDatabaseLock);
+
+    bool ok = true;
+
+#ifdef LIBPQ_HAS_PIPELINING
+    // Pipeline: send the statements without waiting for each result, and collect the results on every sync point.
+    if (!PQenterPipelineMode(dbCnt))
+    {
+        lastSQLError = PQerrorMessage(dbCnt);
+        return false;
+    }
+
+    ok =    PQsendQueryParams(dbCnt, "BEGIN;", 0, nullptr, nullptr, nullptr, nullptr, 0)
+         && PQsendPrepare(dbCnt, "", query.c_str(), paramCount, nullptr);
+
+    size_t pendingRows = 0;
+    for ( const auto & row : inputRows )
+    {
+        if (!ok || !psqlFillParams(row))
+        {
+            ok = false;
+            break;
+        }
+
+        ok = PQsendQueryPrepared(dbCnt, "", paramCount, paramValues, paramLengths, paramFormats, 0);
+        clearDestroyableStringsForInput();
+
+        // Bound the client/server buffers:
+        if (ok && ++pendingRows == PSQL_PIPELINE_SYNC_ROWS)
+        {
+            ok = psqlPipelineSync();
+            pendingRows = 0;
+        }
+    }
+
+    if (ok)
+        ok = PQsendQueryParams(dbCnt, "COMMIT;", 0, nullptr, nullptr, nullptr, nullptr, 0);
+
+    // Collect the pending results (even on failures):
+    if (!psqlPipelineSync())
+        ok = false;
+
+    PQexitPipelineMode(dbCnt);
+#else
+    // Without pipelining: prepare once and execute each row.
+    ok = psqlExecCommand(PQexec(dbCnt, "BEGIN;")) && psqlExecCommand(PQprepare(dbCnt, "", query.c_str(), paramCount, nullptr));
+
+    for ( const auto & row : inputRows )
+    {
+        if (!ok || !psqlFillParams(row) || !psqlExecCommand(PQexecPrepared(dbCnt, "", paramCount, paramValues, paramLengths, paramFormats, 0)))
+        {
+            ok = false;
+            break;
+        }
+        clearDestroyableStringsForInput();
+    }
+
+    if (ok)
+        ok = psqlExecCommand(PQexec(dbCnt, "COMMIT;"));
+#endif
+
+    if (!ok)
+    {
+        if (lastSQLError.empty())
+            lastSQLError = PQerrorMessage(dbCnt);
+        PQclear(PQexec(dbCnt, "ROLLBACK;"));
+    }
+
+    return ok;
 }
 
 void Query_PostgreSQL::psqlSetDatabaseConnector(PGconn *conn)
@@ -190,15 +677,40 @@ ExecStatusType Query_PostgreSQL::psqlGetExecStatus() const
     return execStatus;
 }
 
+void Query_PostgreSQL::psqlSetBinaryResults(bool value)
+{
+    bBinaryResults = value;
+}
+
+bool Query_PostgreSQL::psqlGetBinaryResults() const
+{
+    return bBinaryResults;
+}
+
+void Query_PostgreSQL::psqlSetSingleRowMode(bool value)
+{
+    bSingleRowMode = value;
+}
+
+bool Query_PostgreSQL::psqlGetSingleRowMode() const
+{
+    return bSingleRowMode;
+}
+
 bool Query_PostgreSQL::postBindInputVars()
+{
+    return psqlBindKeys(InputVars) && psqlFillParams(InputVars);
+}
+
+bool Query_PostgreSQL::psqlBindKeys(const std::map<std::string, CX2::Memory::Abstract::Var *> &vars)
 {
     paramCount = 0;
 
     std::list<std::string> keysIn;
-    for (auto & i : InputVars) keysIn.push_back(i.first);
+    for (auto & i : vars) keysIn.push_back(i.first);
 
-    // Replace the named keys for $0, $1, etc...:
-    while (replaceFirstKey(query,keysIn,keysByPos, std::string("$") + std::to_string(paramCount)))
+    // Replace the named keys for $1, $2, etc...:
+    while (replaceFirstKey(query,keysIn,keysByPos, std::string("$") + std::to_string(paramCount+1)))
     {
         paramCount++;
     }
@@ -217,92 +729,104 @@ bool Query_PostgreSQL::postBindInputVars()
     paramLengths = (int *)malloc( paramCount * sizeof(int) );;
     paramFormats = (int *)malloc( paramCount * sizeof(int) );
 
+    return true;
+}
+
+bool Query_PostgreSQL::psqlFillParams(const std::map<std::string, CX2::Memory::Abstract::Var *> &vars)
+{
     for (size_t pos=0; pos<keysByPos.size(); pos++)
     {
         std::string * str = nullptr;
         paramFormats[pos] = 0;
-        std::string key = keysByPos[pos];
+
+        auto it = vars.find(keysByPos[pos]);
+        if (it == vars.end())
+        {
+            lastSQLError = "Input variable " + keysByPos[pos] + " not found";
+            return false;
+        }
+        Memory::Abstract::Var * var = it->second;
 
         /*
         Bind params here.
         */
-        switch (InputVars[ key ]->getVarType())
+        switch (var->getVarType())
         {
         case Memory::Abstract::TYPE_BOOL:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(BOOL,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(BOOL,var)->toString());
         } break;
         case Memory::Abstract::TYPE_INT8:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT8,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT8,var)->toString());
         } break;
         case Memory::Abstract::TYPE_INT16:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT16,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT16,var)->toString());
         } break;
         case Memory::Abstract::TYPE_INT32:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT32,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT32,var)->toString());
         } break;
         case Memory::Abstract::TYPE_INT64:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT64,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(INT64,var)->toString());
         } break;
         case Memory::Abstract::TYPE_UINT8:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT8,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT8,var)->toString());
         } break;
         case Memory::Abstract::TYPE_UINT16:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT16,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT16,var)->toString());
         } break;
         case Memory::Abstract::TYPE_UINT32:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT32,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT32,var)->toString());
         } break;
         case Memory::Abstract::TYPE_UINT64:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT64,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(UINT64,var)->toString());
         } break;
         case Memory::Abstract::TYPE_DATETIME:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(DATETIME,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(DATETIME,var)->toString());
         } break;
         case Memory::Abstract::TYPE_DOUBLE:
         {
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(DOUBLE,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(DOUBLE,var)->toString());
         } break;
         case Memory::Abstract::TYPE_BIN:
         {
-            auto * i =ABSTRACT_PTR_AS(BINARY,InputVars[key])->getValue();
+            auto * i =ABSTRACT_PTR_AS(BINARY,var)->getValue();
             paramValues[pos] = i->ptr;
             paramLengths[pos] = i->dataSize;
             paramFormats[pos] = 1;
         } break;
         case Memory::Abstract::TYPE_VARCHAR:
         {
-            paramValues[pos] = ABSTRACT_PTR_AS(VARCHAR,InputVars[key])->getValue();
-            paramLengths[pos] = strnlen(ABSTRACT_PTR_AS(VARCHAR,InputVars[key])->getValue(),ABSTRACT_PTR_AS(VARCHAR,InputVars[key])->getVarSize());
+            paramValues[pos] = ABSTRACT_PTR_AS(VARCHAR,var)->getValue();
+            paramLengths[pos] = strnlen(ABSTRACT_PTR_AS(VARCHAR,var)->getValue(),ABSTRACT_PTR_AS(VARCHAR,var)->getVarSize());
         } break;
         case Memory::Abstract::TYPE_PTR:
         {
-            void * ptr = ABSTRACT_PTR_AS(PTR,InputVars[key])->getValue();
+            void * ptr = ABSTRACT_PTR_AS(PTR,var)->getValue();
             // Threat PTR as char * (be careful, we should receive strlen compatible string, without null termination will result in an undefined behaviour)
             paramLengths[pos] = strnlen((char *)ptr,0xFFFFFFFF);
             paramValues[pos] = (char *) ptr;
         } break;
         case Memory::Abstract::TYPE_STRING:
         {
-            str = (std::string *)ABSTRACT_PTR_AS(STRING,InputVars[key])->getDirectMemory();
+            str = (std::string *)ABSTRACT_PTR_AS(STRING,var)->getDirectMemory();
         } break;
         case Memory::Abstract::TYPE_STRINGLIST:
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(STRINGLIST,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(STRINGLIST,var)->toString());
             break;
         case Memory::Abstract::TYPE_IPV4:
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(IPV4,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(IPV4,var)->toString());
             break;
         case Memory::Abstract::TYPE_IPV6:
-            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(IPV6,InputVars[key])->toString());
+            str = createDestroyableStringForInput(ABSTRACT_PTR_AS(IPV6,var)->toString());
             break;
         case Memory::Abstract::TYPE_NULL:
             paramValues[pos] = nullptr;
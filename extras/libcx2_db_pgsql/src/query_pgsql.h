@@ -4,7 +4,7 @@
 #include <cx2_db/query.h>
 
 #if __has_include(<libpq-fe.h>)
-# include "<libpq-fe.h>"
+# include <libpq-fe.h>
 #elif __has_include(<postgresql/libpq-fe.h>)
 # include <postgresql/libpq-fe.h>
 #endif
@@ -17,16 +17,45 @@ public:
     Query_PostgreSQL();
     ~Query_PostgreSQL();
     bool exec(const ExecType & execType);
+    bool execBatch(const std::list<std::map<std::string,Memory::Abstract::Var *>> & inputRows);
 
 
     // PostgreSQL specific functions:
     void psqlSetDatabaseConnector(PGconn *conn );
     ExecStatusType psqlGetExecStatus() const;
 
+    /**
+     * @brief psqlSetBinaryResults Request the results in binary format (resultFormat=1) and decode them directly
+     *                             into the bound variables (bool, int2/4/8, float4/8, text, bytea, timestamp, date and inet
+     *                             columns, other column types should be casted in the query).
+     * @param value true for binary results (default: false)
+     */
+    void psqlSetBinaryResults(bool value);
+    bool psqlGetBinaryResults() const;
+    /**
+     * @brief psqlSetSingleRowMode Retrieve SELECT rows one by one (PQsetSingleRowMode) instead of the whole result set,
+     *                             the first row is available as soon as the server sends it and the client memory remains bounded.
+     *                             NOTE: the connection remains locked until the last row is read or the query is destroyed.
+     * @param value true for single row mode (default: false)
+     */
+    void psqlSetSingleRowMode(bool value);
+    bool psqlGetSingleRowMode() const;
+
 protected:
     bool step0();
     bool postBindInputVars();
 private:
+    bool psqlBindKeys(const std::map<std::string,Memory::Abstract::Var *> & vars);
+    bool psqlFillParams(const std::map<std::string,Memory::Abstract::Var *> & vars);
+    bool psqlExecCommand(PGresult * r);
+#ifdef LIBPQ_HAS_PIPELINING
+    bool psqlPipelineSync();
+#endif
+    bool psqlFetchNextResult();
+    void psqlFinishStreaming();
+    void fillRowFromText(const int & row);
+    void fillRowFromBinary(const int & row);
+
     std::vector<std::string> keysByPos;
 
     int paramCount;
@@ -39,6 +68,9 @@ private:
     PGconn *dbCnt;
     PGresult* result;
     int currentRow;
+
+    bool bBinaryResults, bSingleRowMode, bStreaming;
+    std::unique_lock<std::mutex> streamLock;
 };
 }}
 
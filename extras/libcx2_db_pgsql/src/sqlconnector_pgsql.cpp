@@ -8,6 +8,8 @@ SQLConnector_PostgreSQL::SQLConnector_PostgreSQL()
     conn = nullptr;
     port = 5432;
     uConnectionTimeout = 10;
+    bBinaryResults = false;
+    bSingleRowMode = false;
 }
 
 SQLConnector_PostgreSQL::~SQLConnector_PostgreSQL()
@@ -29,6 +31,14 @@ void SQLConnector_PostgreSQL::getDatabaseConnector(Query_PostgreSQL *query)
     query->psqlSetDatabaseConnector(conn);
 }
 
+Query *SQLConnector_PostgreSQL::createQuery0()
+{
+    Query_PostgreSQL * query = new Query_PostgreSQL;
+    query->psqlSetBinaryResults(bBinaryResults);
+    query->psqlSetSingleRowMode(bSingleRowMode);
+    return query;
+}
+
 bool SQLConnector_PostgreSQL::dbTableExist(const std::string &table)
 {
     std::string realTableName;
@@ -174,3 +184,23 @@ void SQLConnector_PostgreSQL::psqlSetConnectionSSLMode(const std::string &value)
 {
     sConnectionSSLMode = value;
 }
+
+void SQLConnector_PostgreSQL::psqlSetBinaryResults(bool value)
+{
+    bBinaryResults = value;
+}
+
+bool SQLConnector_PostgreSQL::psqlGetBinaryResults() const
+{
+    return bBinaryResults;
+}
+
+void SQLConnector_PostgreSQL::psqlSetSingleRowMode(bool value)
+{
+    bSingleRowMode = value;
+}
+
+bool SQLConnector_PostgreSQL::psqlGetSingleRowMode() const
+{
+    return bSingleRowMode;
+}
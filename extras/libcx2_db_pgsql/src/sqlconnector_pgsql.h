@@ -5,7 +5,7 @@
 #include "query_pgsql.h"
 
 #if __has_include(<libpq-fe.h>)
-# include "<libpq-fe.h>"
+# include <libpq-fe.h>
 #elif __has_include(<postgresql/libpq-fe.h>)
 # include <postgresql/libpq-fe.h>
 #endif
@@ -46,8 +46,23 @@ public:
     void psqlSetConnectionOptions(const std::string &value);
     void psqlSetConnectionSSLMode(const std::string &value);
 
+    // Defaults for the new queries:
+
+    /**
+     * @brief psqlSetBinaryResults Set the binary result format for the new queries (see Query_PostgreSQL::psqlSetBinaryResults)
+     * @param value true for binary results (default: false)
+     */
+    void psqlSetBinaryResults(bool value);
+    bool psqlGetBinaryResults() const;
+    /**
+     * @brief psqlSetSingleRowMode Set the single row (streaming) mode for the new queries (see Query_PostgreSQL::psqlSetSingleRowMode)
+     * @param value true for single row mode (default: false)
+     */
+    void psqlSetSingleRowMode(bool value);
+    bool psqlGetSingleRowMode() const;
+
 protected:
-    Query * createQuery0() { return new Query_PostgreSQL; };
+    Query * createQuery0();
     bool connect0();
 private:
     void fillConnectionArray();
@@ -64,6 +79,8 @@ private:
 
     uint32_t uConnectionTimeout;
     std::string sConnectionOptions, sConnectionSSLMode;
+
+    bool bBinaryResults, bSingleRowMode;
 };
 }}
 
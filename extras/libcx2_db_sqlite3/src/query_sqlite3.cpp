@@ -9,6 +9,7 @@ Query_SQLite3::Query_SQLite3()
 {
     stmt = nullptr;
     ppDb = nullptr;
+    bReadConnection = false;
     lastSQLReturnValue = SQLITE_OK;
 }
 
@@ -18,8 +19,12 @@ Query_SQLite3::~Query_SQLite3()
     {
         sqlite3_reset(stmt);
         sqlite3_clear_bindings(stmt);
-        sqlite3_finalize(stmt);
+        // Keep the statement for the next query with the same SQL:
+        if (!((SQLConnector_SQLite3*)sqlConnector)->sqlite3CacheStatement(ppDb, query, stmt))
+            sqlite3_finalize(stmt);
     }
+    if (bReadConnection)
+        ((SQLConnector_SQLite3*)sqlConnector)->sqlite3ReleaseReadConnection(ppDb);
 }
 
 bool Query_SQLite3::exec(const ExecType &execType)
@@ -36,111 +41,42 @@ bool Query_SQLite3::exec(const ExecType &execType)
     if (!ppDb)
         return false;
 
-    std::unique_lock<std::mutex> lock(*mtDatabaseLock);
-
-    const char *tail;
-    // TODO: querylenght isn't -1?
-    lastSQLReturnValue = sqlite3_prepare_v2(ppDb, query.c_str(), query.length(), &stmt, &tail);
-    if ( lastSQLReturnValue != SQLITE_OK)
+    // Read-only statements can go to a read connection (if available), which is used exclusively by this query.
+    if (execType == EXEC_TYPE_SELECT)
     {
-        lastSQLError = "Error preparing the SQL query";
-        return false;
-    }
+        sqlite3 * readDb = ((SQLConnector_SQLite3*)sqlConnector)->sqlite3AcquireReadConnection();
+        if (readDb)
+        {
+            sqlite3 * writeDb = ppDb;
+            ppDb = readDb;
+            bReadConnection = true;
 
+            if (!sqlite3PrepareStatement() || !sqlite3_stmt_readonly(stmt))
+            {
+                // Not for the read-only connection, back to the writer.
+                if (stmt && !((SQLConnector_SQLite3*)sqlConnector)->sqlite3CacheStatement(ppDb, query, stmt))
+                    sqlite3_finalize(stmt);
+                stmt = nullptr;
+                ((SQLConnector_SQLite3*)sqlConnector)->sqlite3ReleaseReadConnection(ppDb);
+                ppDb = writeDb;
+                bReadConnection = false;
+            }
+        }
+    }
 
-    // Bind the parameters (in and out)
-    for ( const auto &inputVar : InputVars)
+    std::unique_lock<std::mutex> lock(*mtDatabaseLock, std::defer_lock);
+    if (!bReadConnection)
     {
-        int idx = sqlite3_bind_parameter_index(stmt, inputVar.first.c_str());
-        if (!idx)
-        {
-            lastSQLError = "Binding parameter for index not found";
+        lock.lock();
+        if (!sqlite3PrepareStatement())
             return false;
-        }
-
-        switch (inputVar.second->getVarType())
-        {
-        case Memory::Abstract::TYPE_BOOL:
-            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(BOOL,inputVar.second)->getValue()?1:0 );
-            break;
-        case Memory::Abstract::TYPE_INT8:
-            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(INT8,inputVar.second)->getValue() );
-            break;
-        case Memory::Abstract::TYPE_INT16:
-            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(INT16,inputVar.second)->getValue() );
-            break;
-        case Memory::Abstract::TYPE_INT32:
-            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(INT32,inputVar.second)->getValue() );
-            break;
-        case Memory::Abstract::TYPE_INT64:
-            sqlite3_bind_int64(stmt, idx, ABSTRACT_PTR_AS(INT64,inputVar.second)->getValue() );
-            break;
-        case Memory::Abstract::TYPE_UINT8:
-            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(UINT8,inputVar.second)->getValue() );
-            break;
-        case Memory::Abstract::TYPE_UINT16:
-            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(UINT16,inputVar.second)->getValue() );
-            break;
-        case Memory::Abstract::TYPE_UINT32:
-            sqlite3_bind_int64(stmt, idx, ABSTRACT_PTR_AS(UINT32,inputVar.second)->getValue() );
-            break;
-        case Memory::Abstract::TYPE_UINT64:
-            // Not implemented.
-            throw std::runtime_error("UINT64 is not supported by SQLite3, check your implementation");
-            break;
-        case Memory::Abstract::TYPE_DOUBLE:
-            sqlite3_bind_double(stmt,idx,ABSTRACT_PTR_AS(DOUBLE,inputVar.second)->getValue());
-            break;
-        case Memory::Abstract::TYPE_BIN:
-        {
-            Memory::Abstract::sBinContainer * i = ABSTRACT_PTR_AS(BINARY,inputVar.second)->getValue();
-            sqlite3_bind_blob64(stmt,idx,i->ptr,i->dataSize,SQLITE_STATIC);
-        } break;
-        case Memory::Abstract::TYPE_VARCHAR:
-        {
-            sqlite3_bind_text64(stmt,idx,ABSTRACT_PTR_AS(VARCHAR,inputVar.second)->getValue(),
-                                ABSTRACT_PTR_AS(VARCHAR,inputVar.second)->getVarSize(),
-                                SQLITE_STATIC,
-                                SQLITE_UTF8);
-        } break;
-        case Memory::Abstract::TYPE_DATETIME:
-        {
-            auto i = ABSTRACT_PTR_AS(DATETIME,inputVar.second)->toString();
-            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
-        }break;
-        case Memory::Abstract::TYPE_STRING:
-        {
-            auto i = ABSTRACT_PTR_AS(STRING,inputVar.second)->toString();
-            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
-        }break;
-        case Memory::Abstract::TYPE_STRINGLIST:
-        {
-            auto i = ABSTRACT_PTR_AS(STRINGLIST,inputVar.second)->toString();
-            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
-        }break;
-        case Memory::Abstract::TYPE_IPV4:
-        {
-            auto i = ABSTRACT_PTR_AS(IPV4,inputVar.second)->toString();
-            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
-        }break;
-        case Memory::Abstract::TYPE_IPV6:
-        {
-            auto i = ABSTRACT_PTR_AS(IPV6,inputVar.second)->toString();
-            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
-        }break;
-        case Memory::Abstract::TYPE_PTR:
-        {
-            void * ptr = ABSTRACT_PTR_AS(PTR,inputVar.second)->getValue();
-            // Threat PTR as char * (be careful, we should receive strlen compatible string, without null termination will result in an undefined behaviour)
-            size_t ptrSize = strnlen((char *)ptr,0xFFFFFFFF);
-            sqlite3_bind_text(stmt,idx,(char *)ptr,ptrSize,SQLITE_STATIC);
-        } break;
-        case Memory::Abstract::TYPE_NULL:
-            sqlite3_bind_null(stmt,idx);
-            break;
-        }
     }
 
+
+    // Bind the parameters (in and out)
+    if (!sqlite3BindInputVars(InputVars))
+        return false;
+
     // if insert, only do one step.
     if (execType == EXEC_TYPE_INSERT)
     {
@@ -149,12 +85,79 @@ bool Query_SQLite3::exec(const ExecType &execType)
         if (bFetchLastInsertRowID)
              lastInsertRowID = sqlite3_last_insert_rowid(ppDb);
 
-        return sqlite3IsDone();
+        // Statements like PRAGMA's may return a row.
+        return sqlite3IsDone() || lastSQLReturnValue == SQLITE_ROW;
     }
 
     return true;
 }
 
+bool Query_SQLite3::execBatch(const std::list<std::map<std::string, CX2::Memory::Abstract::Var *> > &inputRows)
+{
+    if (stmt)
+    {
+        throw std::runtime_error("Re-using queries is not supported.");
+        return false;
+    }
+
+    ((SQLConnector_SQLite3*)sqlConnector)->putDatabaseConnectorIntoQuery(this);
+
+    if (!ppDb)
+        return false;
+
+    std::unique_lock<std::mutex> lock(*mtDatabaseLock);
+
+    if ((lastSQLReturnValue = sqlite3_exec(ppDb, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr)) != SQLITE_OK)
+    {
+        lastSQLError = sqlite3_errmsg(ppDb);
+        return false;
+    }
+
+    bool ok;
+    try
+    {
+        // Prepare the statement only once, and re-use it for every row:
+        ok = sqlite3PrepareStatement();
+
+        for ( const auto & row : inputRows )
+        {
+            // Unsupported types fail the batch (the transaction should not be left open):
+            if (!ok || !sqlite3BindInputVars(row,false))
+            {
+                ok = false;
+                break;
+            }
+
+            lastSQLReturnValue = sqlite3_step(stmt);
+            if (!sqlite3IsDone())
+            {
+                lastSQLError = sqlite3_errmsg(ppDb);
+                ok = false;
+                break;
+            }
+
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+        }
+    }
+    catch (...)
+    {
+        sqlite3_exec(ppDb, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+
+    if (ok && sqlite3_exec(ppDb, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        lastSQLError = sqlite3_errmsg(ppDb);
+        ok = false;
+    }
+
+    if (!ok)
+        sqlite3_exec(ppDb, "ROLLBACK;", nullptr, nullptr, nullptr);
+
+    return ok;
+}
+
 bool Query_SQLite3::step0()
 {
     lastSQLReturnValue = sqlite3_step(stmt);
@@ -259,3 +262,117 @@ void Query_SQLite3::sqlite3SetDatabaseConnector(sqlite3 *ppDb)
     this->ppDb = ppDb;
 }
 
+bool Query_SQLite3::sqlite3PrepareStatement()
+{
+    stmt = ((SQLConnector_SQLite3*)sqlConnector)->sqlite3GetCachedStatement(ppDb, query);
+    if (stmt)
+        return true;
+
+    const char *tail;
+    // TODO: querylenght isn't -1?
+    lastSQLReturnValue = sqlite3_prepare_v2(ppDb, query.c_str(), query.length(), &stmt, &tail);
+    if ( lastSQLReturnValue != SQLITE_OK)
+    {
+        lastSQLError = "Error preparing the SQL query";
+        return false;
+    }
+    return true;
+}
+
+bool Query_SQLite3::sqlite3BindInputVars(const std::map<std::string, CX2::Memory::Abstract::Var *> &vars, bool throwOnUnsupportedTypes)
+{
+    for ( const auto &inputVar : vars)
+    {
+        int idx = sqlite3_bind_parameter_index(stmt, inputVar.first.c_str());
+        if (!idx)
+        {
+            lastSQLError = "Binding parameter for index not found";
+            return false;
+        }
+
+        switch (inputVar.second->getVarType())
+        {
+        case Memory::Abstract::TYPE_BOOL:
+            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(BOOL,inputVar.second)->getValue()?1:0 );
+            break;
+        case Memory::Abstract::TYPE_INT8:
+            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(INT8,inputVar.second)->getValue() );
+            break;
+        case Memory::Abstract::TYPE_INT16:
+            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(INT16,inputVar.second)->getValue() );
+            break;
+        case Memory::Abstract::TYPE_INT32:
+            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(INT32,inputVar.second)->getValue() );
+            break;
+        case Memory::Abstract::TYPE_INT64:
+            sqlite3_bind_int64(stmt, idx, ABSTRACT_PTR_AS(INT64,inputVar.second)->getValue() );
+            break;
+        case Memory::Abstract::TYPE_UINT8:
+            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(UINT8,inputVar.second)->getValue() );
+            break;
+        case Memory::Abstract::TYPE_UINT16:
+            sqlite3_bind_int(stmt, idx, ABSTRACT_PTR_AS(UINT16,inputVar.second)->getValue() );
+            break;
+        case Memory::Abstract::TYPE_UINT32:
+            sqlite3_bind_int64(stmt, idx, ABSTRACT_PTR_AS(UINT32,inputVar.second)->getValue() );
+            break;
+        case Memory::Abstract::TYPE_UINT64:
+            // Not implemented.
+            if (throwOnUnsupportedTypes)
+                throw std::runtime_error("UINT64 is not supported by SQLite3, check your implementation");
+            lastSQLError = "UINT64 is not supported by SQLite3";
+            return false;
+        case Memory::Abstract::TYPE_DOUBLE:
+            sqlite3_bind_double(stmt,idx,ABSTRACT_PTR_AS(DOUBLE,inputVar.second)->getValue());
+            break;
+        case Memory::Abstract::TYPE_BIN:
+        {
+            Memory::Abstract::sBinContainer * i = ABSTRACT_PTR_AS(BINARY,inputVar.second)->getValue();
+            sqlite3_bind_blob64(stmt,idx,i->ptr,i->dataSize,SQLITE_STATIC);
+        } break;
+        case Memory::Abstract::TYPE_VARCHAR:
+        {
+            sqlite3_bind_text64(stmt,idx,ABSTRACT_PTR_AS(VARCHAR,inputVar.second)->getValue(),
+                                ABSTRACT_PTR_AS(VARCHAR,inputVar.second)->getVarSize(),
+                                SQLITE_STATIC,
+                                SQLITE_UTF8);
+        } break;
+        case Memory::Abstract::TYPE_DATETIME:
+        {
+            auto i = ABSTRACT_PTR_AS(DATETIME,inputVar.second)->toString();
+            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
+        }break;
+        case Memory::Abstract::TYPE_STRING:
+        {
+            auto i = ABSTRACT_PTR_AS(STRING,inputVar.second)->toString();
+            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
+        }break;
+        case Memory::Abstract::TYPE_STRINGLIST:
+        {
+            auto i = ABSTRACT_PTR_AS(STRINGLIST,inputVar.second)->toString();
+            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
+        }break;
+        case Memory::Abstract::TYPE_IPV4:
+        {
+            auto i = ABSTRACT_PTR_AS(IPV4,inputVar.second)->toString();
+            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
+        }break;
+        case Memory::Abstract::TYPE_IPV6:
+        {
+            auto i = ABSTRACT_PTR_AS(IPV6,inputVar.second)->toString();
+            sqlite3_bind_text(stmt,idx,i.c_str(),i.size(),SQLITE_TRANSIENT);
+        }break;
+        case Memory::Abstract::TYPE_PTR:
+        {
+            void * ptr = ABSTRACT_PTR_AS(PTR,inputVar.second)->getValue();
+            // Threat PTR as char * (be careful, we should receive strlen compatible string, without null termination will result in an undefined behaviour)
+            size_t ptrSize = strnlen((char *)ptr,0xFFFFFFFF);
+            sqlite3_bind_text(stmt,idx,(char *)ptr,ptrSize,SQLITE_STATIC);
+        } break;
+        case Memory::Abstract::TYPE_NULL:
+            sqlite3_bind_null(stmt,idx);
+            break;
+        }
+    }
+    return true;
+}
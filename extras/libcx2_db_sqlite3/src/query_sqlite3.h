@@ -14,6 +14,7 @@ public:
 
     // Direct Query:
     bool exec(const ExecType & execType);
+    bool execBatch(const std::list<std::map<std::string,Memory::Abstract::Var *>> & inputRows);
 
     // Sqlite3 options...
 
@@ -24,8 +25,17 @@ protected:
     bool step0();
 
 private:
+    bool sqlite3PrepareStatement();
+    /**
+     * @brief sqlite3BindInputVars Bind the input vars into the prepared statement
+     * @param throwOnUnsupportedTypes throw on unsupported types (UINT64), or fail (return false)
+     * @return true if all the vars were bound
+     */
+    bool sqlite3BindInputVars(const std::map<std::string,Memory::Abstract::Var *> & vars, bool throwOnUnsupportedTypes = true);
+
     sqlite3_stmt *stmt;
     sqlite3 *ppDb;
+    bool bReadConnection;
 };
 }}
 
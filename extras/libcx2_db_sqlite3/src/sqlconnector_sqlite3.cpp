@@ -6,10 +6,17 @@ using namespace CX2::Database;
 SQLConnector_SQLite3::SQLConnector_SQLite3()
 {
     ppDb = nullptr;
+    rc = 0;
+    statementCacheSize = 32;
 }
 
 SQLConnector_SQLite3::~SQLConnector_SQLite3()
 {
+    sqlite3ClearStatementCache();
+
+    for (auto * db : readConnections)
+        sqlite3_close(db);
+
     if (ppDb)
         sqlite3_close(ppDb);
 }
@@ -85,6 +92,121 @@ bool SQLConnector_SQLite3::sqlite3PragmaSynchronous(const eSqlite3PragmaSyncMode
     return false;
 }
 
+bool SQLConnector_SQLite3::sqlite3PragmaMMapSize(const uint64_t &size)
+{
+    return query("PRAGMA mmap_size = " + std::to_string(size) + ";");
+}
+
+bool SQLConnector_SQLite3::sqlite3BusyTimeout(const uint32_t &ms)
+{
+    return ppDb && sqlite3_busy_timeout(ppDb,ms) == SQLITE_OK;
+}
+
+bool SQLConnector_SQLite3::sqlite3ServerProfile(const uint32_t &readConnectionsCount, const uint32_t &busyTimeoutMS, const uint64_t &mmapSize)
+{
+    if (!ppDb)
+        return false;
+
+    if (!sqlite3BusyTimeout(busyTimeoutMS))
+        return false;
+
+    // In-memory databases can't be shared between connections, and don't need WAL/mmap
+    if (dbFilePath.empty() || dbFilePath == ":memory:")
+        return true;
+
+    // The journal mode is persistent and WAL allows the readers to run concurrently with the writer.
+    if (!sqlite3PragmaJournalMode(SQLITE3_JOURNAL_WAL) ||
+            !sqlite3PragmaSynchronous(SQLITE3_SYNC_NORMAL) ||
+            !sqlite3PragmaMMapSize(mmapSize))
+        return false;
+
+    std::unique_lock<std::mutex> lock(mtReadConnections);
+    while (readConnections.size() < readConnectionsCount)
+    {
+        sqlite3 * db = nullptr;
+        if (sqlite3_open_v2(dbFilePath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+        {
+            lastSQLError = "Error openning the database file (read-only)";
+            if (db) sqlite3_close(db);
+            return false;
+        }
+
+        sqlite3_busy_timeout(db,busyTimeoutMS);
+        sqlite3Exec(db, "PRAGMA mmap_size = " + std::to_string(mmapSize) + ";");
+
+        readConnections.push_back(db);
+        freeReadConnections.push_back(db);
+    }
+
+    return true;
+}
+
+void SQLConnector_SQLite3::sqlite3SetStatementCacheSize(const size_t &value)
+{
+    std::unique_lock<std::mutex> lock(mtStatementCache);
+    statementCacheSize = value;
+}
+
+sqlite3 *SQLConnector_SQLite3::sqlite3AcquireReadConnection()
+{
+    std::unique_lock<std::mutex> lock(mtReadConnections);
+    // When all the readers are busy, the query goes to the writer connection.
+    if (freeReadConnections.empty())
+        return nullptr;
+    sqlite3 * db = freeReadConnections.front();
+    freeReadConnections.pop_front();
+    return db;
+}
+
+void SQLConnector_SQLite3::sqlite3ReleaseReadConnection(sqlite3 *db)
+{
+    std::unique_lock<std::mutex> lock(mtReadConnections);
+    freeReadConnections.push_back(db);
+}
+
+sqlite3_stmt *SQLConnector_SQLite3::sqlite3GetCachedStatement(sqlite3 *db, const std::string &sql)
+{
+    std::unique_lock<std::mutex> lock(mtStatementCache);
+
+    auto & cache = statementCache[db];
+    auto i = cache.find(sql);
+    if (i == cache.end())
+        return nullptr;
+
+    sqlite3_stmt * stmt = i->second;
+    cache.erase(i);
+    return stmt;
+}
+
+bool SQLConnector_SQLite3::sqlite3CacheStatement(sqlite3 *db, const std::string &sql, sqlite3_stmt *stmt)
+{
+    std::unique_lock<std::mutex> lock(mtStatementCache);
+
+    auto & cache = statementCache[db];
+    if (cache.size() >= statementCacheSize)
+        return false;
+
+    cache.insert(std::make_pair(sql,stmt));
+    return true;
+}
+
+bool SQLConnector_SQLite3::sqlite3Exec(sqlite3 *db, const std::string &sql)
+{
+    return sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+void SQLConnector_SQLite3::sqlite3ClearStatementCache()
+{
+    std::unique_lock<std::mutex> lock(mtStatementCache);
+
+    for (auto & cache : statementCache)
+    {
+        for (auto & i : cache.second)
+            sqlite3_finalize(i.second);
+    }
+    statementCache.clear();
+}
+
 std::string SQLConnector_SQLite3::getEscaped(const std::string &v)
 {
     char * cEscaped = sqlite3_mprintf("%Q", v.c_str());
@@ -5,6 +5,8 @@
 #include "query_sqlite3.h"
 #include <sqlite3.h>
 #include <mutex>
+#include <list>
+#include <map>
 
 namespace CX2 { namespace Database {
 
@@ -67,6 +69,37 @@ public:
     bool sqlite3PragmaForeignKeys(bool on = true);
     bool sqlite3PragmaJournalMode(const eSqlite3PragmaJournalMode & mode);
     bool sqlite3PragmaSynchronous(const eSqlite3PragmaSyncMode & mode);
+    bool sqlite3PragmaMMapSize(const uint64_t & size);
+    /**
+     * @brief sqlite3BusyTimeout Wait up to ms milliseconds when the database is locked by other connection/process
+     * @param ms milliseconds
+     * @return true if succeed.
+     */
+    bool sqlite3BusyTimeout(const uint32_t & ms);
+
+    /**
+     * @brief sqlite3ServerProfile Configure the database for concurrent server use (call it after connect):
+     *                             WAL journal, synchronous=NORMAL, busy timeout, memory mapped I/O and a pool of read-only
+     *                             connections for the SELECT queries (next to the single writer connection).
+     *                             In-memory databases only get the busy timeout.
+     * @param readConnections read-only connections to be opened
+     * @param busyTimeoutMS busy timeout in milliseconds (for every connection)
+     * @param mmapSize maximum bytes of the database to be memory mapped (for every connection)
+     * @return true if succeed.
+     */
+    bool sqlite3ServerProfile(const uint32_t & readConnections = 4, const uint32_t & busyTimeoutMS = 5000, const uint64_t & mmapSize = 256*1024*1024);
+    /**
+     * @brief sqlite3SetStatementCacheSize Set the maximum prepared statements retained (reset) per connection
+     *                                     to be re-used by the next query with the same SQL (0 to disable, default: 32)
+     * @param value max statements per connection
+     */
+    void sqlite3SetStatementCacheSize(const size_t & value);
+
+    // Internal functions used by the query (don't use):
+    sqlite3 * sqlite3AcquireReadConnection();
+    void sqlite3ReleaseReadConnection(sqlite3 * db);
+    sqlite3_stmt * sqlite3GetCachedStatement(sqlite3 * db, const std::string & sql);
+    bool sqlite3CacheStatement(sqlite3 * db, const std::string & sql, sqlite3_stmt * stmt);
 
 
     std::string getEscaped(const std::string & value);
@@ -77,9 +110,21 @@ protected:
     bool connect0();
 
 private:
+    bool sqlite3Exec(sqlite3 * db, const std::string & sql);
+    void sqlite3ClearStatementCache();
+
     int rc;
     sqlite3 *ppDb;
 
+    // Read-Only connections pool:
+    std::list<sqlite3 *> readConnections, freeReadConnections;
+    std::mutex mtReadConnections;
+
+    // Prepared statements cache (by connection and sql):
+    std::map<sqlite3 *, std::multimap<std::string,sqlite3_stmt *>> statementCache;
+    size_t statementCacheSize;
+    std::mutex mtStatementCache;
+
 };
 }}
 
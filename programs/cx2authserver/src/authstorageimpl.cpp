@@ -46,6 +46,14 @@ bool AuthStorageImpl::createAuth()
             return false;
         }
 
+        // WAL + read-only connections pool for concurrent logins:
+        if (!sqlConnector->sqlite3ServerProfile( Globals::getConfig_main()->get<uint32_t>("Auth.ReadConnections",4),
+                                                 Globals::getConfig_main()->get<uint32_t>("Auth.BusyTimeoutMS",5000),
+                                                 Globals::getConfig_main()->get<uint64_t>("Auth.MMapSize",256*1024*1024) ))
+        {
+            Globals::getAppLog()->log0(__func__,Logs::LEVEL_WARN, "Failed to apply the SQLite3 server profile on: '%s'", dbFilePath.c_str());
+        }
+
         authManager = new Authentication::Manager_DB(sqlConnector);
     }
     /*    else if (boost::to_lower_copy(driver) == "postgresql")
@@ -72,6 +80,18 @@ bool AuthStorageImpl::createAuth()
         return false;
     }
 
+    // Login bookkeeping (last login/bad attempts) written in batches (opt-in: pending updates are lost on a crash):
+    authManager->setWriteBehind( Globals::getConfig_main()->get<bool>("Auth.WriteBehind",false),
+                                 Globals::getConfig_main()->get<uint32_t>("Auth.WriteBehindPeriodMS",1000),
+                                 Globals::getConfig_main()->get<size_t>("Auth.WriteBehindMaxPending",512) );
+
+    // Secrets hashed out of the RPC/Web threads, fair-queued by client IP:
+    Authentication::HashingPool * hashingPool = new Authentication::HashingPool( Globals::getConfig_main()->get<uint32_t>("Auth.HashingThreads",4),
+                                                                                  Globals::getConfig_main()->get<uint32_t>("Auth.HashingMaxQueuedCost",16384),
+                                                                                  Globals::getConfig_main()->get<uint32_t>("Auth.HashingMaxQueuedCostPerIP",256) );
+    hashingPool->start();
+    authManager->setHashingPool(hashingPool);
+
 
     // Check for admin accounts:
     if ( authManager->accountExist("admin") && !authManager->isAccountSuperUser("admin") )
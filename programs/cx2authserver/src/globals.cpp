@@ -10,6 +10,7 @@ std::mutex Globals::mDatabase, Globals::mDirs;
 boost::property_tree::ptree Globals::config_main;
 
 CX2::RPC::Fast::FastRPC * Globals::fastRPC = nullptr;
+CX2::Threads::Metrics::MetricsRegistry * Globals::metrics = nullptr;
 
 Globals::Globals()
 {
@@ -82,6 +83,16 @@ void Globals::setAuthManager(CX2::Authentication::Manager *value)
     authManager = value;
 }
 
+CX2::Threads::Metrics::MetricsRegistry *Globals::getMetrics()
+{
+    return metrics;
+}
+
+void Globals::setMetrics(CX2::Threads::Metrics::MetricsRegistry *value)
+{
+    metrics = value;
+}
+
 CX2::Application::Logs::RPCLog *Globals::getRPCLog()
 {
     return rpclog;
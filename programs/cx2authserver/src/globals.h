@@ -37,6 +37,9 @@ public:
     static CX2::Authentication::Manager *getAuthManager();
     static void setAuthManager(CX2::Authentication::Manager *value);
 
+    static CX2::Threads::Metrics::MetricsRegistry *getMetrics();
+    static void setMetrics(CX2::Threads::Metrics::MetricsRegistry *value);
+
 
 private:
     static std::string rulesDir,actionsDir;
@@ -48,6 +51,7 @@ private:
 
     static CX2::Authentication::Manager * authManager;
     static CX2::RPC::Fast::FastRPC * fastRPC;
+    static CX2::Threads::Metrics::MetricsRegistry * metrics;
 
 };
 
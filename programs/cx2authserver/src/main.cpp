@@ -130,6 +130,9 @@ public:
         Globals::getRPCLog()->setStandardLogSeparator(",");
         Globals::getRPCLog()->setDebug(Globals::getConfig_main()->get<bool>("Logs.Debug",false));
 
+        if ( config_main.get<bool>("Metrics.Enabled",false) )
+            Globals::setMetrics(new CX2::Threads::Metrics::MetricsRegistry);
+
         return true;
     }
 };
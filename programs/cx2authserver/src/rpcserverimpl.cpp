@@ -58,11 +58,14 @@ bool LoginRPCServerImpl::createRPCListener()
     }
 
     Globals::setFastRPC(new CX2::RPC::Fast::FastRPC);
+    Globals::getFastRPC()->setMetrics(Globals::getMetrics(), Globals::getConfig_main()->get<bool>("Metrics.RPCExport",false));
 
     // Set RPC Methods.
     CX2::RPC::Templates::LoginAuth::AddLoginAuthMethods(
                 Globals::getAuthManager(),
                 Globals::getFastRPC());
+    // No more methods, use the lock-free dispatch table:
+    Globals::getFastRPC()->freezeMethods();
 
     // Init the server:
     Network::Sockets::Acceptors::Socket_Acceptor_MultiThreaded * multiThreadedAcceptor = new Network::Sockets::Acceptors::Socket_Acceptor_MultiThreaded;
@@ -62,6 +62,7 @@ bool WebServerImpl::createWebServer()
     {
         Authentication::Domains * authDomains = new Authentication::Domains;
         MethodsManager *methodsManagers = new MethodsManager(DB_APPNAME);
+        methodsManagers->setMetrics(Globals::getMetrics());
 
         // Add the default domain / auth:
         authDomains->addDomain("",Globals::getAuthManager());
@@ -78,6 +79,7 @@ bool WebServerImpl::createWebServer()
         webServer->setMethodManagers(methodsManagers);
         webServer->setSoftwareVersion(AUTHSERVER_VER_MAJOR, AUTHSERVER_VER_MINOR, AUTHSERVER_VER_SUBMINOR, AUTHSERVER_VER_CODENAME);
         webServer->setExtCallBackOnInitFailed(WebServerImpl::protoInitFail);
+        webServer->setMetricsURI(Globals::getConfig_main()->get<std::string>("Metrics.WebURI",""));
 
         webServer->acceptPoolThreaded(sockWebListen);
 
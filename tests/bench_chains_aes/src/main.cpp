@@ -0,0 +1,146 @@
+#include <cx2_net_chains/chainsockets.h>
+#include <cx2_net_chains/socketchain_aes.h>
+
+#include <openssl/evp.h>
+
+#include <chrono>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+using namespace CX2::Network::Chains;
+using namespace CX2::Network::Streams;
+
+/*
+ * Throughput of SocketChain_AES (legacy XOR blocks and CTR, threaded and in-process layers)
+ * over a local socket pair, against the raw EVP AES-256-CTR speed (the upper bound).
+ *
+ * usage: bench_chains_aes [MiB to transfer (default 256)] [write size (default 16384)]
+ */
+
+static double elapsedSecs(const std::chrono::steady_clock::time_point & start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+static void report(const char * name, const uint64_t & bytes, double secs)
+{
+    printf("%-40s %10.1f MiB/s\n", name, bytes/secs/(1024.0*1024.0));
+    fflush(stdout);
+}
+
+static bool benchEVP(const uint64_t & bytes, const size_t & writeSize)
+{
+    unsigned char key[32], iv[16];
+    memset(key,0x55,sizeof(key));
+    memset(iv,0xAA,sizeof(iv));
+
+    std::vector<unsigned char> buf(writeSize,'x');
+    EVP_CIPHER_CTX * ctx = EVP_CIPHER_CTX_new();
+    if (!ctx || EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, key, iv)!=1)
+    {
+        if (ctx) EVP_CIPHER_CTX_free(ctx);
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int outl;
+    for (uint64_t done=0; done<bytes; done+=writeSize)
+        EVP_EncryptUpdate(ctx, buf.data(), &outl, buf.data(), (int)writeSize);
+    report("EVP AES-256-CTR (no socket)", bytes, elapsedSecs(start));
+
+    EVP_CIPHER_CTX_free(ctx);
+    return true;
+}
+
+static void releaseChain(const std::initializer_list<StreamSocket *> & sockets)
+{
+    // StreamSocket::shutdownSocket does not shut down the descriptor, so the layer threads are released here:
+    for (StreamSocket * sock : sockets)
+    {
+        if (sock->isActive())
+            shutdown(sock->getSocketFD(), SHUT_RDWR);
+    }
+}
+
+static bool benchChain(const char * name, const Protocols::eAESChainMode & mode, bool inProcess, const uint64_t & bytes, const size_t & writeSize)
+{
+    std::pair<StreamSocket *, StreamSocket *> sockPair = StreamSocket::GetSocketPair();
+    if (!sockPair.first || !sockPair.second)
+        return false;
+
+    // The layers should outlive the chains:
+    Protocols::SocketChain_AES clientAES, serverAES;
+    ChainSockets client(sockPair.first), server(sockPair.second);
+    clientAES.setPhase1Key((char *)"benchmark");
+    clientAES.setAESMode(mode);
+    serverAES.setPhase1Key((char *)"benchmark");
+    serverAES.setAESMode(mode);
+    serverAES.setServerMode(true);
+
+    // Both handshakes have to run at the same time:
+    bool serverReady = false;
+    std::thread serverInit([&]() { serverReady = server.addToChain(&serverAES, inProcess); });
+    bool clientReady = client.addToChain(&clientAES, inProcess);
+    serverInit.join();
+    if (!clientReady || !serverReady)
+    {
+        fprintf(stderr, "%s: handshake failed\n", name);
+        releaseChain({ sockPair.first, sockPair.second, &clientAES, &serverAES });
+        return false;
+    }
+
+    uint64_t received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread reader([&]() {
+        std::vector<char> buf(writeSize);
+        int r;
+        while (received<bytes && (r=server.partialRead(buf.data(), (uint32_t)buf.size()))>0)
+            received+=r;
+    });
+
+    std::vector<char> buf(writeSize,'x');
+    for (uint64_t sent=0; sent<bytes; sent+=writeSize)
+    {
+        if (!client.writeBlock(buf.data(), (uint32_t)writeSize))
+            break;
+    }
+    reader.join();
+
+    if (received<bytes)
+    {
+        fprintf(stderr, "%s: only %llu of %llu bytes received\n", name, (unsigned long long)received, (unsigned long long)bytes);
+        releaseChain({ sockPair.first, sockPair.second, &clientAES, &serverAES });
+        return false;
+    }
+    report(name, bytes, elapsedSecs(start));
+
+    releaseChain({ sockPair.first, sockPair.second, &clientAES, &serverAES });
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t mib = argc>1? strtoull(argv[1],nullptr,10) : 256;
+    size_t writeSize = argc>2? strtoull(argv[2],nullptr,10) : 16384;
+    if (!mib || !writeSize)
+    {
+        fprintf(stderr, "usage: %s [MiB to transfer] [write size]\n", argv[0]);
+        return -1;
+    }
+    // Transfer complete writes:
+    uint64_t bytes = ((mib*1024*1024)/writeSize)*writeSize;
+
+    bool ok = benchEVP(bytes, writeSize);
+    ok = benchChain("AES XOR blocks (threaded layer)", Protocols::AES_CHAINMODE_XORBLOCKS, false, bytes, writeSize) && ok;
+    ok = benchChain("AES XOR blocks (in-process layer)", Protocols::AES_CHAINMODE_XORBLOCKS, true, bytes, writeSize) && ok;
+    ok = benchChain("AES-256-CTR (threaded layer)", Protocols::AES_CHAINMODE_CTR, false, bytes, writeSize) && ok;
+    ok = benchChain("AES-256-CTR (in-process layer)", Protocols::AES_CHAINMODE_CTR, true, bytes, writeSize) && ok;
+
+    return ok? 0 : -1;
+}
@@ -0,0 +1,231 @@
+#include <cx2_mem_vars/substreamparser.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace CX2::Memory::Streams;
+using namespace CX2::Memory::Streams::Parsing;
+
+/*
+ * SubParser delimiter modes (DelimiterMatcher):
+ *   - model check: random delimiter sets and inputs split by a reference splitter (the first delimiter
+ *                  that ends in the stream, the longest if many end at the same byte), with the input
+ *                  fed whole, in random pieces and one byte at a time.
+ *   - throughput: a long line fed one byte at a time (linear, the data is scanned once).
+ *
+ * usage: bench_delimiters [model check iterations (default 3000, 0 to skip)] [seed (default 7)]
+ */
+
+struct sToken {
+    bool operator==(const sToken & other) const { return data==other.data && delimiter==other.delimiter; }
+    bool operator!=(const sToken & other) const { return !(*this==other); }
+    std::string data, delimiter;
+};
+
+class TokenCollector : public SubParser
+{
+public:
+    TokenCollector(const ParseMode & mode, const std::list<std::string> & delimiters)
+    {
+        setParseMode(mode);
+        if (mode==PARSE_MODE_MULTIDELIMITER)
+            setParseMultiDelimiter(delimiters);
+        else
+            setParseDelimiter(delimiters.front());
+        setParseDataTargetSize(1024*1024*1024);
+    }
+    bool stream(Status &) override
+    {
+        return true;
+    }
+
+    std::vector<sToken> tokens;
+
+protected:
+    ParseStatus parse() override
+    {
+        // The data left at the stream end is not delimited:
+        tokens.push_back( { getParsedData()->toString(), isStreamEnded()? "" : getDelimiterFound() } );
+        return PARSE_STAT_GET_MORE_DATA;
+    }
+};
+
+static std::vector<sToken> referenceSplit(const std::string & data, const std::list<std::string> & delimiters)
+{
+    std::vector<sToken> r;
+    size_t tokenStart = 0;
+    for (size_t end=1; end<=data.size(); end++)
+    {
+        std::string best;
+        for (const std::string & delimiter : delimiters)
+        {
+            if (end>=tokenStart+delimiter.size() && data.compare(end-delimiter.size(),delimiter.size(),delimiter)==0 && delimiter.size()>best.size())
+                best = delimiter;
+        }
+        if (!best.empty())
+        {
+            r.push_back( { data.substr(tokenStart,end-best.size()-tokenStart), best } );
+            tokenStart = end;
+        }
+    }
+    // The stream end parses the remaining (maybe empty) data:
+    r.push_back( { data.substr(tokenStart), "" } );
+    return r;
+}
+
+static bool feed(SubParser & parser, const std::string & data, size_t maxPieceSize, std::mt19937 & rng)
+{
+    size_t offset = 0;
+    while (offset<data.size())
+    {
+        size_t pieceSize = maxPieceSize==1? 1 : std::min<size_t>(data.size()-offset, maxPieceSize? 1+rng()%maxPieceSize : data.size());
+        while (pieceSize)
+        {
+            std::pair<bool,uint64_t> r = parser.writeIntoParser(data.data()+offset, pieceSize);
+            if (!r.first)
+                return false;
+            offset+=r.second;
+            pieceSize-=r.second;
+        }
+    }
+    return true;
+}
+
+static std::string printable(std::string s)
+{
+    for (char & c : s)
+    {
+        if (c=='\r') c='R';
+        else if (c=='\n') c='N';
+    }
+    return s;
+}
+
+static bool modelCheck(const uint32_t & iterations, const uint32_t & seed)
+{
+    const char alphabet[] = "ab\r\n";
+    std::mt19937 rng(seed);
+
+    for (uint32_t it=0; it<iterations; it++)
+    {
+        std::list<std::string> delimiters;
+        size_t delimitersCount = 1+rng()%3;
+        for (size_t i=0; i<delimitersCount; i++)
+        {
+            std::string delimiter;
+            for (size_t len=1+rng()%4; len; len--)
+                delimiter+=alphabet[rng()%4];
+            delimiters.push_back(delimiter);
+        }
+        std::string data;
+        for (size_t len=rng()%300; len; len--)
+            data+=alphabet[rng()%4];
+
+        std::vector<sToken> expected = referenceSplit(data, delimiters);
+        ParseMode mode = delimitersCount==1 && rng()%2? PARSE_MODE_DELIMITER : PARSE_MODE_MULTIDELIMITER;
+
+        // Whole (0), random pieces of up to 50 bytes, one byte at a time:
+        for (size_t maxPieceSize : { 0, 50, 1 })
+        {
+            TokenCollector parser(mode, delimiters);
+            if (!feed(parser, data, maxPieceSize, rng) || !parser.writeIntoParser(nullptr,0).first)
+            {
+                fprintf(stderr, "model check: write failed (iteration %u, pieces of %zu)\n", it, maxPieceSize);
+                return false;
+            }
+            // In the single delimiter mode, the delimiter is not reported:
+            if (mode==PARSE_MODE_DELIMITER)
+            {
+                for (sToken & token : parser.tokens)
+                    token.delimiter = token.delimiter.empty()? "" : delimiters.front();
+            }
+            if (parser.tokens.size()!=expected.size())
+            {
+                fprintf(stderr, "model check: %zu tokens, expected %zu (iteration %u, pieces of %zu)\n",
+                        parser.tokens.size(), expected.size(), it, maxPieceSize);
+                return false;
+            }
+            for (size_t i=0; i<expected.size(); i++)
+            {
+                if (parser.tokens[i]!=expected[i])
+                {
+                    fprintf(stderr, "model check: token %zu is '%s'/'%s', expected '%s'/'%s' (iteration %u, pieces of %zu)\n", i,
+                            printable(parser.tokens[i].data).c_str(), printable(parser.tokens[i].delimiter).c_str(),
+                            printable(expected[i].data).c_str(), printable(expected[i].delimiter).c_str(), it, maxPieceSize);
+                    return false;
+                }
+            }
+        }
+
+        // Direct delimiter: the data is parsed as it comes, until the delimiter:
+        if (delimitersCount==1)
+        {
+            const std::string & delimiter = delimiters.front();
+            std::string expectedData = data.substr(0,data.find(delimiter)), parsedData;
+
+            TokenCollector parser(PARSE_MODE_DIRECT_DELIMITER, delimiters);
+            for (size_t offset=0; offset<data.size() && parser.getDelimiterFound().empty(); )
+            {
+                offset+=parser.writeIntoParser(data.data()+offset,1).second;
+                for (const sToken & token : parser.tokens)
+                    parsedData+=token.data;
+                parser.tokens.clear();
+            }
+
+            // Without the delimiter, the bytes that can start it are kept:
+            bool ok = parser.getDelimiterFound().empty()?
+                        expectedData.compare(0,parsedData.size(),parsedData)==0 && expectedData.size()-parsedData.size()<delimiter.size() :
+                        parsedData==expectedData;
+            if (!ok)
+            {
+                fprintf(stderr, "model check: direct delimiter '%s' parsed '%s', expected '%s' (iteration %u)\n",
+                        printable(delimiter).c_str(), printable(parsedData).c_str(), printable(expectedData).c_str(), it);
+                return false;
+            }
+        }
+    }
+
+    printf("model check OK (%u iterations)\n", iterations);
+    fflush(stdout);
+    return true;
+}
+
+static bool benchLine(const size_t & lineSize)
+{
+    std::string data(lineSize,'x');
+    data+="\r\n";
+
+    TokenCollector parser(PARSE_MODE_DELIMITER, { "\r\n" });
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i=0; i<data.size(); i++)
+    {
+        if (!parser.writeIntoParser(data.data()+i,1).first)
+        {
+            fprintf(stderr, "%zu bytes line: write failed at byte %zu\n", lineSize, i);
+            return false;
+        }
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    printf("%8zu bytes line, 1-byte writes: %8.3f s (%6.0f ns/byte)\n", lineSize, secs, secs*1e9/data.size());
+    fflush(stdout);
+    return parser.tokens.size()==1 && parser.tokens.front().data.size()==lineSize;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = argc>1? strtoul(argv[1],nullptr,10) : 3000;
+    uint32_t seed = argc>2? strtoul(argv[2],nullptr,10) : 7;
+
+    bool ok = !iterations || modelCheck(iterations, seed);
+    // Every write is kept as a chunk (up to 256K chunks in the unparsed buffer):
+    for (size_t lineSize : { 4*1024, 16*1024, 64*1024, 128*1024 })
+        ok = ok && benchLine(lineSize);
+
+    return ok? 0 : -1;
+}
@@ -0,0 +1,173 @@
+#include <cx2_mem_vars/b_mmap.h>
+
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace CX2::Memory::Containers;
+
+/*
+ * File mapped container (B_MMAP/FileMap):
+ *   - model check: random appends, prepends, displaces and truncates against a std::string, including
+ *                  the file contents left after closing it.
+ *   - throughput: appends up to the size, then displace+append at that size (the queue pattern),
+ *                 from 1 MiB up to the max size (x4 each step).
+ *
+ * usage: bench_filemap [file (default /tmp/bench_filemap.bin)] [max MiB (default 10240)] [min MiB (default 1)]
+ */
+
+#define BENCH_CHUNK_SIZE (64*1024)
+
+static std::string fileContent(const std::string & filePath)
+{
+    std::ifstream f(filePath, std::ios::binary);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+static std::string containerContent(B_MMAP & container)
+{
+    std::string r;
+    r.resize(container.size());
+    if (!r.empty())
+        container.copyOut(&r[0], r.size());
+    return r;
+}
+
+static bool modelCheck(const std::string & filePath)
+{
+    remove(filePath.c_str());
+
+    std::string model;
+    {
+        B_MMAP container;
+        if (!container.referenceFile(filePath, false, true))
+        {
+            fprintf(stderr, "model check: can't open %s\n", filePath.c_str());
+            return false;
+        }
+
+        std::mt19937 rng(1);
+        for (uint32_t i=0; i<20000; i++)
+        {
+            uint32_t op = rng()%5;
+            std::string data(rng()%5000, 0);
+            for (char & c : data)
+                c = 'a'+rng()%26;
+
+            if (op<=1)
+            {
+                container.append(data.data(), data.size());
+                model+=data;
+            }
+            else if (op==2)
+            {
+                container.prepend(data.data(), data.size());
+                model=data+model;
+            }
+            else if (op==3)
+            {
+                size_t bytes = rng()%(model.size()+1);
+                container.displace(bytes);
+                model.erase(0,bytes);
+            }
+            else if (rng()%10==0)
+            {
+                if (!container.truncate(model.size()/2).first)
+                {
+                    fprintf(stderr, "model check: truncate failed at operation %u\n", i);
+                    return false;
+                }
+                model.resize(model.size()/2);
+            }
+
+            if (container.size()!=model.size() || (i%500==0 && containerContent(container)!=model))
+            {
+                fprintf(stderr, "model check: mismatch at operation %u (%llu vs %llu bytes)\n", i,
+                        (unsigned long long)container.size(), (unsigned long long)model.size());
+                return false;
+            }
+        }
+
+        if (containerContent(container)!=model)
+        {
+            fprintf(stderr, "model check: final content mismatch\n");
+            return false;
+        }
+    }
+
+    // The closed file should contain only the data:
+    bool ok = fileContent(filePath)==model;
+    remove(filePath.c_str());
+    printf("model check %s (%llu bytes)\n", ok? "OK" : "FAILED (file content mismatch)", (unsigned long long)model.size());
+    fflush(stdout);
+    return ok;
+}
+
+static bool benchSize(const std::string & filePath, const uint64_t & size)
+{
+    remove(filePath.c_str());
+
+    B_MMAP container;
+    if (!container.referenceFile(filePath, false, true))
+    {
+        fprintf(stderr, "can't open %s\n", filePath.c_str());
+        return false;
+    }
+    container.setRemoveOnDestroy(true);
+
+    std::string chunk(BENCH_CHUNK_SIZE,'x');
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t written=0; written<size; written+=chunk.size())
+    {
+        if (!container.append(chunk.data(), chunk.size()).first)
+        {
+            fprintf(stderr, "append failed at %llu bytes\n", (unsigned long long)written);
+            return false;
+        }
+    }
+    auto appended = std::chrono::steady_clock::now();
+
+    // Queue pattern: consume from the head while producing at the tail, keeping the size:
+    for (uint64_t written=0; written<size; written+=chunk.size())
+    {
+        container.displace(chunk.size());
+        if (!container.append(chunk.data(), chunk.size()).first)
+        {
+            fprintf(stderr, "displace+append failed at %llu bytes\n", (unsigned long long)written);
+            return false;
+        }
+    }
+    auto displaced = std::chrono::steady_clock::now();
+
+    double mib = size/(1024.0*1024.0);
+    printf("%8llu MiB: append %10.1f MiB/s, displace+append %10.1f MiB/s\n", (unsigned long long)(size>>20),
+           mib/std::chrono::duration<double>(appended-start).count(),
+           mib/std::chrono::duration<double>(displaced-appended).count());
+    fflush(stdout);
+    return container.size()==((size+BENCH_CHUNK_SIZE-1)/BENCH_CHUNK_SIZE)*BENCH_CHUNK_SIZE;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string filePath = argc>1? argv[1] : "/tmp/bench_filemap.bin";
+    uint64_t maxMiB = argc>2? strtoull(argv[2],nullptr,10) : 10240;
+    uint64_t minMiB = argc>3? strtoull(argv[3],nullptr,10) : 1;
+    if (!maxMiB || !minMiB || minMiB>maxMiB)
+    {
+        fprintf(stderr, "usage: %s [file] [max MiB] [min MiB]\n", argv[0]);
+        return -1;
+    }
+
+    bool ok = modelCheck(filePath);
+    for (uint64_t mib=minMiB; ok && mib<=maxMiB; mib = (mib<maxMiB && mib*4>maxMiB)? maxMiB : mib*4)
+        ok = benchSize(filePath, mib*1024*1024);
+
+    return ok? 0 : -1;
+}
@@ -0,0 +1,215 @@
+#include <cx2_mem_vars/b_ring.h>
+#include <cx2_mem_vars/b_chunks.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace CX2::Memory::Containers;
+
+/*
+ * Ring container (B_Ring):
+ *   - model check: random appends, prepends, displaces, truncates, finds and compares against a std::string
+ *                  (the ring grows from 16 bytes).
+ *   - spsc check: one thread appends a known byte sequence while another one reads, verifies and displaces it
+ *                 (single-producer/single-consumer mode, fixed capacity).
+ *   - throughput: append+displace (the queue pattern), B_Ring vs B_Chunks.
+ *
+ * usage: bench_ring [model check operations (default 200000)] [spsc MiB (default 1024)] [seed (default 3)]
+ */
+
+static std::string containerContent(B_Base & container)
+{
+    std::string r;
+    r.resize(container.size());
+    if (!r.empty())
+        container.copyOut(&r[0], r.size());
+    return r;
+}
+
+static bool modelCheck(const uint32_t & operations, const uint32_t & seed)
+{
+    B_Ring container(16);
+    std::string model;
+    std::mt19937 rng(seed);
+
+    for (uint32_t i=0; i<operations; i++)
+    {
+        uint32_t op = rng()%6;
+        std::string data(rng()%100, 0);
+        for (char & c : data)
+            c = 'a'+rng()%26;
+
+        if (op<=1)
+        {
+            if (!container.append(data.data(), data.size()).first)
+            {
+                fprintf(stderr, "model check: append failed at operation %u\n", i);
+                return false;
+            }
+            model+=data;
+        }
+        else if (op==2)
+        {
+            if (!container.prepend(data.data(), data.size()).first)
+            {
+                fprintf(stderr, "model check: prepend failed at operation %u\n", i);
+                return false;
+            }
+            model=data+model;
+        }
+        else if (op==3)
+        {
+            size_t bytes = rng()%(model.size()+1);
+            container.displace(bytes);
+            model.erase(0,bytes);
+        }
+        else if (op==4 && model.size()>4)
+        {
+            // Find/compare a piece of the data (may be split by the ring end):
+            size_t offset = rng()%(model.size()-3);
+            std::string needle = model.substr(offset,3);
+            std::pair<bool,uint64_t> found = container.find(needle.data(), needle.size(), true, 0, 0);
+            if (!found.first || found.second!=model.find(needle) || !container.compare(needle.data(), needle.size(), true, offset))
+            {
+                fprintf(stderr, "model check: find/compare mismatch at operation %u\n", i);
+                return false;
+            }
+        }
+        else if (op==5 && !model.empty())
+        {
+            size_t bytes = rng()%model.size();
+            container.truncate(bytes);
+            model.resize(bytes);
+        }
+
+        if (container.size()!=model.size() || (i%97==0 && containerContent(container)!=model))
+        {
+            fprintf(stderr, "model check: mismatch at operation %u (%llu vs %llu bytes)\n", i,
+                    (unsigned long long)container.size(), (unsigned long long)model.size());
+            return false;
+        }
+    }
+
+    // Copied to other container:
+    B_Chunks out;
+    container.appendTo(out);
+    bool ok = containerContent(container)==model && containerContent(out)==model;
+    printf("model check %s (%u operations, capacity %llu)\n", ok? "OK" : "FAILED (content mismatch)", operations,
+           (unsigned long long)container.getCapacity());
+    fflush(stdout);
+    return ok;
+}
+
+static char sequenceByte(const uint64_t & pos)
+{
+    return (char)((pos*7) ^ (pos>>11));
+}
+
+static bool spscCheck(const uint64_t & bytes, const uint32_t & seed)
+{
+    B_Ring container(64*1024, true);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        std::mt19937 rng(seed);
+        char buf[4096];
+        uint64_t written = 0;
+        while (written<bytes)
+        {
+            size_t len = std::min<uint64_t>(1+rng()%sizeof(buf), bytes-written);
+            for (size_t i=0; i<len; i++)
+                buf[i] = sequenceByte(written+i);
+            if (container.append(buf, len).first)
+                written+=len;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    // Consumer:
+    char buf[8192];
+    uint64_t received = 0;
+    bool ok = true;
+    while (ok && received<bytes)
+    {
+        uint64_t len = std::min<uint64_t>(container.size(), sizeof(buf));
+        if (!len)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        container.copyOut(buf, len);
+        for (size_t i=0; ok && i<len; i++)
+        {
+            if (buf[i]!=sequenceByte(received+i))
+            {
+                fprintf(stderr, "spsc check: unexpected byte at %llu\n", (unsigned long long)(received+i));
+                ok = false;
+            }
+        }
+        container.displace(len);
+        received+=len;
+    }
+
+    // On failure, let the producer finish:
+    while (!ok && received<bytes)
+    {
+        uint64_t len = container.size();
+        container.displace(len);
+        received+=len;
+    }
+    producer.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    // prepend is not available in the spsc mode:
+    ok = ok && !container.prepend("x",1).first && container.size()==0;
+
+    printf("spsc check %s (%llu MiB, %.1f MiB/s)\n", ok? "OK" : "FAILED", (unsigned long long)(bytes>>20), (bytes/(1024.0*1024.0))/secs);
+    fflush(stdout);
+    return ok;
+}
+
+static void benchQueue(B_Base & container, const char * name)
+{
+    std::string chunk(1500,'x');
+    for (int i=0; i<1000; i++)
+        container.append(chunk.data(), chunk.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<200000; i++)
+    {
+        container.append(chunk.data(), chunk.size());
+        container.displace(1000);
+        container.displace(500);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    printf("%-8s: %6.0f ns per append+2 displaces\n", name, secs*1e9/200000);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t operations = argc>1? strtoul(argv[1],nullptr,10) : 200000;
+    uint64_t spscMiB = argc>2? strtoull(argv[2],nullptr,10) : 1024;
+    uint32_t seed = argc>3? strtoul(argv[3],nullptr,10) : 3;
+
+    bool ok = (!operations || modelCheck(operations, seed)) &&
+              (!spscMiB || spscCheck(spscMiB*1024*1024, seed));
+
+    if (ok)
+    {
+        B_Ring ring;
+        B_Chunks chunks;
+        benchQueue(ring, "B_Ring");
+        benchQueue(chunks, "B_Chunks");
+    }
+
+    return ok? 0 : -1;
+}
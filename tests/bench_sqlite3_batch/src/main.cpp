@@ -0,0 +1,122 @@
+#include <cx2_db_sqlite3/sqlconnector_sqlite3.h>
+#include <cx2_mem_vars/a_allvars.h>
+
+#include <chrono>
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace CX2::Database;
+using namespace CX2::Memory::Abstract;
+
+/*
+ * SQLite3 inserts per second: one query() per row (autocommit) against batchQuery() (one transaction
+ * and one prepared statement), with the default rollback journal and with the WAL server profile
+ * (synchronous=NORMAL and the prepared statements cache).
+ *
+ * usage: bench_sqlite3_batch [database file (default /tmp/bench_sqlite3_batch.db)] [batch rows (default 200000)] [loop rows (default 2000)]
+ */
+
+#define INSERT_QUERY "INSERT INTO vals (a,b,c) VALUES(:a,:b,:c);"
+
+static std::map<std::string,Var *> newRow(const uint32_t & i)
+{
+    return { {":a",new INT32(i)}, {":b",new STRING("value " + std::to_string(i))}, {":c",new DOUBLE(i*0.5)} };
+}
+
+static bool openDB(SQLConnector_SQLite3 & db, const std::string & dbFile, bool serverProfile)
+{
+    unlink(dbFile.c_str());
+    unlink((dbFile + "-wal").c_str());
+    unlink((dbFile + "-shm").c_str());
+
+    if (!db.connect(dbFile))
+        return false;
+
+    if (serverProfile)
+    {
+        if (!db.sqlite3ServerProfile(0))
+            return false;
+    }
+    else
+        db.sqlite3SetStatementCacheSize(0);
+
+    return db.query("CREATE TABLE vals (a INTEGER, b TEXT, c REAL);");
+}
+
+static void report(const char * name, const uint32_t & rows, double secs)
+{
+    printf("%-50s %12.0f rows/s\n", name, rows/secs);
+    fflush(stdout);
+}
+
+static bool benchLoop(const char * name, const std::string & dbFile, bool serverProfile, const uint32_t & rows)
+{
+    SQLConnector_SQLite3 db;
+    if (!openDB(db, dbFile, serverProfile))
+    {
+        fprintf(stderr, "%s: can't open %s\n", name, dbFile.c_str());
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i=0; i<rows; i++)
+    {
+        if (!db.query(INSERT_QUERY, newRow(i)))
+        {
+            fprintf(stderr, "%s: %s\n", name, db.getLastSQLError().c_str());
+            return false;
+        }
+    }
+    report(name, rows, std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+    return true;
+}
+
+static bool benchBatch(const char * name, const std::string & dbFile, bool serverProfile, const uint32_t & rows)
+{
+    SQLConnector_SQLite3 db;
+    if (!openDB(db, dbFile, serverProfile))
+    {
+        fprintf(stderr, "%s: can't open %s\n", name, dbFile.c_str());
+        return false;
+    }
+
+    // The rows are built outside the measurement (like the loop does with the query parameters):
+    std::list<std::map<std::string,Var *>> inputRows;
+    for (uint32_t i=0; i<rows; i++)
+        inputRows.push_back(newRow(i));
+
+    auto start = std::chrono::steady_clock::now();
+    if (!db.batchQuery(INSERT_QUERY, inputRows))
+    {
+        fprintf(stderr, "%s: %s\n", name, db.getLastSQLError().c_str());
+        return false;
+    }
+    report(name, rows, std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string dbFile = argc>1? argv[1] : "/tmp/bench_sqlite3_batch.db";
+    uint32_t batchRows = argc>2? strtoul(argv[2],nullptr,10) : 200000;
+    uint32_t loopRows = argc>3? strtoul(argv[3],nullptr,10) : 2000;
+    if (!batchRows || !loopRows)
+    {
+        fprintf(stderr, "usage: %s [database file] [batch rows] [loop rows]\n", argv[0]);
+        return -1;
+    }
+
+    bool ok = benchLoop("query() loop (rollback journal)", dbFile, false, loopRows);
+    ok = benchLoop("query() loop (WAL profile, statement cache)", dbFile, true, loopRows) && ok;
+    ok = benchBatch("batchQuery() (rollback journal)", dbFile, false, batchRows) && ok;
+    ok = benchBatch("batchQuery() (WAL profile, statement cache)", dbFile, true, batchRows) && ok;
+
+    unlink(dbFile.c_str());
+    unlink((dbFile + "-wal").c_str());
+    unlink((dbFile + "-shm").c_str());
+
+    return ok? 0 : -1;
+}
@@ -0,0 +1,36 @@
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+isEmpty(PREFIX) {
+    PREFIX = /usr/local
+}
+
+isEmpty(OSSLIBS_PREFIX) {
+    OSSLIBS_PREFIX = /opt/osslibs
+}
+
+# includes dir
+LIBS += -L$$PREFIX/lib -L$$OSSLIBS_PREFIX/lib
+
+QMAKE_INCDIR += src
+INCLUDEPATH += src
+
+QMAKE_INCDIR += $$PREFIX/include
+INCLUDEPATH += $$PREFIX/include
+
+QMAKE_INCDIR += $$OSSLIBS_PREFIX/include
+INCLUDEPATH += $$OSSLIBS_PREFIX/include
+
+#Target directory
+DESTDIR=bin
+#Intermediate object files directory
+OBJECTS_DIR=obj
+
+LIBS += -lcx2_net_interfaces
+
+LIBS += -lpthread
+
+SOURCES +=  \
+    src/main.cpp
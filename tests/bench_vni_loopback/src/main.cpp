@@ -0,0 +1,273 @@
+#include <cx2_net_interfaces/virtualnetworkinterface.h>
+#include <cx2_net_interfaces/netifconfig.h>
+
+#include <arpa/inet.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <linux/if_ether.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <sys/time.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace CX2::Network::Interfaces;
+
+/*
+ * Packets per second through a TAP interface (needs CAP_NET_ADMIN), looped with a kernel UDP socket:
+ *   - write path: UDP frames written with writePacket/writePackets, received by a UDP socket bound to the interface address.
+ *   - read path: UDP broadcasts sent by a UDP socket through the interface, read with readPacket/readPackets.
+ *
+ * usage: bench_vni_loopback [packets (default 200000)] [UDP payload size (default 1024)] [nonblocking (0/1, default 0)]
+ */
+
+#define BENCH_IFACE_ADDR "10.201.0.1"
+#define BENCH_PEER_ADDR "10.201.0.2"
+#define BENCH_BROADCAST_ADDR "10.201.0.255"
+#define BENCH_UDP_PORT 40201
+#define BENCH_BATCH_SIZE 32
+
+static void report(const char * name, const uint64_t & packets, const uint64_t & sent, const size_t & payloadSize, double secs)
+{
+    printf("%-36s %10.0f pkt/s %8.1f MiB/s (%llu/%llu packets)\n", name, packets/secs, packets*payloadSize/secs/(1024.0*1024.0),
+           (unsigned long long)packets, (unsigned long long)sent);
+    fflush(stdout);
+}
+
+static uint16_t ipChecksum(const void * data, size_t len)
+{
+    const uint16_t * p = (const uint16_t *)data;
+    uint32_t sum = 0;
+    for (; len>1; len-=2)
+        sum += *p++;
+    while (sum>>16)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+static std::vector<unsigned char> buildFrame(const ethhdr & ifaceEthernet, const size_t & payloadSize)
+{
+    std::vector<unsigned char> frame(sizeof(ethhdr)+sizeof(iphdr)+sizeof(udphdr)+payloadSize, 'x');
+
+    // From a fake peer in the interface subnet to the interface address:
+    ethhdr * eth = (ethhdr *)frame.data();
+    memcpy(eth->h_dest, ifaceEthernet.h_dest, ETH_ALEN);
+    const unsigned char peerMAC[ETH_ALEN] = { 0x02,0x00,0x00,0xC8,0x00,0x02 };
+    memcpy(eth->h_source, peerMAC, ETH_ALEN);
+    eth->h_proto = htons(ETH_P_IP);
+
+    iphdr * ip = (iphdr *)(frame.data()+sizeof(ethhdr));
+    memset(ip,0,sizeof(iphdr));
+    ip->version = 4;
+    ip->ihl = 5;
+    ip->ttl = 64;
+    ip->protocol = IPPROTO_UDP;
+    ip->tot_len = htons((uint16_t)(sizeof(iphdr)+sizeof(udphdr)+payloadSize));
+    inet_pton(AF_INET, BENCH_PEER_ADDR, &ip->saddr);
+    inet_pton(AF_INET, BENCH_IFACE_ADDR, &ip->daddr);
+    ip->check = ipChecksum(ip, sizeof(iphdr));
+
+    // UDP checksum 0 (not computed) is valid for IPv4:
+    udphdr * udp = (udphdr *)(frame.data()+sizeof(ethhdr)+sizeof(iphdr));
+    udp->source = htons(BENCH_UDP_PORT);
+    udp->dest = htons(BENCH_UDP_PORT);
+    udp->len = htons((uint16_t)(sizeof(udphdr)+payloadSize));
+    udp->check = 0;
+    return frame;
+}
+
+static int udpSocket(const char * bindAddr)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock<0)
+        return -1;
+
+    int bufSize = 16*1024*1024, on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+    setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    // Stop receiving after one second without packets (dropped ones):
+    struct timeval tv = { 1, 0 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    struct sockaddr_in addr;
+    memset(&addr,0,sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(bindAddr? BENCH_UDP_PORT : 0);
+    inet_pton(AF_INET, bindAddr? bindAddr : BENCH_IFACE_ADDR, &addr.sin_addr);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr))<0)
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+static bool benchWrite(VirtualNetworkInterface & vni, const ethhdr & ifaceEthernet, bool batched, const uint64_t & packets, const size_t & payloadSize)
+{
+    int sock = udpSocket(BENCH_IFACE_ADDR);
+    if (sock<0)
+    {
+        perror("bind");
+        return false;
+    }
+
+    std::vector<unsigned char> frame = buildFrame(ifaceEthernet, payloadSize);
+    std::vector<sVirtualNetworkPacket> batch(BENCH_BATCH_SIZE, sVirtualNetworkPacket{frame.data(),frame.size()});
+
+    std::atomic<uint64_t> received(0);
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point lastPacket = start;
+    std::thread receiver([&]() {
+        std::vector<char> buf(payloadSize+1);
+        while (received<packets && recv(sock, buf.data(), buf.size(), 0)>0)
+        {
+            received++;
+            lastPacket = std::chrono::steady_clock::now();
+        }
+    });
+
+    uint64_t sent = 0;
+    while (sent<packets)
+    {
+        if (batched)
+        {
+            if (packets-sent < batch.size())
+                batch.resize(packets-sent);
+            ssize_t r = vni.writePackets(0, batch);
+            if (r<=0)
+                break;
+            sent += r;
+        }
+        else
+        {
+            if (vni.writePacket(frame.data(), frame.size()) != (ssize_t)frame.size())
+                break;
+            sent++;
+        }
+    }
+    receiver.join();
+    close(sock);
+
+    report(batched? "writePackets -> UDP socket" : "writePacket -> UDP socket", received, sent, payloadSize,
+           std::chrono::duration<double>(lastPacket-start).count());
+    return sent==packets;
+}
+
+static bool isBenchFrame(const unsigned char * data, const size_t & len)
+{
+    if (len < sizeof(ethhdr)+sizeof(iphdr)+sizeof(udphdr))
+        return false;
+    const ethhdr * eth = (const ethhdr *)data;
+    const iphdr * ip = (const iphdr *)(data+sizeof(ethhdr));
+    const udphdr * udp = (const udphdr *)(data+sizeof(ethhdr)+ip->ihl*4);
+    return eth->h_proto == htons(ETH_P_IP) && ip->protocol == IPPROTO_UDP && udp->dest == htons(BENCH_UDP_PORT);
+}
+
+static bool benchRead(VirtualNetworkInterface & vni, bool batched, const uint64_t & packets, const size_t & payloadSize)
+{
+    int sock = udpSocket(nullptr);
+    if (sock<0)
+    {
+        perror("bind");
+        return false;
+    }
+
+    std::vector<unsigned char> arena(BENCH_BATCH_SIZE*vni.getMaxPacketSize());
+    std::vector<sVirtualNetworkPacket> readed;
+
+    uint64_t received = 0;
+    std::atomic<uint64_t> sent(0);
+    std::thread sender([&]() {
+        std::vector<char> payload(payloadSize,'x');
+        struct sockaddr_in addr;
+        memset(&addr,0,sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(BENCH_UDP_PORT);
+        inet_pton(AF_INET, BENCH_BROADCAST_ADDR, &addr.sin_addr);
+        for (uint64_t i=0; i<packets; i++)
+        {
+            if (sendto(sock, payload.data(), payload.size(), 0, (struct sockaddr *)&addr, sizeof(addr)) > 0)
+                sent++;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point lastPacket = start;
+    while (received<packets)
+    {
+        if (batched)
+        {
+            readed.clear();
+            // Stop after one second without packets (dropped ones):
+            if (vni.readPackets(0, arena.data(), arena.size(), readed, 1000) <= 0)
+                break;
+            for (const sVirtualNetworkPacket & packet : readed)
+            {
+                if (isBenchFrame(packet.data, packet.len))
+                    received++;
+            }
+        }
+        else
+        {
+            // readPacket has no timeout, wait here for the next packet:
+            struct pollfd pfd = { vni.getInterfaceHandler(0), POLLIN, 0 };
+            if (poll(&pfd,1,1000) <= 0)
+                break;
+            ssize_t r = vni.readPacket(arena.data(), (unsigned int)arena.size());
+            if (r<=0)
+                break;
+            if (isBenchFrame(arena.data(), r))
+                received++;
+        }
+        lastPacket = std::chrono::steady_clock::now();
+    }
+    sender.join();
+    close(sock);
+
+    report(batched? "UDP socket -> readPackets" : "UDP socket -> readPacket", received, sent, payloadSize,
+           std::chrono::duration<double>(lastPacket-start).count());
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t packets = argc>1? strtoull(argv[1],nullptr,10) : 200000;
+    size_t payloadSize = argc>2? strtoull(argv[2],nullptr,10) : 1024;
+    bool nonBlocking = argc>3 && atoi(argv[3]);
+    if (!packets || !payloadSize || payloadSize > 1472)
+    {
+        fprintf(stderr, "usage: %s [packets] [UDP payload size (up to 1472)] [nonblocking]\n", argv[0]);
+        return -1;
+    }
+
+    NetIfConfig netcfg;
+    struct in_addr address, netmask;
+    inet_pton(AF_INET, BENCH_IFACE_ADDR, &address);
+    inet_pton(AF_INET, "255.255.255.0", &netmask);
+    netcfg.setIPv4Address(address, netmask);
+
+    VirtualNetworkInterface vni;
+    if (!vni.start(&netcfg, "cxbench", 1, false, nonBlocking))
+    {
+        fprintf(stderr, "Can't start the TAP interface: %s\n", vni.getLastError().c_str());
+        return -1;
+    }
+    ethhdr ifaceEthernet = netcfg.getEthernetAddress();
+
+    printf("Interface %s (%s descriptor)\n", vni.getInterfaceRealName().c_str(), nonBlocking? "non-blocking" : "blocking");
+    bool ok = benchWrite(vni, ifaceEthernet, false, packets, payloadSize);
+    ok = benchWrite(vni, ifaceEthernet, true, packets, payloadSize) && ok;
+    ok = benchRead(vni, true, packets, payloadSize) && ok;
+    ok = benchRead(vni, false, packets, payloadSize) && ok;
+
+    vni.stop();
+    return ok? 0 : -1;
+}
@@ -0,0 +1,38 @@
+TEMPLATE = subdirs
+
+# Benchmarks and model checks, linked against the installed libraries
+# (build and install the framework first).
+
+# ChainSockets AES layers vs raw EVP AES-CTR throughput
+SUBDIRS += bench_chains_aes
+# Project folders:
+bench_chains_aes.subdir    = bench_chains_aes
+
+# SubParser delimiter modes model check (vs a reference splitter) and 1-byte writes throughput
+SUBDIRS += bench_delimiters
+# Project folders:
+bench_delimiters.subdir    = bench_delimiters
+
+# FileMap (B_MMAP) model check and append/displace throughput, 1 MiB to 10 GiB
+SUBDIRS += bench_filemap
+# Project folders:
+bench_filemap.subdir    = bench_filemap
+
+# B_Ring model check (vs std::string), producer/consumer data check and queue throughput vs B_Chunks
+SUBDIRS += bench_ring
+# Project folders:
+bench_ring.subdir    = bench_ring
+
+# SQLite3 inserts/sec: batchQuery vs query loop
+SUBDIRS += bench_sqlite3_batch
+# Project folders:
+bench_sqlite3_batch.subdir    = bench_sqlite3_batch
+
+# VirtualNetworkInterface packets/sec through a TAP interface (linux, CAP_NET_ADMIN)
+linux:SUBDIRS += bench_vni_loopback
+# Project folders:
+bench_vni_loopback.subdir    = bench_vni_loopback
+
+
+
+#END-